@@ -195,3 +195,35 @@ AC_DEFUN([MPC_GITVERSION], [
       ])
    fi
 ])
+
+
+#
+# SYNOPSIS
+#
+#
+# MPC_C_THREAD_LOCAL
+#
+# DESCRIPTION
+#
+# Look for a storage class specifier for thread local variables among
+# _Thread_local, __thread and __declspec(thread), and define
+# MPC_THREAD_LOCAL to the first one that is accepted by the compiler.
+# Otherwise, MPC_THREAD_LOCAL is defined as empty, and the internal
+# caches of the library are shared between all threads.
+#
+AC_DEFUN([MPC_C_THREAD_LOCAL], [
+   AC_MSG_CHECKING([for thread local storage])
+   mpc_thread_local=
+   for tls in _Thread_local __thread "__declspec(thread)"; do
+      AC_COMPILE_IFELSE(
+         [AC_LANG_PROGRAM([[static $tls int x;]], [[x = 1; return x;]])],
+         [mpc_thread_local=$tls; break])
+   done
+   if test -n "$mpc_thread_local"; then
+      AC_MSG_RESULT([$mpc_thread_local])
+   else
+      AC_MSG_RESULT([no, internal caches are not thread-safe])
+   fi
+   AC_DEFINE_UNQUOTED([MPC_THREAD_LOCAL], [$mpc_thread_local],
+      [Storage class specifier for thread local variables])
+])
@@ -1,6 +1,6 @@
 /* mpc_abs -- Absolute value of a complex number.
 
-Copyright (C) 2008, 2009, 2011 INRIA
+Copyright (C) 2008, 2009, 2011, 2025 INRIA
 
 This file is part of GNU MPC.
 
@@ -24,5 +24,6 @@ along with this program. If not, see http://www.gnu.org/licenses/ .
 int
 mpc_abs (mpfr_ptr a, mpc_srcptr b, mpfr_rnd_t rnd)
 {
+   MPC_STATS_FUNC (abs, mpfr_get_prec (a))
    return mpfr_hypot (a, mpc_realref(b), mpc_imagref(b), rnd);
 }
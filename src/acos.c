@@ -1,6 +1,6 @@
 /* mpc_acos -- arccosine of a complex number.
 
-Copyright (C) 2009, 2010, 2011, 2012, 2020, 2024 INRIA
+Copyright (C) 2009, 2010, 2011, 2012, 2020, 2024, 2025 INRIA
 
 This file is part of GNU MPC.
 
@@ -24,6 +24,7 @@ along with this program. If not, see http://www.gnu.org/licenses/ .
 int
 mpc_acos (mpc_ptr rop, mpc_srcptr op, mpc_rnd_t rnd)
 {
+  MPC_STATS_FUNC (acos, MPC_MAX_PREC (rop))
   int inex_re, inex_im, inex, loop = 0;
   mpfr_prec_t p_re, p_im, p;
   mpfr_exp_t ex, ey;
@@ -208,6 +209,7 @@ mpc_acos (mpc_ptr rop, mpc_srcptr op, mpc_rnd_t rnd)
     {
       MPC_LOOP_NEXT(loop, op, rop);
       p += (loop <= 2) ? mpc_ceil_log2 (p) + 3 : p / 2;
+      MPC_ZIV_START (acos, loop, p, p_re);
       mpfr_set_prec (mpc_realref(z1), p);
       mpfr_set_prec (pi_over_2, p);
 
@@ -235,6 +237,7 @@ mpc_acos (mpc_ptr rop, mpc_srcptr op, mpc_rnd_t rnd)
             break;
         }
     }
+  MPC_ZIV_END (acos, loop, p, p_re);
   inex = mpc_set (rop, z1, rnd);
   inex_re = MPC_INEX_RE(inex);
   mpc_clear (z1);
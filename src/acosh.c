@@ -1,6 +1,6 @@
 /* mpc_acosh -- inverse hyperbolic cosine of a complex number.
 
-Copyright (C) 2009, 2011, 2012 INRIA
+Copyright (C) 2009, 2011, 2012, 2025 INRIA
 
 This file is part of GNU MPC.
 
@@ -30,6 +30,7 @@ along with this program. If not, see http://www.gnu.org/licenses/ .
 int
 mpc_acosh (mpc_ptr rop, mpc_srcptr op, mpc_rnd_t rnd)
 {
+  MPC_STATS_FUNC (acosh, MPC_MAX_PREC (rop))
   /* acosh(z) =
       NaN + i*NaN, if z=0+i*NaN
      -i*acos(z), if sign(Im(z)) = -
@@ -1,6 +1,6 @@
 /* mpc_add -- Add two complex numbers.
 
-Copyright (C) 2002, 2009, 2011 INRIA
+Copyright (C) 2002, 2009, 2011, 2025 INRIA
 
 This file is part of GNU MPC.
 
@@ -24,6 +24,7 @@ along with this program. If not, see http://www.gnu.org/licenses/ .
 int
 mpc_add (mpc_ptr a, mpc_srcptr b, mpc_srcptr c, mpc_rnd_t rnd)
 {
+  MPC_STATS_FUNC (add, MPC_MAX_PREC (a))
   int inex_re, inex_im;
 
   inex_re = mpfr_add (mpc_realref(a), mpc_realref(b), mpc_realref(c), MPC_RND_RE(rnd));
@@ -1,6 +1,6 @@
 /* mpc_add_si -- Add a complex number and a signed long int.
 
-Copyright (C) 2011 INRIA
+Copyright (C) 2011, 2025 INRIA
 
 This file is part of GNU MPC.
 
@@ -23,6 +23,7 @@ along with this program. If not, see http://www.gnu.org/licenses/ .
 int
 mpc_add_si (mpc_ptr rop, mpc_srcptr op1, long int op2, mpc_rnd_t rnd)
 {
+   MPC_STATS_FUNC (add_si, MPC_MAX_PREC (rop))
    int inex_re, inex_im;
 
    inex_re = mpfr_add_si (mpc_realref (rop), mpc_realref (op1), op2, MPC_RND_RE (rnd));
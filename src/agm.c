@@ -1,6 +1,6 @@
 /* mpc_agm -- AGM of a complex number.
 
-Copyright (C) 2022 INRIA
+Copyright (C) 2022, 2025 INRIA
 
 This file is part of GNU MPC.
 
@@ -208,6 +208,7 @@ mpc_agm_general (mpc_ptr rop, mpc_srcptr a, mpc_srcptr b, mpc_rnd_t rnd)
 int
 mpc_agm (mpc_ptr rop, mpc_srcptr a, mpc_srcptr b, mpc_rnd_t rnd)
 {
+   MPC_STATS_FUNC (agm, MPC_MAX_PREC (rop))
    int inex_re, inex_im;
 
    if (!mpc_fin_p (a) || !mpc_fin_p (b)) {
@@ -1,6 +1,6 @@
 /* mpc_asin -- arcsine of a complex number.
 
-Copyright (C) 2009, 2010, 2011, 2012, 2013, 2014, 2020, 2022, 2024 INRIA
+Copyright (C) 2009, 2010, 2011, 2012, 2013, 2014, 2020, 2022, 2024, 2025 INRIA
 
 This file is part of GNU MPC.
 
@@ -396,6 +396,7 @@ asin_taylor1 (int *inex, mpc_ptr rop, mpc_srcptr z, mpc_rnd_t rnd)
 int
 mpc_asin (mpc_ptr rop, mpc_srcptr op, mpc_rnd_t rnd)
 {
+  MPC_STATS_FUNC (asin, MPC_MAX_PREC (rop))
   mpfr_prec_t p, p_re, p_im;
   mpfr_rnd_t rnd_re, rnd_im;
   mpc_t z1;
@@ -542,6 +543,7 @@ mpc_asin (mpc_ptr rop, mpc_srcptr op, mpc_rnd_t rnd)
     p += err - olderr; /* add extra number of lost bits in previous loop */
     olderr = err;
     p += (loop <= 2) ? mpc_ceil_log2 (p) + 3 : p / 2; // ensures p>=4 in mpc_asin_large_pos()
+    MPC_ZIV_START (asin, loop, p, MPC_MAX (p_re, p_im));
     mpc_set_prec (z1, p);
 
     /* try special code for 1+i*y with tiny y */
@@ -631,6 +633,7 @@ mpc_asin (mpc_ptr rop, mpc_srcptr op, mpc_rnd_t rnd)
       break;
   }
 
+  MPC_ZIV_END (asin, loop, p, MPC_MAX (p_re, p_im));
   inex = mpc_set (rop, z1, rnd);
   mpc_clear (z1);
 
@@ -1,6 +1,6 @@
 /* mpc_atan -- arctangent of a complex number.
 
-Copyright (C) 2009, 2010, 2011, 2012, 2013, 2017, 2020, 2022, 2024 INRIA
+Copyright (C) 2009, 2010, 2011, 2012, 2013, 2017, 2020, 2022, 2024, 2025 INRIA
 
 This file is part of GNU MPC.
 
@@ -45,6 +45,7 @@ set_pi_over_2 (mpfr_ptr rop, int s, mpfr_rnd_t rnd)
 int
 mpc_atan (mpc_ptr rop, mpc_srcptr op, mpc_rnd_t rnd)
 {
+  MPC_STATS_FUNC (atan, MPC_MAX_PREC (rop))
   int s_re, s_im;
   int inex_re, inex_im, inex;
   mpfr_exp_t saved_emin, saved_emax;
@@ -266,6 +267,7 @@ mpc_atan (mpc_ptr rop, mpc_srcptr op, mpc_rnd_t rnd)
       {
         MPC_LOOP_NEXT(loop, op, rop);
         p += (loop <= 2) ? mpc_ceil_log2 (p) + 2 : p / 2;
+        MPC_ZIV_START (atan, loop, p, prec);
         mpfr_set_prec (a, p);
         mpfr_set_prec (b, p);
         mpfr_set_prec (x, p);
@@ -314,6 +316,7 @@ mpc_atan (mpc_ptr rop, mpc_srcptr op, mpc_rnd_t rnd)
         ok = mpfr_can_round (x, p - err, MPFR_RNDU, MPFR_RNDD,
                              prec + (MPC_RND_RE (rnd) == MPFR_RNDN));
       } while (ok == 0);
+    MPC_ZIV_END (atan, loop, p, prec);
 
     /* Imaginary part
        Im(atan(x+I*y)) = 1/4 * [log(x^2+(1+y)^2) - log (x^2 +(1-y)^2)] */
@@ -1,6 +1,6 @@
 /* mpc_atanh -- inverse hyperbolic tangent of a complex number.
 
-Copyright (C) 2009, 2011, 2012 INRIA
+Copyright (C) 2009, 2011, 2012, 2025 INRIA
 
 This file is part of GNU MPC.
 
@@ -23,6 +23,7 @@ along with this program. If not, see http://www.gnu.org/licenses/ .
 int
 mpc_atanh (mpc_ptr rop, mpc_srcptr op, mpc_rnd_t rnd)
 {
+  MPC_STATS_FUNC (atanh, MPC_MAX_PREC (rop))
   /* atanh(op) = -i*atan(i*op) */
   int inex;
   mpfr_t tmp;
@@ -1,6 +1,6 @@
 /* balls -- Functions for complex ball arithmetic.
 
-Copyright (C) 2018, 2020, 2021, 2022, 2023 INRIA
+Copyright (C) 2018, 2020, 2021, 2022, 2023, 2025 INRIA
 
 This file is part of GNU MPC.
 
@@ -136,6 +136,22 @@ mpcb_set_ui_ui (mpcb_ptr z, unsigned long int re, unsigned long int im,
 }
 
 
+void
+mpcb_set_fr (mpcb_ptr z, mpfr_srcptr x, mpfr_prec_t prec,
+   unsigned long int err)
+   /* Set the precision of z to prec and assign a ball with real centre x
+      to it, where err is the error of x in half ulps as for mpcb_set_c. */
+{
+   mpc_t c;
+
+   mpc_init3 (c, mpfr_get_prec (x), 2);
+   mpfr_set (mpc_realref (c), x, MPFR_RNDN);
+   mpfr_set_ui (mpc_imagref (c), 0, MPFR_RNDN);
+   mpcb_set_c (z, c, prec, err, 0);
+   mpc_clear (c);
+}
+
+
 void
 mpcb_neg (mpcb_ptr z, mpcb_srcptr z1)
 {
@@ -153,12 +169,161 @@ mpcb_neg (mpcb_ptr z, mpcb_srcptr z1)
 }
 
 
+void
+mpcb_add_error (mpcb_ptr z, mpcr_srcptr err)
+   /* Add the absolute error err to the radius of z. */
+{
+   mpcr_t r, s;
+
+   mpcr_c_abs_rnd (s, z->c, MPFR_RNDD);
+   mpcr_div (r, err, s);
+   mpcr_add (z->r, z->r, r);
+}
+
+
+void
+mpcb_restrict_real (mpcb_ptr z)
+   /* Replace z by a ball with real centre containing all the real
+      elements of z: if c is the centre of z, a real number x with
+      |x - c| <= r |c| also satisfies |x - Re c| <= r |c|. */
+{
+   mpcr_t s, t;
+
+   mpcr_c_abs_rnd (s, z->c, MPFR_RNDU);
+   mpcr_f_abs_rnd (t, mpc_realref (z->c), MPFR_RNDD);
+   mpcr_mul (s, s, z->r);
+   mpcr_div (z->r, s, t);
+   mpfr_set_ui (mpc_imagref (z->c), 0, MPFR_RNDN);
+}
+
+
+/* The centres of products and quotients of balls need not be correctly
+   rounded, since the radius accounts for the rounding error anyway; the
+   following functions compute them at the precision p of z with a few
+   roundings to nearest and return k such that the relative error with
+   respect to the computed centre is bounded by k * 2^(-p-4), that is,
+   k is counted in sixteenths of 2^(-p). Products are correctly rounded
+   with k = 16, and so are squares below the Karatsuba threshold of
+   mpc_mul. */
+#define CENTRE_ERR_BITS 4
+
+static unsigned int
+mul_centre (mpc_ptr z, mpc_srcptr z1, mpc_srcptr z2)
+   /* Compute z = z1 * z2 with z not overlapping z1 or z2, correctly
+      rounded to nearest. Below the Karatsuba threshold, each part is
+      computed with one rounding by mpfr_fmms and mpfr_fmma, as in
+      mpc_mul_naive; otherwise, mpc_mul uses Karatsuba multiplication
+      with three real multiplications instead of four. */
+{
+   mpfr_srcptr x1, y1, x2, y2;
+   mpfr_prec_t p = mpfr_get_prec (mpc_realref (z));
+
+   if (p > (mpfr_prec_t) MUL_KARATSUBA_THRESHOLD * BITS_PER_MP_LIMB) {
+      mpc_mul (z, z1, z2, MPC_RNDNN);
+      return 16;
+   }
+
+   x1 = mpc_realref (z1);
+   y1 = mpc_imagref (z1);
+   x2 = mpc_realref (z2);
+   y2 = mpc_imagref (z2);
+   mpfr_fmms (mpc_realref (z), x1, x2, y1, y2, MPFR_RNDN);
+   mpfr_fmma (mpc_imagref (z), x1, y2, y1, x2, MPFR_RNDN);
+
+   return 16;
+}
+
+
+static unsigned int
+sqr_centre (mpc_ptr z, mpc_srcptr z1)
+   /* Compute z = z1^2 with z not overlapping z1.
+      Below the Karatsuba threshold, the real part is computed with one
+      rounding by mpfr_fmms, and the imaginary part as 2 * x1 * y1.
+      Otherwise, the real part is computed as (x1 + y1) * (x1 - y1) with
+      a relative error of at most (1 + 2^(-p))^3 - 1, and the imaginary
+      part has a relative error of at most 2^(-p), so the complex error
+      is bounded by 3.01 * 2^(-p) * |z1^2|, or 3.02 * 2^(-p) * |z|. */
+{
+   mpfr_srcptr x1, y1;
+   mpfr_t t;
+   mpfr_prec_t p = mpfr_get_prec (mpc_realref (z));
+
+   x1 = mpc_realref (z1);
+   y1 = mpc_imagref (z1);
+   mpfr_mul (mpc_imagref (z), x1, y1, MPFR_RNDN);
+   mpfr_mul_2ui (mpc_imagref (z), mpc_imagref (z), 1, MPFR_RNDN);
+
+   if (p <= (mpfr_prec_t) MUL_KARATSUBA_THRESHOLD * BITS_PER_MP_LIMB) {
+      mpfr_fmms (mpc_realref (z), x1, x1, y1, y1, MPFR_RNDN);
+      return 16;
+   }
+
+   mpfr_init2 (t, p);
+   mpfr_add (mpc_realref (z), x1, y1, MPFR_RNDN);
+   mpfr_sub (t, x1, y1, MPFR_RNDN);
+   mpfr_mul (mpc_realref (z), mpc_realref (z), t, MPFR_RNDN);
+   mpfr_clear (t);
+
+   return 49;
+}
+
+
+static unsigned int
+div_centre (mpc_ptr z, mpc_srcptr z1, mpc_srcptr z2)
+   /* Compute z = z1 / z2 with z not overlapping z1 or z2, as
+      z1 * conj (z2) / n with n = x2^2 + y2^2, where the numerator and n
+      are computed with mul_centre and mpfr_fmma at precision q = p+4.
+      Both are correctly rounded, so their relative errors are bounded
+      by 2^(-q), and the final divisions add 2^(-p); so the error is
+      bounded by (1 + 2^(-p)) * (1 + 2^(-q)) / (1 - 2^(-q)) - 1
+      < 1.25 * 2^(-p) with respect to the computed value for p >= 2. */
+{
+   const mpfr_prec_t q = mpfr_get_prec (mpc_realref (z)) + CENTRE_ERR_BITS;
+   mpc_t c, u;
+   mpfr_t n;
+
+   mpfr_init2 (n, q);
+   mpc_init2 (u, q);
+   mpfr_fmma (n, mpc_realref (z2), mpc_realref (z2),
+      mpc_imagref (z2), mpc_imagref (z2), MPFR_RNDN);
+   /* shallow copy of conj (z2) */
+   c [0] = z2 [0];
+   mpfr_neg (mpc_imagref (c), mpc_imagref (c), MPFR_RNDN);
+   mul_centre (u, z1, c);
+   mpfr_div (mpc_realref (z), mpc_realref (u), n, MPFR_RNDN);
+   mpfr_div (mpc_imagref (z), mpc_imagref (u), n, MPFR_RNDN);
+   mpfr_clear (n);
+   mpc_clear (u);
+
+   return 20;
+}
+
+
+static void
+add_centre_error (mpcr_ptr r, unsigned int k, mpfr_prec_t p)
+   /* Replace r, radius of a complex ball, by the new radius obtained
+      after replacing its centre by an approximation with relative error
+      at most k * 2^(-p-4), that is, r += k * 2^(-p-4) * (1 + r).
+      For k = 16, this is mpcr_add_rounding_error with rounding to
+      nearest. */
+{
+   mpcr_t s, t;
+
+   mpcr_set_one (s);
+   mpcr_add (s, s, r);
+   mpcr_set_ui64_2si64 (t, (uint64_t) k, (int64_t) (-p - CENTRE_ERR_BITS));
+   mpcr_mul (s, s, t);
+   mpcr_add (r, r, s);
+}
+
+
 void
 mpcb_mul (mpcb_ptr z, mpcb_srcptr z1, mpcb_srcptr z2)
 {
    mpcr_t r;
    mpfr_prec_t p = MPC_MIN (mpcb_get_prec (z1), mpcb_get_prec (z2));
    int overlap = (z == z1 || z == z2);
+   unsigned int k;
    mpc_t zc;
 
    if (overlap)
@@ -167,7 +332,7 @@ mpcb_mul (mpcb_ptr z, mpcb_srcptr z1, mpcb_srcptr z2)
       zc [0] = z->c [0];
       mpc_set_prec (zc, p);
    }
-   mpc_mul (zc, z1->c, z2->c, MPC_RNDNN);
+   k = mul_centre (zc, z1->c, z2->c);
    if (overlap)
       mpc_clear (z->c);
    z->c [0] = zc [0];
@@ -176,8 +341,8 @@ mpcb_mul (mpcb_ptr z, mpcb_srcptr z1, mpcb_srcptr z2)
    mpcr_mul (r, z1->r, z2->r);
    mpcr_add (r, r, z1->r);
    mpcr_add (r, r, z2->r);
-   /* error of rounding to nearest */
-   mpcr_add_rounding_error (r, p, MPFR_RNDN);
+   /* error of the centre */
+   add_centre_error (r, k, p);
    mpcr_set (z->r, r);
 }
 
@@ -188,16 +353,26 @@ mpcb_sqr (mpcb_ptr z, mpcb_srcptr z1)
    mpcr_t r, r2;
    mpfr_prec_t p = mpcb_get_prec (z1);
    int overlap = (z == z1);
+   unsigned int k;
+   mpc_t zc;
 
-   /* Compute the error first in case there is overlap. */
+   if (overlap)
+      mpc_init2 (zc, p);
+   else {
+      zc [0] = z->c [0];
+      mpc_set_prec (zc, p);
+   }
+   k = sqr_centre (zc, z1->c);
+   if (overlap)
+      mpc_clear (z->c);
+   z->c [0] = zc [0];
+
+   /* generic error of squaring */
    mpcr_mul_2ui (r2, z1->r, 1);
    mpcr_sqr (r, z1->r);
    mpcr_add (r, r, r2);
-   mpcr_add_rounding_error (r, p, MPFR_RNDN);
-
-   if (!overlap)
-      mpcb_set_prec (z, p);
-   mpc_sqr (z->c, z1->c, MPC_RNDNN);
+   /* error of the centre */
+   add_centre_error (r, k, p);
    mpcr_set (z->r, r);
 }
 
@@ -272,6 +447,148 @@ mpcb_add (mpcb_ptr z, mpcb_srcptr z1, mpcb_srcptr z2)
 }
 
 
+void
+mpcb_sub (mpcb_ptr z, mpcb_srcptr z1, mpcb_srcptr z2)
+{
+   mpcb_t t;
+
+   mpcb_init (t);
+   mpcb_neg (t, z2);
+   mpcb_add (z, z1, t);
+   mpcb_clear (t);
+}
+
+
+static int
+fma_centre (mpc_ptr z, mpc_srcptr z1, mpc_srcptr z2, mpc_srcptr z3,
+   int neg)
+   /* Compute z = z3 + z1 * z2 if neg is 0 and z = z3 - z1 * z2 otherwise,
+      with z not overlapping z1, z2 or z3, and return the rounding
+      direction value. As in mpc_fma_naive, the products of the parts are
+      computed exactly and each part of the result is obtained by one
+      call to mpfr_sum, so that it is correctly rounded to nearest. */
+{
+   mpfr_srcptr x1, y1, x2, y2;
+   mpfr_t x1x2, y1y2, x1y2, y1x2;
+   mpfr_ptr sum [3];
+   int inex_re, inex_im;
+
+   x1 = mpc_realref (z1);
+   y1 = mpc_imagref (z1);
+   x2 = mpc_realref (z2);
+   y2 = mpc_imagref (z2);
+   mpfr_init2 (x1x2, mpfr_get_prec (x1) + mpfr_get_prec (x2));
+   mpfr_init2 (y1y2, mpfr_get_prec (y1) + mpfr_get_prec (y2));
+   mpfr_init2 (x1y2, mpfr_get_prec (x1) + mpfr_get_prec (y2));
+   mpfr_init2 (y1x2, mpfr_get_prec (y1) + mpfr_get_prec (x2));
+   mpfr_mul (x1x2, x1, x2, MPFR_RNDN); /* exact */
+   mpfr_mul (y1y2, y1, y2, MPFR_RNDN); /* exact */
+   mpfr_mul (x1y2, x1, y2, MPFR_RNDN); /* exact */
+   mpfr_mul (y1x2, y1, x2, MPFR_RNDN); /* exact */
+   if (neg) {
+      mpfr_neg (x1x2, x1x2, MPFR_RNDN);
+      mpfr_neg (x1y2, x1y2, MPFR_RNDN);
+      mpfr_neg (y1x2, y1x2, MPFR_RNDN);
+   }
+   else
+      mpfr_neg (y1y2, y1y2, MPFR_RNDN);
+
+   sum [0] = x1x2;
+   sum [1] = y1y2;
+   sum [2] = (mpfr_ptr) mpc_realref (z3);
+   inex_re = mpfr_sum (mpc_realref (z), sum, 3, MPFR_RNDN);
+   sum [0] = x1y2;
+   sum [1] = y1x2;
+   sum [2] = (mpfr_ptr) mpc_imagref (z3);
+   inex_im = mpfr_sum (mpc_imagref (z), sum, 3, MPFR_RNDN);
+
+   mpfr_clear (x1x2);
+   mpfr_clear (y1y2);
+   mpfr_clear (x1y2);
+   mpfr_clear (y1x2);
+
+   return MPC_INEX (inex_re, inex_im);
+}
+
+
+static void
+mpcb_fma_sign (mpcb_ptr z, mpcb_srcptr z1, mpcb_srcptr z2, mpcb_srcptr z3,
+   int neg)
+   /* Set z to z3 + z1 * z2 if neg is 0 and to z3 - z1 * z2 otherwise.
+      The centre is rounded only once, and the radius is obtained from the
+      generic error of the product and the generic error of the addition
+      in one step:
+      r <= (|z1*z2|*(r1+r2+r1*r2) + |z3|*r3) / |z| + 2^(-p),
+      where the last term is the error of rounding the centre to nearest,
+      relative to the computed centre z; it vanishes if the centre is
+      exact. */
+{
+   mpcr_t r, s;
+   mpfr_prec_t p = MPC_MIN (MPC_MIN (mpcb_get_prec (z1), mpcb_get_prec (z2)),
+                            mpcb_get_prec (z3));
+   int overlap = (z == z1 || z == z2 || z == z3);
+   int inex;
+   mpc_t zc;
+
+   if (overlap)
+      mpc_init2 (zc, p);
+   else {
+      zc [0] = z->c [0];
+      mpc_set_prec (zc, p);
+   }
+   inex = fma_centre (zc, z1->c, z2->c, z3->c, neg);
+
+   /* generic error of multiplication, in absolute terms */
+   mpcr_mul (r, z1->r, z2->r);
+   mpcr_add (r, r, z1->r);
+   mpcr_add (r, r, z2->r);
+   mpcr_c_abs_rnd (s, z1->c, MPFR_RNDU);
+   mpcr_mul (r, r, s);
+   mpcr_c_abs_rnd (s, z2->c, MPFR_RNDU);
+   mpcr_mul (r, r, s);
+   /* generic error of addition */
+   mpcr_c_abs_rnd (s, z3->c, MPFR_RNDU);
+   mpcr_mul (s, s, z3->r);
+   mpcr_add (r, r, s);
+   if (!mpcr_zero_p (r)) {
+      mpcr_c_abs_rnd (s, zc, MPFR_RNDD);
+      mpcr_div (r, r, s);
+   }
+   /* error of the centre */
+   if (inex != 0) {
+      mpcr_set_one (s);
+      mpcr_div_2ui (s, s, (unsigned long int) p);
+      mpcr_add (r, r, s);
+   }
+
+   if (overlap)
+      mpc_clear (z->c);
+   z->c [0] = zc [0];
+   mpcr_set (z->r, r);
+}
+
+
+void
+mpcb_fma (mpcb_ptr z, mpcb_srcptr z1, mpcb_srcptr z2, mpcb_srcptr z3)
+{
+   mpcb_fma_sign (z, z1, z2, z3, 0);
+}
+
+
+void
+mpcb_addmul (mpcb_ptr z, mpcb_srcptr z1, mpcb_srcptr z2)
+{
+   mpcb_fma_sign (z, z1, z2, z, 0);
+}
+
+
+void
+mpcb_submul (mpcb_ptr z, mpcb_srcptr z1, mpcb_srcptr z2)
+{
+   mpcb_fma_sign (z, z1, z2, z, 1);
+}
+
+
 void
 mpcb_sqrt (mpcb_ptr z, mpcb_srcptr z1)
    /* The function "glides over" the branch cut on the negative real axis:
@@ -319,6 +636,7 @@ mpcb_div (mpcb_ptr z, mpcb_srcptr z1, mpcb_srcptr z2)
    mpcr_t r, s;
    mpfr_prec_t p = MPC_MIN (mpcb_get_prec (z1), mpcb_get_prec (z2));
    int overlap = (z == z1 || z == z2);
+   unsigned int k;
    mpc_t zc;
 
    if (overlap)
@@ -327,7 +645,7 @@ mpcb_div (mpcb_ptr z, mpcb_srcptr z1, mpcb_srcptr z2)
       zc [0] = z->c [0];
       mpc_set_prec (zc, p);
    }
-   mpc_div (zc, z1->c, z2->c, MPC_RNDNN);
+   k = div_centre (zc, z1->c, z2->c);
    if (overlap)
       mpc_clear (z->c);
    z->c [0] = zc [0];
@@ -337,8 +655,8 @@ mpcb_div (mpcb_ptr z, mpcb_srcptr z1, mpcb_srcptr z2)
    mpcr_set_one (s);
    mpcr_sub_rnd (s, s, z2->r, MPFR_RNDD);
    mpcr_div (r, r, s);
-   /* error of rounding to nearest */
-   mpcr_add_rounding_error (r, p, MPFR_RNDN);
+   /* error of the centre */
+   add_centre_error (r, k, p);
    mpcr_set (z->r, r);
 }
 
@@ -346,11 +664,357 @@ mpcb_div (mpcb_ptr z, mpcb_srcptr z1, mpcb_srcptr z2)
 void
 mpcb_div_2ui (mpcb_ptr z, mpcb_srcptr z1, unsigned long int e)
 {
-   mpc_div_2ui (z->c, z1->c, e, MPC_RNDNN);
+   mpfr_prec_t p;
+
+   if (z != z1) {
+      p = mpcb_get_prec (z1);
+      if (mpcb_get_prec (z) != p)
+         mpcb_set_prec (z, p);
+   }
+
+   mpc_div_2ui (z->c, z1->c, e, MPC_RNDNN); /* exact */
    mpcr_set (z->r, z1->r);
 }
 
 
+void
+mpcb_exp (mpcb_ptr z, mpcb_srcptr z1)
+   /* Writing an element of z1 as c*(1+theta) with |theta| <= r, we have
+      exp (c*(1+theta)) = exp (c) * (1 + eta) with
+      |eta| = |exp (c*theta) - 1| <= t / (1-t) for t = |c|*r < 1;
+      we require t < 1/2. If the centre overflows or underflows, the
+      radius is set to infinity. */
+{
+   mpcr_t r, s;
+   mpfr_prec_t p = mpcb_get_prec (z1);
+   int overlap = (z == z1), zero_im;
+
+   /* Compute the error first in case there is overlap. */
+   mpcr_c_abs_rnd (r, z1->c, MPFR_RNDU);
+   mpcr_mul (r, r, z1->r);
+   if (!mpcr_lt_half_p (r))
+      mpcr_set_inf (r);
+   else {
+      mpcr_set_one (s);
+      mpcr_sub_rnd (s, s, r, MPFR_RNDD);
+      mpcr_div (r, r, s);
+      /* error of rounding to nearest */
+      mpcr_add_rounding_error (r, p, MPFR_RNDN);
+   }
+   zero_im = mpfr_zero_p (mpc_imagref (z1->c));
+
+   if (!overlap)
+      mpcb_set_prec (z, p);
+   mpc_exp (z->c, z1->c, MPC_RNDNN);
+   if (!mpc_fin_p (z->c) || mpfr_zero_p (mpc_realref (z->c))
+       || (mpfr_zero_p (mpc_imagref (z->c)) && !zero_im))
+      mpcr_set_inf (r);
+   mpcr_set (z->r, r);
+}
+
+
+void
+mpcb_log (mpcb_ptr z, mpcb_srcptr z1)
+   /* Writing an element of z1 as c*(1+theta) with |theta| <= r < 1/2,
+      log (c*(1+theta)) = log (c) + log (1+theta) up to a multiple of
+      2*pi*i, and |log (1+theta)| <= r / (1-r). This absolute error is
+      turned into a relative one by dividing by a lower bound on
+      |log (c)|. As mpcb_sqrt, the function "glides over" the branch cut,
+      that is, it returns a ball around the principal value of log (c)
+      which contains a logarithm, but not necessarily the principal one,
+      of every element of z1. */
+{
+   mpcr_t r, s;
+   mpfr_prec_t p = mpcb_get_prec (z1);
+   int overlap = (z == z1);
+
+   /* Compute the absolute error first in case there is overlap. */
+   if (!mpcr_lt_half_p (z1->r))
+      mpcr_set_inf (r);
+   else {
+      mpcr_set_one (s);
+      mpcr_sub_rnd (s, s, z1->r, MPFR_RNDD);
+      mpcr_div (r, z1->r, s);
+   }
+
+   if (!overlap)
+      mpcb_set_prec (z, p);
+   mpc_log (z->c, z1->c, MPC_RNDNN);
+
+   if (!mpcr_inf_p (r) && !mpcr_zero_p (r)) {
+      mpcr_c_abs_rnd (s, z->c, MPFR_RNDD);
+      mpcr_div (r, r, s);
+   }
+   if (!mpc_fin_p (z->c))
+      mpcr_set_inf (r);
+   else if (!mpcr_inf_p (r))
+      /* error of rounding to nearest; if the centre is 1, then its
+         logarithm 0 is exact */
+      if (!mpc_zero_p (z->c) || !mpcr_zero_p (r))
+         mpcr_add_rounding_error (r, p, MPFR_RNDN);
+   mpcr_set (z->r, r);
+}
+
+
+static void
+abs_bounds (mpcr_ptr lo, mpcr_ptr hi, mpc_srcptr c, mpfr_prec_t p)
+   /* Given the centre c of a ball obtained by rounding a complex number
+      w to nearest at precision p, so that |w - c| <= 2^(-p) * |c|,
+      compute a lower bound lo and an upper bound hi on |w|. Either of
+      them may be NULL if it is not needed. */
+{
+   mpcr_t e;
+
+   if (lo != NULL) {
+      mpcr_c_abs_rnd (lo, c, MPFR_RNDD);
+      mpcr_div_2ui (e, lo, (unsigned long int) p);
+      mpcr_sub_rnd (lo, lo, e, MPFR_RNDD);
+   }
+   if (hi != NULL) {
+      mpcr_c_abs_rnd (hi, c, MPFR_RNDU);
+      mpcr_div_2ui (e, hi, (unsigned long int) p);
+      mpcr_add (hi, hi, e);
+   }
+}
+
+
+static void
+round_centre_error (mpcr_ptr r, mpc_srcptr c, int inex, mpfr_prec_t p)
+   /* Add to r the error of the centre c computed with rounding to nearest
+      at precision p and rounding direction value inex. A part that has
+      been rounded to 0 carries no relative error bound, so then r is set
+      to infinity, as it is if c is not finite. */
+{
+   if (!mpc_fin_p (c)
+       || (mpfr_zero_p (mpc_realref (c)) && MPC_INEX_RE (inex) != 0)
+       || (mpfr_zero_p (mpc_imagref (c)) && MPC_INEX_IM (inex) != 0))
+      mpcr_set_inf (r);
+   else if (inex != 0)
+      mpcr_add_rounding_error (r, p, MPFR_RNDN);
+}
+
+
+void
+mpcb_sin_cos (mpcb_ptr s, mpcb_ptr c, mpcb_srcptr z1)
+   /* Set s to the sine and c to the cosine of z1, where s and c must be
+      different variables.
+      Writing an element of z1 as w + delta with w the centre and
+      |delta| <= t = |w|*r, we have
+      sin (w + delta) = sin (w) * (1 + (cos (delta) - 1)
+                                     + cot (w) * sin (delta)),
+      where |cos (delta) - 1| <= cosh (t) - 1 <= t^2 / (1-t) and
+      |sin (delta)| <= sinh (t) <= t / (1-t). So the relative error of
+      the sine is at most t / (1-t) * (t + |cot (w)|), and similarly that
+      of the cosine is at most t / (1-t) * (t + |tan (w)|);
+      we require t < 1/2. The absolute values of sin (w) and cos (w) are
+      bounded using the rounded values. */
+{
+   mpcr_t t, u, r_sin, r_cos, lo_sin, hi_sin, lo_cos, hi_cos;
+   mpfr_prec_t p = mpcb_get_prec (z1);
+   mpc_t sc, cc;
+   int inex;
+
+   MPC_ASSERT (s != c);
+
+   mpcr_c_abs_rnd (t, z1->c, MPFR_RNDU);
+   mpcr_mul (t, t, z1->r);
+   mpc_init2 (sc, p);
+   mpc_init2 (cc, p);
+   inex = mpc_sin_cos (sc, cc, z1->c, MPC_RNDNN, MPC_RNDNN);
+
+   if (mpcr_zero_p (t)) {
+      mpcr_set_zero (r_sin);
+      mpcr_set_zero (r_cos);
+   }
+   else if (!mpcr_lt_half_p (t)) {
+      mpcr_set_inf (r_sin);
+      mpcr_set_inf (r_cos);
+   }
+   else {
+      mpcr_set_one (u);
+      mpcr_sub_rnd (u, u, t, MPFR_RNDD);
+      mpcr_div (u, t, u);
+      abs_bounds (lo_sin, hi_sin, sc, p);
+      abs_bounds (lo_cos, hi_cos, cc, p);
+      mpcr_div (r_sin, hi_cos, lo_sin);
+      mpcr_add (r_sin, r_sin, t);
+      mpcr_mul (r_sin, r_sin, u);
+      mpcr_div (r_cos, hi_sin, lo_cos);
+      mpcr_add (r_cos, r_cos, t);
+      mpcr_mul (r_cos, r_cos, u);
+   }
+   round_centre_error (r_sin, sc, MPC_INEX1 (inex), p);
+   round_centre_error (r_cos, cc, MPC_INEX2 (inex), p);
+
+   mpc_swap (s->c, sc);
+   mpc_swap (c->c, cc);
+   mpcr_set (s->r, r_sin);
+   mpcr_set (c->r, r_cos);
+   mpc_clear (sc);
+   mpc_clear (cc);
+}
+
+
+void
+mpcb_atan (mpcb_ptr z, mpcb_srcptr z1)
+   /* Writing an element of z1 as w + delta with w the centre and
+      |delta| <= t = |w|*r, the absolute error
+      |atan (w + delta) - atan (w)| = |int_0^1 delta / (1 + (w+s*delta)^2) ds|
+      is bounded by t / ((|w-i| - t) * (|w+i| - t)), provided that the
+      segment from w to w + delta does not come close to the poles +-i.
+      This is turned into a relative error by dividing by a lower bound
+      on |atan (w)|. As mpcb_log, the function "glides over" the branch
+      cuts on the imaginary axis, so that the result contains a value of
+      the arc tangent of every element of z1, but not necessarily its
+      principal value. */
+{
+   mpcr_t t, r, s;
+   mpfr_prec_t p = mpcb_get_prec (z1);
+   mpc_t ac, w;
+   int inex;
+
+   mpcr_c_abs_rnd (t, z1->c, MPFR_RNDU);
+   mpcr_mul (t, t, z1->r);
+   mpc_init2 (ac, p);
+   inex = mpc_atan (ac, z1->c, MPC_RNDNN);
+
+   if (mpcr_zero_p (t))
+      mpcr_set_zero (r);
+   else if (mpcr_inf_p (t))
+      mpcr_set_inf (r);
+   else {
+      /* lower bounds on |w-i| - t and |w+i| - t; rounding the imaginary
+         part towards 0 makes the absolute values smaller */
+      mpc_init3 (w, mpfr_get_prec (mpc_realref (z1->c)),
+         mpfr_get_prec (mpc_imagref (z1->c)));
+      mpfr_set (mpc_realref (w), mpc_realref (z1->c), MPFR_RNDN);
+      mpfr_sub_ui (mpc_imagref (w), mpc_imagref (z1->c), 1, MPFR_RNDZ);
+      mpcr_c_abs_rnd (r, w, MPFR_RNDD);
+      mpcr_sub_rnd (r, r, t, MPFR_RNDD);
+      mpfr_add_ui (mpc_imagref (w), mpc_imagref (z1->c), 1, MPFR_RNDZ);
+      mpcr_c_abs_rnd (s, w, MPFR_RNDD);
+      mpcr_sub_rnd (s, s, t, MPFR_RNDD);
+      mpc_clear (w);
+      if (mpcr_inf_p (r) || mpcr_inf_p (s))
+         /* The segment may contain a pole. */
+         mpcr_set_inf (r);
+      else {
+         mpcr_mul (r, r, s);
+         mpcr_div (r, t, r);
+         abs_bounds (s, NULL, ac, p);
+         mpcr_div (r, r, s);
+      }
+   }
+   round_centre_error (r, ac, inex, p);
+
+   mpc_swap (z->c, ac);
+   mpcr_set (z->r, r);
+   mpc_clear (ac);
+}
+
+
+void
+mpcb_agm (mpcb_ptr z, mpcb_srcptr z1, mpcb_srcptr z2)
+   /* Compute the arithmetic-geometric mean of z1 and z2 as explained in
+      algorithms.tex: After normalising to 1 and b = z2/z1 (or z1/z2,
+      whichever is smaller), the iteration a' = (a+b)/2, b' = sqrt (a*b)
+      is carried out in ball arithmetic until the centres become equal
+      or stationary, and the radius of the limit is bounded using the
+      difference of the last a and b.
+      Since mpcb_sqrt glides over its branch cut, the square roots follow
+      the centres; this yields the "right" choice in the sense of mpc_agm
+      for all elements of the balls as long as the result is not
+      infinite. If one of the centres is 0, then the result is 0. */
+{
+   mpfr_prec_t p = MPC_MIN (mpcb_get_prec (z1), mpcb_get_prec (z2));
+   mpcb_t an, bn, anp1, bnp1, res;
+   mpc_t diff;
+   mpfr_exp_t exp_an, exp_diff;
+   mpcr_t rab;
+   int cmp, equal, re_zero, im_zero;
+   mpfr_prec_t n;
+
+   if (mpc_zero_p (z1->c) || mpc_zero_p (z2->c)) {
+      mpc_set_prec (z->c, p);
+      mpc_set_ui_ui (z->c, 0, 0, MPC_RNDNN);
+      mpcr_set_zero (z->r);
+      return;
+   }
+
+   mpcb_init (an);
+   mpcb_init (bn);
+   mpcb_init (anp1);
+   mpcb_init (bnp1);
+   mpcb_init (res);
+
+   cmp = mpc_cmp_abs (z1->c, z2->c);
+   mpcb_set_ui_ui (an, 1, 0, p);
+   if (cmp >= 0)
+      mpcb_div (bn, z2, z1);
+   else
+      mpcb_div (bn, z1, z2);
+
+   /* Iterate until there is a fixed point or (often one iteration
+      earlier) the arithmetic and the geometric mean coincide. The
+      number of iterations is logarithmic in p and in the logarithm of
+      |z2/z1| unless the centres cycle, in which case we give up. */
+   n = 0;
+   do {
+      mpcb_add (anp1, an, bn);
+      mpcb_div_2ui (anp1, anp1, 1);
+      mpcb_mul (bnp1, an, bn);
+      mpcb_sqrt (bnp1, bnp1);
+      equal = mpc_cmp (anp1->c, bnp1->c) == 0
+              || (   mpc_cmp (an->c, anp1->c) == 0
+                  && mpc_cmp (bn->c, bnp1->c) == 0);
+      mpcb_set (an, anp1);
+      mpcb_set (bn, bnp1);
+      n++;
+   } while (!equal && !mpc_zero_p (an->c) && !mpc_zero_p (bn->c)
+            && n <= p + 64);
+
+   if (!equal || mpcr_inf_p (an->r) || mpcr_inf_p (bn->r))
+      mpcb_set_inf (res);
+   else {
+      mpcb_set (res, an);
+      mpc_init2 (diff, p);
+      mpc_sub (diff, an->c, bn->c, MPC_RNDAA);
+      re_zero = mpfr_zero_p (mpc_realref (diff));
+      im_zero = mpfr_zero_p (mpc_imagref (diff));
+      if (re_zero && im_zero)
+         mpcr_set_zero (rab);
+      else {
+         exp_an = MPC_MIN (mpfr_get_exp (mpc_realref (an->c)),
+                           mpfr_get_exp (mpc_imagref (an->c))) - 1;
+         if (re_zero)
+            exp_diff = mpfr_get_exp (mpc_imagref (diff)) + 1;
+         else if (im_zero)
+            exp_diff = mpfr_get_exp (mpc_realref (diff)) + 1;
+         else
+            exp_diff = MPC_MAX (mpfr_get_exp (mpc_realref (diff)),
+                                mpfr_get_exp (mpc_imagref (diff)) + 1);
+         mpcr_set_ui64_2si64 (rab, 1, (int64_t) (exp_diff - exp_an));
+      }
+      mpc_clear (diff);
+      /* r = 2 * (rab + an->r) + bn->r */
+      mpcr_add (rab, rab, an->r);
+      mpcr_mul_2ui (rab, rab, 1);
+      mpcr_add (res->r, rab, bn->r);
+      if (cmp >= 0)
+         mpcb_mul (res, res, z1);
+      else
+         mpcb_mul (res, res, z2);
+   }
+   mpcb_set (z, res);
+
+   mpcb_clear (an);
+   mpcb_clear (bn);
+   mpcb_clear (anp1);
+   mpcb_clear (bnp1);
+   mpcb_clear (res);
+}
+
+
 int
 mpcb_can_round (mpcb_srcptr op, mpfr_prec_t prec_re, mpfr_prec_t prec_im,
    mpc_rnd_t rnd)
@@ -0,0 +1,182 @@
+/* mpc_batch_run -- distribute a batch of evaluations over threads.
+
+Copyright (C) 2025 INRIA
+
+This file is part of GNU MPC.
+
+GNU MPC is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the
+Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+GNU MPC is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for
+more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program. If not, see http://www.gnu.org/licenses/ .
+*/
+
+#include <stdio.h> /* for MPC_ASSERT */
+#include "mpc-impl.h"
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+#endif
+#ifdef HAVE_UNISTD_H
+#include <unistd.h> /* for sysconf */
+#endif
+
+/* The elements of a batch are handed out one by one to the threads,
+   since their cost may vary. */
+struct mpc_batch_struct {
+   unsigned long int n;
+   unsigned long int next;
+   mpc_batch_work_t work;
+   void *data;
+#ifdef HAVE_PTHREAD
+   pthread_mutex_t lock;
+   int threaded;
+   mpfr_exp_t emin, emax;
+   mpfr_flags_t flags;
+   int adaptive;
+#endif
+};
+
+
+int
+mpc_batch_next (unsigned long int *i, mpc_batch_ptr batch)
+   /* If there are elements of the batch that are not yet taken by
+      another thread, set i to the index of the next one and return 1;
+      otherwise return 0. */
+{
+   int res;
+
+#ifdef HAVE_PTHREAD
+   if (batch->threaded)
+      pthread_mutex_lock (&batch->lock);
+#endif
+   res = (batch->next < batch->n);
+   if (res)
+      *i = batch->next++;
+#ifdef HAVE_PTHREAD
+   if (batch->threaded)
+      pthread_mutex_unlock (&batch->lock);
+#endif
+
+   return res;
+}
+
+
+#ifdef HAVE_PTHREAD
+static void *
+batch_thread (void *data)
+   /* Start function of the additional threads. The exponent range of
+      MPFR and the adaptive mode of the Ziv loops are thread local and
+      are set to the ones of the calling thread; the flags raised by the
+      thread are collected for the calling thread, and the MPFR caches
+      the thread has filled are freed. */
+{
+   mpc_batch_ptr batch = (mpc_batch_ptr) data;
+
+   mpfr_set_emin (batch->emin);
+   mpfr_set_emax (batch->emax);
+   if (mpc_get_ziv_adaptive () != batch->adaptive)
+      /* without thread local storage, the mode is shared already */
+      mpc_set_ziv_adaptive (batch->adaptive);
+   mpfr_clear_flags ();
+   batch->work (batch, batch->data);
+   pthread_mutex_lock (&batch->lock);
+   batch->flags |= mpfr_flags_save ();
+   pthread_mutex_unlock (&batch->lock);
+   mpfr_free_cache ();
+
+   return NULL;
+}
+
+
+static unsigned long int
+batch_threads (unsigned long int n)
+   /* Return the number of threads to be used for a batch of n elements:
+      the value of the environment variable MPC_NUM_THREADS if it is set,
+      and otherwise the number of available processors, but not more
+      than n. Only one thread is used when the MPFR caches are shared
+      between threads. */
+{
+   const char *env;
+   long int t;
+
+   if (!mpfr_buildopt_tls_p ())
+      return 1;
+
+   env = getenv ("MPC_NUM_THREADS");
+   if (env != NULL)
+      t = strtol (env, NULL, 10);
+   else
+#if defined (HAVE_SYSCONF) && defined (_SC_NPROCESSORS_ONLN)
+      t = sysconf (_SC_NPROCESSORS_ONLN);
+#else
+      t = 1;
+#endif
+
+   if (t < 1)
+      return 1;
+   else
+      return MPC_MIN ((unsigned long int) t, n);
+}
+#endif
+
+
+void
+mpc_batch_run (unsigned long int n, mpc_batch_work_t work, void *data)
+   /* Run work (batch, data) in several threads if possible, and in the
+      current one, such that the calls together treat the n elements
+      with indices obtained through mpc_batch_next (batch). Each call may
+      set up state such as caches that it shares between the elements
+      it treats. The additional threads run in the exponent range and the
+      adaptive mode of the current thread, and the MPFR flags they raise are set in the
+      current thread on return. They are created anew for each batch and
+      joined before the function returns; no thread pool is kept between
+      calls. */
+{
+   struct mpc_batch_struct batch;
+#ifdef HAVE_PTHREAD
+   pthread_t *thread;
+   unsigned long int t, i, started;
+#endif
+
+   batch.n = n;
+   batch.next = 0;
+   batch.work = work;
+   batch.data = data;
+
+#ifdef HAVE_PTHREAD
+   t = batch_threads (n);
+   batch.threaded = (t > 1);
+   if (batch.threaded) {
+      thread = (pthread_t *) malloc ((t - 1) * sizeof (pthread_t));
+      MPC_ASSERT (thread != NULL);
+      pthread_mutex_init (&batch.lock, NULL);
+      batch.emin = mpfr_get_emin ();
+      batch.emax = mpfr_get_emax ();
+      batch.flags = 0;
+      batch.adaptive = mpc_get_ziv_adaptive ();
+      /* The current thread is the t-th one; if a thread cannot be
+         created, the work is done by the others. */
+      started = 0;
+      for (i = 0; i < t - 1; i++)
+         if (pthread_create (&thread [started], NULL, batch_thread,
+                             &batch) == 0)
+            started++;
+      work (&batch, data);
+      for (i = 0; i < started; i++)
+         pthread_join (thread [i], NULL);
+      mpfr_flags_set (batch.flags);
+      pthread_mutex_destroy (&batch.lock);
+      free (thread);
+      return;
+   }
+#endif
+
+   work (&batch, data);
+}
@@ -0,0 +1,111 @@
+/* mpc_bernoulli_b2k -- cached Bernoulli numbers.
+
+Copyright (C) 2025 INRIA
+
+This file is part of GNU MPC.
+
+GNU MPC is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the
+Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+GNU MPC is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for
+more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program. If not, see http://www.gnu.org/licenses/ .
+*/
+
+#include <stdio.h> /* for MPC_ASSERT */
+#include "mpc-impl.h"
+
+/* The Bernoulli numbers B_0, B_2, ..., B_{2(n-1)} as exact rationals;
+   the cache is local to each thread when the compiler supports it. */
+static MPC_THREAD_LOCAL mpq_t *bernoulli_cache = NULL;
+static MPC_THREAD_LOCAL unsigned long int bernoulli_size = 0;
+
+static void
+bernoulli_fill (mpq_t *b, unsigned long int n)
+   /* Set b [k] to B_{2k} for 0 <= k < n, where the b [k] are initialised,
+      using the tangent numbers T_k as in Algorithm TangentNumbers of
+      Brent and Harvey, "Fast computation of Bernoulli, Tangent and Secant
+      numbers", 2011: T_1, ..., T_m are obtained in place with O(m^2)
+      multiplications of integers by small integers, and then
+      B_{2k} = (-1)^(k-1) 2k T_k / (2^(2k) (2^(2k)-1)). */
+{
+   mpz_t *t;
+   unsigned long int m = n - 1, j, k;
+
+   mpq_set_ui (b [0], 1, 1);
+   if (m == 0)
+      return;
+
+   t = (mpz_t *) malloc (m * sizeof (mpz_t));
+   MPC_ASSERT (t != NULL);
+   /* t [k-1] holds T_k. */
+   mpz_init_set_ui (t [0], 1);
+   for (k = 2; k <= m; k++) {
+      mpz_init (t [k-1]);
+      mpz_mul_ui (t [k-1], t [k-2], k - 1);
+   }
+   for (k = 2; k <= m; k++)
+      for (j = k; j <= m; j++) {
+         mpz_mul_ui (t [j-1], t [j-1], j - k + 2);
+         mpz_addmul_ui (t [j-1], t [j-2], j - k);
+      }
+
+   for (k = 1; k <= m; k++) {
+      mpz_mul_ui (mpq_numref (b [k]), t [k-1], 2 * k);
+      if (k % 2 == 0)
+         mpz_neg (mpq_numref (b [k]), mpq_numref (b [k]));
+      mpz_set_ui (mpq_denref (b [k]), 1);
+      mpz_mul_2exp (mpq_denref (b [k]), mpq_denref (b [k]), 2 * k);
+      mpz_sub_ui (mpq_denref (b [k]), mpq_denref (b [k]), 1);
+      mpz_mul_2exp (mpq_denref (b [k]), mpq_denref (b [k]), 2 * k);
+      mpq_canonicalize (b [k]);
+      mpz_clear (t [k-1]);
+   }
+   free (t);
+}
+
+
+mpq_srcptr
+mpc_bernoulli_b2k (unsigned long int k)
+   /* Return a pointer to the exact value of B_{2k}; the pointer remains
+      valid until the next call with a larger value of k or to
+      mpc_free_cache. The cache grows geometrically, so that the total
+      cost of the recomputations is dominated by that of the last one. */
+{
+   unsigned long int n, i;
+
+   if (k >= bernoulli_size) {
+      n = MPC_MAX (k + 1, bernoulli_size + bernoulli_size / 2);
+      n = MPC_MAX (n, 32);
+      for (i = 0; i < bernoulli_size; i++)
+         mpq_clear (bernoulli_cache [i]);
+      free (bernoulli_cache);
+      bernoulli_cache = (mpq_t *) malloc (n * sizeof (mpq_t));
+      MPC_ASSERT (bernoulli_cache != NULL);
+      for (i = 0; i < n; i++)
+         mpq_init (bernoulli_cache [i]);
+      bernoulli_fill (bernoulli_cache, n);
+      bernoulli_size = n;
+   }
+
+   return bernoulli_cache [k];
+}
+
+
+void
+mpc_bernoulli_free_cache (void)
+{
+   unsigned long int i;
+
+   for (i = 0; i < bernoulli_size; i++)
+      mpq_clear (bernoulli_cache [i]);
+   free (bernoulli_cache);
+   bernoulli_cache = NULL;
+   bernoulli_size = 0;
+}
@@ -1,6 +1,6 @@
 /* mpc_cos -- cosine of a complex number.
 
-Copyright (C) 2010, 2011 INRIA
+Copyright (C) 2010, 2011, 2025 INRIA
 
 This file is part of GNU MPC.
 
@@ -23,5 +23,6 @@ along with this program. If not, see http://www.gnu.org/licenses/ .
 int
 mpc_cos (mpc_ptr rop, mpc_srcptr op, mpc_rnd_t rnd)
 {
+  MPC_STATS_FUNC (cos, MPC_MAX_PREC (rop))
   return MPC_INEX2 (mpc_sin_cos (NULL, rop, op, 0, rnd));
 }
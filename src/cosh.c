@@ -1,6 +1,6 @@
 /* mpc_cosh -- hyperbolic cosine of a complex number.
 
-Copyright (C)  2008, 2009, 2011 INRIA
+Copyright (C)  2008, 2009, 2011, 2025 INRIA
 
 This file is part of GNU MPC.
 
@@ -23,6 +23,7 @@ along with this program. If not, see http://www.gnu.org/licenses/ .
 int
 mpc_cosh (mpc_ptr rop, mpc_srcptr op, mpc_rnd_t rnd)
 {
+  MPC_STATS_FUNC (cosh, MPC_MAX_PREC (rop))
   /* cosh(op) = cos(i*op) */
   mpc_t z;
 
@@ -1,6 +1,6 @@
 /* mpc_div -- Divide two complex numbers.
 
-Copyright (C) 2002, 2003, 2004, 2005, 2008, 2009, 2010, 2011, 2012, 2020 INRIA
+Copyright (C) 2002, 2003, 2004, 2005, 2008, 2009, 2010, 2011, 2012, 2020, 2025 INRIA
 
 This file is part of GNU MPC.
 
@@ -28,6 +28,7 @@ mpc_div_zero (mpc_ptr a, mpc_srcptr z, mpc_srcptr w, mpc_rnd_t rnd)
    int sign = MPFR_SIGNBIT (mpc_realref (w));
    mpfr_t infty;
 
+   MPC_STATS_EVENT (div_zero);
    mpfr_init2 (infty, MPFR_PREC_MIN);
    mpfr_set_inf (infty, sign);
    mpfr_mul (mpc_realref (a), infty, mpc_realref (z), MPC_RND_RE (rnd));
@@ -44,6 +45,7 @@ mpc_div_inf_fin (mpc_ptr rop, mpc_srcptr z, mpc_srcptr w)
 {
    int a, b, x, y;
 
+   MPC_STATS_EVENT (div_inf_fin);
    a = (mpfr_inf_p (mpc_realref (z)) ? MPFR_SIGNBIT (mpc_realref (z)) : 0);
    b = (mpfr_inf_p (mpc_imagref (z)) ? MPFR_SIGNBIT (mpc_imagref (z)) : 0);
 
@@ -116,6 +118,7 @@ mpc_div_fin_inf (mpc_ptr rop, mpc_srcptr z, mpc_srcptr w)
 {
    mpfr_t c, d, a, b, x, y, zero;
 
+   MPC_STATS_EVENT (div_fin_inf);
    mpfr_init2 (c, 2); /* needed to hold a signed zero, +1 or -1 */
    mpfr_init2 (d, 2);
    mpfr_init2 (x, 2);
@@ -165,6 +168,7 @@ mpc_div_real (mpc_ptr rop, mpc_srcptr z, mpc_srcptr w, mpc_rnd_t rnd)
    int wrs = MPFR_SIGNBIT (mpc_realref (w));
    int wis = MPFR_SIGNBIT (mpc_imagref (w));
 
+   MPC_STATS_EVENT (div_real);
    /* warning: rop may overlap with z,w so treat the imaginary part first */
    inex_im = mpfr_div (mpc_imagref(rop), mpc_imagref(z), mpc_realref(w), MPC_RND_IM(rnd));
    inex_re = mpfr_div (mpc_realref(rop), mpc_realref(z), mpc_realref(w), MPC_RND_RE(rnd));
@@ -199,6 +203,7 @@ mpc_div_imag (mpc_ptr rop, mpc_srcptr z, mpc_srcptr w, mpc_rnd_t rnd)
    int wrs = MPFR_SIGNBIT (mpc_realref (w));
    int wis = MPFR_SIGNBIT (mpc_imagref (w));
 
+   MPC_STATS_EVENT (div_imag);
    if (overlap)
       mpc_init3 (tmprop, MPC_PREC_RE (rop), MPC_PREC_IM (rop));
 
@@ -234,6 +239,7 @@ mpc_div_imag (mpc_ptr rop, mpc_srcptr z, mpc_srcptr w, mpc_rnd_t rnd)
 int
 mpc_div (mpc_ptr a, mpc_srcptr b, mpc_srcptr c, mpc_rnd_t rnd)
 {
+   MPC_STATS_FUNC (div, MPC_MAX_PREC (a))
    int ok_re = 0, ok_im = 0;
    mpc_t res, c_conj;
    mpfr_t q;
@@ -264,6 +270,7 @@ mpc_div (mpc_ptr a, mpc_srcptr b, mpc_srcptr c, mpc_rnd_t rnd)
    else if (mpc_fin_p (b) && mpc_inf_p (c))
          return mpc_div_fin_inf (a, b, c);
    else if (!mpc_fin_p (b) || !mpc_fin_p (c)) {
+      MPC_STATS_EVENT (div_nan);
       mpc_set_nan (a);
       return MPC_INEX (0, 0);
    }
@@ -1,6 +1,6 @@
 /* mpc_div_ui -- Divide a complex number by a nonnegative integer.
 
-Copyright (C) 2002, 2009, 2011 INRIA
+Copyright (C) 2002, 2009, 2011, 2025 INRIA
 
 This file is part of GNU MPC.
 
@@ -23,6 +23,7 @@ along with this program. If not, see http://www.gnu.org/licenses/ .
 int
 mpc_div_ui (mpc_ptr a, mpc_srcptr b, unsigned long int c, mpc_rnd_t rnd)
 {
+  MPC_STATS_FUNC (div_ui, MPC_MAX_PREC (a))
   int inex_re, inex_im;
 
   inex_re = mpfr_div_ui (mpc_realref(a), mpc_realref(b), c, MPC_RND_RE(rnd));
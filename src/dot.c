@@ -1,6 +1,6 @@
 /* mpc_dot -- Dot product of two arrays of complex numbers.
 
-Copyright (C) 2018, 2020 INRIA
+Copyright (C) 2018, 2020, 2025 INRIA
 
 This file is part of GNU MPC.
 
@@ -26,6 +26,7 @@ int
 mpc_dot (mpc_ptr res, const mpc_ptr *x, const mpc_ptr *y,
          unsigned long n, mpc_rnd_t rnd)
 {
+  MPC_STATS_FUNC (dot, MPC_MAX_PREC (res))
   int inex_re, inex_im;
   mpfr_ptr *t;
   mpfr_t *z;
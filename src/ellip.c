@@ -0,0 +1,531 @@
+/* ellip.c -- Complete elliptic integrals and periods of elliptic curves.
+
+Copyright (C) 2025 INRIA
+
+This file is part of GNU MPC.
+
+GNU MPC is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the
+Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+GNU MPC is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for
+more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program. If not, see http://www.gnu.org/licenses/ .
+*/
+
+#include "mpc-impl.h"
+
+static int
+ball_abs_bounds (mpcr_ptr lo, mpcr_ptr hi, mpcb_srcptr z)
+   /* If the radius of z is less than 1/2, set lo and hi to a lower and
+      an upper bound on the absolute values of the elements of z and
+      return 1; otherwise return 0. */
+{
+   mpcr_t one, t;
+
+   if (!mpcr_lt_half_p (z->r))
+      return 0;
+   mpcr_set_one (one);
+   mpcr_sub_rnd (t, one, z->r, MPFR_RNDD);
+   mpcr_c_abs_rnd (lo, z->c, MPFR_RNDD);
+   mpcr_mul (lo, lo, t);
+   mpcr_add (t, one, z->r);
+   mpcr_c_abs_rnd (hi, z->c, MPFR_RNDU);
+   mpcr_mul (hi, hi, t);
+   return 1;
+}
+
+
+static void
+right_sign (mpcb_ptr b, mpcb_srcptr a)
+   /* Negate b if needed so that Re (b / a) >= 0, or equivalently
+      Re (b * conj (a)) >= 0, which is tested on the centres; this makes
+      |a - b| <= |a + b|. */
+{
+   mpfr_t x, y;
+
+   mpfr_init2 (x, 53);
+   mpfr_init2 (y, 53);
+   mpfr_mul (x, mpc_realref (b->c), mpc_realref (a->c), MPFR_RNDN);
+   mpfr_mul (y, mpc_imagref (b->c), mpc_imagref (a->c), MPFR_RNDN);
+   mpfr_add (x, x, y, MPFR_RNDN);
+   if (mpfr_sgn (x) < 0)
+      mpcb_neg (b, b);
+   mpfr_clear (x);
+   mpfr_clear (y);
+}
+
+
+static void
+agm_ball (mpcb_ptr M, mpcb_ptr S, mpcb_srcptr a, mpcb_srcptr b,
+   mpcb_srcptr s)
+   /* Set M to the arithmetic-geometric mean of a and b with the "right"
+      choice of square roots in the sense of [Cox 1984, "The
+      arithmetic-geometric mean of Gauss"], that is, such that
+      Re (b_n / a_n) >= 0 for n >= 1, which is tested on the centres,
+      and S to sum_{n >= 0} 2^(n-1) c_n^2 with c_0^2 = s = a^2 - b^2 and
+      c_(n+1) = (a_n - b_n) / 2 = c_n^2 / (4 a_(n+1)), so that the c_n^2
+      are obtained without cancellation; s is passed separately since it
+      is usually known with a smaller relative error than a^2 - b^2.
+      The iteration stops at the first index N such that
+      |c_N|^2 <= 2^(-p) |a_N|^2, where p is the precision. Then
+      |c_(n+1)| <= 0.27 |c_n|^2 / |a_n| and |a_(n+1)| >= 0.98 |a_n| for
+      n >= N, from which |M - a_N| <= |c_N|^2 / |a_N| and a bound of
+      2^N |c_N|^4 / |a_N|^2 on the tail of the sum follow.
+      If the stopping criterion is not reached after p + 64 steps, or the
+      radii become too large, M and S are set to infinite balls.
+      mpcb_agm cannot provide S: it only carries a_n and b_n, from which
+      c_n = (a_n - b_n) / 2 would lose about log2 |a_n / c_n| bits to
+      cancellation, while the terms of S require c_n^2 with a small
+      relative error. It also stops only when the centres of a_n and b_n
+      coincide, which bounds M but not the tail of S, and after its
+      normalisation to a = 1 and |b| <= 1, the c_n belong to a rescaled
+      sequence. */
+{
+   mpfr_prec_t p = MPC_MIN (mpcb_get_prec (a), mpcb_get_prec (b));
+   mpcb_t an, bn, sn, t;
+   mpcr_t alo, ahi, slo, shi, err;
+   unsigned long int n;
+   int ok;
+
+   mpcb_init (an);
+   mpcb_init (bn);
+   mpcb_init (sn);
+   mpcb_init (t);
+
+   mpcb_set (an, a);
+   mpcb_set (bn, b);
+   mpcb_set (sn, s);
+   mpcb_div_2ui (S, s, 1);
+
+   for (n = 0; ; n++) {
+      ok = ball_abs_bounds (alo, ahi, an) && ball_abs_bounds (slo, shi, sn);
+      if (ok) {
+         mpcr_sqr (err, alo);
+         mpcr_div_2ui (err, err, (unsigned long int) p);
+         if (mpcr_cmp (shi, err) <= 0)
+            break;
+      }
+      if (!ok || n > (unsigned long int) p + 64) {
+         mpcb_set_inf (M);
+         mpcb_set_inf (S);
+         goto clear;
+      }
+
+      mpcb_mul (t, an, bn);
+      mpcb_add (an, an, bn);
+      mpcb_div_2ui (an, an, 1);
+      mpcb_sqrt (bn, t);
+      right_sign (bn, an);
+      /* c_(n+1)^2 = (c_n^2 / (4 a_(n+1)))^2 */
+      mpcb_div (sn, sn, an);
+      mpcb_div_2ui (sn, sn, 2);
+      mpcb_sqr (sn, sn);
+      /* add 2^n c_(n+1)^2 */
+      mpcb_set (t, sn);
+      mpc_mul_2ui (t->c, t->c, n, MPC_RNDNN); /* exact */
+      mpcb_add (S, S, t);
+   }
+
+   /* M = a_N (1 + theta) with |theta| <= |c_N|^2 / |a_N|^2 =: err,
+      so that the relative radius becomes r + err + r * err. */
+   mpcr_sqr (alo, alo);
+   mpcr_div (err, shi, alo);
+   mpcb_set (M, an);
+   mpcr_mul (slo, M->r, err);
+   mpcr_add (M->r, M->r, err);
+   mpcr_add (M->r, M->r, slo);
+   /* The tail of the sum is bounded by 2^N |c_N|^2 * err. */
+   mpcr_mul (err, err, shi);
+   mpcr_mul_2ui (err, err, n);
+   if (!mpcr_zero_p (err))
+      mpcb_add_error (S, err);
+
+clear:
+   mpcb_clear (an);
+   mpcb_clear (bn);
+   mpcb_clear (sn);
+   mpcb_clear (t);
+}
+
+
+typedef struct {
+   mpc_srcptr m;
+   int e;
+   int real;
+} ellip_data_t;
+
+
+static int
+ellip_ball (mpcb_ptr res, mpfr_prec_t prec, const void *data)
+   /* Evaluation function for mpcb_ziv, where data points to an
+      ellip_data_t containing the parameter m, whether K (m) (e = 0)
+      or E (m) (e = 1) is to be computed and whether the result is known
+      to be real. With M = AGM (1, sqrt (1 - m)), K (m) = pi / (2 M) and
+      E (m) = K (m) (1 - sum_{n >= 0} 2^(n-1) c_n^2) with c_0^2 = m,
+      see [Abramowitz and Stegun 1964, 17.6]; the sum is obtained from
+      the same sequence as M by agm_ball, while K alone is computed with
+      the cheaper mpcb_agm. */
+{
+   const ellip_data_t *d = (const ellip_data_t *) data;
+   mpcb_t m, b, one, M, S;
+   mpfr_t pi;
+
+   mpcb_init (m);
+   mpcb_init (b);
+   mpcb_init (one);
+   mpcb_init (M);
+   mpcb_init (S);
+   mpfr_init2 (pi, prec);
+
+   mpcb_set_c (m, d->m, prec, 0, 0);
+   mpcb_set_ui_ui (one, 1, 0, prec);
+   mpcb_sub (b, one, m);
+   /* For m on the branch cut [1, +inf), the side is given by the sign of
+      the zero imaginary part of m, which is passed to 1 - m. */
+   if (mpfr_zero_p (mpc_imagref (d->m)))
+      mpfr_neg (mpc_imagref (b->c), mpc_imagref (d->m), MPFR_RNDN);
+   mpcb_sqrt (b, b);
+   if (d->e)
+      agm_ball (M, S, one, b, m);
+   else
+      mpcb_agm (M, one, b);
+
+   mpfr_const_pi (pi, MPFR_RNDN);
+   mpcb_set_fr (res, pi, prec, 1);
+   mpcb_div (res, res, M);
+   mpcb_div_2ui (res, res, 1);
+   if (d->e) {
+      mpcb_sub (S, one, S);
+      mpcb_mul (res, res, S);
+   }
+   if (d->real)
+      mpcb_restrict_real (res);
+
+   mpcb_clear (m);
+   mpcb_clear (b);
+   mpcb_clear (one);
+   mpcb_clear (M);
+   mpcb_clear (S);
+   mpfr_clear (pi);
+
+   return 0;
+}
+
+
+static int
+mpc_ellip (mpc_ptr rop, mpc_srcptr m, int e, mpc_rnd_t rnd)
+   /* Common code for mpc_ellipk (e = 0) and mpc_ellipe (e = 1). */
+{
+   ellip_data_t d;
+   int inex;
+
+   if (!mpc_fin_p (m)) {
+      mpfr_set_nan (mpc_realref (rop));
+      mpfr_set_nan (mpc_imagref (rop));
+      return MPC_INEX (0, 0);
+   }
+
+   /* special values K (0) = E (0) = pi/2, K (1) = +inf, E (1) = 1 */
+   if (mpc_zero_p (m)) {
+      inex = mpfr_const_pi (mpc_realref (rop), MPC_RND_RE (rnd));
+      mpfr_div_2ui (mpc_realref (rop), mpc_realref (rop), 1, MPFR_RNDN);
+      mpfr_set_ui (mpc_imagref (rop), 0, MPFR_RNDN);
+      return MPC_INEX (inex, 0);
+   }
+   else if (mpc_cmp_si_si (m, 1, 0) == 0) {
+      if (e)
+         return mpc_set_ui (rop, 1, rnd);
+      mpfr_set_inf (mpc_realref (rop), +1);
+      mpfr_set_ui (mpc_imagref (rop), 0, MPFR_RNDN);
+      return MPC_INEX (0, 0);
+   }
+
+   d.m = m;
+   d.e = e;
+   d.real = mpfr_zero_p (mpc_imagref (m))
+            && mpfr_cmp_ui (mpc_realref (m), 1) < 0;
+
+   return mpcb_ziv (rop, ellip_ball, &d, NULL, d.real, rnd);
+}
+
+
+int
+mpc_ellipk (mpc_ptr rop, mpc_srcptr m, mpc_rnd_t rnd)
+   /* Compute the complete elliptic integral of the first kind
+      K (m) = int_0^(pi/2) dt / sqrt (1 - m sin^2 t), with the parameter
+      m = k^2. */
+{
+   MPC_STATS_FUNC (ellipk, MPC_MAX_PREC (rop))
+   return mpc_ellip (rop, m, 0, rnd);
+}
+
+
+int
+mpc_ellipe (mpc_ptr rop, mpc_srcptr m, mpc_rnd_t rnd)
+   /* Compute the complete elliptic integral of the second kind
+      E (m) = int_0^(pi/2) sqrt (1 - m sin^2 t) dt, with the parameter
+      m = k^2. */
+{
+   MPC_STATS_FUNC (ellipe, MPC_MAX_PREC (rop))
+   return mpc_ellip (rop, m, 1, rnd);
+}
+
+
+/* Kinds of values of periods */
+#define KIND_COMPLEX 0
+#define KIND_REAL 1
+#define KIND_IMAG 2
+
+typedef struct {
+   mpc_srcptr e1, e2, e3;
+   int second;
+   int kind;
+} period_data_t;
+
+
+static int
+period_ball (mpcb_ptr w, mpfr_prec_t prec, const void *data)
+   /* Evaluation function for mpcb_ziv, where data points to a
+      period_data_t containing the roots e1, e2 and e3 of the curve,
+      which of the two periods is to be computed and whether it is known
+      to be real or purely imaginary; in the latter case, the period
+      divided by i is computed.
+      With a = sqrt (e1 - e3), b = +-sqrt (e1 - e2) and
+      c = +-sqrt (e2 - e3) such that |a - b| <= |a + b| and
+      |a - c| <= |a + c|, the periods are pi / AGM (a, b) and
+      i * pi / AGM (a, c), see [Cremona and Thongjunthug 2013, "The
+      complex AGM, periods of elliptic curves over C and complex elliptic
+      logarithms", Theorem 4.2], where the AGM is the optimal one, which
+      is what mpcb_agm computes after normalising its arguments. */
+{
+   const period_data_t *d = (const period_data_t *) data;
+   mpcb_t e1, e2, e3, a, b;
+   mpfr_t pi;
+
+   mpcb_init (e1);
+   mpcb_init (e2);
+   mpcb_init (e3);
+   mpcb_init (a);
+   mpcb_init (b);
+   mpfr_init2 (pi, prec);
+
+   mpcb_set_c (e1, d->e1, prec, 0, 0);
+   mpcb_set_c (e2, d->e2, prec, 0, 0);
+   mpcb_set_c (e3, d->e3, prec, 0, 0);
+   mpcb_sub (a, e1, e3);
+   mpcb_sqrt (a, a);
+   if (!d->second)
+      mpcb_sub (b, e1, e2);
+   else
+      mpcb_sub (b, e2, e3);
+   mpcb_sqrt (b, b);
+   right_sign (b, a);
+   mpcb_agm (a, a, b);
+
+   mpfr_const_pi (pi, MPFR_RNDN);
+   mpcb_set_fr (w, pi, prec, 1);
+   mpcb_div (w, w, a);
+   /* multiply by i for the second period, and divide by i for a purely
+      imaginary one */
+   if (d->second && d->kind != KIND_REAL)
+      mpc_mul_i (w->c, w->c, 1, MPC_RNDNN); /* exact */
+   else if (!d->second && d->kind == KIND_IMAG)
+      mpc_mul_i (w->c, w->c, -1, MPC_RNDNN); /* exact */
+   if (d->kind != KIND_COMPLEX)
+      mpcb_restrict_real (w);
+
+   mpcb_clear (e1);
+   mpcb_clear (e2);
+   mpcb_clear (e3);
+   mpcb_clear (a);
+   mpcb_clear (b);
+   mpfr_clear (pi);
+
+   return 0;
+}
+
+
+static void
+exact_sub (mpfr_ptr z, mpfr_srcptr x, mpfr_srcptr y)
+   /* Set z to x - y, with a precision large enough to hold the
+      difference exactly. */
+{
+   mpfr_prec_t p;
+   mpfr_exp_t ex, ey;
+
+   if (mpfr_zero_p (x) || mpfr_zero_p (y))
+      p = MPC_MAX (mpfr_get_prec (x), mpfr_get_prec (y));
+   else {
+      ex = mpfr_get_exp (x);
+      ey = mpfr_get_exp (y);
+      p = MPC_MAX (ex, ey)
+          - MPC_MIN (ex - mpfr_get_prec (x), ey - mpfr_get_prec (y)) + 1;
+   }
+   mpfr_set_prec (z, p);
+   mpfr_sub (z, x, y, MPFR_RNDN); /* exact */
+}
+
+
+static int
+agm_kind (mpc_srcptr x1, mpc_srcptr x2, mpc_srcptr y1, mpc_srcptr y2)
+   /* Return the kind of AGM (sqrt (x), +-sqrt (y)) with x = x1 - x2 and
+      y = y1 - y2, both non-zero, with the choice of sign of right_sign:
+      If x and y are real and of the same sign, the AGM is real or purely
+      imaginary. If y = conj (x), then AGM (a, conj (a)) is real for
+      Re x >= 0, and otherwise AGM (a, -conj (a)) is purely imaginary.
+      In all other cases, no part of the AGM is known to vanish. */
+{
+   mpfr_t u, v;
+   int kind, sx, sy;
+
+   kind = KIND_COMPLEX;
+   if (   mpfr_equal_p (mpc_imagref (x1), mpc_imagref (x2))
+       && mpfr_equal_p (mpc_imagref (y1), mpc_imagref (y2))) {
+      sx = mpfr_cmp (mpc_realref (x1), mpc_realref (x2));
+      sy = mpfr_cmp (mpc_realref (y1), mpc_realref (y2));
+      if (sx > 0 && sy > 0)
+         kind = KIND_REAL;
+      else if (sx < 0 && sy < 0)
+         kind = KIND_IMAG;
+   }
+   else {
+      mpfr_init2 (u, MPFR_PREC_MIN);
+      mpfr_init2 (v, MPFR_PREC_MIN);
+      exact_sub (u, mpc_realref (x1), mpc_realref (x2));
+      exact_sub (v, mpc_realref (y1), mpc_realref (y2));
+      if (mpfr_equal_p (u, v)) {
+         exact_sub (u, mpc_imagref (x1), mpc_imagref (x2));
+         exact_sub (v, mpc_imagref (y2), mpc_imagref (y1));
+         if (mpfr_equal_p (u, v))
+            kind = (mpfr_cmp (mpc_realref (x1), mpc_realref (x2)) >= 0 ?
+                    KIND_REAL : KIND_IMAG);
+      }
+      mpfr_clear (u);
+      mpfr_clear (v);
+   }
+
+   return kind;
+}
+
+
+static int
+period (mpc_ptr w, mpc_srcptr e1, mpc_srcptr e2, mpc_srcptr e3, int second,
+   mpc_rnd_t rnd)
+   /* Compute the first or second period with the roots e1, e2 and e3,
+      which are finite and pairwise distinct. */
+{
+   period_data_t d;
+   mpc_t v;
+   int inex, kind;
+
+   d.e1 = e1;
+   d.e2 = e2;
+   d.e3 = e3;
+   d.second = second;
+   if (!second)
+      d.kind = agm_kind (e1, e3, e1, e2);
+   else
+      d.kind = agm_kind (e1, e3, e2, e3);
+
+   /* The period is purely imaginary if the AGM is real for the second
+      period, or purely imaginary for the first one. */
+   kind = d.kind;
+   if (second && kind != KIND_COMPLEX)
+      kind = KIND_REAL + KIND_IMAG - kind;
+   if (kind != KIND_IMAG)
+      return mpcb_ziv (w, period_ball, &d, NULL, kind == KIND_REAL, rnd);
+
+   /* Compute the period divided by i as a real number rounded to the
+      precision of the imaginary part of w. */
+   mpc_init3 (v, mpfr_get_prec (mpc_imagref (w)), MPFR_PREC_MIN);
+   inex = mpcb_ziv (v, period_ball, &d, NULL, 1,
+      MPC_RND (MPC_RND_IM (rnd), MPFR_RNDN));
+   mpfr_set_ui (mpc_realref (w), 0, MPFR_RNDN);
+   mpfr_set (mpc_imagref (w), mpc_realref (v), MPFR_RNDN); /* exact */
+   mpc_clear (v);
+
+   return MPC_INEX (0, MPC_INEX_RE (inex));
+}
+
+
+int
+mpc_ellip_periods (mpc_ptr w1, mpc_ptr w2, mpc_srcptr e1, mpc_srcptr e2,
+   mpc_srcptr e3, mpc_rnd_t rnd)
+   /* Set w1 and w2 to a basis of the period lattice of the elliptic curve
+      y^2 = 4 (x - e1) (x - e2) (x - e3) and return the rounding
+      direction values combined with MPC_INEX12. If the roots are not
+      finite or not pairwise distinct, the results are NaN+i*NaN. */
+{
+   MPC_STATS_FUNC (ellip_periods,
+                   MPC_MAX (MPC_MAX_PREC (w1), MPC_MAX_PREC (w2)))
+   int inex1, inex2;
+
+   if (   !mpc_fin_p (e1) || !mpc_fin_p (e2) || !mpc_fin_p (e3)
+       || mpc_cmp (e1, e2) == 0 || mpc_cmp (e1, e3) == 0
+       || mpc_cmp (e2, e3) == 0) {
+      mpfr_set_nan (mpc_realref (w1));
+      mpfr_set_nan (mpc_imagref (w1));
+      mpfr_set_nan (mpc_realref (w2));
+      mpfr_set_nan (mpc_imagref (w2));
+      return MPC_INEX12 (MPC_INEX (0, 0), MPC_INEX (0, 0));
+   }
+
+   inex1 = period (w1, e1, e2, e3, 0, rnd);
+   inex2 = period (w2, e1, e2, e3, 1, rnd);
+
+   return MPC_INEX12 (inex1, inex2);
+}
+
+
+/* A batch of evaluations of mpc_ellip_periods_vec. */
+typedef struct {
+   mpc_ptr *w1, *w2;
+   int *inex;
+   const mpc_ptr *e1, *e2, *e3;
+   mpc_rnd_t rnd;
+} periods_batch_t;
+
+
+static void
+periods_batch_work (mpc_batch_ptr batch, void *data)
+{
+   periods_batch_t *b = (periods_batch_t *) data;
+   unsigned long int i;
+   int inex;
+
+   while (mpc_batch_next (&i, batch)) {
+      inex = mpc_ellip_periods (b->w1 [i], b->w2 [i], b->e1 [i], b->e2 [i],
+                                b->e3 [i], b->rnd);
+      if (b->inex != NULL)
+         b->inex [i] = inex;
+   }
+}
+
+
+void
+mpc_ellip_periods_vec (mpc_ptr *w1, mpc_ptr *w2, int *inex,
+   const mpc_ptr *e1, const mpc_ptr *e2, const mpc_ptr *e3,
+   unsigned long int n, mpc_rnd_t rnd)
+   /* Set w1 [i] and w2 [i] as in mpc_ellip_periods for the roots e1 [i],
+      e2 [i] and e3 [i] for 0 <= i < n, and, unless inex is NULL,
+      inex [i] to the corresponding return value; the curves are spread
+      over several threads if possible. The w1 [i] and w2 [i] must be
+      distinct from each other and from the roots. */
+{
+   periods_batch_t batch;
+
+   batch.w1 = w1;
+   batch.w2 = w2;
+   batch.inex = inex;
+   batch.e1 = e1;
+   batch.e2 = e2;
+   batch.e3 = e3;
+   batch.rnd = rnd;
+   mpc_batch_run (n, periods_batch_work, &batch);
+}
@@ -0,0 +1,949 @@
+/* mpc_erf, mpc_erfc -- error function and complementary error function
+   of a complex number.
+
+Copyright (C) 2025 INRIA
+
+This file is part of GNU MPC.
+
+GNU MPC is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the
+Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+GNU MPC is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for
+more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program. If not, see http://www.gnu.org/licenses/ .
+*/
+
+#include <stdio.h> /* for MPC_ASSERT */
+#include "mpc-impl.h"
+
+/* Write z = x + i*y. Using erf (-z) = -erf (z) and erfc (-z) = 2 - erfc (z),
+   we may assume that x >= 0, and use one of the following formulae.
+   (S) The Taylor series
+          erf (z) = 2 z / sqrt (pi) * sum_{n>=0} (-z^2)^n / (n! (2n+1)).
+       The sum of the absolute values of its terms is at most exp (|z|^2),
+       so that about 2 x^2 / log (2) bits cancel when |y| >= x.
+   (E) The series
+          erf (z) = 2 z / sqrt (pi) * exp (-z^2)
+                    * sum_{n>=0} (2 z^2)^n / (2n+1)!!,
+       which has the same bound on its terms, and in which about
+       2 y^2 / log (2) bits cancel; it is used instead of (S) when x > |y|.
+       For both series, the terms decrease by a factor of at least 2
+       from an index n >= 2 |z|^2 onwards, so that the remainder is bounded
+       by twice the first neglected term.
+   (A) The asymptotic expansion of DLMF 7.12.1,
+          erfc (z) = exp (-z^2) / (z sqrt (pi))
+                     * (sum_{n<N} (-1)^n (1/2)_n / z^(2n) + R_N (z)),
+       where for x > 0 the remainder is bounded by kappa times the first
+       neglected term, with kappa = 1 if x >= |y| and
+       kappa = 1 / sin (2 arg z) = |z|^2 / (2 x |y|) otherwise.
+       For x = 0, the same sum yields erf (z) = -exp (-z^2) / (z sqrt (pi))
+       * (sum + R_N (z)); integrating by parts in
+       erf (i y) = 2 i / sqrt (pi) * int_0^y exp (t^2) dt, with the integral
+       split at y / sqrt (2), shows that for y^2 >= 4 (N + 1) the remainder
+       is bounded by twice the first neglected term plus
+       3 y^2 exp (-y^2 / 2).
+   (F) The continued fraction
+          erfc (z) = exp (-z^2) / sqrt (pi)
+                     * 1 / (z + (1/2) / (z + 1 / (z + (3/2) / (z + ...)))),
+       which is an S-fraction in 1 / z^2, so that for x > 0 by Henrici and
+       Pfluger, "Truncation error estimates for Stieltjes fractions", 1966,
+       the error of an approximant is bounded by kappa as in (A) times the
+       difference to the previous approximant, which in turn is given by
+       the product of the partial numerators divided by the product of the
+       last two denominators. The fraction is evaluated forwards with balls.
+   The series (S), (E) and (A) are evaluated by rectangular splitting
+   with mpc_rect_sum, shared with the hypergeometric series:
+   With m about the square root of the number N of terms, the powers
+   w^2, ..., w^m of the variable w are precomputed, and then the sum is
+   obtained by a Horner scheme in w^m, in which the blocks of m terms only
+   require multiplications and divisions by small integers; so only about
+   2 sqrt (N) full multiplications are needed. Every operation rounds to
+   nearest, so that the error of the computed sum is bounded by
+   (1.03 K u) times the sum of the absolute values of the terms, where K
+   bounds the number of roundings on the way of any term to the result
+   and u = 2^(-prec).
+   The cancellation of each method, the ratio between the real and
+   imaginary parts of the result and the growth of the error in the
+   exponential are estimated from the exponents of x and y, which
+   determines the working precision from the start; among the applicable
+   formulae, we then choose the one with the smallest estimated cost.
+   The factor exp (-z^2) is computed as exp (y^2 - x^2) exp (-2ixy), so that
+   overflows and underflows of the first factor are easily detected. */
+
+#define LOG2_E 1.4426950408889634
+
+#define ERF_SERIES     0 /* (S) */
+#define ERF_SERIES_EXP 1 /* (E) */
+#define ERF_ASYMPT     2 /* (A) */
+#define ERF_FRACTION   3 /* (F) */
+
+/* 1 / sqrt (pi), rounded to nearest from pi rounded to nearest at
+   precision rsqrt_pi_prec, so that its error is at most 2 half ulps */
+static MPC_THREAD_LOCAL mpfr_t rsqrt_pi;
+static MPC_THREAD_LOCAL mpfr_prec_t rsqrt_pi_prec = 0;
+
+static void
+ball_rsqrt_pi (mpcb_ptr z, mpfr_prec_t prec)
+   /* Set z to a ball of precision prec around 1 / sqrt (pi). */
+{
+   mpfr_prec_t p;
+
+   if (prec > rsqrt_pi_prec) {
+      /* grow geometrically to avoid too many recomputations */
+      p = MPC_MAX (prec, rsqrt_pi_prec + rsqrt_pi_prec / 2);
+      if (rsqrt_pi_prec == 0)
+         mpfr_init2 (rsqrt_pi, p);
+      else
+         mpfr_set_prec (rsqrt_pi, p);
+      mpfr_const_pi (rsqrt_pi, MPFR_RNDN);
+      mpfr_rec_sqrt (rsqrt_pi, rsqrt_pi, MPFR_RNDN);
+      rsqrt_pi_prec = p;
+   }
+   mpcb_set_fr (z, rsqrt_pi, prec, 2);
+}
+
+
+void
+mpc_erf_free_cache (void)
+{
+   if (rsqrt_pi_prec != 0)
+      mpfr_clear (rsqrt_pi);
+   rsqrt_pi_prec = 0;
+}
+
+
+static void
+term_ratio (long int *c, unsigned long int *d1, unsigned long int *d2,
+   int kind, unsigned long int n)
+   /* Return the ratio T_n / T_{n-1} of the terms of the series of the given
+      kind in the variable w as c w / (d1 d2), where w = z^2 for (S) and
+      (E), and w = -1 / (2 z^2) for (A). */
+{
+   switch (kind) {
+   case ERF_SERIES:
+      *c = - (long int) (2 * n - 1);
+      *d1 = n;
+      *d2 = 2 * n + 1;
+      break;
+   case ERF_SERIES_EXP:
+      *c = 2;
+      *d1 = 2 * n + 1;
+      *d2 = 1;
+      break;
+   default:
+      *c = (long int) (2 * n - 1);
+      *d1 = 1;
+      *d2 = 1;
+   }
+}
+
+
+static unsigned long int
+sum_length (mpfr_ptr sum, mpfr_ptr last, mpfr_srcptr aw, int kind,
+   mpfr_exp_t target, unsigned long int nmin, unsigned long int nmax)
+   /* Given an upper bound aw on |w|, return the smallest N >= nmin such
+      that the first neglected term T_N satisfies
+      |T_N| <= 2^target sum_{n<N} |T_n|, and set last and sum to upper
+      bounds on both sides. Return 0 if there is no such N <= nmax. The
+      variables sum and last should have a small precision. */
+{
+   unsigned long int n, d1, d2;
+   long int c;
+
+   mpfr_set_ui (sum, 0, MPFR_RNDU);
+   mpfr_set_ui (last, 1, MPFR_RNDU);
+   n = 0;
+   while (n == 0 || n < nmin
+          || mpfr_get_exp (last) > mpfr_get_exp (sum) + target - 1) {
+      if (n == nmax)
+         return 0;
+      mpfr_add (sum, sum, last, MPFR_RNDU);
+      n++;
+      term_ratio (&c, &d1, &d2, kind, n);
+      mpfr_mul (last, last, aw, MPFR_RNDU);
+      mpfr_mul_ui (last, last, (unsigned long int) (c < 0 ? -c : c),
+                   MPFR_RNDU);
+      mpfr_div_ui (last, last, d1, MPFR_RNDU);
+      mpfr_div_ui (last, last, d2, MPFR_RNDU);
+   }
+
+   return n;
+}
+
+
+static void
+ratio_mul (mpc_ptr u, unsigned long int n, const void *data)
+   /* Multiply u by T_n / (w T_{n-1}) with at most 3 roundings, where
+      data points to the kind of the series; this is the ratio function
+      for mpc_rect_sum. */
+{
+   unsigned long int d1, d2;
+   long int c;
+
+   term_ratio (&c, &d1, &d2, *(const int *) data, n);
+   if (c == -1)
+      mpc_neg (u, u, MPC_RNDNN);
+   else if (c == 2)
+      mpc_mul_2ui (u, u, 1, MPC_RNDNN);
+   else if (c != 1)
+      mpc_mul_si (u, u, c, MPC_RNDNN);
+   if (d1 < 32768 && d2 < 65536) {
+      /* the product fits into an unsigned long int */
+      d1 *= d2;
+      d2 = 1;
+   }
+   if (d1 == 2)
+      mpc_div_2ui (u, u, 1, MPC_RNDNN);
+   else if (d1 != 1)
+      mpc_div_ui (u, u, d1, MPC_RNDNN);
+   if (d2 != 1)
+      mpc_div_ui (u, u, d2, MPC_RNDNN);
+}
+
+
+static void
+ball_add_error (mpcb_ptr z, mpfr_srcptr err)
+   /* Add the absolute error err to the radius of z. */
+{
+   mpcr_t r, s;
+
+   mpcr_f_abs_rnd (r, err, MPFR_RNDU);
+   mpcr_c_abs_rnd (s, z->c, MPFR_RNDD);
+   mpcr_div (r, r, s);
+   mpcr_add (z->r, z->r, r);
+}
+
+
+static void
+ball_sum (mpcb_ptr b, mpc_srcptr w, int kind, unsigned long int n,
+   mpfr_srcptr sum, mpfr_srcptr tail, mpfr_prec_t prec)
+   /* Set b to a ball of precision prec containing sum_{n>=0} T_n, or
+      rather its value up to a remainder bounded by tail, where w has been
+      obtained with at most 2 roundings of its exact value, and sum bounds
+      the sum of the absolute values of the first n terms. */
+{
+   mpc_t s;
+   mpfr_t err;
+   unsigned long int k;
+
+   mpc_init2 (s, prec);
+   mpfr_init2 (err, 32);
+   k = mpc_rect_sum (s, w, n, ratio_mul, &kind, 3);
+   /* The errors of w amount to at most 2 n further roundings. */
+   mpfr_mul_ui (err, sum, k + 2 * n, MPFR_RNDU);
+   mpfr_mul_ui (err, err, 103, MPFR_RNDU);
+   mpfr_div_ui (err, err, 100, MPFR_RNDU);
+   mpfr_div_2ui (err, err, prec, MPFR_RNDU);
+   mpfr_add (err, err, tail, MPFR_RNDU);
+   mpcb_set_c (b, s, prec, 0, 0);
+   ball_add_error (b, err);
+   mpc_clear (s);
+   mpfr_clear (err);
+}
+
+
+static mpfr_exp_t
+max_exp (mpc_srcptr z)
+{
+   return MPC_MAX (mpfr_get_exp (mpc_realref (z)),
+                   mpfr_get_exp (mpc_imagref (z)));
+}
+
+
+static void
+fraction (mpcb_ptr f, mpcb_srcptr z, mpfr_srcptr kappa)
+   /* Set f to a ball containing 1 / (z + (1/2) / (z + 1 / (z + ...))),
+      where z has a positive real part and kappa is the factor of the
+      error bound. */
+{
+   mpfr_prec_t p = mpcb_get_prec (z);
+   mpcb_t a [2], b [2], t, u;
+   mpcb_ptr a0 = a [0], a1 = a [1], b0 = b [0], b1 = b [1], tmp;
+   mpfr_t prod;
+   mpcr_t r, s, one;
+   mpfr_exp_t target;
+   unsigned long int k;
+
+   mpcb_init (a0);
+   mpcb_init (a1);
+   mpcb_init (b0);
+   mpcb_init (b1);
+   mpcb_init (t);
+   mpcb_init (u);
+   mpfr_init2 (prod, 32);
+
+   /* a1 / b1 and a0 / b0 are the k-th and (k-1)-st approximants, and
+      prod is the product of the partial numerators 1, 1/2, ..., (k-1)/2. */
+   mpcb_set_ui_ui (a0, 1, 0, p);
+   mpcb_set (a1, z);
+   mpcb_set (b0, z);
+   mpcb_sqr (b1, z);
+   mpcb_set_ui_ui (t, 1, 0, p);
+   mpcb_div_2ui (t, t, 1);
+   mpcb_add (b1, b1, t);
+   mpfr_set_ui_2exp (prod, 1, -1, MPFR_RNDU);
+   k = 2;
+   while (1) {
+      if (!mpcr_lt_half_p (a1->r) || !mpcr_lt_half_p (b0->r)
+          || !mpcr_lt_half_p (b1->r))
+         break;
+      /* With |b| >= 2^(max_exp (b) - 2) for b = b0 and b1, stop when the
+         error bound is less than 2^(-p-2) times a lower bound on |a1/b1|. */
+      target = max_exp (a1->c) - max_exp (b1->c) - 3 - p - 2;
+      if (mpfr_get_exp (prod) + mpfr_get_exp (kappa)
+          - max_exp (b0->c) - max_exp (b1->c) + 4 <= target)
+         break;
+      k++;
+      /* a_k = z a_{k-1} + (k-1)/2 a_{k-2}, and similarly for b */
+      mpcb_set_ui_ui (u, k - 1, 0, p);
+      mpcb_div_2ui (u, u, 1);
+      mpcb_mul (t, z, a1);
+      mpcb_mul (a0, a0, u);
+      mpcb_add (a0, t, a0);
+      tmp = a0;
+      a0 = a1;
+      a1 = tmp;
+      mpcb_mul (t, z, b1);
+      mpcb_mul (b0, b0, u);
+      mpcb_add (b0, t, b0);
+      tmp = b0;
+      b0 = b1;
+      b1 = tmp;
+      mpfr_mul_ui (prod, prod, k - 1, MPFR_RNDU);
+      mpfr_div_2ui (prod, prod, 1, MPFR_RNDU);
+   }
+
+   mpcb_div (f, a1, b1);
+   if (!mpcr_lt_half_p (b0->r) || !mpcr_lt_half_p (b1->r))
+      mpcr_set_inf (f->r);
+   else {
+      /* truncation error kappa * prod / (|b0| |b1|) */
+      mpcr_set_one (one);
+      mpcr_f_abs_rnd (r, prod, MPFR_RNDU);
+      mpcr_f_abs_rnd (s, kappa, MPFR_RNDU);
+      mpcr_mul (r, r, s);
+      mpcr_c_abs_rnd (s, b0->c, MPFR_RNDD);
+      mpcr_div (r, r, s);
+      mpcr_sub_rnd (s, one, b0->r, MPFR_RNDD);
+      mpcr_div (r, r, s);
+      mpcr_c_abs_rnd (s, b1->c, MPFR_RNDD);
+      mpcr_div (r, r, s);
+      mpcr_sub_rnd (s, one, b1->r, MPFR_RNDD);
+      mpcr_div (r, r, s);
+      /* conversion into a relative error */
+      mpcr_c_abs_rnd (s, f->c, MPFR_RNDD);
+      mpcr_div (r, r, s);
+      mpcr_add (f->r, f->r, r);
+   }
+
+   mpcb_clear (a0);
+   mpcb_clear (a1);
+   mpcb_clear (b0);
+   mpcb_clear (b1);
+   mpcb_clear (t);
+   mpcb_clear (u);
+   mpfr_clear (prod);
+}
+
+
+static double
+cost (unsigned long int n, mpfr_prec_t prec, int splitting)
+   /* Estimate the cost of n terms at precision prec in units of a
+      multiplication at precision 1, with or without rectangular
+      splitting. */
+{
+   unsigned long int m;
+   double c;
+
+   if (splitting) {
+      for (m = 1; (m + 1) * (m + 1) <= n; m++);
+      c = 2.0 * m + 0.35 * n;
+   }
+   else
+      /* about 6 multiplications per term of the continued fraction */
+      c = 6.0 * n;
+   return c * prec * (1 + prec / 1024.0);
+}
+
+
+static long int
+erf_core (mpcb_ptr m, mpcb_ptr h, mpc_srcptr z, int complement,
+   mpfr_prec_t p)
+   /* For z = x + i*y with x >= 0 and y != 0, compute a real ball m and a
+      ball h such that erf (z) (if complement is 0) or erfc (z) (otherwise)
+      lies in c + m h, where c is the return value, with a working
+      precision chosen for a result at precision p. For x = 0, complement
+      must be 0. */
+{
+   mpfr_srcptr x = mpc_realref (z), y = mpc_imagref (z);
+   mpfr_exp_t ex, ey, ez, lkappa;
+   double xd, yd, a, b, lerf, lerfc, lf, lt, li, small, extra, c, best;
+   mpfr_prec_t q, qc, qe, qce, qs, qa, prec;
+   unsigned long int ns, na, nmin, nmax;
+   int kind, method, imag = mpfr_zero_p (x);
+   mpfr_t aw, sum, last, suma, lasta, kappa, t;
+   mpc_t w;
+   mpcb_t zb, s, u;
+   long int ret;
+
+   mpfr_init2 (aw, 32);
+   mpfr_init2 (sum, 32);
+   mpfr_init2 (last, 32);
+   mpfr_init2 (suma, 32);
+   mpfr_init2 (lasta, 32);
+   mpfr_init2 (kappa, 32);
+   mpfr_init2 (t, 32);
+
+   /* Rough estimates in double precision of the logarithms in base 2 of
+      |erf (z)|, |erfc (z)| and the parts of the result. */
+   ex = imag ? 0 : mpfr_get_exp (x);
+   ey = mpfr_get_exp (y);
+   ez = imag ? ey : MPC_MAX (ex, ey);
+   xd = (imag || ex < -100) ? 0
+        : (ex > 100 ? 1e30 : mpfr_get_d (x, MPFR_RNDN));
+   yd = ey < -100 ? 0 : (ey > 100 ? 1e30 : mpfr_get_d (y, MPFR_RNDN));
+   yd = (yd < 0 ? -yd : yd);
+   a = xd * xd;
+   b = yd * yd;
+   if (ez <= 0) {
+      lerf = ez + 0.17;
+      lerfc = 0;
+   }
+   else {
+      /* |erfc (z)| is about exp (y^2 - x^2) / (|z| sqrt (pi)) */
+      lerfc = LOG2_E * (b - a) - ez - 0.33;
+      lerf = (lerfc > 0 ? lerfc : 0);
+   }
+   lf = (complement ? lerfc : lerf);
+   /* Bits lost when one part of the result is much smaller than the
+      other one, relative to the ball computed by the series, of the order
+      of erf (z), and to the ball computed by (A) and (F), of the order of
+      erfc (z); small estimates the logarithm of the smaller part. */
+   if (imag)
+      small = lf;
+   else if (yd < xd) {
+      /* the imaginary part, of the order of y exp (-x^2) for 2xy < 1 and
+         of |erfc (z)| otherwise */
+      small = ey + 0.17 - LOG2_E * a;
+      if (ex + ey + 1 > 0)
+         small += LOG2_E * b - ex - ey - 1;
+   }
+   else {
+      li = ex + 0.17 + LOG2_E * b;
+      small = (complement && li < 0 ? 0 : li);
+   }
+   extra = lf - small;
+   q = p + (extra > 0 ? (mpfr_prec_t) extra : 0) + mpc_ceil_log2 (p) + 10;
+   extra = (imag ? 0 : lerfc - small);
+   qc = p + (extra > 0 ? (mpfr_prec_t) extra : 0) + mpc_ceil_log2 (p) + 10;
+   /* An error of 2^-q relative to the argument of the exponential, which
+      is bounded by 2^(2ez+1), becomes an error of up to 2^(2ez+1-q)
+      relative to its value. */
+   qe = q + (ez > 0 ? 2 * ez + 1 : 0);
+   qce = qc + (ez > 0 ? 2 * ez + 1 : 0);
+
+   mpfr_sqr (aw, x, MPFR_RNDU);
+   mpfr_sqr (t, y, MPFR_RNDU);
+   mpfr_add (aw, aw, t, MPFR_RNDU);
+   if (imag || mpfr_cmpabs (x, y) >= 0)
+      mpfr_set_ui (kappa, 1, MPFR_RNDU);
+   else {
+      mpfr_mul (kappa, x, y, MPFR_RNDD);
+      mpfr_mul_2ui (kappa, kappa, 1, MPFR_RNDD);
+      mpfr_abs (kappa, kappa, MPFR_RNDD);
+      mpfr_div (kappa, aw, kappa, MPFR_RNDU);
+   }
+   lkappa = mpfr_get_exp (kappa);
+
+   best = -1;
+   method = ERF_SERIES;
+
+   /* (A) */
+   na = 0;
+   qa = qce;
+   if (ez > 0) {
+      mpfr_set (t, aw, MPFR_RNDD);
+      if (imag)
+         mpfr_div_2ui (t, t, 2, MPFR_RNDD);
+      if (mpfr_cmp_ui_2exp (t, 1, 30) >= 0)
+         nmax = 1ul << 30;
+      else {
+         nmax = mpfr_get_ui (t, MPFR_RNDD);
+         if (imag)
+            nmax = (nmax >= 2 ? nmax - 1 : 0);
+      }
+      mpfr_ui_div (t, 1, aw, MPFR_RNDU);
+      mpfr_div_2ui (t, t, 1, MPFR_RNDU);
+      if (nmax > 0)
+         na = sum_length (suma, lasta, t, ERF_ASYMPT, -qc - lkappa - 2, 1,
+                          nmax);
+      /* On the imaginary axis, 3 y^2 exp (-y^2/2) needs to be small. */
+      if (na != 0 && imag
+          && ey < 31
+          && LOG2_E * b / 2 < qc + 4 + 2 * ey)
+         na = 0;
+      if (na != 0) {
+         qa += mpc_ceil_log2 (7 * na + 10);
+         c = cost (na, qa, 1);
+         if (best < 0 || c < best) {
+            best = c;
+            method = ERF_ASYMPT;
+         }
+      }
+   }
+
+   /* (F); the number of terms is a rough empirical estimate. */
+   if (!imag && xd > 0) {
+      c = 0.7 * qc;
+      c = c * c / (8 * xd * (xd + yd)) + qc / 6.0 + lkappa;
+      if (c < 1e9) {
+         c = cost ((unsigned long int) c, qce, 0);
+         if (best < 0 || c < best) {
+            best = c;
+            method = ERF_FRACTION;
+         }
+      }
+   }
+
+   /* (S) or (E), unless there are clearly too many terms; since at least
+      2|z|^2 terms are needed, the length is only determined when this
+      lower bound does not already make the series more expensive than
+      (A) or (F). */
+   kind = (yd >= xd ? ERF_SERIES : ERF_SERIES_EXP);
+   if (kind == ERF_SERIES)
+      lt = ez + 0.17 + LOG2_E * (a + b);
+   else
+      lt = ez + 0.17 + 2 * LOG2_E * b;
+   if (complement && lt < 0)
+      lt = 0;
+   qs = q + (lt > lf ? (mpfr_prec_t) (lt - lf) : 0);
+   ns = 0;
+   nmin = mpfr_get_ui (aw, MPFR_RNDU);
+   nmin = (nmin > ULONG_MAX / 2 ? ULONG_MAX : 2 * nmin);
+   if (ez <= 20 && (best < 0 || cost (nmin, qs, 1) < best)) {
+      ns = sum_length (sum, last, aw, kind, -qs - 1, nmin, ULONG_MAX);
+      qs += mpc_ceil_log2 (7 * ns + 10);
+      if (kind == ERF_SERIES_EXP)
+         qs = MPC_MAX (qs, qe);
+      c = cost (ns, qs, 1);
+      if (best < 0 || c < best) {
+         best = c;
+         method = kind;
+      }
+   }
+
+   if (best < 0) {
+      /* nothing else applies */
+      method = kind;
+      ns = sum_length (sum, last, aw, kind, -qs - 1, nmin, ULONG_MAX);
+      qs += mpc_ceil_log2 (7 * ns + 10);
+      if (kind == ERF_SERIES_EXP)
+         qs = MPC_MAX (qs, qe);
+   }
+
+   if (method == ERF_SERIES || method == ERF_SERIES_EXP)
+      prec = qs;
+   else if (method == ERF_ASYMPT)
+      prec = qa;
+   else
+      prec = qce;
+
+   /* Compute m = exp (y^2 - x^2) and u = exp (-2ixy) / sqrt (pi), or
+      m = 1 and u = 1 / sqrt (pi) for (S). */
+   mpcb_init (zb);
+   mpcb_init (s);
+   mpcb_init (u);
+   mpc_init2 (w, prec);
+   mpcb_set_c (zb, z, prec, 0, 0);
+   ball_rsqrt_pi (u, prec);
+   if (method == ERF_SERIES)
+      mpcb_set_ui_ui (m, 1, 0, prec);
+   else {
+      mpfr_set_prec (t, prec);
+      mpfr_fmms (t, y, y, x, x, MPFR_RNDN);
+      mpcb_set_fr (m, t, prec, mpfr_zero_p (t) ? 0 : 1);
+      mpcb_exp (m, m);
+      if (!imag) {
+         /* the product 2xy is exact */
+         mpfr_set_prec (mpc_realref (w), 2);
+         mpfr_set_ui (mpc_realref (w), 0, MPFR_RNDN);
+         mpfr_set_prec (mpc_imagref (w),
+                        mpfr_get_prec (x) + mpfr_get_prec (y) + 1);
+         mpfr_mul (mpc_imagref (w), x, y, MPFR_RNDN);
+         mpfr_mul_2ui (mpc_imagref (w), mpc_imagref (w), 1, MPFR_RNDN);
+         mpfr_neg (mpc_imagref (w), mpc_imagref (w), MPFR_RNDN);
+         mpcb_set_c (s, w, prec, 0, 0);
+         mpcb_exp (s, s);
+         mpcb_mul (u, u, s);
+         mpc_set_prec (w, prec);
+      }
+      mpfr_set_prec (t, 32);
+   }
+
+   if (method == ERF_SERIES || method == ERF_SERIES_EXP) {
+      /* h = 2 z u sum */
+      mpc_sqr (w, z, MPC_RNDNN);
+      mpfr_mul_2ui (last, last, 1, MPFR_RNDU);
+      ball_sum (s, w, method, ns, sum, last, prec);
+      mpcb_mul (h, zb, s);
+      mpcb_mul (h, h, u);
+      mpc_mul_2ui (h->c, h->c, 1, MPC_RNDNN);
+      ret = 0;
+      if (complement) {
+         mpcb_neg (h, h);
+         ret = 1;
+      }
+   }
+   else {
+      if (method == ERF_ASYMPT) {
+         /* h = u sum / z with w = -1 / (2 z^2) */
+         mpc_sqr (w, z, MPC_RNDNN);
+         mpc_mul_2ui (w, w, 1, MPC_RNDNN);
+         mpc_ui_div (w, 1, w, MPC_RNDNN);
+         mpc_neg (w, w, MPC_RNDNN);
+         if (imag) {
+            /* 2 |T_N| + 3 y^2 exp (-y^2 / 2) */
+            mpfr_mul_2ui (lasta, lasta, 1, MPFR_RNDU);
+            mpfr_sqr (t, y, MPFR_RNDD);
+            mpfr_div_2ui (t, t, 1, MPFR_RNDD);
+            mpfr_neg (t, t, MPFR_RNDU);
+            mpfr_exp (t, t, MPFR_RNDU);
+            mpfr_mul (t, t, y, MPFR_RNDU);
+            mpfr_mul (t, t, y, MPFR_RNDU);
+            mpfr_mul_ui (t, t, 3, MPFR_RNDU);
+            mpfr_add (lasta, lasta, t, MPFR_RNDU);
+         }
+         else
+            mpfr_mul (lasta, lasta, kappa, MPFR_RNDU);
+         ball_sum (s, w, ERF_ASYMPT, na, suma, lasta, prec);
+         mpcb_div (s, s, zb);
+      }
+      else
+         /* h = u f */
+         fraction (s, zb, kappa);
+      mpcb_mul (h, s, u);
+      /* erfc (z) = m h for x > 0, and erf (z) = -m h for x = 0 */
+      if (imag || !complement) {
+         mpcb_neg (h, h);
+         ret = !imag;
+      }
+      else
+         ret = 0;
+   }
+
+   mpc_clear (w);
+   mpcb_clear (zb);
+   mpcb_clear (s);
+   mpcb_clear (u);
+   mpfr_clear (aw);
+   mpfr_clear (sum);
+   mpfr_clear (last);
+   mpfr_clear (suma);
+   mpfr_clear (lasta);
+   mpfr_clear (kappa);
+   mpfr_clear (t);
+
+   return ret;
+}
+
+
+static mpfr_exp_t
+error_exp (mpcb_srcptr op)
+   /* Return an exponent e such that 2^e bounds the absolute error of both
+      parts of the centre of op, which has a finite and non-zero radius and
+      a non-zero centre. */
+{
+   mpfr_srcptr re = mpc_realref (op->c), im = mpc_imagref (op->c);
+   mpfr_exp_t e;
+
+   if (mpfr_zero_p (re))
+      e = mpfr_get_exp (im);
+   else if (mpfr_zero_p (im))
+      e = mpfr_get_exp (re);
+   else
+      e = MPC_MAX (mpfr_get_exp (re), mpfr_get_exp (im));
+   return 1 + e + mpcr_get_exp (op->r);
+}
+
+
+static int
+can_round_part (mpcb_srcptr op, int part, mpfr_prec_t prec, mpfr_rnd_t rnd)
+   /* Return true if rounding the real (if part is 0) or the imaginary
+      (otherwise) part of the centre of op to precision prec in direction
+      rnd yields the correctly rounded corresponding part of every element
+      of the ball, with a correct rounding direction value; this is
+      mpcb_can_round for a single part, which is of interest when the
+      other part is much smaller or not needed. */
+{
+   mpfr_srcptr x = (part ? mpc_imagref (op->c) : mpc_realref (op->c));
+
+   if (mpcr_inf_p (op->r) || mpfr_zero_p (x))
+      return 0;
+   else if (mpcr_zero_p (op->r))
+      return 1;
+
+   return mpfr_can_round (x, mpfr_get_exp (x) - error_exp (op),
+                          MPFR_RNDN, MPFR_RNDZ, prec + (rnd == MPFR_RNDN));
+}
+
+
+static int
+sign_known (mpcb_srcptr op, int part)
+   /* Return true if all elements of the ball op have real (if part is 0)
+      or imaginary (otherwise) parts of the same sign as the centre, which
+      is then non-zero. */
+{
+   mpfr_srcptr x = (part ? mpc_imagref (op->c) : mpc_realref (op->c));
+
+   if (mpcr_inf_p (op->r) || mpfr_zero_p (x))
+      return 0;
+   else if (mpcr_zero_p (op->r))
+      return 1;
+
+   return mpfr_get_exp (x) - 1 > error_exp (op);
+}
+
+
+static int
+erf_special (mpc_ptr rop, mpc_srcptr op, int complement)
+   /* Handle the case of a real or an imaginary part which is infinite or
+      NaN, the imaginary part being non-zero. */
+{
+   mpfr_srcptr x = mpc_realref (op), y = mpc_imagref (op);
+   int sx = (mpfr_signbit (x) != 0), sy = (mpfr_signbit (y) != 0);
+
+   if (mpfr_inf_p (x) && !mpfr_inf_p (y)) {
+      /* erf (z) tends to sign (x) when |x| tends to infinity and y is
+         bounded; the imaginary part is a zero of the sign of y for erf,
+         and +0 for y = NaN. */
+      if (complement)
+         mpfr_set_ui (mpc_realref (rop), sx ? 2 : 0, MPFR_RNDN);
+      else
+         mpfr_set_si (mpc_realref (rop), sx ? -1 : 1, MPFR_RNDN);
+      mpfr_set_zero (mpc_imagref (rop),
+                     (mpfr_nan_p (y) || complement == sy) ? 1 : -1);
+   }
+   else if (mpfr_zero_p (x) && !mpfr_number_p (y)) {
+      /* erf (i y) = i erfi (y) with erfi (+-inf) = +-inf */
+      if (complement) {
+         mpfr_set_ui (mpc_realref (rop), 1, MPFR_RNDN);
+         mpfr_neg (mpc_imagref (rop), y, MPFR_RNDN);
+      }
+      else {
+         mpfr_set_zero (mpc_realref (rop), sx ? -1 : 1);
+         mpfr_set (mpc_imagref (rop), y, MPFR_RNDN);
+      }
+   }
+   else
+      mpc_set_nan (rop);
+
+   return MPC_INEX (0, 0);
+}
+
+
+static int
+erf_aux (mpc_ptr rop, mpc_srcptr op, mpc_rnd_t rnd, int complement)
+{
+   mpcb_t m, h, g, f;
+   mpc_t z;
+   mpfr_prec_t prec;
+   long int c;
+   int neg, imag, sx, sy, ok, tiny, inex_re, inex_im, overflow, underflow;
+   int saved_underflow, saved_overflow;
+   mpfr_exp_t saved_emin, saved_emax;
+
+   if (mpfr_zero_p (mpc_imagref (op))) {
+      /* erf (x + 0i) = erf (x) + 0i and erfc (x + 0i) = erfc (x) - 0i */
+      sy = (mpfr_signbit (mpc_imagref (op)) != 0);
+      if (complement)
+         inex_re = mpfr_erfc (mpc_realref (rop), mpc_realref (op),
+                              MPC_RND_RE (rnd));
+      else
+         inex_re = mpfr_erf (mpc_realref (rop), mpc_realref (op),
+                             MPC_RND_RE (rnd));
+      mpfr_set_zero (mpc_imagref (rop), (complement == sy) ? 1 : -1);
+      return MPC_INEX (inex_re, 0);
+   }
+   else if (!mpfr_number_p (mpc_realref (op))
+            || !mpfr_number_p (mpc_imagref (op)))
+      return erf_special (rop, op, complement);
+
+   saved_emin = mpfr_get_emin ();
+   saved_emax = mpfr_get_emax ();
+   mpfr_set_emin (mpfr_get_emin_min ());
+   mpfr_set_emax (mpfr_get_emax_max ());
+   saved_underflow = mpfr_underflow_p ();
+   saved_overflow = mpfr_overflow_p ();
+
+   /* Reduce to x >= 0, with x = +0 for a purely imaginary argument. */
+   sx = mpfr_signbit (mpc_realref (op));
+   imag = mpfr_zero_p (mpc_realref (op));
+   neg = sx && !imag;
+   mpc_init3 (z, mpfr_get_prec (mpc_realref (op)),
+              mpfr_get_prec (mpc_imagref (op)));
+   if (neg)
+      mpc_neg (z, op, MPC_RNDNN);
+   else
+      mpc_set (z, op, MPC_RNDNN);
+   if (imag)
+      mpfr_set_zero (mpc_realref (z), 1);
+
+   mpcb_init (m);
+   mpcb_init (h);
+   mpcb_init (g);
+   mpcb_init (f);
+   prec = MPC_MAX_PREC (rop);
+   while (1) {
+      mpfr_clear_overflow ();
+      mpfr_clear_underflow ();
+      /* For a purely imaginary argument, the result is obtained from
+         erf (i y) = i erfi (y) and erfc (i y) = 1 - i erfi (y). */
+      c = erf_core (m, h, z, complement && !imag, prec);
+      if (neg) {
+         /* erf (z) = -erf (-z) and erfc (z) = 2 - erfc (-z) */
+         c = (complement ? 2 : 0) - c;
+         mpcb_neg (h, h);
+      }
+      overflow = mpfr_inf_p (mpc_realref (m->c));
+      underflow = mpfr_zero_p (mpc_realref (m->c));
+      tiny = 0;
+      if (overflow || underflow) {
+         /* Only the signs of the parts of h matter. */
+         if (sign_known (h, 1) && (imag || sign_known (h, 0)))
+            break;
+      }
+      else {
+         /* The parts of c + g are rounded separately, since c is real and
+            g may be much smaller than c. */
+         mpcb_mul (g, m, h);
+         ok = can_round_part (g, 1, MPC_PREC_IM (rop), MPC_RND_IM (rnd));
+         if (ok && !imag) {
+            if (c == 0)
+               ok = can_round_part (g, 0, MPC_PREC_RE (rop),
+                                    MPC_RND_RE (rnd));
+            else if (error_exp (g) - mpcr_get_exp (g->r)
+                     < - MPC_PREC_RE (rop) - 2) {
+               /* |g| < 2^(-prec-2), so that only its sign matters. */
+               tiny = 1;
+               ok = sign_known (g, 0);
+            }
+            else {
+               mpcb_set_ui_ui (f, (unsigned long int) (c < 0 ? -c : c), 0,
+                               MPC_MAX_PREC (g->c));
+               if (c < 0)
+                  mpcb_neg (f, f);
+               mpcb_add (f, f, g);
+               ok = can_round_part (f, 0, MPC_PREC_RE (rop),
+                                    MPC_RND_RE (rnd));
+            }
+         }
+         if (ok)
+            break;
+      }
+      prec += prec / 2;
+   }
+
+   if (overflow || underflow) {
+      /* The result overflows or underflows. */
+      mpfr_set_inf (mpc_realref (rop),
+                    mpfr_signbit (mpc_realref (h->c)) ? -1 : 1);
+      mpfr_set_inf (mpc_imagref (rop),
+                    mpfr_signbit (mpc_imagref (h->c)) ? -1 : 1);
+      if (imag) {
+         if (complement) {
+            mpfr_set_ui (mpc_realref (rop), 1, MPFR_RNDN);
+            mpfr_neg (mpc_imagref (rop), mpc_imagref (rop), MPFR_RNDN);
+         }
+         else
+            mpfr_set_zero (mpc_realref (rop), sx ? -1 : 1);
+         inex_re = 0;
+      }
+      else if (overflow)
+         inex_re = mpc_fix_inf (mpc_realref (rop), MPC_RND_RE (rnd));
+      else if (c == 0) {
+         mpfr_set_zero (mpc_realref (rop),
+                        mpfr_signbit (mpc_realref (h->c)) ? -1 : 1);
+         inex_re = mpc_fix_zero (mpc_realref (rop), MPC_RND_RE (rnd));
+      }
+      else
+         inex_re = mpc_set_si_tiny (mpc_realref (rop), c,
+            mpfr_signbit (mpc_realref (h->c)) ? -1 : 1, MPC_RND_RE (rnd));
+      if (overflow)
+         inex_im = mpc_fix_inf (mpc_imagref (rop), MPC_RND_IM (rnd));
+      else {
+         mpfr_set_zero (mpc_imagref (rop),
+                        mpfr_signbit (mpc_imagref (h->c)) ? -1 : 1);
+         inex_im = mpc_fix_zero (mpc_imagref (rop), MPC_RND_IM (rnd));
+      }
+   }
+   else {
+      if (imag && complement)
+         inex_im = mpfr_neg (mpc_imagref (rop), mpc_imagref (g->c),
+                             MPC_RND_IM (rnd));
+      else
+         inex_im = mpfr_set (mpc_imagref (rop), mpc_imagref (g->c),
+                             MPC_RND_IM (rnd));
+      if (imag) {
+         if (complement)
+            mpfr_set_ui (mpc_realref (rop), 1, MPFR_RNDN);
+         else
+            mpfr_set_zero (mpc_realref (rop), sx ? -1 : 1);
+         inex_re = 0;
+      }
+      else if (c == 0)
+         inex_re = mpfr_set (mpc_realref (rop), mpc_realref (g->c),
+                             MPC_RND_RE (rnd));
+      else if (tiny)
+         inex_re = mpc_set_si_tiny (mpc_realref (rop), c,
+            mpfr_signbit (mpc_realref (g->c)) ? -1 : 1, MPC_RND_RE (rnd));
+      else
+         inex_re = mpfr_set (mpc_realref (rop), mpc_realref (f->c),
+                             MPC_RND_RE (rnd));
+   }
+   mpc_clear (z);
+   mpcb_clear (m);
+   mpcb_clear (h);
+   mpcb_clear (g);
+   mpcb_clear (f);
+
+   /* Flags raised by intermediate computations are not meaningful. */
+   if (!overflow)
+      mpfr_clear_overflow ();
+   if (!underflow)
+      mpfr_clear_underflow ();
+   /* restore underflow and overflow flags from MPFR */
+   if (saved_underflow)
+      mpfr_set_underflow ();
+   if (saved_overflow)
+      mpfr_set_overflow ();
+
+   /* restore the exponent range, and check the range of results */
+   mpfr_set_emin (saved_emin);
+   mpfr_set_emax (saved_emax);
+   inex_re = mpfr_check_range (mpc_realref (rop), inex_re, MPC_RND_RE (rnd));
+   inex_im = mpfr_check_range (mpc_imagref (rop), inex_im, MPC_RND_IM (rnd));
+
+   return MPC_INEX (inex_re, inex_im);
+}
+
+
+int
+mpc_erf (mpc_ptr rop, mpc_srcptr op, mpc_rnd_t rnd)
+{
+   MPC_STATS_FUNC (erf, MPC_MAX_PREC (rop))
+   return erf_aux (rop, op, rnd, 0);
+}
+
+
+int
+mpc_erfc (mpc_ptr rop, mpc_srcptr op, mpc_rnd_t rnd)
+{
+   MPC_STATS_FUNC (erfc, MPC_MAX_PREC (rop))
+   return erf_aux (rop, op, rnd, 1);
+}
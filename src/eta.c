@@ -1,6 +1,7 @@
-/* eta -- Functions for computing the Dedekind eta function
+/* eta -- Functions for computing the Dedekind eta function and related
+   modular functions
 
-Copyright (C) 2022, 2024 INRIA
+Copyright (C) 2022, 2024, 2025 INRIA
 
 This file is part of GNU MPC.
 
@@ -18,53 +19,152 @@ You should have received a copy of the GNU Lesser General Public License
 along with this program. If not, see http://www.gnu.org/licenses/ .
 */
 
-#include <limits.h> /* for CHAR_BIT */
+#include <stdio.h> /* for MPC_ASSERT */
 #include "mpc-impl.h"
 
 static void
-eta_series (mpcb_ptr eta, mpcb_srcptr q, mpfr_exp_t expq, int N)
-   /* Evaluate 2N+1 terms of the Dedekind eta function without the q^(1/24)
-      factor (where internally N is taken to be at least 1).
-      expq is an upper bound on the exponent of |q|, valid everywhere
-      inside the ball; for the error analysis to hold the function assumes
-      that expq < -1, which implies |q| < 1/4. */
+pentagonal_sequence (int *op, int *a, int *b, const unsigned long int *e,
+   int from, int K)
+   /* Given the K >= 2 first generalised pentagonal numbers
+      e [0..K-1] = 1, 2, 5, 7, 12, 15, ... in increasing order, compute an
+      addition sequence for them: for from <= i < K, where from >= 2,
+      e [i] = e [a [i]] + e [b [i]] if op [i] = 0, and
+      e [i] = 2 * e [a [i]] + e [b [i]] if op [i] = 1, with a [i], b [i] < i.
+      Sums are preferred, since they cost one multiplication instead of
+      a squaring and a multiplication; among them, the operands are chosen
+      as large as possible, so that small powers may be freed early.
+      By [Enge, Hart, Johansson 2018, "Short addition sequences for theta
+      functions"], one of the two decompositions always exists; op [i] = 2
+      signals a failure nevertheless, so that the caller can fall back to
+      a generic exponentiation. */
 {
-   const mpfr_prec_t p = mpcb_get_prec (q);
-   mpcb_t q2, qn, q2n1, q3nm1, q3np1;
-   int M, n;
-   mpcr_t r, r2;
+   int i, j, k, lo, hi, mid;
+   unsigned long int r;
 
-   mpcb_init (q2);
-   mpcb_init (qn);
-   mpcb_init (q2n1);
-   mpcb_init (q3nm1);
-   mpcb_init (q3np1);
+   for (i = from; i < K; i++) {
+      op [i] = 2;
+      /* e [j] + e [k] with j <= k < i, with a maximal smaller operand j */
+      j = 0;
+      k = i - 1;
+      while (j <= k)
+         if (e [j] + e [k] < e [i])
+            j++;
+         else if (e [j] + e [k] > e [i])
+            k--;
+         else {
+            op [i] = 0;
+            a [i] = k;
+            b [i] = j;
+            j++;
+         }
+      if (op [i] == 0)
+         continue;
+      /* 2 * e [j] + e [k] with e [k] found by binary search */
+      for (j = 0; j < i && 2 * e [j] < e [i]; j++) {
+         r = e [i] - 2 * e [j];
+         lo = 0;
+         hi = i - 1;
+         while (lo < hi) {
+            mid = (lo + hi) / 2;
+            if (e [mid] < r)
+               lo = mid + 1;
+            else
+               hi = mid;
+         }
+         if (e [lo] == r
+             && (op [i] == 2 || MPC_MIN (j, lo) > MPC_MIN (a [i], b [i]))) {
+            op [i] = 1;
+            a [i] = j;
+            b [i] = lo;
+         }
+      }
+   }
+}
 
-   mpcb_sqr (q2, q);
 
-   /* n = 0 */
-   mpcb_set_ui_ui (eta, 1, 0, p);
+/* Data that may be shared between evaluations of eta, for instance
+   between the elements of a batch handled by the same thread: the addition
+   sequence for the exponents of the series and the constant i*pi/12. */
+typedef struct {
+   int K;                  /* number of exponents */
+   unsigned long int *e;   /* generalised pentagonal numbers */
+   int *op, *a, *b;        /* addition sequence, see pentagonal_sequence */
+   int *last;              /* scratch space for eta_series */
+   mpcb_t pi12;            /* i*pi/12 if pi12_prec > 0 */
+   mpfr_prec_t pi12_prec;
+} eta_cache_struct;
 
-   /* n = 1 */
-   mpcb_set (qn, q); /* q^n */
-   mpcb_neg (q2n1, q); /* -q^(2n-1) */
-   mpcb_neg (q3nm1, q); /* +- q^((3n-1)*n/2) */
-   mpcb_neg (q3np1, q2); /* +- q^(3n+1)*n/2) */
-   mpcb_add (eta, eta, q3nm1);
-   mpcb_add (eta, eta, q3np1);
+typedef eta_cache_struct eta_cache_t [1];
+typedef eta_cache_struct *eta_cache_ptr;
 
-   N = MPC_MAX (1, N);
-   for (n = 2; n <= N; n++) {
-      mpcb_mul (qn, qn, q);
-      mpcb_mul (q2n1, q2n1, q2);
-      mpcb_mul (q3nm1, q3np1, q2n1);
-      mpcb_mul (q3np1, q3nm1, qn);
-      mpcb_add (eta, eta, q3nm1);
-      mpcb_add (eta, eta, q3np1);
+
+static void
+eta_cache_init (eta_cache_t cache)
+{
+   cache->K = 0;
+   cache->e = NULL;
+   cache->op = NULL;
+   cache->a = NULL;
+   cache->b = NULL;
+   cache->last = NULL;
+   mpcb_init (cache->pi12);
+   cache->pi12_prec = 0;
+}
+
+
+static void
+eta_cache_clear (eta_cache_t cache)
+{
+   free (cache->e);
+   free (cache->op);
+   free (cache->a);
+   free (cache->b);
+   free (cache->last);
+   mpcb_clear (cache->pi12);
+}
+
+
+static void
+eta_cache_reserve (eta_cache_t cache, int K)
+   /* Make sure that cache contains the addition sequence for at least
+      K >= 2 exponents. Since the decomposition of an exponent depends only
+      on the smaller ones, the sequence is extended and serves as well for
+      any smaller number of terms. */
+{
+   int n, k;
+
+   if (K <= cache->K)
+      return;
+
+   k = cache->K;
+   K = MPC_MAX (K, 2 * cache->K);
+   cache->e = (unsigned long int *)
+      realloc (cache->e, K * sizeof (unsigned long int));
+   cache->op = (int *) realloc (cache->op, K * sizeof (int));
+   cache->a = (int *) realloc (cache->a, K * sizeof (int));
+   cache->b = (int *) realloc (cache->b, K * sizeof (int));
+   cache->last = (int *) realloc (cache->last, K * sizeof (int));
+   MPC_ASSERT (cache->e != NULL && cache->op != NULL && cache->a != NULL
+               && cache->b != NULL && cache->last != NULL);
+   for (n = 1; n <= K / 2; n++) {
+      cache->e [2*n-2] = (unsigned long int) ((3*n-1) * n / 2);
+      cache->e [2*n-1] = (unsigned long int) ((3*n+1) * n / 2);
    }
+   pentagonal_sequence (cache->op, cache->a, cache->b, cache->e,
+      MPC_MAX (k, 2), K);
+   cache->K = K;
+}
+
+
+static void
+eta_truncation (mpcb_ptr eta, int N, mpfr_exp_t expq)
+   /* Add to eta the relative error due to the truncation of the series
+      after 2N+1 terms, as explained in algorithms.tex, where expq < -1 is
+      an upper bound on the exponent of |q|. */
+{
+   int M;
+   mpcr_t r, r2;
 
-   /* Compute the relative error due to the truncation of the series
-      as explained in algorithms.tex. */
    M = (3 * (N+1) - 1) * (N+1) / 2;
    mpcr_set_one (r);
    mpcr_div_2ui (r, r, (unsigned long int) (- (M * expq + 1)));
@@ -73,17 +173,152 @@ eta_series (mpcb_ptr eta, mpcb_srcptr q, mpfr_exp_t expq, int N)
    mpcr_mul (r2, r, eta->r);
    mpcr_add (eta->r, eta->r, r);
    mpcr_add (eta->r, eta->r, r2);
+}
 
-   mpcb_clear (q2);
-   mpcb_clear (qn);
-   mpcb_clear (q2n1);
-   mpcb_clear (q3nm1);
-   mpcb_clear (q3np1);
+
+static void
+eta_series (mpcb_ptr eta, mpcb_ptr eta2, mpcb_srcptr q, mpfr_exp_t expq,
+   int N, int N2, eta_cache_t cache)
+   /* Evaluate 2N+1 terms of the Dedekind eta function without the q^(1/24)
+      factor (where internally N is taken to be at least 1).
+      expq is an upper bound on the exponent of |q|, valid everywhere
+      inside the ball; for the error analysis to hold the function assumes
+      that expq < -1, which implies |q| < 1/4.
+      The terms are the powers of q with the generalised pentagonal
+      numbers as exponents; they are computed by an addition sequence
+      with about 1.15 multiplications per term instead of 2, and each
+      power is freed after its last use in the sequence.
+      The addition sequence is taken from cache.
+      If eta2 is not NULL, then 2*N2+1 terms of the same series in q^2,
+      that is, of eta (2z) without the q^(1/12) factor, are evaluated as
+      well and stored in eta2, where 1 <= N2 <= N is assumed; their
+      powers of q^2 are the squares of those of q. */
+{
+   const mpfr_prec_t p = mpcb_get_prec (q);
+   mpcb_t *pw, s, s2;
+   const unsigned long int *e;
+   const int *op, *a, *b;
+   int *last;
+   int K, K2, i, j;
+
+   N = MPC_MAX (1, N);
+   K = 2 * N;
+   K2 = (eta2 == NULL ? 0 : 2 * N2);
+   eta_cache_reserve (cache, K);
+   e = cache->e;
+   op = cache->op;
+   a = cache->a;
+   b = cache->b;
+   last = cache->last;
+   pw = (mpcb_t *) malloc (K * sizeof (mpcb_t));
+   MPC_ASSERT (pw != NULL);
+
+   for (i = 0; i < K; i++)
+      last [i] = i;
+   for (i = 2; i < K; i++)
+      if (op [i] != 2) {
+         last [a [i]] = i;
+         last [b [i]] = i;
+      }
+
+   /* The terms with odd n are summed up in s, and subtracted in the end;
+      the same holds for s2 and eta2. */
+   mpcb_set_ui_ui (eta, 1, 0, p);
+   mpcb_init (s);
+   if (K2 > 0) {
+      mpcb_set_ui_ui (eta2, 1, 0, p);
+      mpcb_init (s2);
+   }
+   for (i = 0; i < K; i++) {
+      mpcb_init (pw [i]);
+      if (i == 0)
+         mpcb_set (pw [0], q);
+      else if (i == 1)
+         mpcb_sqr (pw [1], q);
+      else if (op [i] == 0 && a [i] == b [i])
+         mpcb_sqr (pw [i], pw [a [i]]);
+      else if (op [i] == 0)
+         mpcb_mul (pw [i], pw [a [i]], pw [b [i]]);
+      else if (op [i] == 1) {
+         mpcb_sqr (pw [i], pw [a [i]]);
+         mpcb_mul (pw [i], pw [i], pw [b [i]]);
+      }
+      else
+         mpcb_pow_ui (pw [i], q, e [i]);
+
+      /* pw [i] belongs to the term n = i/2 + 1. */
+      if (i == 0)
+         mpcb_set (s, pw [0]);
+      else if ((i / 2) % 2 == 0)
+         mpcb_add (s, s, pw [i]);
+      else
+         mpcb_add (eta, eta, pw [i]);
+      if (i < K2) {
+         /* The squares are accumulated with a fused operation. */
+         if (i == 0)
+            mpcb_sqr (s2, pw [0]);
+         else if ((i / 2) % 2 == 0)
+            mpcb_addmul (s2, pw [i], pw [i]);
+         else
+            mpcb_addmul (eta2, pw [i], pw [i]);
+      }
+
+      for (j = 0; j <= i; j++)
+         if (last [j] == i)
+            mpcb_clear (pw [j]);
+   }
+   mpcb_sub (eta, eta, s);
+   eta_truncation (eta, N, expq);
+   if (K2 > 0) {
+      mpcb_sub (eta2, eta2, s2);
+      eta_truncation (eta2, N2, 2 * expq);
+      mpcb_clear (s2);
+   }
+
+   mpcb_clear (s);
+   free (pw);
+}
+
+
+static int
+eta_terms (mpfr_prec_t prec, mpfr_exp_t expq)
+   /* Return an approximate N such that (3*N+1)*N/2 * |expq| > prec, so
+      that 2N+1 terms of the eta series in q with Exp (|q|) <= expq < -1
+      yield a relative error of about 2^(-prec). */
+{
+   int N, target;
+
+   target = (2 * prec) / (3 * (-expq)) + 1;
+   for (N = 2; N * N <= target; N += N / 2);
+
+   return N;
+}
+
+
+static mpfr_exp_t
+eta_expq (mpcb_srcptr q)
+   /* Return an upper bound on the exponent of |q| valid in the ball q,
+      or 0 if it cannot be determined to be less than -1. */
+{
+   mpfr_exp_t expq;
+
+   /* Writing q as having the centre x+i*y and the radius r, we have
+      |q| =  sqrt (x^2+y^2) |1+\theta| with |theta| <= r
+          <= (1 + r) \sqrt 2 max (|x|, |y|)
+          <  2^{max (Exp x, Exp y) + 1}
+      assuming that r < sqrt 2 - 1, which is the case for r < 1/4
+      or Exp r < -1.
+      Then Exp (|q|) <= max (Exp x, Exp y) + 1. */
+   if (mpcr_inf_p (q->r) || mpcr_get_exp (q->r) >= -1)
+      return 0;
+   expq = MPC_MAX (mpfr_get_exp (mpc_realref (q->c)),
+                   mpfr_get_exp (mpc_imagref (q->c))) + 1;
+   return (expq >= -1 ? 0 : expq);
 }
 
 
 static void
-mpcb_eta_q24 (mpcb_ptr eta, mpcb_srcptr q24)
+mpcb_eta_q24 (mpcb_ptr eta, mpcb_srcptr q24, eta_cache_t cache)
    /* Assuming that q24 is a ball containing
       q^{1/24} = exp (2 * pi * i * z / 24) for z in the fundamental domain,
       the function computes eta (z).
@@ -92,136 +327,115 @@ mpcb_eta_q24 (mpcb_ptr eta, mpcb_srcptr q24)
 {
    mpcb_t q;
    mpfr_exp_t expq;
-   int N, target;
 
    mpcb_init (q);
 
    mpcb_pow_ui (q, q24, 24);
-
-   /* We need an upper bound on the exponent of |q|. Writing q as having
-      the centre x+i*y and the radius r, we have
-      |q| =  sqrt (x^2+y^2) |1+\theta| with |theta| <= r
-          <= (1 + r) \sqrt 2 max (|x|, |y|)
-          <  2^{max (Exp x, Exp y) + 1}
-      assuming that r < sqrt 2 - 1, which is the case for r < 1/4
-      or Exp r < -1.
-      Then Exp (|q|) <= max (Exp x, Exp y) + 1. */
-   if (mpcr_inf_p (q->r) || mpcr_get_exp (q->r) >= -1)
+   expq = eta_expq (q);
+   if (expq == 0)
       mpcb_set_inf (eta);
    else {
-      expq = MPC_MAX (mpfr_get_exp (mpc_realref (q->c)),
-                      mpfr_get_exp (mpc_imagref (q->c))) + 1;
-      if (expq >= -1)
-         mpcb_set_inf (eta);
-      else {
-         /* Compute an approximate N such that
-            (3*N+1)*N/2 * |expq| > prec. */
-         target = (2 * mpcb_get_prec (q24)) / (3 * (-expq)) + 1;
-         for (N = 2; N * N <= target; N += N / 2);
-         eta_series (eta, q, expq, N);
-         mpcb_mul (eta, eta, q24);
-      }
+      eta_series (eta, NULL, q, expq,
+         eta_terms (mpcb_get_prec (q24), expq), 0, cache);
+      mpcb_mul (eta, eta, q24);
    }
 
    mpcb_clear (q);
 }
 
 
+static void
+q24_from_ball (mpcb_ptr q24, mpcb_srcptr zb, eta_cache_t cache)
+   /* Given a ball zb, compute q24 = exp (pi*i*zb/12) at the precision
+      of zb. The ball containing i*pi/12 is kept in cache for the next
+      call at the same precision. */
+{
+   const mpfr_prec_t p = mpcb_get_prec (zb);
+   mpc_t ipi;
+   mpcb_t twelve;
+
+   if (cache->pi12_prec != p) {
+      mpc_init2 (ipi, p);
+      mpcb_init (twelve);
+      mpfr_set_ui (mpc_realref (ipi), 0, MPFR_RNDN);
+      mpfr_const_pi (mpc_imagref (ipi), MPFR_RNDN);
+      mpcb_set_c (cache->pi12, ipi, p, 0, 1);
+      mpcb_set_ui_ui (twelve, 12, 0, p);
+      mpcb_div (cache->pi12, cache->pi12, twelve);
+      cache->pi12_prec = p;
+      mpc_clear (ipi);
+      mpcb_clear (twelve);
+   }
+
+   mpcb_mul (q24, zb, cache->pi12);
+   mpcb_exp (q24, q24);
+}
+
+
+static int
+q24_domain_p (mpc_srcptr z)
+   /* Return true if z = x+i*y satisfies |x|<=5/8 and y>=1/2, the domain
+      in which q24_from_z works. */
+{
+   return (   mpfr_cmp_d (mpc_realref (z),  0.625) <= 0
+           && mpfr_cmp_d (mpc_realref (z), -0.625) >= 0
+           && mpfr_cmp_d (mpc_imagref (z), 0.5) >= 0);
+}
+
+
 static void
 q24_from_z (mpcb_ptr q24, mpc_srcptr z, unsigned long int err_re,
-   unsigned long int err_im)
+   unsigned long int err_im, eta_cache_t cache)
    /* Given z=x+i*y, compute q24 = exp (pi*i*z/12).
-      err_re and err_im are a priori errors (in 1/2 ulp) of x and y,
-      respectively; they can be 0 if a part is exact. In particular we
-      need err_re=0 when x=0.
+      err_re and err_im are a priori errors of x and y, respectively,
+      in 1/2 ulp at the working precision as for mpcb_set_c; they can be
+      0 if a part is exact. In particular we need err_re=0 when x=0.
       The function requires and checks that |x|<=5/8 and y>=1/2.
-      Moreover if err_im != 0, it assumes (but cannot check, so this must be
-      assured by the caller) that y is a lower bound on the correct value.
-      The algorithm is taken from algorithms.tex.
-      The precision of q24 is computed from z with a little extra so that
-      the series has a good chance of being rounded to the precision of z. */
+      The computation is carried out in ball arithmetic at a precision
+      computed from z with a little extra so that the series has a good
+      chance of being rounded to the precision of z. */
 {
    const mpfr_prec_t pz = MPC_MAX_PREC (z);
    int xzero;
-   long int Y, err_a, err_b;
-   mpfr_prec_t p, min;
-   mpfr_t pi, u, v, t, r, s;
-   mpc_t q24c;
+   mpfr_prec_t p;
+   mpc_t zp;
+   mpcb_t zb;
 
    xzero = mpfr_zero_p (mpc_realref (z));
-   if (   mpfr_cmp_d  (mpc_realref (z),  0.625) > 0
-       || mpfr_cmp_d  (mpc_realref (z), -0.625) < 0
-       || mpfr_cmp_d (mpc_imagref (z), 0.5) < 0
-       || (xzero && err_re > 0))
+   if (!q24_domain_p (z) || (xzero && err_re > 0))
        mpcb_set_inf (q24);
    else {
       /* Experiments seem to imply that it is enough to add 20 bits to the
          target precision; to be on the safe side, we also add 1%. */
       p = pz * 101 / 100 + 20;
-      /* We need 2^p >= 240 + 66 k_x = 240 + 33 err_re. */
-      if (p < (mpfr_prec_t) (CHAR_BIT * sizeof (mpfr_prec_t))) {
-         min = (240 + 33 * err_re) >> p;
-         while (min > 0) {
-            p++;
-            min >>= 1;
-         }
-      }
 
-      mpfr_init2 (pi, p);
-      mpfr_init2 (u, p);
-      mpfr_init2 (v, p);
-      mpfr_init2 (t, p);
-      mpfr_init2 (r, p);
-      mpfr_init2 (s, p);
-      mpc_init2 (q24c, p);
-
-      mpfr_const_pi (pi, MPFR_RNDD);
-      mpfr_div_ui (pi, pi, 12, MPFR_RNDD);
-      mpfr_mul (u, mpc_imagref (z), pi, MPFR_RNDD);
-      mpfr_neg (u, u, MPFR_RNDU);
-      mpfr_mul (v, mpc_realref (z), pi, MPFR_RNDN);
-      mpfr_exp (t, u, MPFR_RNDU);
-      if (xzero) {
-         mpfr_set (mpc_realref (q24c), t, MPFR_RNDN);
-         mpfr_set_ui (mpc_imagref (q24c), 0, MPFR_RNDN);
-      }
-      else {
-         /* Unfortunately we cannot round in two different directions with
-            mpfr_sin_cos. */
-         mpfr_cos (r, v, MPFR_RNDZ);
-         mpfr_sin (s, v, MPFR_RNDA);
-         mpfr_mul (mpc_realref (q24c), t, r, MPFR_RNDN);
-         mpfr_mul (mpc_imagref (q24c), t, s, MPFR_RNDN);
-      }
-      Y = mpfr_get_exp (mpc_imagref (z));
-      if (xzero) {
-         Y = (224 + 33 * err_im + 63) / 64 << Y;
-         err_a = Y + 1;
-         err_b = 0;
-      }
-      else {
-         if (Y >= 2)
-            Y = (32 + 5 * err_im) << (Y - 2);
-         else if (Y == 1)
-            Y = 16 + (5 * err_im + 1) / 2;
-         else /* Y == 0 */
-            Y = 8 + (5 * err_im + 3) / 4;
-         err_a = Y + 9 + err_re;
-         err_b = Y + (67 + 9 * err_re + 1) / 2;
-      }
-      mpcb_set_c (q24, q24c, p, err_a, err_b);
-
-      mpfr_clear (pi);
-      mpfr_clear (u);
-      mpfr_clear (v);
-      mpfr_clear (t);
-      mpfr_clear (r);
-      mpfr_clear (s);
-      mpc_clear (q24c);
+      mpc_init2 (zp, p);
+      mpcb_init (zb);
+      mpc_set (zp, z, MPC_RNDNN); /* exact */
+      mpcb_set_c (zb, zp, p, err_re, err_im);
+      q24_from_ball (q24, zb, cache);
+      mpc_clear (zp);
+      mpcb_clear (zb);
    }
 }
 
 
+static void
+eta_err_cache (mpcb_ptr eta, mpc_srcptr z, unsigned long int err_re,
+   unsigned long int err_im, eta_cache_t cache)
+   /* The same as mpcb_eta_err, with shared data taken from cache. */
+{
+   mpcb_t q24;
+
+   mpcb_init (q24);
+
+   q24_from_z (q24, z, err_re, err_im, cache);
+   mpcb_eta_q24 (eta, q24, cache);
+
+   mpcb_clear (q24);
+}
+
+
 void
 mpcb_eta_err (mpcb_ptr eta, mpc_srcptr z, unsigned long int err_re,
    unsigned long int err_im)
@@ -230,19 +444,54 @@ mpcb_eta_err (mpcb_ptr eta, mpc_srcptr z, unsigned long int err_re,
       respectively; they can be 0 if a part is exact. In particular we
       need err_re=0 when x=0.
       The function requires (and checks through the call to q24_from_z)
-      that |x|<=5/8 and y>=1/2.
-      Moreover if err_im != 0, it assumes (but cannot check, so this must
-      be assured by the caller) that y is a lower bound on the correct
-      value. */
+      that |x|<=5/8 and y>=1/2. */
 {
-   mpcb_t q24;
+   eta_cache_t cache;
 
-   mpcb_init (q24);
+   eta_cache_init (cache);
+   eta_err_cache (eta, z, err_re, err_im, cache);
+   eta_cache_clear (cache);
+}
 
-   q24_from_z (q24, z, err_re, err_im);
-   mpcb_eta_q24 (eta, q24);
 
-   mpcb_clear (q24);
+typedef struct {
+   mpc_srcptr z;
+   eta_cache_ptr cache;
+} eta_fund_data_t;
+
+
+static int
+eta_fund_ball (mpcb_ptr eta, mpfr_prec_t prec, const void *data)
+   /* Evaluation function for mpcb_ziv, where data points to an
+      eta_fund_data_t containing the argument z of mpc_eta_fund and the
+      cache to be used. Outside the domain of q24_from_z, the function
+      reports failure. */
+{
+   const eta_fund_data_t *d = (const eta_fund_data_t *) data;
+   mpc_t zl;
+
+   if (!q24_domain_p (d->z))
+      return 1;
+
+   mpc_init2 (zl, MPC_MAX (prec, MPC_MAX_PREC (d->z)));
+   mpc_set (zl, d->z, MPC_RNDNN); /* exact */
+   eta_err_cache (eta, zl, 0, 0, d->cache);
+   mpc_clear (zl);
+
+   return 0;
+}
+
+
+static int
+eta_fund_cache (mpc_ptr rop, mpc_srcptr z, mpc_rnd_t rnd,
+   eta_cache_t cache)
+{
+   eta_fund_data_t d;
+
+   d.z = z;
+   d.cache = cache;
+   return mpcb_ziv (rop, eta_fund_ball, &d, NULL,
+      mpfr_zero_p (mpc_realref (z)), rnd);
 }
 
 
@@ -250,62 +499,952 @@ int
 mpc_eta_fund (mpc_ptr rop, mpc_srcptr z, mpc_rnd_t rnd)
    /* Given z in the fundamental domain for Sl_2 (Z), that is,
       |Re z| <= 1/2 and |z| >= 1, compute Dedekind eta (z).
-      Outside the fundamental domain, the function may loop
-      indefinitely. */
+      For purely imaginary z, the result is real.
+      Outside the fundamental domain, the function is slower; if
+      |Re z| > 5/8 or Im z < 1/2, the result is NaN. */
 {
-   mpfr_prec_t prec;
-   mpc_t zl;
-   mpcb_t eta;
-   int xzero, ok, inex;
+   MPC_STATS_FUNC (eta_fund, MPC_MAX_PREC (rop))
+   eta_cache_t cache;
+   int inex;
 
-   mpc_init2 (zl, 2);
-   mpcb_init (eta);
+   eta_cache_init (cache);
+   inex = eta_fund_cache (rop, z, rnd, cache);
+   eta_cache_clear (cache);
 
-   xzero = mpfr_zero_p (mpc_realref (z));
-   prec = MPC_MAX (MPC_MAX_PREC (rop), MPC_MAX_PREC (z));
-   do {
-      mpc_set_prec (zl, prec);
-      mpc_set (zl, z, MPC_RNDNN); /* exact */
-      mpcb_eta_err (eta, zl, 0, 0);
+   return inex;
+}
 
-      if (!xzero)
-         ok = mpcb_can_round (eta, MPC_PREC_RE (rop), MPC_PREC_IM (rop),
-            rnd);
-      else {
-         /* TODO: The result is real, so the ball contains part of the
-            imaginary axis, and rounding to a complex number is impossible
-            independently of the precision.
-            It would be best to project to a real interval and to decide
-            whether we can round. Lacking such functionality, we add
-            the non-representable number 0.1*I (in ball arithmetic) and
-            check whether rounding is possible then. */
-         mpc_t fuzz;
-         mpcb_t fuzzb;
-         mpc_init2 (fuzz, prec);
-         mpcb_init (fuzzb);
-         mpc_set_ui_ui (fuzz, 0, 1, MPC_RNDNN);
-         mpc_div_ui (fuzz, fuzz, 10, MPC_RNDNN);
-         mpcb_set_c (fuzzb, fuzz, prec, 0, 1);
-         ok = mpfr_zero_p (mpc_imagref (eta->c));
-         mpcb_add (eta, eta, fuzzb);
-         ok &= mpcb_can_round (eta, MPC_PREC_RE (rop), 2, rnd);
-         mpc_clear (fuzz);
-         mpcb_clear (fuzzb);
+
+static int
+eta_reduce (mpz_t a, mpz_t b, mpz_t c, mpz_t d, mpc_srcptr z)
+   /* Given z with positive imaginary part, compute a matrix
+      gamma = (a b; c d) in Sl_2 (Z) such that gamma z = (a*z+b)/(c*z+d)
+      lies close to the fundamental domain, with c > 0, or c = 0 and
+      a = d = 1.
+      The reduction is carried out with floating point approximations
+      and may thus be slightly off; but it is checked that the imaginary
+      part of gamma z is at least 3/4, so that the q-series converges
+      quickly in it. The function returns 1 if gamma is the identity,
+      and 0 otherwise. */
+{
+   mpfr_exp_t ex, ey;
+   mpfr_prec_t p;
+   mpfr_t x, y, n, t;
+   mpz_t k;
+   int ok;
+
+   ex = (mpfr_zero_p (mpc_realref (z)) ? 0 : mpfr_get_exp (mpc_realref (z)));
+   ey = mpfr_get_exp (mpc_imagref (z));
+   /* The entries of gamma are of the order of |z| / sqrt (Im z), so that
+      about 2*ex - ey bits cancel when computing gamma z. */
+   p = 64 + 2 * (2 * MPC_MAX (MPC_MAX (ex, ey), 0) + MPC_MAX (-ey, 0));
+   mpfr_inits2 (p, x, y, n, t, (mpfr_ptr) 0);
+   mpz_init (k);
+
+   do {
+      mpfr_set (x, mpc_realref (z), MPFR_RNDN);
+      mpfr_set (y, mpc_imagref (z), MPFR_RNDN);
+      mpz_set_ui (a, 1);
+      mpz_set_ui (b, 0);
+      mpz_set_ui (c, 0);
+      mpz_set_ui (d, 1);
+      while (1) {
+         /* Translate by -k, that is, multiply gamma by (1 -k; 0 1). */
+         mpfr_get_z (k, x, MPFR_RNDN);
+         mpfr_sub_z (x, x, k, MPFR_RNDN);
+         mpz_submul (a, k, c);
+         mpz_submul (b, k, d);
+         /* Invert if |x+i*y| < 1, that is, multiply by (0 -1; 1 0); the
+            slack ensures termination in spite of rounding errors. */
+         mpfr_sqr (n, x, MPFR_RNDN);
+         mpfr_sqr (t, y, MPFR_RNDN);
+         mpfr_add (n, n, t, MPFR_RNDN);
+         if (mpfr_cmp_d (n, 0.99) >= 0)
+            break;
+         mpfr_div (x, x, n, MPFR_RNDN);
+         mpfr_neg (x, x, MPFR_RNDN);
+         mpfr_div (y, y, n, MPFR_RNDN);
+         mpz_swap (a, c);
+         mpz_swap (b, d);
+         mpz_neg (a, a);
+         mpz_neg (b, b);
+      }
+      if (mpz_sgn (c) < 0 || (mpz_sgn (c) == 0 && mpz_sgn (d) < 0)) {
+         mpz_neg (a, a);
+         mpz_neg (b, b);
+         mpz_neg (c, c);
+         mpz_neg (d, d);
       }
 
-      prec += 20;
+      /* Check that Im (gamma z) = y / |c*z+d|^2 >= 3/4, with y and
+         |c*z+d|^2 computed from z at precision p; otherwise start over
+         with a higher precision. */
+      mpfr_mul_z (x, mpc_realref (z), c, MPFR_RNDN);
+      mpfr_add_z (x, x, d, MPFR_RNDN);
+      mpfr_sqr (x, x, MPFR_RNDN);
+      mpfr_mul_z (t, mpc_imagref (z), c, MPFR_RNDN);
+      mpfr_sqr (t, t, MPFR_RNDN);
+      mpfr_add (n, x, t, MPFR_RNDN);
+      mpfr_div (y, mpc_imagref (z), n, MPFR_RNDN);
+      ok = (mpfr_cmp_d (y, 0.75) >= 0);
+      if (!ok) {
+         p *= 2;
+         mpfr_set_prec (x, p);
+         mpfr_set_prec (y, p);
+         mpfr_set_prec (n, p);
+         mpfr_set_prec (t, p);
+      }
    } while (!ok);
 
-   if (!xzero)
-      inex = mpcb_round (rop, eta, rnd);
+   mpfr_clears (x, y, n, t, (mpfr_ptr) 0);
+   mpz_clear (k);
+
+   return (mpz_sgn (b) == 0 && mpz_sgn (c) == 0);
+}
+
+
+static int
+eta_multiplier (mpz_srcptr a, mpz_srcptr b, mpz_srcptr c, mpz_srcptr d)
+   /* Given gamma = (a b; c d) in Sl_2 (Z) with c > 0, or c = 0 and
+      a = d = 1, return the k with 0 <= k < 24 such that
+      eta (gamma z) = exp (pi*i*k/12) * sqrt (-i*(c*z+d)) * eta (z)
+      if c > 0, and eta (gamma z) = exp (pi*i*k/12) * eta (z) if c = 0.
+      For c > 0, these are the formulae of [Knopp 1970, "Modular functions
+      in analytic number theory", Chapter 4, Theorem 2] with the Jacobi
+      symbol written as a power of exp (pi*i), and up to a factor of
+      exp (pi*i/4) coming from the different normalisation of the square
+      root. */
+{
+   long int aa, bb, cc, dd, k;
+
+   bb = (long int) mpz_fdiv_ui (b, 24);
+   if (mpz_sgn (c) == 0)
+      return (int) bb;
+
+   aa = (long int) mpz_fdiv_ui (a, 24);
+   cc = (long int) mpz_fdiv_ui (c, 24);
+   dd = (long int) mpz_fdiv_ui (d, 24);
+   k = (aa + dd) * cc - (bb * dd % 24) * ((cc * cc - 1) % 24);
+   if (mpz_odd_p (c)) {
+      k += 3 - 3 * cc;
+      if (mpz_jacobi (d, c) < 0)
+         k += 12;
+   }
+   else {
+      /* Since a*d - b*c = 1, d is odd; for c > 0 the Kronecker symbol
+         (c/d) equals the Jacobi symbol (c/|d|). */
+      k += 3 * dd - 3 * cc * dd;
+      if (mpz_kronecker (c, d) < 0)
+         k += 12;
+   }
+   k %= 24;
+
+   return (int) (k < 0 ? k + 24 : k);
+}
+
+
+static void
+mpcb_set_z_exact (mpcb_ptr rop, mpz_srcptr n, mpfr_prec_t prec)
+   /* Set rop to a ball of radius 0 with centre n, and precision at least
+      prec, but large enough to hold n exactly. */
+{
+   mpc_t c;
+
+   prec = MPC_MAX (prec, (mpfr_prec_t) mpz_sizeinbase (n, 2));
+   mpc_init2 (c, prec);
+   mpc_set_z (c, n, MPC_RNDNN); /* exact */
+   mpcb_set_c (rop, c, prec, 0, 0);
+   mpc_clear (c);
+}
+
+
+static void
+modular_image (mpz_ptr P, mpz_ptr Q, mpz_ptr R, mpz_ptr S,
+   mpz_srcptr a, mpz_srcptr b, mpz_srcptr c, mpz_srcptr d, mpc_srcptr z)
+   /* Writing z = (X+i*Y) / 2^E with integers X, Y and E >= 0, set
+      P + i*Q = a*X + b*2^E + i*a*Y and R + i*S = c*X + d*2^E + i*c*Y,
+      so that (a*z+b)/(c*z+d) = (P+i*Q) / (R+i*S) exactly. */
+{
+   mpz_t X, Y, U;
+   mpfr_exp_t ex, ey, e;
+
+   mpz_init (X);
+   mpz_init (Y);
+   mpz_init (U);
+
+   ey = mpfr_get_z_2exp (Y, mpc_imagref (z));
+   if (mpfr_zero_p (mpc_realref (z)))
+      ex = ey;
    else
-      inex = MPC_INEX (mpfr_set (mpc_realref (rop), mpc_realref (eta->c),
-                          MPC_RND_RE (rnd)),
-                       mpfr_set_ui (mpc_imagref (rop), 0, MPFR_RNDN));
+      ex = mpfr_get_z_2exp (X, mpc_realref (z));
+   e = MPC_MIN (MPC_MIN (ex, ey), 0);
+   mpz_mul_2exp (X, X, (mp_bitcnt_t) (ex - e));
+   mpz_mul_2exp (Y, Y, (mp_bitcnt_t) (ey - e));
+   mpz_set_ui (U, 1);
+   mpz_mul_2exp (U, U, (mp_bitcnt_t) (-e));
 
-   mpc_clear (zl);
-   mpcb_clear (eta);
+   mpz_mul (P, a, X);
+   mpz_addmul (P, b, U);
+   mpz_mul (Q, a, Y);
+   mpz_mul (R, c, X);
+   mpz_addmul (R, d, U);
+   mpz_mul (S, c, Y);
+
+   mpz_clear (X);
+   mpz_clear (Y);
+   mpz_clear (U);
+}
+
+
+static int
+eta_axis (mpz_srcptr a, mpz_srcptr b, mpz_srcptr c, mpz_srcptr d, int k,
+   mpc_srcptr z)
+   /* Given the matrix gamma = (a b; c d) computed by eta_reduce and the
+      multiplier k computed by eta_multiplier, return 1 if eta (z) is
+      real, 2 if it is purely imaginary, and 0 otherwise.
+      Since eta is positive on the imaginary axis, this is the case if
+      tau = gamma z is purely imaginary and, for c > 0, -i*(c*z+d) is
+      real; then eta (z) has the argument -pi*k/12. With the notation of
+      modular_image, the conditions become P*R + Q*S = 0 and, for c > 0,
+      R = 0, which is the case when Re z is an integer. */
+{
+   mpz_t P, Q, R, S, t;
+   int res;
+
+   mpz_init (P);
+   mpz_init (Q);
+   mpz_init (R);
+   mpz_init (S);
+   mpz_init (t);
+
+   modular_image (P, Q, R, S, a, b, c, d, z);
+   mpz_mul (t, P, R);
+   mpz_addmul (t, Q, S);
+   if (mpz_sgn (t) != 0 || (mpz_sgn (c) != 0 && mpz_sgn (R) != 0))
+      res = 0;
+   else if (k % 12 == 0)
+      res = 1;
+   else if (k % 12 == 6)
+      res = 2;
+   else
+      res = 0;
+
+   mpz_clear (P);
+   mpz_clear (Q);
+   mpz_clear (R);
+   mpz_clear (S);
+   mpz_clear (t);
+
+   return res;
+}
+
+
+typedef struct {
+   mpc_srcptr z;
+   mpz_srcptr a, b, c, d;
+   int k;
+   int real, imag;
+   eta_cache_ptr cache;
+} eta_data_t;
+
+
+static void
+eta_tau_ball (mpcb_ptr tau, mpcb_ptr den, const eta_data_t *dat,
+   mpfr_prec_t prec)
+   /* Set tau to a ball of precision prec containing gamma z
+      = (a*z+b)/(c*z+d) and den to a ball containing c*z+d, where z and
+      gamma are taken from dat. */
+{
+   mpcb_t zb, tmp;
+
+   mpcb_init (zb);
+   mpcb_init (tmp);
+
+   mpcb_set_c (zb, dat->z, prec, 0, 0);
+   mpcb_set_z_exact (tmp, dat->a, prec);
+   mpcb_mul (tau, zb, tmp);
+   mpcb_set_z_exact (tmp, dat->b, prec);
+   mpcb_add (tau, tau, tmp);
+   mpcb_set_z_exact (tmp, dat->c, prec);
+   mpcb_mul (den, zb, tmp);
+   mpcb_set_z_exact (tmp, dat->d, prec);
+   mpcb_add (den, den, tmp);
+   mpcb_div (tau, tau, den);
+
+   mpcb_clear (zb);
+   mpcb_clear (tmp);
+}
+
+
+static int
+eta_ball (mpcb_ptr eta, mpfr_prec_t prec, const void *data)
+   /* Evaluation function for mpcb_ziv, where data points to an eta_data_t
+      containing the argument z of mpc_eta, the matrix gamma = (a b; c d)
+      reducing it, the corresponding multiplier k as computed by
+      eta_multiplier and the cache to be used. With tau = gamma z,
+      eta (z) = eta (tau) * exp (-pi*i*k/12) / sqrt (-i*(c*z+d)),
+      where the root of unity is absorbed into q24 = exp (pi*i*(tau-k)/12)
+      and the square root is omitted for c = 0. If dat->imag is set,
+      eta (z) / i is computed instead; if it or dat->real is set, the
+      ball is restricted to the real line. */
+{
+   const eta_data_t *dat = (const eta_data_t *) data;
+   mpcb_t tau, den, tmp, q24;
+   mpz_t k;
+
+   mpcb_init (tau);
+   mpcb_init (den);
+   mpcb_init (tmp);
+   mpcb_init (q24);
+   mpz_init_set_ui (k, (unsigned long int) dat->k);
+
+   eta_tau_ball (tau, den, dat, prec);
+   mpcb_set_z_exact (tmp, k, prec);
+   mpcb_sub (tau, tau, tmp);
+
+   q24_from_ball (q24, tau, dat->cache);
+   mpcb_eta_q24 (eta, q24, dat->cache);
+
+   if (mpz_sgn (dat->c) != 0) {
+      /* -i*(c*z+d) has a positive real part. */
+      mpc_mul_i (den->c, den->c, -1, MPC_RNDNN); /* exact */
+      mpcb_sqrt (den, den);
+      mpcb_div (eta, eta, den);
+   }
+   if (dat->imag)
+      mpc_mul_i (eta->c, eta->c, -1, MPC_RNDNN); /* exact */
+   if (dat->real || dat->imag)
+      mpcb_restrict_real (eta);
+
+   mpcb_clear (tau);
+   mpcb_clear (den);
+   mpcb_clear (tmp);
+   mpcb_clear (q24);
+   mpz_clear (k);
+
+   return 0;
+}
+
+
+int
+mpc_eta (mpc_ptr rop, mpc_srcptr z, mpc_rnd_t rnd)
+   /* Compute Dedekind eta (z) for z in the upper half plane, by first
+      moving z into the fundamental domain with an element of Sl_2 (Z),
+      in which the q-series converges quickly; otherwise, for z close to
+      the real axis, the number of terms would grow like 1/Im z.
+      Outside the upper half plane, the result is NaN+i*NaN.
+      For Re z = m an integer, eta (z) = exp (pi*i*m/12) * eta (i*Im z)
+      is real if m is divisible by 12, and purely imaginary if m is
+      divisible by 6 but not by 12. */
+{
+   MPC_STATS_FUNC (eta, MPC_MAX_PREC (rop))
+   eta_cache_t cache;
+   eta_data_t dat;
+   mpz_t a, b, c, d;
+   mpc_t w;
+   int axis, inex;
+
+   if (!mpc_fin_p (z) || mpfr_sgn (mpc_imagref (z)) <= 0) {
+      mpfr_set_nan (mpc_realref (rop));
+      mpfr_set_nan (mpc_imagref (rop));
+      return MPC_INEX (0, 0);
+   }
+
+   mpz_init (a);
+   mpz_init (b);
+   mpz_init (c);
+   mpz_init (d);
+   eta_cache_init (cache);
+
+   if (eta_reduce (a, b, c, d, z))
+      inex = eta_fund_cache (rop, z, rnd, cache);
+   else {
+      dat.z = z;
+      dat.a = a;
+      dat.b = b;
+      dat.c = c;
+      dat.d = d;
+      dat.k = eta_multiplier (a, b, c, d);
+      axis = eta_axis (a, b, c, d, dat.k, z);
+      dat.real = (axis == 1 || mpfr_zero_p (mpc_realref (z)));
+      dat.imag = (axis == 2);
+      dat.cache = cache;
+      if (!dat.imag)
+         inex = mpcb_ziv (rop, eta_ball, &dat, NULL, dat.real, rnd);
+      else {
+         /* Compute eta (z) / i as a real number rounded to the precision
+            of the imaginary part of rop. */
+         mpc_init3 (w, mpfr_get_prec (mpc_imagref (rop)), MPFR_PREC_MIN);
+         inex = mpcb_ziv (w, eta_ball, &dat, NULL, 1,
+            MPC_RND (MPC_RND_IM (rnd), MPFR_RNDN));
+         mpfr_set_ui (mpc_realref (rop), 0, MPFR_RNDN);
+         mpfr_set (mpc_imagref (rop), mpc_realref (w), MPFR_RNDN); /* exact */
+         mpc_clear (w);
+         inex = MPC_INEX (0, MPC_INEX_RE (inex));
+      }
+   }
+
+   eta_cache_clear (cache);
+   mpz_clear (a);
+   mpz_clear (b);
+   mpz_clear (c);
+   mpz_clear (d);
 
    return inex;
 }
 
+
+static void
+radius_pow_ui (mpcr_ptr r, mpcr_srcptr s, unsigned long int e)
+   /* Set r to an upper bound on s^e. */
+{
+   mpcr_t t;
+
+   mpcr_set (t, s);
+   mpcr_set_one (r);
+   while (e != 0) {
+      if (e & 1)
+         mpcr_mul (r, r, t);
+      e >>= 1;
+      if (e != 0)
+         mpcr_sqr (t, t);
+   }
+}
+
+
+static void
+radius_abs_upper (mpcr_ptr r, mpcb_srcptr z)
+   /* Set r to an upper bound on the absolute values of the elements
+      of z. */
+{
+   mpcr_t one;
+
+   mpcr_set_one (one);
+   mpcr_add (one, one, z->r);
+   mpcr_c_abs_rnd (r, z->c, MPFR_RNDU);
+   mpcr_mul (r, r, one);
+}
+
+
+typedef struct {
+   int k;
+   mpc_srcptr z, q;
+   int real, imag;
+} theta_data_t;
+
+
+static unsigned long int
+theta_terms (mpfr_prec_t prec, mpc_srcptr z, mpc_srcptr q)
+   /* Return an approximate N such that |q|^((N+1)^2) * e^(2(N+1)|Im z|)
+      < 2^(-prec), which bounds the truncation error of the theta series
+      after the index N; here 0 < |q| < 1. */
+{
+   mpfr_t t;
+   double lq, lw;
+   unsigned long int N;
+
+   mpfr_init2 (t, 53);
+   mpc_abs (t, q, MPFR_RNDU);
+   mpfr_log2 (t, t, MPFR_RNDU);
+   lq = mpfr_get_d (t, MPFR_RNDU);
+   if (lq > -1e-15)
+      lq = -1e-15;
+   mpfr_abs (t, mpc_imagref (z), MPFR_RNDU);
+   lw = mpfr_get_d (t, MPFR_RNDU) * 1.4426950408889634;
+   mpfr_clear (t);
+
+   /* The logarithm of the bound is a quadratic polynomial in N with
+      negative leading coefficient lq. */
+   for (N = 1;
+        (double) (N + 1) * ((double) (N + 1) * lq + 2 * lw) + prec > 0;
+        N++);
+
+   return N;
+}
+
+
+static int
+theta_ball (mpcb_ptr theta, mpfr_prec_t prec, const void *data)
+   /* Evaluation function for mpcb_ziv, where data points to a
+      theta_data_t containing the index k, the argument z and the nome q
+      of mpc_theta, and whether the result is known to be real or purely
+      imaginary; in the latter case, theta_k (z, q) / i is computed.
+      With w = exp (i*z), the series are written as
+      theta_3, theta_4 (z, q) = 1 + sum_{n>=1} (+-1)^n q^(n^2)
+                                      (w^(2n) + w^(-2n))
+      theta_2 (z, q) = q^(1/4) sum_{n>=0} q^(n(n+1)) (w^(2n+1) + w^(-2n-1))
+      theta_1 (z, q) = -i q^(1/4) sum_{n>=0} (-1)^n q^(n(n+1))
+                          (w^(2n+1) - w^(-2n-1)),
+      and the two families of terms are obtained by multiplying by
+      q^(2n+1) w^(+-2), or q^(2n+2) w^(+-2), respectively, which are
+      themselves updated by a multiplication by q^2.
+      If the terms of index n > N are bounded by
+      2 |q|^(n^2) W^(2n), or 2 |q|^(n(n+1)) W^(2n+1), where
+      W = max (|w|, |1/w|), and the quotient of two successive ones by
+      rho = |q|^(2N+3) W^2, or |q|^(2N+4) W^2, then the tail of the series
+      is bounded by twice its first term as soon as rho <= 1/2. */
+{
+   const theta_data_t *d = (const theta_data_t *) data;
+   const int odd = (d->k <= 2);
+   const int zzero = mpc_cmp_si_si (d->z, 0, 0) == 0;
+   mpc_t iz;
+   mpcb_t qb, q2, w, wi, A, B, R, S, t;
+   mpcr_t Q, W, rho, err, half;
+   unsigned long int N, n;
+
+   mpcb_init (qb);
+   mpcb_init (q2);
+   mpcb_init (w);
+   mpcb_init (wi);
+   mpcb_init (A);
+   mpcb_init (B);
+   mpcb_init (R);
+   mpcb_init (S);
+   mpcb_init (t);
+
+   mpcb_set_c (qb, d->q, prec, 0, 0);
+   radius_abs_upper (Q, qb);
+   mpcr_set_one (half);
+   if (mpcr_cmp (Q, half) >= 0) {
+      /* |q| < 1 is not certain */
+      mpcb_set_inf (theta);
+      goto clear;
+   }
+   mpcr_div_2ui (half, half, 1);
+
+   if (zzero) {
+      mpcb_set_ui_ui (w, 1, 0, prec);
+      mpcb_set_ui_ui (wi, 1, 0, prec);
+      mpcr_set_one (W);
+   }
+   else {
+      mpc_init2 (iz, MPC_MAX_PREC (d->z));
+      mpc_mul_i (iz, d->z, 1, MPC_RNDNN); /* exact */
+      mpcb_set_c (w, iz, prec, 0, 0);
+      mpcb_exp (w, w);
+      mpc_neg (iz, iz, MPC_RNDNN);
+      mpcb_set_c (wi, iz, prec, 0, 0);
+      mpcb_exp (wi, wi);
+      mpc_clear (iz);
+      radius_abs_upper (W, w);
+      radius_abs_upper (err, wi);
+      mpcr_max (W, W, err);
+   }
+
+   /* Determine N such that rho <= 1/2, and the error bound. */
+   N = theta_terms (prec, d->z, d->q);
+   while (1) {
+      radius_pow_ui (rho, Q, 2 * N + 3 + odd);
+      radius_pow_ui (err, W, 2);
+      mpcr_mul (rho, rho, err);
+      if (mpcr_cmp (rho, half) <= 0)
+         break;
+      N++;
+   }
+   radius_pow_ui (err, Q, (N + 1) * (N + 1 + odd));
+   radius_pow_ui (rho, W, 2 * (N + 1) + odd);
+   mpcr_mul (err, err, rho);
+   mpcr_mul_2ui (err, err, 2);
+
+   mpcb_sqr (q2, qb);
+   if (odd) {
+      /* terms A = q^(n(n+1)) w^(2n+1) and B = q^(n(n+1)) w^(-2n-1),
+         multipliers R = q^(2n+2) w^2 and S = q^(2n+2) w^(-2) */
+      mpcb_set (A, w);
+      mpcb_set (B, wi);
+      mpcb_sqr (R, w);
+      mpcb_mul (R, R, q2);
+      mpcb_sqr (S, wi);
+      mpcb_mul (S, S, q2);
+      n = 0;
+   }
+   else {
+      /* terms A = q^(n^2) w^(2n) and B = q^(n^2) w^(-2n),
+         multipliers R = q^(2n+1) w^2 and S = q^(2n+1) w^(-2), starting
+         with n = 1 */
+      mpcb_sqr (R, w);
+      mpcb_mul (R, R, qb);
+      mpcb_sqr (S, wi);
+      mpcb_mul (S, S, qb);
+      mpcb_set (A, R);
+      mpcb_set (B, S);
+      mpcb_mul (R, R, q2);
+      mpcb_mul (S, S, q2);
+      mpcb_set_ui_ui (theta, 1, 0, prec);
+      n = 1;
+   }
+
+   for (; n <= N; n++) {
+      if (d->k == 1)
+         mpcb_sub (t, A, B);
+      else
+         mpcb_add (t, A, B);
+      if (odd && n == 0)
+         mpcb_set (theta, t);
+      else if ((d->k == 1 || d->k == 4) && n % 2 == 1)
+         mpcb_sub (theta, theta, t);
+      else
+         mpcb_add (theta, theta, t);
+      if (n < N) {
+         mpcb_mul (A, A, R);
+         mpcb_mul (R, R, q2);
+         if (zzero)
+            mpcb_set (B, A);
+         else {
+            mpcb_mul (B, B, S);
+            mpcb_mul (S, S, q2);
+         }
+      }
+   }
+   mpcb_add_error (theta, err);
+
+   if (odd) {
+      /* multiply by q^(1/4), and by -i for theta_1, or by -1 if the
+         result divided by i is asked for */
+      mpcb_sqrt (t, qb);
+      mpcb_sqrt (t, t);
+      mpcb_mul (theta, theta, t);
+      if (d->k == 1) {
+         if (d->imag)
+            mpc_neg (theta->c, theta->c, MPC_RNDNN); /* exact */
+         else
+            mpc_mul_i (theta->c, theta->c, -1, MPC_RNDNN); /* exact */
+      }
+   }
+
+   if (d->real || d->imag)
+      mpcb_restrict_real (theta);
+
+clear:
+   mpcb_clear (qb);
+   mpcb_clear (q2);
+   mpcb_clear (w);
+   mpcb_clear (wi);
+   mpcb_clear (A);
+   mpcb_clear (B);
+   mpcb_clear (R);
+   mpcb_clear (S);
+   mpcb_clear (t);
+
+   return 0;
+}
+
+
+int
+mpc_theta (mpc_ptr rop, int k, mpc_srcptr z, mpc_srcptr q, mpc_rnd_t rnd)
+   /* Compute the Jacobi theta function theta_k (z, q) for k = 1, 2, 3 or 4
+      with nome q, where |q| < 1, in the normalisation
+      theta_3 (z, q) = sum_{n in Z} q^(n^2) exp (2*i*n*z), and with the
+      principal branch of q^(1/4) for theta_1 and theta_2.
+      For k outside 1..4, non-finite arguments or |q| >= 1, the result
+      is NaN+i*NaN.
+      For real q, the result is real if k >= 3 or q > 0, and z is real
+      or, except for theta_1, purely imaginary; theta_1 (z, q) with z
+      purely imaginary and q > 0 is purely imaginary. */
+{
+   MPC_STATS_FUNC (theta, MPC_MAX_PREC (rop))
+   theta_data_t d;
+   mpc_t one, w;
+   int far, inex;
+
+   if (k < 1 || k > 4 || !mpc_fin_p (z) || !mpc_fin_p (q)) {
+      mpfr_set_nan (mpc_realref (rop));
+      mpfr_set_nan (mpc_imagref (rop));
+      return MPC_INEX (0, 0);
+   }
+   mpc_init2 (one, 2);
+   mpc_set_ui (one, 1, MPC_RNDNN);
+   far = (mpc_cmp_abs (q, one) >= 0);
+   mpc_clear (one);
+   if (far) {
+      mpfr_set_nan (mpc_realref (rop));
+      mpfr_set_nan (mpc_imagref (rop));
+      return MPC_INEX (0, 0);
+   }
+
+   /* exact cases: theta_3 (z, 0) = theta_4 (z, 0) = 1,
+      theta_1 (z, 0) = theta_2 (z, 0) = theta_1 (0, q) = 0 */
+   if (mpc_cmp_si_si (q, 0, 0) == 0)
+      return mpc_set_ui (rop, k >= 3, rnd);
+   if (k == 1 && mpc_cmp_si_si (z, 0, 0) == 0)
+      return mpc_set_ui (rop, 0, rnd);
+
+   d.k = k;
+   d.z = z;
+   d.q = q;
+   d.real = 0;
+   d.imag = 0;
+   if (mpfr_zero_p (mpc_imagref (q))) {
+      if (k >= 3 || mpfr_sgn (mpc_realref (q)) > 0)
+         d.real = mpfr_zero_p (mpc_imagref (z))
+                  || (k >= 2 && mpfr_zero_p (mpc_realref (z)));
+      if (k == 1 && mpfr_sgn (mpc_realref (q)) > 0)
+         d.imag = mpfr_zero_p (mpc_realref (z));
+   }
+
+   if (!d.imag)
+      return mpcb_ziv (rop, theta_ball, &d, z, d.real, rnd);
+
+   /* Compute theta_1 (z, q) / i as a real number rounded to the
+      precision of the imaginary part of rop. */
+   mpc_init3 (w, mpfr_get_prec (mpc_imagref (rop)), MPFR_PREC_MIN);
+   inex = mpcb_ziv (w, theta_ball, &d, z, 1,
+      MPC_RND (MPC_RND_IM (rnd), MPFR_RNDN));
+   mpfr_set_ui (mpc_realref (rop), 0, MPFR_RNDN);
+   mpfr_set (mpc_imagref (rop), mpc_realref (w), MPFR_RNDN); /* exact */
+   mpc_clear (w);
+
+   return MPC_INEX (0, MPC_INEX_RE (inex));
+}
+
+
+static int
+modular_image_p (mpz_srcptr a, mpz_srcptr b, mpz_srcptr c, mpz_srcptr d,
+   mpc_srcptr z, unsigned long int t)
+   /* Return non-zero if and only if (a*z+b)/(c*z+d) = t*i exactly, that
+      is, with the notation of modular_image, P = -t*S and Q = t*R. */
+{
+   mpz_t P, Q, R, S;
+   int res;
+
+   mpz_init (P);
+   mpz_init (Q);
+   mpz_init (R);
+   mpz_init (S);
+
+   modular_image (P, Q, R, S, a, b, c, d, z);
+   mpz_addmul_ui (P, S, t);
+   mpz_submul_ui (Q, R, t);
+   res = (mpz_sgn (P) == 0 && mpz_sgn (Q) == 0);
+
+   mpz_clear (P);
+   mpz_clear (Q);
+   mpz_clear (R);
+   mpz_clear (S);
+
+   return res;
+}
+
+
+static int
+j_real_p (mpz_srcptr a, mpz_srcptr b, mpz_srcptr c, mpz_srcptr d,
+   mpc_srcptr z)
+   /* Return non-zero if and only if j (z) is real, given the matrix
+      gamma = (a b; c d) computed by eta_reduce, so that tau = gamma z
+      lies close to the fundamental domain F. There, j is real exactly
+      on the boundary of F and on the imaginary axis, that is, on the
+      lines Re tau in Z/2 and on the circle |tau| = 1; since tau may lie
+      slightly outside of F, close to one of its corners, the images of
+      these lines under tau -> -1/tau, the circles |tau -+ 1| = 1, are
+      also tested. With the notation of modular_image and
+      N = |R+i*S|^2, the conditions become N | 2*(P*R + Q*S),
+      |P+i*Q|^2 = N and |P-+R + i*(Q-+S)|^2 = N. */
+{
+   mpz_t P, Q, R, S, N, t, u;
+   int res;
+
+   mpz_init (P);
+   mpz_init (Q);
+   mpz_init (R);
+   mpz_init (S);
+   mpz_init (N);
+   mpz_init (t);
+   mpz_init (u);
+
+   modular_image (P, Q, R, S, a, b, c, d, z);
+   mpz_mul (N, R, R);
+   mpz_addmul (N, S, S);
+   mpz_mul (t, P, R);
+   mpz_addmul (t, Q, S);
+   mpz_mul_2exp (t, t, 1);
+   res = mpz_divisible_p (t, N);
+   if (!res) {
+      mpz_mul (t, P, P);
+      mpz_addmul (t, Q, Q);
+      res = (mpz_cmp (t, N) == 0);
+   }
+   if (!res) {
+      /* |P-R + i*(Q-S)|^2 - N = |P+i*Q|^2 - 2*(P*R + Q*S), and
+         similarly for the other circle. */
+      mpz_mul (u, P, R);
+      mpz_addmul (u, Q, S);
+      mpz_mul_2exp (u, u, 1);
+      res = (mpz_cmp (t, u) == 0);
+      if (!res) {
+         mpz_neg (u, u);
+         res = (mpz_cmp (t, u) == 0);
+      }
+   }
+
+   mpz_clear (P);
+   mpz_clear (Q);
+   mpz_clear (R);
+   mpz_clear (S);
+   mpz_clear (N);
+   mpz_clear (t);
+   mpz_clear (u);
+
+   return res;
+}
+
+
+static int
+j_ball (mpcb_ptr j, mpfr_prec_t prec, const void *data)
+   /* Evaluation function for mpcb_ziv, where data points to an eta_data_t
+      containing the argument z of mpc_j, the matrix gamma reducing it,
+      the cache to be used and whether the result is known to be real.
+      With tau = gamma z and q = exp (2*pi*i*tau), and writing
+      eta (tau) = q^(1/24) E (q) and eta (2 tau) = q^(1/12) E (q^2),
+      j (z) = j (tau) = (256 x + 1)^3 / x with
+      x = (eta (2 tau) / eta (tau))^24 = q (E (q^2) / E (q))^24,
+      where both series are obtained from the same powers of q. */
+{
+   const eta_data_t *dat = (const eta_data_t *) data;
+   mpcb_t tau, den, q, e1, e2, t;
+   mpfr_exp_t expq;
+
+   mpcb_init (tau);
+   mpcb_init (den);
+   mpcb_init (q);
+   mpcb_init (e1);
+   mpcb_init (e2);
+   mpcb_init (t);
+
+   eta_tau_ball (tau, den, dat, prec);
+   mpcb_set_ui_ui (t, 24, 0, prec);
+   mpcb_mul (tau, tau, t);
+   q24_from_ball (q, tau, dat->cache);
+   expq = eta_expq (q);
+   if (expq == 0)
+      mpcb_set_inf (j);
+   else {
+      eta_series (e1, e2, q, expq, eta_terms (prec, expq),
+         eta_terms (prec, 2 * expq), dat->cache);
+      mpcb_div (e2, e2, e1);
+      mpcb_pow_ui (e2, e2, 24);
+      mpcb_mul (e2, e2, q);
+      mpcb_set_ui_ui (t, 256, 0, prec);
+      mpcb_mul (t, t, e2);
+      mpcb_set_ui_ui (e1, 1, 0, prec);
+      mpcb_add (t, t, e1);
+      mpcb_pow_ui (t, t, 3);
+      mpcb_div (j, t, e2);
+      if (dat->real)
+         mpcb_restrict_real (j);
+   }
+
+   mpcb_clear (tau);
+   mpcb_clear (den);
+   mpcb_clear (q);
+   mpcb_clear (e1);
+   mpcb_clear (e2);
+   mpcb_clear (t);
+
+   return 0;
+}
+
+
+int
+mpc_j (mpc_ptr rop, mpc_srcptr z, mpc_rnd_t rnd)
+   /* Compute the modular j-invariant j (z) for z in the upper half plane;
+      outside of it, the result is NaN+i*NaN.
+      Since j is invariant under Sl_2 (Z), z is first moved close to the
+      fundamental domain. The only arguments with an exactly representable
+      value are the points equivalent to i and 2*i, with j = 1728 and
+      j = 66^3; the value is real on the orbits of the boundary of the
+      fundamental domain and of the imaginary axis. */
+{
+   MPC_STATS_FUNC (j, MPC_MAX_PREC (rop))
+   eta_cache_t cache;
+   eta_data_t dat;
+   mpz_t a, b, c, d;
+   int inex;
+
+   if (!mpc_fin_p (z) || mpfr_sgn (mpc_imagref (z)) <= 0) {
+      mpfr_set_nan (mpc_realref (rop));
+      mpfr_set_nan (mpc_imagref (rop));
+      return MPC_INEX (0, 0);
+   }
+
+   mpz_init (a);
+   mpz_init (b);
+   mpz_init (c);
+   mpz_init (d);
+
+   eta_reduce (a, b, c, d, z);
+   if (modular_image_p (a, b, c, d, z, 1))
+      inex = mpc_set_ui (rop, 1728, rnd);
+   else if (modular_image_p (a, b, c, d, z, 2))
+      inex = mpc_set_ui (rop, 287496, rnd);
+   else {
+      eta_cache_init (cache);
+      dat.z = z;
+      dat.a = a;
+      dat.b = b;
+      dat.c = c;
+      dat.d = d;
+      dat.k = 0;
+      dat.real = j_real_p (a, b, c, d, z);
+      dat.imag = 0;
+      dat.cache = cache;
+      inex = mpcb_ziv (rop, j_ball, &dat, NULL, dat.real, rnd);
+      eta_cache_clear (cache);
+   }
+
+   mpz_clear (a);
+   mpz_clear (b);
+   mpz_clear (c);
+   mpz_clear (d);
+
+   return inex;
+}
+
+
+/* A batch of evaluations of mpc_eta_fund_vec. */
+typedef struct {
+   mpc_ptr *rop;
+   int *inex;
+   const mpc_ptr *op;
+   mpc_rnd_t rnd;
+} eta_batch_t;
+
+
+static void
+eta_batch_work (mpc_batch_ptr batch, void *data)
+   /* Evaluate eta in the elements of the batch data handed out by batch,
+      with a cache shared by all the evaluations done by the current
+      thread. */
+{
+   eta_batch_t *b = (eta_batch_t *) data;
+   eta_cache_t cache;
+   unsigned long int i;
+   int inex;
+
+   eta_cache_init (cache);
+   while (mpc_batch_next (&i, batch)) {
+      inex = eta_fund_cache (b->rop [i], b->op [i], b->rnd, cache);
+      if (b->inex != NULL)
+         b->inex [i] = inex;
+   }
+   eta_cache_clear (cache);
+}
+
+
+void
+mpc_eta_fund_vec (mpc_ptr *rop, int *inex, const mpc_ptr *op,
+   unsigned long int n, mpc_rnd_t rnd)
+   /* Set rop [i] to mpc_eta_fund (op [i]) for 0 <= i < n, and, unless
+      inex is NULL, inex [i] to the corresponding rounding direction
+      value. The addition sequence and the constant i*pi/12 are shared
+      between the evaluations, which are spread over several threads if possible.
+      The rop [i] must be distinct from each other and from the op [j]
+      with j != i. */
+{
+   eta_batch_t batch;
+
+   batch.rop = rop;
+   batch.inex = inex;
+   batch.op = op;
+   batch.rnd = rnd;
+   mpc_batch_run (n, eta_batch_work, &batch);
+}
@@ -1,6 +1,6 @@
 /* mpc_exp -- exponential of a complex number.
 
-Copyright (C) 2002, 2009, 2010, 2011, 2012, 2020, 2024 INRIA
+Copyright (C) 2002, 2009, 2010, 2011, 2012, 2020, 2024, 2025 INRIA
 
 This file is part of GNU MPC.
 
@@ -23,6 +23,7 @@ along with this program. If not, see http://www.gnu.org/licenses/ .
 int
 mpc_exp (mpc_ptr rop, mpc_srcptr op, mpc_rnd_t rnd)
 {
+  MPC_STATS_FUNC (exp, MPC_MAX_PREC (rop))
   mpfr_t x, y, z;
   mpfr_prec_t prec;
   int loop;
@@ -157,6 +158,7 @@ mpc_exp (mpc_ptr rop, mpc_srcptr op, mpc_rnd_t rnd)
     {
       MPC_LOOP_NEXT(loop, op, rop);
       prec += prec / 2 + mpc_ceil_log2 (prec) + 5;
+      MPC_ZIV_START (exp, loop, prec, MPC_MAX_PREC (rop));
 
       mpfr_set_prec (x, prec);
       mpfr_set_prec (y, prec);
@@ -181,6 +183,7 @@ mpc_exp (mpc_ptr rop, mpc_srcptr op, mpc_rnd_t rnd)
         }
     }
   while (ok == 0);
+  MPC_ZIV_END (exp, loop, prec, MPC_MAX_PREC (rop));
 
   inex_re = mpfr_set (mpc_realref(rop), y, MPC_RND_RE(rnd));
   inex_im = mpfr_set (mpc_imagref(rop), z, MPC_RND_IM(rnd));
@@ -1,6 +1,6 @@
 /* mpc_exp10 -- base-10 exponential of a complex number.
 
-Copyright (C) 2024 INRIA
+Copyright (C) 2024, 2025 INRIA
 
 This file is part of GNU MPC.
 
@@ -23,6 +23,7 @@ along with this program. If not, see http://www.gnu.org/licenses/ .
 int
 mpc_exp10 (mpc_ptr rop, mpc_srcptr op, mpc_rnd_t rnd)
 {
+  MPC_STATS_FUNC (exp10, MPC_MAX_PREC (rop))
   mpc_t ten;
   int ret;
   mpc_init2 (ten, 4); // 4 bits is enough to store 10 exactly
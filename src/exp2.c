@@ -1,6 +1,6 @@
 /* mpc_exp2 -- base-2 exponential of a complex number.
 
-Copyright (C) 2024 INRIA
+Copyright (C) 2024, 2025 INRIA
 
 This file is part of GNU MPC.
 
@@ -23,6 +23,7 @@ along with this program. If not, see http://www.gnu.org/licenses/ .
 int
 mpc_exp2 (mpc_ptr rop, mpc_srcptr op, mpc_rnd_t rnd)
 {
+  MPC_STATS_FUNC (exp2, MPC_MAX_PREC (rop))
   mpc_t two;
   int ret;
   mpc_init2 (two, MPFR_PREC_MIN); // 1 bit is enough to store 2 exactly
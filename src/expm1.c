@@ -0,0 +1,211 @@
+/* mpc_expm1 -- exponential of a complex number minus one.
+
+Copyright (C) 2025 INRIA
+
+This file is part of GNU MPC.
+
+GNU MPC is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the
+Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+GNU MPC is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for
+more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program. If not, see http://www.gnu.org/licenses/ .
+*/
+
+#include "mpc-impl.h"
+
+/* For z = x + i*y we have
+      Re (exp(z) - 1) = exp(x) * cos(y) - 1 = expm1(x) * cos(y) - 2 sin(y/2)^2
+      Im (exp(z) - 1) = exp(x) * sin(y)
+   The first form of the real part suffers from a cancellation for z
+   close to 0, which the second one avoids: both terms are computed with
+   a relative error, and the only remaining cancellation happens when the
+   real part of the result itself is close to 0. */
+
+int
+mpc_expm1 (mpc_ptr rop, mpc_srcptr op, mpc_rnd_t rnd)
+{
+  MPC_STATS_FUNC (expm1, MPC_MAX_PREC (rop))
+  mpfr_t a, c, s, t, e, u, v, h;
+  mpfr_prec_t prec;
+  mpfr_exp_t m, cancel;
+  int loop, ok_re, ok_im, tiny;
+  int inex_re, inex_im;
+  int saved_underflow, saved_overflow, overflow = 0, underflow = 0;
+  mpfr_exp_t saved_emin, saved_emax;
+
+  if (!mpc_fin_p (op))
+    /* exp(op) is one of 0, an infinity or NaN in each part, and
+       subtracting 1 does not change the imaginary part; the real part
+       of exp(op) is 0 only for Re(op) = -inf, and then becomes -1. */
+    {
+      inex_im = mpc_exp (rop, op, rnd);
+      inex_im = MPC_INEX_IM (inex_im);
+      inex_re = mpfr_sub_ui (mpc_realref (rop), mpc_realref (rop), 1,
+                             MPC_RND_RE (rnd));
+      return MPC_INEX (inex_re, inex_im);
+    }
+
+  if (mpfr_zero_p (mpc_imagref (op)))
+    /* real input: expm1(x+i*0) = expm1(x) + i*0, with the sign of the
+       imaginary part preserved since exp(x) > 0 */
+    {
+      inex_re = mpfr_expm1 (mpc_realref (rop), mpc_realref (op),
+                            MPC_RND_RE (rnd));
+      inex_im = mpfr_set (mpc_imagref (rop), mpc_imagref (op),
+                          MPC_RND_IM (rnd));
+      return MPC_INEX (inex_re, inex_im);
+    }
+
+  /* from now on, both parts of op are finite and Im(op) != 0 */
+  saved_emin = mpfr_get_emin ();
+  saved_emax = mpfr_get_emax ();
+  mpfr_set_emin (mpfr_get_emin_min ());
+  mpfr_set_emax (mpfr_get_emax_max ());
+
+  saved_underflow = mpfr_underflow_p ();
+  saved_overflow = mpfr_overflow_p ();
+
+  mpfr_init2 (a, 2);
+  mpfr_init2 (c, 2);
+  mpfr_init2 (s, 2);
+  mpfr_init2 (t, 2);
+  mpfr_init2 (e, 2);
+  mpfr_init2 (u, 2);
+  mpfr_init2 (v, 2);
+  /* y/2 is exact at the precision of y in the extended exponent range,
+     while rounding it to the working precision would spoil sin(y/2) for
+     large |y|. */
+  mpfr_init2 (h, mpfr_get_prec (mpc_imagref (op)));
+  mpfr_div_2ui (h, mpc_imagref (op), 1, MPFR_RNDN);
+
+  /* If x < -(p+1), where p is the target precision of the real part,
+     then exp(x) < 2^-(p+1) and the real part lies strictly between -1 and
+     its neighbours at precision p, on the side given by the sign of cos(y);
+     it cannot be determined by the loop below, but rounds as
+     -1 + sign(cos(y)) * 2^-(p+2). */
+  tiny = mpfr_cmp_si (mpc_realref (op), - (long) MPC_PREC_RE (rop) - 1) < 0;
+
+  prec = MPC_MAX_PREC (rop);
+  cancel = 0;
+  loop = 0;
+  do
+    {
+      MPC_LOOP_NEXT (loop, op, rop);
+      prec += mpc_ceil_log2 (prec) + 5 + cancel;
+      MPC_ZIV_START (expm1, loop, prec, MPC_MAX_PREC (rop));
+
+      mpfr_set_prec (a, prec);
+      mpfr_set_prec (c, prec);
+      mpfr_set_prec (s, prec);
+      mpfr_set_prec (t, prec);
+      mpfr_set_prec (e, prec);
+      mpfr_set_prec (u, prec);
+      mpfr_set_prec (v, prec);
+
+      mpfr_clear_overflow ();
+      mpfr_clear_underflow ();
+
+      mpfr_sin_cos (s, c, mpc_imagref (op), MPFR_RNDN);
+
+      if (tiny)
+        ok_re = 1;
+      else
+        {
+          /* real part: with u = 2^-prec, each of a = expm1(x), c = cos(y)
+             and t = sin(y/2) has a relative error bounded by u; the error on
+             a*c - 2*t^2 before the final rounding is then bounded by
+             2.03 u (|a*c| + 2*t^2) < 2^(m+3-prec), where 2^m bounds both
+             |a*c| and 2*t^2. Adding the final rounding error 2^(er-1-prec),
+             where er is the exponent of the result, we obtain an error
+             bounded by 2^(max(m+3,er-1)+1-prec) */
+          mpfr_expm1 (a, mpc_realref (op), MPFR_RNDN);
+          mpfr_sin (t, h, MPFR_RNDN);
+          mpfr_mul_2ui (u, t, 1, MPFR_RNDN);
+          mpfr_fmms (v, a, c, u, t, MPFR_RNDN);
+          overflow = mpfr_overflow_p ();
+
+          if (overflow)
+            ok_re = 1;
+          else if (mpfr_zero_p (v))
+            {
+              ok_re = 0;
+              cancel = prec;
+            }
+          else
+            {
+              m = 2 * mpfr_get_exp (t) + 1;
+              if (!mpfr_zero_p (a))
+                m = MPC_MAX (m, mpfr_get_exp (a) + mpfr_get_exp (c));
+              cancel = MPC_MAX (m + 4 - mpfr_get_exp (v), 0);
+              ok_re = mpfr_can_round (v, prec - cancel, MPFR_RNDN, MPFR_RNDZ,
+                                      MPC_PREC_RE (rop)
+                                      + (MPC_RND_RE (rnd) == MPFR_RNDN));
+            }
+        }
+
+      if (ok_re)
+        {
+          /* imaginary part: exp(x) * sin(y) with an error of at most
+             2 ulps as in mpc_exp */
+          mpfr_exp (e, mpc_realref (op), MPFR_RNDN);
+          mpfr_mul (s, s, e, MPFR_RNDN);
+          overflow = mpfr_overflow_p ();
+          underflow = mpfr_zero_p (e);
+          ok_im = overflow || underflow
+                  || mpfr_can_round (s, prec - 2, MPFR_RNDN, MPFR_RNDZ,
+                                     MPC_PREC_IM (rop)
+                                     + (MPC_RND_IM (rnd) == MPFR_RNDN));
+        }
+      else
+        ok_im = 0;
+    }
+  while (ok_re == 0 || ok_im == 0);
+  MPC_ZIV_END (expm1, loop, prec, MPC_MAX_PREC (rop));
+
+  if (tiny)
+    {
+      mpfr_set_prec (v, MPC_PREC_RE (rop) + 3);
+      mpfr_set_si_2exp (v, mpfr_sgn (c), - (mpfr_exp_t) MPC_PREC_RE (rop) - 2,
+                        MPFR_RNDN);
+      mpfr_sub_ui (v, v, 1, MPFR_RNDN); /* exact */
+    }
+  inex_re = mpfr_set (mpc_realref (rop), v, MPC_RND_RE (rnd));
+  inex_im = mpfr_set (mpc_imagref (rop), s, MPC_RND_IM (rnd));
+  if (overflow)
+    {
+      inex_re = mpc_fix_inf (mpc_realref (rop), MPC_RND_RE (rnd));
+      inex_im = mpc_fix_inf (mpc_imagref (rop), MPC_RND_IM (rnd));
+    }
+  else if (underflow)
+    inex_im = mpc_fix_zero (mpc_imagref (rop), MPC_RND_IM (rnd));
+
+  mpfr_clear (a);
+  mpfr_clear (c);
+  mpfr_clear (s);
+  mpfr_clear (t);
+  mpfr_clear (e);
+  mpfr_clear (u);
+  mpfr_clear (v);
+  mpfr_clear (h);
+
+  /* restore underflow and overflow flags from MPFR */
+  if (saved_underflow)
+    mpfr_set_underflow ();
+  if (saved_overflow)
+    mpfr_set_overflow ();
+
+  /* restore the exponent range, and check the range of results */
+  mpfr_set_emin (saved_emin);
+  mpfr_set_emax (saved_emax);
+  inex_re = mpfr_check_range (mpc_realref (rop), inex_re, MPC_RND_RE (rnd));
+  inex_im = mpfr_check_range (mpc_imagref (rop), inex_im, MPC_RND_IM (rnd));
+
+  return MPC_INEX (inex_re, inex_im);
+}
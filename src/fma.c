@@ -1,6 +1,6 @@
 /* mpc_fma -- Fused multiply-add of three complex numbers
 
-Copyright (C) 2011, 2012, 2022 INRIA
+Copyright (C) 2011, 2012, 2022, 2025 INRIA
 
 This file is part of GNU MPC.
 
@@ -64,6 +64,7 @@ mpc_fma_naive (mpc_ptr r, mpc_srcptr a, mpc_srcptr b, mpc_srcptr c, mpc_rnd_t rn
 int
 mpc_fma (mpc_ptr r, mpc_srcptr a, mpc_srcptr b, mpc_srcptr c, mpc_rnd_t rnd)
 {
+  MPC_STATS_FUNC (fma, MPC_MAX_PREC (r))
   mpc_t ab;
   mpfr_prec_t pre, pim, wpre, wpim;
   mpfr_exp_t diffre, diffim;
@@ -1,6 +1,6 @@
 /* mpc_fr_div -- Divide a floating-point number by a complex number.
 
-Copyright (C) 2008, 2009, 2011, 2012 INRIA
+Copyright (C) 2008, 2009, 2011, 2012, 2025 INRIA
 
 This file is part of GNU MPC.
 
@@ -23,6 +23,7 @@ along with this program. If not, see http://www.gnu.org/licenses/ .
 int
 mpc_fr_div (mpc_ptr a, mpfr_srcptr b, mpc_srcptr c, mpc_rnd_t rnd)
 {
+   MPC_STATS_FUNC (fr_div, MPC_MAX_PREC (a))
    mpc_t bc;
    int inexact;
 
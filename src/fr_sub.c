@@ -1,6 +1,6 @@
 /* mpc_fr_sub -- Substract a complex number from a floating-point number.
 
-Copyright (C) 2008, 2009, 2011, 2012 INRIA
+Copyright (C) 2008, 2009, 2011, 2012, 2025 INRIA
 
 This file is part of GNU MPC.
 
@@ -24,6 +24,7 @@ along with this program. If not, see http://www.gnu.org/licenses/ .
 int
 mpc_fr_sub (mpc_ptr a, mpfr_srcptr b, mpc_srcptr c, mpc_rnd_t rnd)
 {
+  MPC_STATS_FUNC (fr_sub, MPC_MAX_PREC (a))
   int inex_re, inex_im;
 
   inex_re = mpfr_sub (mpc_realref (a), b, mpc_realref (c), MPC_RND_RE (rnd));
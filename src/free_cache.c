@@ -0,0 +1,32 @@
+/* mpc_free_cache -- Free the caches of the current thread.
+
+Copyright (C) 2025 INRIA
+
+This file is part of GNU MPC.
+
+GNU MPC is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the
+Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+GNU MPC is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for
+more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program. If not, see http://www.gnu.org/licenses/ .
+*/
+
+#include "mpc-impl.h"
+
+void
+mpc_free_cache (void)
+{
+   mpc_gamma_free_cache ();
+   mpc_erf_free_cache ();
+   mpc_zeta_free_cache ();
+   mpc_bernoulli_free_cache ();
+   mpc_ziv_free_cache ();
+   mpfr_free_cache ();
+}
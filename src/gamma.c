@@ -0,0 +1,813 @@
+/* mpc_lgamma, mpc_tgamma -- logarithm of the Gamma function and Gamma
+   function of a complex number.
+
+Copyright (C) 2025 INRIA
+
+This file is part of GNU MPC.
+
+GNU MPC is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the
+Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+GNU MPC is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for
+more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program. If not, see http://www.gnu.org/licenses/ .
+*/
+
+#include <stdio.h> /* for MPC_ASSERT */
+#include "mpc-impl.h"
+
+/* For z with positive real part, the Stirling series reads
+      loggamma (z) = (z-1/2) log z - z + log (2 pi) / 2
+                     + sum_{k=1}^M B_{2k} / (2k (2k-1) z^(2k-1)) + R_M (z),
+   where loggamma is the analytic continuation of the logarithm of Gamma
+   on the complex plane without the negative real axis, and by
+   Whittaker-Watson, Sec. 12.33, or Brent, "On asymptotic approximations
+   to the log-Gamma and Riemann-Siegel theta functions", 2018,
+      |R_M (z)| <= |B_{2M+2}| / ((2M+2) (2M+1) |z|^(2M+1)) * s^(M+1)
+   with s = sec^2 (arg (z) / 2) = 2 |z| / (|z| + Re (z)).
+   Outside of a region Re (z) >= 1, |z| >= R, where the series converges
+   quickly enough, we use the recurrence
+      loggamma (z) = loggamma (z+n) - sum_{k=0}^{n-1} log (z+k),
+   and for Re (z) < -R the reflection formula, which for Im (z) > 0 can
+   be written as
+      loggamma (z) = log (2 pi) + i pi (z - 1/2) - log (1 - e^(2 pi i z))
+                     - loggamma (1-z).
+   A smaller R means more terms of the series, a larger one more factors
+   in the recurrence; with R = 0.17 p + 8 for a target precision p, both
+   are about p/6.
+   All computations are carried out with balls, so that the working
+   precision only needs to be increased when the ball for the result
+   is too large to decide the correct rounding. */
+
+/* The coefficients B_{2k} / (2k (2k-1)) for 1 <= k <= stirling_size,
+   rounded to nearest at precision stirling_prec, which is the largest
+   precision requested so far. */
+static MPC_THREAD_LOCAL mpfr_t *stirling_cache = NULL;
+static MPC_THREAD_LOCAL unsigned long int stirling_size = 0;
+static MPC_THREAD_LOCAL mpfr_prec_t stirling_prec = 0;
+
+static void
+stirling_set (mpfr_ptr c, unsigned long int k)
+{
+   mpq_t q;
+
+   mpq_init (q);
+   mpq_set (q, mpc_bernoulli_b2k (k));
+   mpz_mul_ui (mpq_denref (q), mpq_denref (q), 2 * k);
+   mpz_mul_ui (mpq_denref (q), mpq_denref (q), 2 * k - 1);
+   mpq_canonicalize (q);
+   mpfr_set_q (c, q, MPFR_RNDN);
+   mpq_clear (q);
+}
+
+
+static mpfr_srcptr
+stirling_coefficient (unsigned long int k, mpfr_prec_t prec)
+   /* Return B_{2k} / (2k (2k-1)) rounded to nearest at a precision of
+      at least prec. */
+{
+   unsigned long int i, n;
+
+   if (prec > stirling_prec) {
+      for (i = 0; i < stirling_size; i++) {
+         mpfr_set_prec (stirling_cache [i], prec);
+         stirling_set (stirling_cache [i], i + 1);
+      }
+      stirling_prec = prec;
+   }
+   if (k > stirling_size) {
+      n = MPC_MAX (k, stirling_size + stirling_size / 2);
+      stirling_cache = (mpfr_t *) realloc (stirling_cache,
+                                           n * sizeof (mpfr_t));
+      MPC_ASSERT (stirling_cache != NULL);
+      for (i = stirling_size; i < n; i++) {
+         mpfr_init2 (stirling_cache [i], stirling_prec);
+         stirling_set (stirling_cache [i], i + 1);
+      }
+      stirling_size = n;
+   }
+
+   return stirling_cache [k - 1];
+}
+
+
+void
+mpc_gamma_free_cache (void)
+{
+   unsigned long int i;
+
+   for (i = 0; i < stirling_size; i++)
+      mpfr_clear (stirling_cache [i]);
+   free (stirling_cache);
+   stirling_cache = NULL;
+   stirling_size = 0;
+   stirling_prec = 0;
+}
+
+
+static void
+ball_i_pi (mpcb_ptr z, unsigned long int e, mpfr_prec_t prec)
+   /* Set z to a ball around i * pi * 2^e. */
+{
+   mpc_t c;
+
+   mpc_init2 (c, prec);
+   mpfr_set_ui (mpc_realref (c), 0, MPFR_RNDN);
+   mpfr_const_pi (mpc_imagref (c), MPFR_RNDN);
+   mpfr_mul_2ui (mpc_imagref (c), mpc_imagref (c), e, MPFR_RNDN);
+   mpcb_set_c (z, c, prec, 0, 1);
+   mpc_clear (c);
+}
+
+
+static void
+ball_log_2pi (mpcb_ptr z, mpfr_prec_t prec)
+   /* Set z to a ball around log (2 pi). */
+{
+   mpfr_t x;
+
+   mpfr_init2 (x, prec);
+   mpfr_const_pi (x, MPFR_RNDN);
+   mpfr_mul_2ui (x, x, 1, MPFR_RNDN);
+   mpfr_log (x, x, MPFR_RNDN);
+   /* The relative error 2^-prec of pi becomes an absolute error of at
+      most 2^-prec in its logarithm, which lies in [1, 2); with the final
+      rounding, the error is bounded by 2 half ulps. */
+   mpcb_set_fr (z, x, prec, 3);
+   mpfr_clear (x);
+}
+
+
+static void
+ball_half (mpcb_ptr z, mpfr_prec_t prec)
+{
+   mpcb_set_ui_ui (z, 1, 0, prec);
+   mpcb_div_2ui (z, z, 1);
+}
+
+
+static void
+stirling (mpcb_ptr s, mpcb_srcptr w)
+   /* Set s to a ball containing loggamma (w') for all w' in w, using the
+      Stirling series with as many terms as needed for the precision of w.
+      The elements of w need to have a positive real part. */
+{
+   mpfr_prec_t p = mpcb_get_prec (w);
+   mpcb_t l, t, u, u2;
+   mpcr_t r, rs;
+   mpfr_t a, b, q, x, y;
+   mpfr_exp_t e, target;
+   unsigned long int m, k;
+
+   mpcb_init (l);
+   mpcb_init (t);
+   mpcb_init (u);
+   mpcb_init (u2);
+   mpfr_init2 (a, 64);
+   mpfr_init2 (b, 64);
+   mpfr_init2 (q, 64);
+   mpfr_init2 (x, 64);
+   mpfr_init2 (y, 64);
+
+   /* main part (w - 1/2) log w - w + log (2 pi) / 2 */
+   mpcb_log (l, w);
+   ball_half (t, p);
+   mpcb_sub (t, w, t);
+   mpcb_mul (t, t, l);
+   mpcb_sub (t, t, w);
+   ball_log_2pi (u, p);
+   mpcb_div_2ui (u, u, 1);
+   mpcb_add (s, t, u);
+
+   if (mpcr_inf_p (s->r) || !mpcr_lt_half_p (w->r)
+       || mpfr_sgn (mpc_realref (w->c)) <= 0)
+      mpcr_set_inf (s->r);
+   else {
+      /* Bound the elements w' of w by a <= |w'| <= b and Re (w') >= x,
+         using w->r < q = 2^e. */
+      if (mpcr_zero_p (w->r))
+         mpfr_set_ui (q, 0, MPFR_RNDN);
+      else {
+         e = mpcr_get_exp (w->r);
+         mpfr_set_ui_2exp (q, 1, e, MPFR_RNDN);
+      }
+      mpfr_hypot (a, mpc_realref (w->c), mpc_imagref (w->c), MPFR_RNDD);
+      mpfr_hypot (b, mpc_realref (w->c), mpc_imagref (w->c), MPFR_RNDU);
+      mpfr_mul (x, b, q, MPFR_RNDU);
+      mpfr_ui_sub (y, 1, q, MPFR_RNDD);
+      mpfr_mul (a, a, y, MPFR_RNDD);
+      mpfr_add (b, b, x, MPFR_RNDU);
+      mpfr_sub (x, mpc_realref (w->c), x, MPFR_RNDD);
+      if (mpfr_sgn (x) <= 0)
+         mpcr_set_inf (s->r);
+      else {
+         /* y = s of the formula above, rounded up */
+         mpfr_add (y, b, x, MPFR_RNDD);
+         mpfr_div (y, b, y, MPFR_RNDU);
+         mpfr_mul_2ui (y, y, 1, MPFR_RNDU);
+         /* With |B_{2k}| = 2 (2k)! zeta (2k) / (2 pi)^(2k) and zeta
+            decreasing, the bound t_k on the k-th term satisfies
+            t_1 = y / (12 a) and
+            t_{k+1} / t_k <= 2k (2k-1) y / (4 pi^2 a^2),
+            where we replace 4 pi^2 by 39. */
+         mpfr_sqr (q, a, MPFR_RNDD);
+         mpfr_mul_ui (q, q, 39, MPFR_RNDD);
+         mpfr_div (q, y, q, MPFR_RNDU);
+         mpfr_mul_ui (a, a, 12, MPFR_RNDD);
+         mpfr_div (a, y, a, MPFR_RNDU);
+         /* Stop when the bound drops below 2^-(p+4) |s|, or when the terms
+            start to increase. */
+         target = MPC_MAX (mpfr_get_exp (mpc_realref (s->c)),
+                           mpfr_get_exp (mpc_imagref (s->c))) - p - 4;
+         m = 0;
+         while (mpfr_cmp_ui_2exp (a, 1, target) > 0) {
+            mpfr_mul_ui (b, a, (2 * m + 2) * (2 * m + 1), MPFR_RNDU);
+            mpfr_mul (b, b, q, MPFR_RNDU);
+            if (mpfr_cmp (b, a) >= 0)
+               break;
+            mpfr_swap (a, b);
+            m++;
+         }
+
+         if (m > 0) {
+            /* Horner evaluation of the sum in 1/w^2 */
+            mpcb_set_ui_ui (u, 1, 0, p);
+            mpcb_div (u, u, w);
+            mpcb_sqr (u2, u);
+            mpcb_set_fr (t, stirling_coefficient (m, p), p, 1);
+            for (k = m - 1; k >= 1; k--) {
+               mpcb_mul (t, t, u2);
+               mpcb_set_fr (l, stirling_coefficient (k, p), p, 1);
+               mpcb_add (t, t, l);
+            }
+            mpcb_mul (t, t, u);
+            mpcb_add (s, s, t);
+         }
+
+         /* Add the remainder a, which is an absolute error, as a relative
+            error to the radius of s. */
+         mpcr_f_abs_rnd (r, a, MPFR_RNDU);
+         mpcr_c_abs_rnd (rs, s->c, MPFR_RNDD);
+         mpcr_div (r, r, rs);
+         mpcr_add (s->r, s->r, r);
+      }
+   }
+
+   mpcb_clear (l);
+   mpcb_clear (t);
+   mpcb_clear (u);
+   mpcb_clear (u2);
+   mpfr_clear (a);
+   mpfr_clear (b);
+   mpfr_clear (q);
+   mpfr_clear (x);
+   mpfr_clear (y);
+}
+
+
+static void
+gamma_ball (mpcb_ptr g, mpcb_srcptr z, int take_exp)
+   /* Set g to a ball containing loggamma (z') if take_exp is 0, or
+      Gamma (z') otherwise, for all z' in z. The centre of z needs to be
+      finite and have a non-zero imaginary part. */
+{
+   mpfr_prec_t p = mpcb_get_prec (z);
+   double x, y, r;
+   unsigned long int n, k, m;
+   int up;
+   mpcb_t t, u, v, w;
+
+   mpcb_init (t);
+
+   if (mpfr_signbit (mpc_imagref (z->c))) {
+      /* loggamma and Gamma commute with complex conjugation */
+      mpcb_set (t, z);
+      mpc_conj (t->c, t->c, MPC_RNDNN);
+      gamma_ball (g, t, take_exp);
+      mpc_conj (g->c, g->c, MPC_RNDNN);
+      mpcb_clear (t);
+      return;
+   }
+
+   mpcb_init (u);
+   mpcb_init (v);
+   mpcb_init (w);
+
+   r = 0.17 * p + 8;
+   x = mpfr_get_d (mpc_realref (z->c), MPFR_RNDN);
+   y = mpfr_get_d (mpc_imagref (z->c), MPFR_RNDN);
+
+   if (x < -r) {
+      /* reflection */
+      mpcb_set_ui_ui (t, 1, 0, p);
+      mpcb_sub (w, t, z);
+      gamma_ball (v, w, take_exp);
+      if (take_exp) {
+         /* Gamma (z) = -2 pi i e / ((1 - e^2) Gamma (1-z))
+            with e = exp (i pi z) */
+         ball_i_pi (u, 0, p);
+         mpcb_mul (u, u, z);
+         mpcb_exp (u, u);
+         mpcb_sqr (w, u);
+         mpcb_sub (w, t, w);
+         mpcb_mul (w, w, v);
+         ball_i_pi (t, 1, p);
+         mpcb_neg (t, t);
+         mpcb_mul (t, t, u);
+         mpcb_div (g, t, w);
+      }
+      else {
+         ball_i_pi (u, 1, p);
+         mpcb_mul (u, u, z);
+         mpcb_exp (u, u);
+         mpcb_sub (u, t, u);
+         mpcb_log (u, u);
+         ball_half (t, p);
+         mpcb_sub (w, z, t);
+         ball_i_pi (t, 0, p);
+         mpcb_mul (w, w, t);
+         ball_log_2pi (t, p);
+         mpcb_add (w, w, t);
+         mpcb_sub (w, w, u);
+         mpcb_sub (g, w, v);
+      }
+   }
+   else {
+      /* Shift z by n such that the real part is at least 1 and the
+         absolute value at least r. */
+      n = 0;
+      if (x < 1)
+         n = (unsigned long int) (1 - x) + 1;
+      if (x < r && (x + n) * (x + n) + y * y < r * r)
+         n = (unsigned long int) (r - x) + 1;
+
+      if (n == 0) {
+         stirling (g, z);
+         if (take_exp)
+            mpcb_exp (g, g);
+      }
+      else {
+         mpcb_set_ui_ui (t, n, 0, p);
+         mpcb_add (w, z, t);
+         stirling (v, w);
+
+         /* u = z (z+1) ... (z+n-1); since all factors lie in the upper
+            half plane, the argument of the partial products increases by
+            less than pi with each factor, and m counts how often it
+            crosses the negative real axis. */
+         mpcb_set (u, z);
+         m = 0;
+         for (k = 1; k < n; k++) {
+            up = (mpfr_sgn (mpc_imagref (u->c)) >= 0);
+            mpcb_set_ui_ui (t, k, 0, p);
+            mpcb_add (w, z, t);
+            mpcb_mul (u, u, w);
+            if (up && mpfr_sgn (mpc_imagref (u->c)) < 0)
+               m++;
+         }
+
+         if (take_exp) {
+            mpcb_exp (v, v);
+            mpcb_div (g, v, u);
+         }
+         else {
+            mpcb_log (u, u);
+            if (m > 0) {
+               ball_i_pi (t, 1, p);
+               mpcb_set_ui_ui (w, m, 0, p);
+               mpcb_mul (t, t, w);
+               mpcb_add (u, u, t);
+            }
+            mpcb_sub (g, v, u);
+         }
+      }
+   }
+
+   mpcb_clear (t);
+   mpcb_clear (u);
+   mpcb_clear (v);
+   mpcb_clear (w);
+}
+
+
+static int
+gamma_real (mpc_ptr rop, mpc_srcptr op, mpc_rnd_t rnd, int take_exp)
+   /* Handle the case of a real op, that is, with an imaginary part +0
+      or -0. */
+{
+   int inex_re, inex_im, sign, ok;
+   mpfr_srcptr x = mpc_realref (op);
+   mpfr_prec_t prec;
+   mpfr_t t;
+   mpz_t k;
+
+   if (take_exp) {
+      /* Gamma (x) is real; the sign of the imaginary part is kept. */
+      inex_re = mpfr_gamma (mpc_realref (rop), x, MPC_RND_RE (rnd));
+      inex_im = mpfr_set (mpc_imagref (rop), mpc_imagref (op),
+                          MPC_RND_IM (rnd));
+      return MPC_INEX (inex_re, inex_im);
+   }
+
+   if (mpfr_nan_p (x) || (mpfr_inf_p (x) && mpfr_sgn (x) < 0)) {
+      mpfr_set_nan (mpc_realref (rop));
+      mpfr_set_nan (mpc_imagref (rop));
+      return MPC_INEX (0, 0);
+   }
+   else if (!mpfr_signbit (x)) {
+      /* loggamma (x) is real for x >= +0 */
+      inex_re = mpfr_lngamma (mpc_realref (rop), x, MPC_RND_RE (rnd));
+      inex_im = mpfr_set (mpc_imagref (rop), mpc_imagref (op),
+                          MPC_RND_IM (rnd));
+      return MPC_INEX (inex_re, inex_im);
+   }
+   else if (mpfr_integer_p (x) && !mpfr_zero_p (x)) {
+      /* pole at a negative integer */
+      mpfr_set_inf (mpc_realref (rop), +1);
+      mpfr_set_nan (mpc_imagref (rop));
+      return MPC_INEX (0, 0);
+   }
+
+   /* For x < 0, loggamma (x + i*0) = log |Gamma (x)| - i*k*pi, where
+      k = ceil (-x) is the number of factors of the recurrence that
+      lie on the negative real axis; x = -0 is treated as a number
+      slightly smaller than 0. */
+   mpz_init (k);
+   mpfr_init2 (t, 2);
+   if (mpfr_zero_p (x))
+      mpz_set_ui (k, 1);
+   else {
+      mpfr_set_prec (t, MPC_MAX (mpfr_get_prec (x), 2));
+      mpfr_neg (t, x, MPFR_RNDN);
+      mpfr_get_z (k, t, MPFR_RNDU);
+   }
+   if (!mpfr_signbit (mpc_imagref (op)))
+      mpz_neg (k, k);
+   prec = MPC_PREC_IM (rop);
+   do {
+      prec += mpc_ceil_log2 (prec) + 5;
+      mpfr_set_prec (t, prec);
+      mpfr_const_pi (t, MPFR_RNDN);
+      mpfr_mul_z (t, t, k, MPFR_RNDN);
+      /* relative error at most 2^(1-prec) */
+      ok = mpfr_can_round (t, prec - 1, MPFR_RNDN, MPFR_RNDZ,
+                           MPC_PREC_IM (rop)
+                           + (MPC_RND_IM (rnd) == MPFR_RNDN));
+   } while (!ok);
+   /* only now that op has been used, rop may be modified */
+   inex_re = mpfr_lgamma (mpc_realref (rop), &sign, x, MPC_RND_RE (rnd));
+   inex_im = mpfr_set (mpc_imagref (rop), t, MPC_RND_IM (rnd));
+   mpfr_clear (t);
+   mpz_clear (k);
+
+   return MPC_INEX (inex_re, inex_im);
+}
+
+
+static int
+gamma_inf (mpc_ptr rop, mpc_srcptr op, int take_exp)
+   /* Handle the case of a non-real op with an infinite or NaN part:
+      the result is an infinity or zero following the asymptotic
+      behaviour, with a NaN part where the argument is undetermined. */
+{
+   mpfr_srcptr x = mpc_realref (op), y = mpc_imagref (op);
+   int sy = MPFR_SIGNBIT (y);
+
+   if (mpfr_nan_p (x) || mpfr_nan_p (y)
+       || (mpfr_inf_p (x) && mpfr_sgn (x) < 0 && mpfr_inf_p (y)
+           && !take_exp)) {
+      mpfr_set_nan (mpc_realref (rop));
+      mpfr_set_nan (mpc_imagref (rop));
+   }
+   else if (mpfr_inf_p (x) && mpfr_sgn (x) > 0) {
+      /* |Gamma| tends to infinity */
+      mpfr_set_inf (mpc_realref (rop), +1);
+      if (take_exp)
+         mpfr_set_nan (mpc_imagref (rop));
+      else
+         mpfr_set_inf (mpc_imagref (rop), sy);
+   }
+   else if (take_exp) {
+      /* |Gamma| tends to 0 */
+      mpfr_set_ui (mpc_realref (rop), 0, MPFR_RNDN);
+      mpfr_set_ui (mpc_imagref (rop), 0, MPFR_RNDN);
+   }
+   else {
+      /* Re (loggamma) tends to -infinity; the imaginary part is
+         dominated by y log |y| for infinite y, and by pi x for
+         x = -infinity. */
+      mpfr_set_inf (mpc_realref (rop), -1);
+      mpfr_set_inf (mpc_imagref (rop), mpfr_inf_p (y) ? sy : -sy);
+   }
+
+   return MPC_INEX (0, 0);
+}
+
+
+static void
+gamma_stirling_estimate (mpfr_ptr l, mpfr_ptr theta, mpfr_ptr err,
+   mpfr_srcptr x, mpfr_srcptr y)
+   /* For w = x + i*y with x >= 1/2 and |w| >= 2^20, set l and theta to
+      approximations of the real and imaginary parts of
+      (w-1/2) log w - w + log (2 pi) / 2, which differ from log |Gamma (w)|
+      and from an argument of Gamma (w) by less than 2^-20, and set err
+      to a bound on the error of theta. With p the precision of theta,
+      the terms of theta are bounded by |y| (log |w| + 1), so that its
+      rounding errors are at most 8 |y| (log |w| + 1) 2^-p. The error of
+      l is only needed up to a small relative one. */
+{
+   mpfr_prec_t p = mpfr_get_prec (theta);
+   mpfr_t a, lw, t;
+
+   mpfr_inits2 (p, a, lw, t, (mpfr_ptr) 0);
+   mpfr_hypot (lw, x, y, MPFR_RNDN);
+   mpfr_log (lw, lw, MPFR_RNDN);
+   mpfr_atan2 (a, y, x, MPFR_RNDN);
+
+   /* l = (x - 1/2) log |w| - y arg (w) - x + log (2 pi) / 2 */
+   mpfr_sub_d (t, x, 0.5, MPFR_RNDN);
+   mpfr_mul (l, t, lw, MPFR_RNDN);
+   mpfr_mul (theta, y, a, MPFR_RNDN);
+   mpfr_sub (l, l, theta, MPFR_RNDN);
+   mpfr_sub (l, l, x, MPFR_RNDN);
+   mpfr_add_d (l, l, 0.9189385332046727, MPFR_RNDN);
+
+   /* theta = y log |w| + (x - 1/2) arg (w) - y */
+   mpfr_mul (t, t, a, MPFR_RNDN);
+   mpfr_mul (theta, y, lw, MPFR_RNDN);
+   mpfr_add (theta, theta, t, MPFR_RNDN);
+   mpfr_sub (theta, theta, y, MPFR_RNDN);
+
+   mpfr_add_ui (lw, lw, 1, MPFR_RNDU);
+   mpfr_abs (err, y, MPFR_RNDU);
+   mpfr_mul (err, err, lw, MPFR_RNDU);
+   mpfr_mul_2si (err, err, 3 - p, MPFR_RNDU);
+   mpfr_add_d (err, err, 0x1p-20, MPFR_RNDU);
+
+   mpfr_clears (a, lw, t, (mpfr_ptr) 0);
+}
+
+
+static void
+gamma_stirling_arg (mpfr_ptr w, mpfr_srcptr x, int reflect)
+   /* Set w to 1 - x if reflect, to x otherwise. The rounding error of w
+      changes the result of gamma_stirling_estimate for w by at most
+      3 |y| 2^-p when the precision p of w is that of theta, which is
+      covered by the error bound of that function. */
+{
+   if (reflect)
+      mpfr_ui_sub (w, 1, x, MPFR_RNDN);
+   else
+      mpfr_set (w, x, MPFR_RNDN);
+}
+
+
+static int
+gamma_out_of_range (mpc_ptr rop, int *inex, mpc_srcptr op,
+   mpfr_exp_t emin, mpfr_exp_t emax)
+   /* Decide from the Stirling formula at low precision whether both
+      parts of Gamma (op) certainly overflow or certainly underflow in
+      the exponent range [emin, emax]. If so, set rop to a value with the
+      same signs far outside the range, so that mpfr_check_range yields
+      the correct result, set the ternary value inex and return 1;
+      otherwise return 0. op is finite and not real, and the function is
+      called in the extended exponent range.
+      For Re (op) >= 1/2, log |Gamma (op)| and arg Gamma (op) are
+      obtained from gamma_stirling_estimate. Otherwise, the reflection
+      formula Gamma (op) = pi / (sin (pi op) Gamma (w)) with w = 1 - op
+      and Gamma (w) the conjugate of Gamma (1 - x + i*y) is used, where
+      log |sin (pi op)| lies between pi |y| - 1 for |y| >= 1, or
+      log (pi |y|) for |y| < 1, and pi |y|, and where the argument of
+      sin (pi op) is that of sin (pi x') + i cos (pi x') tanh (pi y) with
+      x' = Re (op) mod 2. */
+{
+   mpfr_srcptr x = mpc_realref (op), y = mpc_imagref (op);
+   mpfr_prec_t p;
+   mpfr_t w, l, theta, err, lo, hi, s, c, t;
+   int reflect, ok, over, sc, ss;
+
+   reflect = (mpfr_cmp_d (x, 0.5) < 0);
+   mpfr_inits2 (64, w, l, theta, err, lo, hi, s, c, t, (mpfr_ptr) 0);
+   gamma_stirling_arg (w, x, reflect);
+   /* Gamma (op) can only leave the exponent range for large |w|, and the
+      neighbourhood of the poles is excluded. */
+   if (mpfr_get_exp (w) < 21 && mpfr_get_exp (y) < 21) {
+      mpfr_clears (w, l, theta, err, lo, hi, s, c, t, (mpfr_ptr) 0);
+      return 0;
+   }
+
+   /* Compute theta with an error below 2^-15, so that the signs of
+      cos (theta) and sin (theta) are known when they are at least 2^-12
+      in absolute value. */
+   gamma_stirling_estimate (l, theta, err, w, y);
+   if (mpfr_get_exp (err) > -15) {
+      p = 64 + mpfr_get_exp (err) + 20;
+      mpfr_set_prec (w, p);
+      mpfr_set_prec (theta, p);
+      gamma_stirling_arg (w, x, reflect);
+      gamma_stirling_estimate (l, theta, err, w, y);
+   }
+   p = mpfr_get_prec (theta);
+   ok = 0;
+   if (mpfr_get_exp (err) <= -15) {
+      /* log |Gamma (w)| lies in [lo, hi], up to a relative error of
+         2^-58 from the roundings */
+      mpfr_sub_ui (lo, l, 1, MPFR_RNDD);
+      mpfr_add_ui (hi, l, 1, MPFR_RNDU);
+      if (reflect) {
+         /* log |Gamma (op)| = log pi - log |sin (pi op)| - log |Gamma (w)|
+            with 1.14 < log pi < 1.15 */
+         mpfr_const_pi (t, MPFR_RNDU);
+         mpfr_mul (t, t, y, MPFR_RNDU);
+         mpfr_abs (t, t, MPFR_RNDU);
+         mpfr_neg (s, hi, MPFR_RNDD);
+         mpfr_sub (s, s, t, MPFR_RNDD);
+         mpfr_add_d (s, s, 1.14, MPFR_RNDD);
+         if (mpfr_get_exp (y) >= 1) /* |y| >= 1 */
+            mpfr_sub_ui (t, t, 1, MPFR_RNDD);
+         else {
+            mpfr_const_pi (t, MPFR_RNDD);
+            mpfr_mul (t, t, y, MPFR_RNDD);
+            mpfr_abs (t, t, MPFR_RNDD);
+            mpfr_log (t, t, MPFR_RNDD);
+         }
+         mpfr_neg (hi, lo, MPFR_RNDU);
+         mpfr_sub (hi, hi, t, MPFR_RNDU);
+         mpfr_add_d (hi, hi, 1.15, MPFR_RNDU);
+         mpfr_swap (lo, s);
+
+         /* theta = - arg (sin (pi op)) - arg (Gamma (w)), where the
+            estimate has been computed for the conjugate 1 - x + i*y of
+            w, so that theta currently holds - arg (Gamma (w)) */
+         mpfr_set_prec (s, MPC_MAX (mpfr_get_prec (x), 64));
+         mpfr_set_ui (t, 2, MPFR_RNDN);
+         mpfr_fmod (s, x, t, MPFR_RNDN); /* exact */
+         mpfr_set_prec (t, p);
+         mpfr_set_prec (c, p);
+         mpfr_const_pi (t, MPFR_RNDN);
+         mpfr_mul (c, t, y, MPFR_RNDN);
+         mpfr_tanh (c, c, MPFR_RNDN);
+         mpfr_mul (t, t, s, MPFR_RNDN);
+         mpfr_set_prec (s, p);
+         mpfr_sin_cos (s, t, t, MPFR_RNDN);
+         mpfr_mul (t, t, c, MPFR_RNDN);
+         mpfr_atan2 (t, t, s, MPFR_RNDN);
+         mpfr_sub (theta, theta, t, MPFR_RNDN);
+      }
+      mpfr_set_prec (s, p);
+      mpfr_set_prec (c, p);
+      mpfr_sin_cos (s, c, theta, MPFR_RNDN);
+      ss = (mpfr_get_exp (s) > -11 ? mpfr_sgn (s) : 0);
+      sc = (mpfr_get_exp (c) > -11 ? mpfr_sgn (c) : 0);
+      /* Both parts have an absolute value in
+         [2^-12 |Gamma (op)|, |Gamma (op)|]; compare in base 2, where
+         1/log (2) > 1.4426 leaves room for the relative rounding errors
+         with the factor 1.4425, and with a margin of 16 for the factor
+         2^-12. */
+      over = (mpfr_sgn (lo) > 0);
+      if (over)
+         mpfr_mul_d (lo, lo, 1.4425, MPFR_RNDD);
+      else if (mpfr_sgn (hi) < 0)
+         mpfr_mul_d (hi, hi, 1.4425, MPFR_RNDU);
+      if (ss != 0 && sc != 0
+          && ((over && mpfr_cmp_si (lo, emax + 16) > 0)
+              || (!over && mpfr_cmp_si (hi, emin - 16) < 0))) {
+         /* only now that op has been used, rop may be modified */
+         mpfr_set_si_2exp (mpc_realref (rop), sc, over ? emax + 1 : emin - 4,
+                           MPFR_RNDN);
+         mpfr_set_si_2exp (mpc_imagref (rop), ss, over ? emax + 1 : emin - 4,
+                           MPFR_RNDN);
+         *inex = MPC_INEX (over ? -sc : sc, over ? -ss : ss);
+         ok = 1;
+      }
+   }
+   mpfr_clears (w, l, theta, err, lo, hi, s, c, t, (mpfr_ptr) 0);
+
+   return ok;
+}
+
+
+static int
+gamma_aux (mpc_ptr rop, mpc_srcptr op, mpc_rnd_t rnd, int take_exp)
+{
+   mpcb_t z, g;
+   mpfr_prec_t prec;
+   mpfr_exp_t ex, ey;
+   int inex, inex_re, inex_im, overflow, underflow;
+   int saved_underflow, saved_overflow;
+   mpfr_exp_t saved_emin, saved_emax;
+
+   if (mpfr_zero_p (mpc_imagref (op)))
+      return gamma_real (rop, op, rnd, take_exp);
+   else if (!mpc_fin_p (op))
+      return gamma_inf (rop, op, take_exp);
+
+   saved_emin = mpfr_get_emin ();
+   saved_emax = mpfr_get_emax ();
+   mpfr_set_emin (mpfr_get_emin_min ());
+   mpfr_set_emax (mpfr_get_emax_max ());
+   saved_underflow = mpfr_underflow_p ();
+   saved_overflow = mpfr_overflow_p ();
+
+   /* Gamma (z) may overflow or underflow for large |z|, which is then
+      detected without increasing the precision in proportion to the
+      exponent of z; otherwise, |Re z| and |Im z| are less than about the
+      largest exponent. */
+   if (take_exp
+       && gamma_out_of_range (rop, &inex, op, saved_emin, saved_emax)) {
+      inex_re = MPC_INEX_RE (inex);
+      inex_im = MPC_INEX_IM (inex);
+   }
+   else {
+      /* Initial working precision: Gamma (z) = exp (loggamma (z)) loses
+         about log2 |z log z| bits, and when |y| is much smaller than |x|,
+         the imaginary part of the result is smaller than the real part by
+         a factor of about |y/x|; the latter increase is capped, and the
+         Ziv loop takes over if more is needed. */
+      prec = MPC_MAX_PREC (rop);
+      prec += mpc_ceil_log2 (prec) + 10;
+      ex = mpfr_zero_p (mpc_realref (op)) ? 0
+           : mpfr_get_exp (mpc_realref (op));
+      ey = mpfr_get_exp (mpc_imagref (op));
+      if (take_exp) {
+         ex = MPC_MAX (MPC_MAX (ex, ey), 0);
+         prec += ex + mpc_ceil_log2 (ex + 1);
+      }
+      else if (ex > ey)
+         prec += MPC_MIN (ex - ey, 2 * prec);
+
+      mpcb_init (z);
+      mpcb_init (g);
+      overflow = 0;
+      underflow = 0;
+      while (1) {
+         mpfr_clear_overflow ();
+         mpfr_clear_underflow ();
+         mpcb_set_c (z, op, prec, 0, 0);
+         gamma_ball (g, z, take_exp);
+         if (mpcr_inf_p (g->r)) {
+            /* Only Gamma can overflow or underflow in the extended exponent
+               range; the signs of the parts of the centre are then taken as
+               those of the result. */
+            overflow = mpfr_overflow_p ();
+            underflow = mpfr_underflow_p ();
+            if (overflow || underflow)
+               break;
+         }
+         else if (mpcb_can_round (g, MPC_PREC_RE (rop), MPC_PREC_IM (rop),
+                                  rnd))
+            break;
+         prec += prec / 2;
+      }
+
+      inex = mpcb_round (rop, g, rnd);
+      inex_re = MPC_INEX_RE (inex);
+      inex_im = MPC_INEX_IM (inex);
+      if (overflow) {
+         inex_re = mpc_fix_inf (mpc_realref (rop), MPC_RND_RE (rnd));
+         inex_im = mpc_fix_inf (mpc_imagref (rop), MPC_RND_IM (rnd));
+      }
+      else if (underflow) {
+         inex_re = mpc_fix_zero (mpc_realref (rop), MPC_RND_RE (rnd));
+         inex_im = mpc_fix_zero (mpc_imagref (rop), MPC_RND_IM (rnd));
+      }
+      mpcb_clear (z);
+      mpcb_clear (g);
+   }
+
+   /* restore underflow and overflow flags from MPFR */
+   if (saved_underflow)
+      mpfr_set_underflow ();
+   if (saved_overflow)
+      mpfr_set_overflow ();
+
+   /* restore the exponent range, and check the range of results */
+   mpfr_set_emin (saved_emin);
+   mpfr_set_emax (saved_emax);
+   inex_re = mpfr_check_range (mpc_realref (rop), inex_re, MPC_RND_RE (rnd));
+   inex_im = mpfr_check_range (mpc_imagref (rop), inex_im, MPC_RND_IM (rnd));
+
+   return MPC_INEX (inex_re, inex_im);
+}
+
+
+int
+mpc_lgamma (mpc_ptr rop, mpc_srcptr op, mpc_rnd_t rnd)
+{
+   MPC_STATS_FUNC (lgamma, MPC_MAX_PREC (rop))
+   return gamma_aux (rop, op, rnd, 0);
+}
+
+
+int
+mpc_tgamma (mpc_ptr rop, mpc_srcptr op, mpc_rnd_t rnd)
+{
+   MPC_STATS_FUNC (tgamma, MPC_MAX_PREC (rop))
+   return gamma_aux (rop, op, rnd, 1);
+}
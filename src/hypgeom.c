@@ -0,0 +1,1024 @@
+/* mpc_hypgeom_pfq -- Generalised hypergeometric function of a complex
+   number.
+
+Copyright (C) 2025 INRIA
+
+This file is part of GNU MPC.
+
+GNU MPC is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the
+Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+GNU MPC is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for
+more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program. If not, see http://www.gnu.org/licenses/ .
+*/
+
+#include <stdio.h> /* for MPC_ASSERT */
+#include "mpc-impl.h"
+
+/* The series
+      pFq (a; b; z) = sum_{k>=0} t_k,
+      t_k = (a_1)_k ... (a_p)_k / ((b_1)_k ... (b_q)_k) z^k / k!,
+   with the rising factorials (x)_k = x (x+1) ... (x+k-1), is summed up
+   to its first N terms, where t_{k+1} = rho_k z t_k with
+      rho_k = (a_1+k) ... (a_p+k) / ((b_1+k) ... (b_q+k) (k+1)).
+   N is chosen at low precision from upper bounds U_k >= |t_k| obtained
+   by the same recurrence, which also yield a bound on the tail: If
+   Re (b_j) + N > 0 for all j, then |rho_k z| <= f for all k >= N, where
+   f is obtained by pairing each a_i with one of the denominators b_j + k
+   or k + 1 of real part c + k, using
+   |a_i+k| / |b_j+k| <= max (1, (|a_i|+N) / (c+N)), and by bounding the
+   remaining denominators, which increase with k, from below at k = N;
+   if f < 1, the tail is at most U_N / (1-f).
+   Every parameter is a dyadic number (x + i y) / 2^d with integers x, y
+   and d >= 0, so that rho_k z = (P (k) / Q (k)) 2^shift z with a Gaussian
+   integer P (k) and a positive integer Q (k). The partial sum is obtained
+   in one of three ways:
+   - By binary splitting as a quotient of a Gaussian integer by an
+     integer, when z is a Gaussian dyadic number with few bits and the
+     precision is large, or exactly when the series terminates.
+   - By rectangular splitting, when all parameters are real with few
+     bits: The partial sum is then a polynomial in z with rational
+     coefficients c_k, which is evaluated by a Horner scheme in z^m for
+     m about sqrt (N), the inner polynomials of degree m-1 being
+     evaluated from the precomputed powers z^2, ..., z^(m-1) using only
+     multiplications and divisions by the integers P (k) and Q (k). So
+     there are only about 2 sqrt (N) full multiplications.
+   - By the forward recurrence otherwise.
+   In the last two cases, each term c_k z^k of the computed sum is
+   affected by at most n roundings to nearest of relative error
+   u = 2^(-prec), so that the error of the partial sum is bounded by
+   gamma_n sum_{k<N} U_k with gamma_n = n u / (1 - n u) <= 2 n u for
+   n u <= 1/2. This bound and the bound on the tail are returned in an
+   mpcr_t. */
+
+#define BOUND_PREC 32 /* precision of the bounds on the terms */
+#define SMALL_BITS 64 /* maximal size of a parameter with few bits */
+
+/* A parameter (x + i y) / 2^d. */
+typedef struct {
+   mpz_t x, y;
+   unsigned long int d;
+} hypgeom_param_t;
+
+typedef struct {
+   const mpc_ptr *a;
+   const mpc_ptr *b;
+   unsigned long int p, q;
+   mpc_srcptr z;
+   hypgeom_param_t *c;   /* a_1, ..., a_p, b_1, ..., b_q */
+   long int shift;       /* sum of the d for b_j minus that for a_i */
+   unsigned long int n;  /* 1 + the degree if the series terminates,
+                            0 otherwise */
+   int real;             /* whether all parameters are real */
+   int small;            /* whether all parameters have few bits */
+   size_t bits;          /* the maximal size of the integers x, y, d */
+} hypgeom_t;
+
+
+static mpfr_exp_t
+dyadic_z (mpz_ptr x, mpz_ptr y, mpc_srcptr z)
+   /* Write z = (x + i y) 2^e and return e. */
+{
+   mpfr_exp_t ex, ey, e;
+
+   ex = (mpfr_zero_p (mpc_realref (z)) ? mpfr_get_emax ()
+         : mpfr_get_z_2exp (x, mpc_realref (z)));
+   ey = (mpfr_zero_p (mpc_imagref (z)) ? mpfr_get_emax ()
+         : mpfr_get_z_2exp (y, mpc_imagref (z)));
+   e = MPC_MIN (ex, ey);
+   if (mpfr_zero_p (mpc_realref (z)))
+      mpz_set_ui (x, 0);
+   else
+      mpz_mul_2exp (x, x, (mp_bitcnt_t) (ex - e));
+   if (mpfr_zero_p (mpc_imagref (z)))
+      mpz_set_ui (y, 0);
+   else
+      mpz_mul_2exp (y, y, (mp_bitcnt_t) (ey - e));
+
+   return e;
+}
+
+
+static int
+nonpositive_integer (unsigned long int *d, mpc_srcptr x)
+   /* If x is an integer -d <= 0 with d < LONG_MAX, set d and return 1;
+      otherwise return 0. */
+{
+   if (mpfr_zero_p (mpc_imagref (x)) && mpfr_integer_p (mpc_realref (x))
+       && mpfr_sgn (mpc_realref (x)) <= 0
+       && mpfr_fits_slong_p (mpc_realref (x), MPFR_RNDN)) {
+      *d = (unsigned long int) (- mpfr_get_si (mpc_realref (x), MPFR_RNDN));
+      return 1;
+   }
+   return 0;
+}
+
+
+static int
+conj_p (mpc_srcptr x, mpc_srcptr y)
+   /* Return 1 if y is the complex conjugate of x, and 0 otherwise. */
+{
+   return mpfr_equal_p (mpc_realref (x), mpc_realref (y))
+          && mpfr_cmpabs (mpc_imagref (x), mpc_imagref (y)) == 0
+          && (mpfr_zero_p (mpc_imagref (x))
+              || mpfr_signbit (mpc_imagref (x))
+                 != mpfr_signbit (mpc_imagref (y)));
+}
+
+
+static int
+real_coefficients (const mpc_ptr *a, unsigned long int p,
+   const mpc_ptr *b, unsigned long int q)
+   /* Return 1 if the rational function prod (x+a_i) / prod (x+b_j) has
+      real coefficients, and 0 otherwise; then the terms of the series
+      are real for real z. This is the case if and only if, after
+      cancelling the parameters a_i and b_j that are equal, each of the
+      remaining non-real parameters can be paired with its complex
+      conjugate among the numerator or denominator parameters,
+      respectively. */
+{
+   unsigned long int i, j;
+   char *used;
+   int res = 1;
+
+   used = (char *) calloc (p + q + 1, 1);
+   MPC_ASSERT (used != NULL);
+   for (i = 0; i < p; i++)
+      for (j = 0; j < q; j++)
+         if (!used [p + j] && mpc_cmp (a [i], b [j]) == 0) {
+            used [i] = used [p + j] = 1;
+            break;
+         }
+   for (i = 0; i < p + q && res; i++) {
+      if (used [i] || mpfr_zero_p (mpc_imagref (i < p ? a [i] : b [i - p])))
+         continue;
+      res = 0;
+      for (j = i + 1; j < (i < p ? p : p + q); j++)
+         if (!used [j] && conj_p (i < p ? a [i] : b [i - p],
+                                  j < p ? a [j] : b [j - p])) {
+            used [i] = used [j] = 1;
+            res = 1;
+            break;
+         }
+   }
+   free (used);
+
+   return res;
+}
+
+
+static void
+hypgeom_init (hypgeom_t *h, const mpc_ptr *a, unsigned long int p,
+   const mpc_ptr *b, unsigned long int q, mpc_srcptr z)
+{
+   unsigned long int i, d;
+   hypgeom_param_t *c;
+   mpfr_exp_t e;
+
+   h->a = a;
+   h->b = b;
+   h->p = p;
+   h->q = q;
+   h->z = z;
+   h->n = 0;
+   for (i = 0; i < p; i++)
+      if (nonpositive_integer (&d, a [i]) && (h->n == 0 || d + 1 < h->n))
+         h->n = d + 1;
+
+   h->c = (hypgeom_param_t *) malloc ((p + q + 1) * sizeof (hypgeom_param_t));
+   MPC_ASSERT (h->c != NULL);
+   h->shift = 0;
+   h->real = 1;
+   h->bits = 0;
+   for (i = 0; i < p + q; i++) {
+      c = h->c + i;
+      mpz_init (c->x);
+      mpz_init (c->y);
+      e = dyadic_z (c->x, c->y, i < p ? a [i] : b [i - p]);
+      if (mpz_sgn (c->x) == 0 && mpz_sgn (c->y) == 0)
+         c->d = 0;
+      else if (e >= 0) {
+         mpz_mul_2exp (c->x, c->x, (mp_bitcnt_t) e);
+         mpz_mul_2exp (c->y, c->y, (mp_bitcnt_t) e);
+         c->d = 0;
+      }
+      else
+         c->d = (unsigned long int) (-e);
+      if (i < p)
+         h->shift -= (long int) c->d;
+      else
+         h->shift += (long int) c->d;
+      h->real &= (mpz_sgn (c->y) == 0);
+      h->bits = MPC_MAX (h->bits, mpz_sizeinbase (c->x, 2));
+      h->bits = MPC_MAX (h->bits, mpz_sizeinbase (c->y, 2));
+      h->bits = MPC_MAX (h->bits, c->d);
+   }
+   h->small = (h->bits <= SMALL_BITS);
+}
+
+
+static void
+hypgeom_clear (hypgeom_t *h)
+{
+   unsigned long int i;
+
+   for (i = 0; i < h->p + h->q; i++) {
+      mpz_clear (h->c [i].x);
+      mpz_clear (h->c [i].y);
+   }
+   free (h->c);
+}
+
+
+static void
+hypgeom_ratio (mpz_ptr nr, mpz_ptr ni, mpz_ptr den, const hypgeom_t *h,
+   unsigned long int k, mpz_ptr t, mpz_ptr u)
+   /* Set nr + i ni and den > 0 such that
+      rho_k = (nr + i ni) / den * 2^shift; if all parameters are real,
+      ni is not used. t and u are temporary variables. */
+{
+   const hypgeom_param_t *c;
+   unsigned long int i;
+
+   mpz_set_ui (nr, 1);
+   if (!h->real)
+      mpz_set_ui (ni, 0);
+   mpz_set_ui (den, k);
+   mpz_add_ui (den, den, 1);
+   for (i = 0; i < h->p + h->q; i++) {
+      c = h->c + i;
+      /* t + i y is the numerator of the parameter plus k */
+      mpz_set_ui (t, k);
+      mpz_mul_2exp (t, t, c->d);
+      mpz_add (t, t, c->x);
+      if (mpz_sgn (c->y) == 0) {
+         if (i < h->p) {
+            mpz_mul (nr, nr, t);
+            if (!h->real)
+               mpz_mul (ni, ni, t);
+         }
+         else
+            mpz_mul (den, den, t);
+      }
+      else {
+         /* multiply by t + i y for a_i and by its conjugate for b_j,
+            whose norm goes to the denominator */
+         if (i >= h->p) {
+            mpz_mul (u, t, t);
+            mpz_addmul (u, c->y, c->y);
+            mpz_mul (den, den, u);
+         }
+         mpz_mul (u, nr, t);
+         if (i < h->p) {
+            mpz_submul (u, ni, c->y);
+            mpz_mul (ni, ni, t);
+            mpz_addmul (ni, nr, c->y);
+         }
+         else {
+            mpz_addmul (u, ni, c->y);
+            mpz_mul (ni, ni, t);
+            mpz_submul (ni, nr, c->y);
+         }
+         mpz_swap (nr, u);
+      }
+   }
+   if (mpz_sgn (den) < 0) {
+      mpz_neg (nr, nr);
+      if (!h->real)
+         mpz_neg (ni, ni);
+      mpz_neg (den, den);
+   }
+}
+
+
+static void
+ratio_bound (mpfr_ptr f, const hypgeom_t *h, mpfr_srcptr az,
+   unsigned long int k, mpfr_ptr x, mpfr_ptr y)
+   /* Set f to an upper bound on |rho_j z| for all j >= k, where az is
+      an upper bound on |z|, assuming that Re (b_j) + k > 0 for all j and
+      p <= q + 1. x and y are temporary variables of precision BOUND_PREC. */
+{
+   unsigned long int i;
+
+   mpfr_set (f, az, MPFR_RNDU);
+   for (i = 0; i <= h->q; i++) {
+      /* y is a lower bound on c + k, where c is the real part of the
+         i-th denominator */
+      if (i < h->q)
+         mpfr_add_ui (y, mpc_realref (h->b [i]), k, MPFR_RNDD);
+      else {
+         mpfr_set_ui (y, k, MPFR_RNDD);
+         mpfr_add_ui (y, y, 1, MPFR_RNDD);
+      }
+      if (i < h->p) {
+         mpc_abs (x, h->a [i], MPFR_RNDU);
+         mpfr_add_ui (x, x, k, MPFR_RNDU);
+         mpfr_div (x, x, y, MPFR_RNDU);
+         if (mpfr_cmp_ui (x, 1) > 0)
+            mpfr_mul (f, f, x, MPFR_RNDU);
+      }
+      else {
+         if (i < h->q) {
+            mpfr_abs (x, mpc_imagref (h->b [i]), MPFR_RNDD);
+            mpfr_max (y, y, x, MPFR_RNDD);
+         }
+         mpfr_div (f, f, y, MPFR_RNDU);
+      }
+   }
+}
+
+
+static int
+hypgeom_plan (unsigned long int *N, mpfr_ptr sum, mpfr_ptr tail,
+   const hypgeom_t *h, mpfr_exp_t target)
+   /* Determine the number N of terms such that the tail is bounded by
+      2^target, and set sum to an upper bound on sum_{k<N} |t_k| and
+      tail to an upper bound on the tail. Return 0 if no such N exists
+      or cannot be found, 1 otherwise. */
+{
+   mpfr_t u, az, x, y, f;
+   unsigned long int k, kmin, i;
+   int ok;
+
+   if (h->n == 0 && h->p > h->q + 1)
+      return 0;
+
+   mpfr_init2 (u, BOUND_PREC);
+   mpfr_init2 (x, BOUND_PREC);
+   mpfr_init2 (y, BOUND_PREC);
+   mpfr_init2 (f, BOUND_PREC);
+   /* For p = q + 1, f tends to |z| < 1, which must not be rounded to 1. */
+   mpfr_init2 (az, h->p == h->q + 1 ? 2 * MPC_MAX_PREC (h->z) + 2
+                                     : BOUND_PREC);
+   mpc_abs (az, h->z, MPFR_RNDU);
+
+   /* the smallest k with Re (b_j) + k > 0 for all j */
+   ok = 1;
+   kmin = 0;
+   for (i = 0; i < h->q && ok; i++)
+      if (mpfr_sgn (mpc_realref (h->b [i])) < 0) {
+         mpfr_neg (x, mpc_realref (h->b [i]), MPFR_RNDU);
+         mpfr_floor (x, x);
+         if (mpfr_fits_ulong_p (x, MPFR_RNDN)
+             && mpfr_get_ui (x, MPFR_RNDN) < ULONG_MAX)
+            kmin = MPC_MAX (kmin, mpfr_get_ui (x, MPFR_RNDN) + 1);
+         else
+            ok = h->n != 0;
+      }
+
+   mpfr_set_ui (u, 1, MPFR_RNDN);
+   mpfr_set_ui (sum, 0, MPFR_RNDN);
+   for (k = 0; ok; k++) {
+      /* u is U_k */
+      mpfr_add (sum, sum, u, MPFR_RNDU);
+      if (k + 1 == h->n) {
+         *N = h->n;
+         mpfr_set_ui (tail, 0, MPFR_RNDN);
+         break;
+      }
+      mpfr_mul (u, u, az, MPFR_RNDU);
+      for (i = 0; i < h->p; i++) {
+         /* |a_i + k| <= |Re (a_i) + k| + |Im (a_i)| */
+         mpfr_add_ui (x, mpc_realref (h->a [i]), k, MPFR_RNDA);
+         mpfr_abs (x, x, MPFR_RNDN);
+         mpfr_abs (y, mpc_imagref (h->a [i]), MPFR_RNDU);
+         mpfr_add (x, x, y, MPFR_RNDU);
+         mpfr_mul (u, u, x, MPFR_RNDU);
+      }
+      for (i = 0; i < h->q; i++) {
+         /* |b_i + k| >= max (|Re (b_i) + k|, |Im (b_i)|) */
+         mpfr_add_ui (x, mpc_realref (h->b [i]), k, MPFR_RNDZ);
+         mpfr_abs (x, x, MPFR_RNDN);
+         mpfr_abs (y, mpc_imagref (h->b [i]), MPFR_RNDZ);
+         mpfr_max (x, x, y, MPFR_RNDZ);
+         if (mpfr_zero_p (x))
+            ok = 0;
+         else
+            mpfr_div (u, u, x, MPFR_RNDU);
+      }
+      mpfr_div_ui (u, u, k + 1, MPFR_RNDU);
+      /* u is U_{k+1}; try N = k+1 */
+      if (ok && h->n == 0 && k + 1 >= kmin && mpfr_get_exp (u) <= target) {
+         ratio_bound (f, h, az, k + 1, x, y);
+         if (mpfr_cmp_ui (f, 1) < 0) {
+            mpfr_ui_sub (y, 1, f, MPFR_RNDD);
+            mpfr_div (tail, u, y, MPFR_RNDU);
+            if (mpfr_cmp_ui_2exp (tail, 1, target) <= 0) {
+               *N = k + 1;
+               break;
+            }
+         }
+      }
+   }
+
+   mpfr_clear (u);
+   mpfr_clear (x);
+   mpfr_clear (y);
+   mpfr_clear (f);
+   mpfr_clear (az);
+
+   return ok;
+}
+
+
+static void
+bsplit (mpz_t *P, mpz_ptr Q, mpz_t *T, const hypgeom_t *h, mpz_t *Z,
+   long int shift, unsigned long int k1, unsigned long int k2)
+   /* Write r_k = rho_k z = p_k / q_k with Gaussian integers p_k and
+      positive integers q_k, where z = Z 2^(shift - h->shift).
+      Set P = p_{k1} ... p_{k2-1}, Q = q_{k1} ... q_{k2-1} and
+      T = Q sum_{k=k1+1}^{k2} r_{k1} ... r_{k-1}, where k1 < k2 and P, T
+      and Z are Gaussian integers given by their real and imaginary
+      parts. */
+{
+   if (k2 - k1 == 1) {
+      hypgeom_ratio (T [0], T [1], Q, h, k1, P [0], P [1]);
+      if (h->real)
+         mpz_set_ui (T [1], 0);
+      mpz_mul (P [0], T [0], Z [0]);
+      mpz_submul (P [0], T [1], Z [1]);
+      mpz_mul (P [1], T [0], Z [1]);
+      mpz_addmul (P [1], T [1], Z [0]);
+      if (shift >= 0) {
+         mpz_mul_2exp (P [0], P [0], (mp_bitcnt_t) shift);
+         mpz_mul_2exp (P [1], P [1], (mp_bitcnt_t) shift);
+      }
+      else
+         mpz_mul_2exp (Q, Q, (mp_bitcnt_t) (-shift));
+      mpz_set (T [0], P [0]);
+      mpz_set (T [1], P [1]);
+   }
+   else {
+      mpz_t P2 [2], Q2, T2 [2], t;
+      unsigned long int m = k1 + (k2 - k1) / 2;
+
+      mpz_init (P2 [0]);
+      mpz_init (P2 [1]);
+      mpz_init (Q2);
+      mpz_init (T2 [0]);
+      mpz_init (T2 [1]);
+      mpz_init (t);
+      bsplit (P, Q, T, h, Z, shift, k1, m);
+      bsplit (P2, Q2, T2, h, Z, shift, m, k2);
+      /* T = T Q2 + P T2 */
+      mpz_mul (T [0], T [0], Q2);
+      mpz_mul (T [1], T [1], Q2);
+      mpz_addmul (T [0], P [0], T2 [0]);
+      mpz_submul (T [0], P [1], T2 [1]);
+      mpz_addmul (T [1], P [0], T2 [1]);
+      mpz_addmul (T [1], P [1], T2 [0]);
+      /* P = P P2 */
+      mpz_mul (t, P [0], P2 [1]);
+      mpz_mul (P [0], P [0], P2 [0]);
+      mpz_submul (P [0], P [1], P2 [1]);
+      mpz_mul (P [1], P [1], P2 [0]);
+      mpz_add (P [1], P [1], t);
+      mpz_mul (Q, Q, Q2);
+      mpz_clear (P2 [0]);
+      mpz_clear (P2 [1]);
+      mpz_clear (Q2);
+      mpz_clear (T2 [0]);
+      mpz_clear (T2 [1]);
+      mpz_clear (t);
+   }
+}
+
+
+static int
+hypgeom_bsplit_sum (mpc_ptr s, const hypgeom_t *h, unsigned long int N,
+   mpz_t *Z, mpfr_exp_t e, mpc_rnd_t rnd)
+   /* Set s to the correctly rounded sum of the first N >= 2 terms
+      computed by binary splitting, where z = (Z [0] + i Z [1]) 2^e,
+      and return the inexact value. */
+{
+   mpz_t P [2], Q, T [2];
+   mpfr_t x;
+   int inex_re, inex_im;
+
+   mpz_init (P [0]);
+   mpz_init (P [1]);
+   mpz_init (Q);
+   mpz_init (T [0]);
+   mpz_init (T [1]);
+   bsplit (P, Q, T, h, Z, h->shift + (long int) e, 0, N - 1);
+   mpz_add (T [0], T [0], Q);
+   /* Divide the exact numerators by Q with only one rounding. */
+   mpfr_init2 (x, MPC_MAX (mpz_sizeinbase (T [0], 2), MPFR_PREC_MIN));
+   mpfr_set_z (x, T [0], MPFR_RNDN);
+   inex_re = mpfr_div_z (mpc_realref (s), x, Q, MPC_RND_RE (rnd));
+   mpfr_set_prec (x, MPC_MAX (mpz_sizeinbase (T [1], 2), MPFR_PREC_MIN));
+   mpfr_set_z (x, T [1], MPFR_RNDN);
+   inex_im = mpfr_div_z (mpc_imagref (s), x, Q, MPC_RND_IM (rnd));
+   mpfr_clear (x);
+   mpz_clear (P [0]);
+   mpz_clear (P [1]);
+   mpz_clear (Q);
+   mpz_clear (T [0]);
+   mpz_clear (T [1]);
+
+   return MPC_INEX (inex_re, inex_im);
+}
+
+
+unsigned long int
+mpc_rect_sum (mpc_ptr s, mpc_srcptr w, unsigned long int n,
+   mpc_rect_ratio_t ratio, const void *data, unsigned long int r)
+   /* Set s to sum_{k<n} c_k w^k with c_0 = 1 by rectangular splitting at
+      the precision of s, where ratio (u, k, data) multiplies u by
+      c_k / c_{k-1} for 1 <= k < n with at most r roundings, and return
+      a bound on the number of roundings affecting each term, not
+      counting those of w: Let A_k = sum_{j=k}^{n-1} c_j / c_k w^(j-mi)
+      with i = floor (k/m) for m about sqrt (n). Then
+      A_{n-1} = w^((n-1) mod m) and
+      A_k = w^(k mod m) + (c_{k+1} / c_k) A_{k+1} w^(m (floor ((k+1)/m) - i)),
+      and the sum is A_0. The term c_j w^j suffers from at most m-1
+      roundings in its power of w, r+1 per step and m per multiplication
+      by w^m, so from at most (r+2) n + m roundings. */
+{
+   mpfr_prec_t prec = MPC_MAX_PREC (s);
+   unsigned long int m, i, k;
+   mpc_t *pw;
+
+   for (m = 1; (m + 1) * (m + 1) <= n; m++);
+   pw = (mpc_t *) malloc ((m + 1) * sizeof (mpc_t));
+   MPC_ASSERT (pw != NULL);
+   /* The power w^i is obtained with at most i-1 roundings. */
+   mpc_init3 (pw [1], MPC_PREC_RE (w), MPC_PREC_IM (w));
+   mpc_set (pw [1], w, MPC_RNDNN);
+   for (i = 2; i <= m; i++) {
+      mpc_init2 (pw [i], prec);
+      if (i % 2 == 0)
+         mpc_sqr (pw [i], pw [i / 2], MPC_RNDNN);
+      else
+         mpc_mul (pw [i], pw [i - 1], w, MPC_RNDNN);
+   }
+
+   if ((n - 1) % m == 0)
+      mpc_set_ui (s, 1, MPC_RNDNN);
+   else
+      mpc_set (s, pw [(n - 1) % m], MPC_RNDNN);
+   for (k = n - 1; k-- > 0; ) {
+      ratio (s, k + 1, data);
+      if ((k + 1) % m == 0)
+         mpc_mul (s, s, pw [m], MPC_RNDNN);
+      if (k % m == 0)
+         mpc_add_ui (s, s, 1, MPC_RNDNN);
+      else
+         mpc_add (s, s, pw [k % m], MPC_RNDNN);
+   }
+
+   for (i = 1; i <= m; i++)
+      mpc_clear (pw [i]);
+   free (pw);
+
+   return (r + 2) * n + m;
+}
+
+
+/* Data for rect_ratio: the series and temporary variables. */
+typedef struct {
+   const hypgeom_t *h;
+   mpz_ptr num, den, t, u;
+} hypgeom_rect_t;
+
+
+static void
+rect_ratio (mpc_ptr s, unsigned long int k, const void *data)
+   /* Multiply s by rho_{k-1} for real parameters with 2 roundings. */
+{
+   const hypgeom_rect_t *d = (const hypgeom_rect_t *) data;
+
+   hypgeom_ratio (d->num, NULL, d->den, d->h, k - 1, d->t, d->u);
+   if (mpz_fits_slong_p (d->num))
+      mpc_mul_si (s, s, mpz_get_si (d->num), MPC_RNDNN);
+   else {
+      mpfr_mul_z (mpc_realref (s), mpc_realref (s), d->num, MPFR_RNDN);
+      mpfr_mul_z (mpc_imagref (s), mpc_imagref (s), d->num, MPFR_RNDN);
+   }
+   if (mpz_fits_ulong_p (d->den))
+      mpc_div_ui (s, s, mpz_get_ui (d->den), MPC_RNDNN);
+   else {
+      mpfr_div_z (mpc_realref (s), mpc_realref (s), d->den, MPFR_RNDN);
+      mpfr_div_z (mpc_imagref (s), mpc_imagref (s), d->den, MPFR_RNDN);
+   }
+   mpc_mul_2si (s, s, d->h->shift, MPC_RNDNN);
+}
+
+
+static unsigned long int
+hypgeom_rect (mpc_ptr s, const hypgeom_t *h, unsigned long int N)
+   /* Set s to the sum of the first N terms by rectangular splitting for
+      real parameters and return a bound on the number of roundings
+      affecting each term. */
+{
+   hypgeom_rect_t d;
+   mpz_t num, den, t, u;
+   unsigned long int n;
+
+   mpz_init (num);
+   mpz_init (den);
+   mpz_init (t);
+   mpz_init (u);
+   d.h = h;
+   d.num = num;
+   d.den = den;
+   d.t = t;
+   d.u = u;
+
+   n = mpc_rect_sum (s, h->z, N, rect_ratio, &d, 2);
+
+   mpz_clear (num);
+   mpz_clear (den);
+   mpz_clear (t);
+   mpz_clear (u);
+
+   return n;
+}
+
+
+static unsigned long int
+hypgeom_forward (mpc_ptr s, const hypgeom_t *h, unsigned long int N)
+   /* Set s to the sum of the first N terms by the forward recurrence and
+      return a bound on the number of roundings affecting each term:
+      2p + 2q + 2 per step and at most N for the additions. */
+{
+   mpfr_prec_t prec = MPC_MAX_PREC (s);
+   unsigned long int k, i;
+   mpc_t t, u;
+
+   mpc_init2 (t, prec);
+   mpc_init2 (u, prec);
+   mpc_set_ui (t, 1, MPC_RNDNN);
+   mpc_set_ui (s, 1, MPC_RNDNN);
+   for (k = 0; k + 1 < N; k++) {
+      for (i = 0; i < h->p; i++) {
+         mpc_add_ui (u, h->a [i], k, MPC_RNDNN);
+         mpc_mul (t, t, u, MPC_RNDNN);
+      }
+      mpc_mul (t, t, h->z, MPC_RNDNN);
+      for (i = 0; i < h->q; i++) {
+         mpc_add_ui (u, h->b [i], k, MPC_RNDNN);
+         mpc_div (t, t, u, MPC_RNDNN);
+      }
+      mpc_div_ui (t, t, k + 1, MPC_RNDNN);
+      mpc_add (s, s, t, MPC_RNDNN);
+   }
+   mpc_clear (t);
+   mpc_clear (u);
+
+   return (2 * (h->p + h->q) + 3) * N;
+}
+
+
+int
+mpc_hypgeom_sum (mpc_ptr s, mpcr_ptr err, const mpc_ptr *a,
+   unsigned long int p, const mpc_ptr *b, unsigned long int q,
+   mpc_srcptr z, mpfr_exp_t target)
+   /* Set s to an approximation of pFq (a; b; z) at its precision and err
+      to a bound on its absolute error, where the tail of the series
+      contributes at most 2^target. The parameters b_j must not be
+      non-positive integers unless the series terminates before, and the
+      function should be called with an extended exponent range.
+      Return 0 if the series diverges or cannot be bounded, in which case
+      err is infinite, and 1 otherwise. */
+{
+   hypgeom_t h;
+   mpfr_prec_t prec = MPC_MAX_PREC (s);
+   mpfr_t sum, tail;
+   mpcr_t r;
+   mpz_t Z [2];
+   mpfr_exp_t e;
+   unsigned long int N, n;
+   int ok, bs;
+
+   hypgeom_init (&h, a, p, b, q, z);
+   mpfr_init2 (sum, BOUND_PREC);
+   mpfr_init2 (tail, BOUND_PREC);
+   mpz_init (Z [0]);
+   mpz_init (Z [1]);
+
+   ok = hypgeom_plan (&N, sum, tail, &h, target);
+   if (!ok)
+      mpcr_set_inf (err);
+   else {
+      bs = 0;
+      e = 0;
+      if (N > 1 && h.small && prec >= HYPGEOM_BSPLIT_THRESHOLD) {
+         e = dyadic_z (Z [0], Z [1], z);
+         bs = (mpz_sizeinbase (Z [0], 2) <= (size_t) prec / 8
+               && mpz_sizeinbase (Z [1], 2) <= (size_t) prec / 8);
+      }
+      if (N == 1) {
+         mpc_set_ui (s, 1, MPC_RNDNN);
+         mpcr_set_zero (err);
+      }
+      else if (bs) {
+         /* one rounding of the exact partial sum */
+         hypgeom_bsplit_sum (s, &h, N, Z, e, MPC_RNDNN);
+         mpcr_c_abs_rnd (err, s, MPFR_RNDU);
+         mpcr_div_2ui (err, err, (unsigned long int) prec - 2);
+      }
+      else {
+         if (h.real && h.small)
+            n = hypgeom_rect (s, &h, N);
+         else
+            n = hypgeom_forward (s, &h, N);
+         if (mpc_ceil_log2 ((mpfr_prec_t) n) >= prec - 1)
+            mpcr_set_inf (err);
+         else {
+            /* gamma_n <= n 2^(1-prec) */
+            mpcr_set_ui64_2si64 (err, (uint64_t) n, (int64_t) (1 - prec));
+            mpcr_f_abs_rnd (r, sum, MPFR_RNDU);
+            mpcr_mul (err, err, r);
+         }
+      }
+      mpcr_f_abs_rnd (r, tail, MPFR_RNDU);
+      mpcr_add (err, err, r);
+   }
+
+   hypgeom_clear (&h);
+   mpfr_clear (sum);
+   mpfr_clear (tail);
+   mpz_clear (Z [0]);
+   mpz_clear (Z [1]);
+
+   return ok;
+}
+
+
+static int
+can_round_part (mpfr_srcptr x, mpcr_srcptr err, mpfr_prec_t prec,
+   mpfr_rnd_t rnd)
+   /* Return 1 if a number at distance at most err from x can be correctly
+      rounded to precision prec in the direction rnd from x. */
+{
+   mpfr_exp_t e;
+
+   if (mpfr_zero_p (x) || mpcr_inf_p (err))
+      return 0;
+   else if (mpcr_zero_p (err))
+      return 1;
+   e = mpfr_get_exp (x) - (mpfr_exp_t) mpcr_get_exp (err);
+   return e > 1 && mpfr_can_round (x, e, MPFR_RNDN, MPFR_RNDZ,
+                                   prec + (rnd == MPFR_RNDN));
+}
+
+
+static mpfr_exp_t
+hypgeom_magnitude (mpc_srcptr s, mpfr_exp_t mag, mpfr_prec_t prec,
+   int real)
+   /* Return the exponent of the smallest part of s that has to be
+      rounded, or mag - prec if it vanishes. */
+{
+   mpfr_exp_t e, m;
+
+   e = (mpfr_zero_p (mpc_realref (s)) ? mag - prec
+        : mpfr_get_exp (mpc_realref (s)));
+   m = e;
+   if (!real) {
+      e = (mpfr_zero_p (mpc_imagref (s)) ? mag - prec
+           : mpfr_get_exp (mpc_imagref (s)));
+      m = MPC_MIN (m, e);
+   }
+
+   return m;
+}
+
+
+static int
+hypgeom_binomial (mpc_ptr rop, mpc_srcptr a, mpc_srcptr z, mpc_rnd_t rnd)
+   /* Set rop to 1F0 (a;; z) = (1-z)^(-a) for |z| < 1 with the correctly
+      rounded mpc_pow, which also recognises exact results, and return
+      its rounding direction value. Return -1 without changing rop if
+      1-z cannot be computed exactly at a reasonable precision. */
+{
+   mpfr_srcptr x = mpc_realref (z);
+   mpfr_prec_t prec;
+   mpc_t w, c;
+   int inex;
+
+   /* Since |x| < 1, 1-x is exact with prec (x) - exp (x) + 2 bits. */
+   prec = 2;
+   if (!mpfr_zero_p (x))
+      prec = mpfr_get_prec (x) - mpfr_get_exp (x) + 2;
+   if (prec > MPC_MAX_PREC (z) + MPC_MAX_PREC (rop) + 64)
+      return -1;
+
+   mpc_init3 (w, prec, mpfr_get_prec (mpc_imagref (z)));
+   mpc_init3 (c, mpfr_get_prec (mpc_realref (a)),
+              mpfr_get_prec (mpc_imagref (a)));
+   mpc_ui_sub (w, 1, z, MPC_RNDNN); /* exact */
+   mpc_neg (c, a, MPC_RNDNN);
+   inex = mpc_pow (rop, w, c, rnd);
+   mpc_clear (w);
+   mpc_clear (c);
+
+   return inex;
+}
+
+
+static int
+hypgeom_pfq (mpc_ptr rop, const mpc_ptr *a, unsigned long int p,
+   const mpc_ptr *b, unsigned long int q, mpc_srcptr z, mpc_rnd_t rnd)
+   /* Compute pFq (a; b; z) as mpc_hypgeom_pfq, assuming that no a_i
+      and b_j cancel. */
+{
+   hypgeom_t h;
+   mpc_t s, one;
+   mpcr_t err;
+   mpz_t Z [2];
+   mpfr_prec_t prec;
+   mpfr_exp_t mag, e, d;
+   unsigned long int i, m;
+   double size;
+   int real, nan, inex, inex_re, inex_im;
+   int saved_underflow, saved_overflow;
+   mpfr_exp_t saved_emin, saved_emax;
+
+   nan = !mpc_fin_p (z);
+   for (i = 0; i < p + q; i++)
+      nan |= !mpc_fin_p (i < p ? a [i] : b [i - p]);
+   if (nan) {
+      mpc_set_nan (rop);
+      return MPC_INEX (0, 0);
+   }
+
+   hypgeom_init (&h, a, p, b, q, z);
+   /* poles: b_j = -m and the series does not terminate before */
+   for (i = 0; i < q; i++)
+      if (mpfr_zero_p (mpc_imagref (b [i]))
+          && mpfr_integer_p (mpc_realref (b [i]))
+          && mpfr_sgn (mpc_realref (b [i])) <= 0
+          && (h.n == 0 || !nonpositive_integer (&m, b [i]) || m + 1 < h.n))
+         nan = 1;
+   if (!nan && h.n == 0 && p >= q + 1 && !mpc_zero_p (z)) {
+      /* divergence for p > q + 1 and |z| >= 1 for p = q + 1 */
+      mpc_init2 (one, 2);
+      mpc_set_ui (one, 1, MPC_RNDNN);
+      nan = (p > q + 1 || mpc_cmp_abs (z, one) >= 0);
+      mpc_clear (one);
+   }
+   if (nan) {
+      hypgeom_clear (&h);
+      mpc_set_nan (rop);
+      return MPC_INEX (0, 0);
+   }
+   if (mpc_zero_p (z) || h.n == 1) {
+      hypgeom_clear (&h);
+      return mpc_set_ui (rop, 1, rnd);
+   }
+
+   /* The result is real if z is real and the terms of the series are,
+      which happens also for non-real parameters. */
+   real = mpfr_zero_p (mpc_imagref (z))
+          && (h.real || real_coefficients (a, p, b, q));
+
+   /* Non-terminating series with an elementary closed form, whose
+      value may be exactly representable, as 1F0 (1;; 1/2) = 2, and
+      would then make the loop below run forever. */
+   inex = -1;
+   if (p == 0 && q == 0)
+      inex = mpc_exp (rop, z, rnd);
+   else if (p == 1 && q == 0 && h.n == 0)
+      inex = hypgeom_binomial (rop, a [0], z, rnd);
+   if (inex != -1) {
+      hypgeom_clear (&h);
+      if (real)
+         mpfr_set_zero (mpc_imagref (rop), 1);
+      return inex;
+   }
+
+   saved_emin = mpfr_get_emin ();
+   saved_emax = mpfr_get_emax ();
+   mpfr_set_emin (mpfr_get_emin_min ());
+   mpfr_set_emax (mpfr_get_emax_max ());
+   saved_underflow = mpfr_underflow_p ();
+   saved_overflow = mpfr_overflow_p ();
+
+   mpz_init (Z [0]);
+   mpz_init (Z [1]);
+   prec = MPC_MAX_PREC (rop);
+   e = 0;
+   size = 0.0;
+   if (h.n != 0) {
+      /* a rough estimate of the size of the exact result */
+      e = dyadic_z (Z [0], Z [1], z);
+      size = (double) (p + 2 * q + 1) * (double) (h.bits + 64)
+             + (double) MPC_MAX (mpz_sizeinbase (Z [0], 2),
+                                 mpz_sizeinbase (Z [1], 2))
+             + (double) SAFE_ABS (unsigned long int, h.shift + (long int) e);
+      size *= (double) h.n;
+   }
+   if (h.n != 0 && size <= (double) MPC_MAX (1ul << 20, 16ul * prec))
+      /* terminating series summed exactly */
+      inex = hypgeom_bsplit_sum (rop, &h, h.n, Z, e, rnd);
+   else {
+      /* The exponent mag of the result is first assumed to be 0, then
+         taken from the previous approximation, and the precision is
+         increased by at least the loss due to cancellation. */
+      prec += mpc_ceil_log2 (prec) + 20;
+      mag = 0;
+      mpc_init2 (s, prec);
+      while (1) {
+         if (!mpc_hypgeom_sum (s, err, a, p, b, q, z, mag - prec)) {
+            mpc_set_nan (rop);
+            inex = MPC_INEX (0, 0);
+            break;
+         }
+         if (can_round_part (mpc_realref (s), err, MPC_PREC_RE (rop),
+                             MPC_RND_RE (rnd))
+             && (real || can_round_part (mpc_imagref (s), err,
+                            MPC_PREC_IM (rop), MPC_RND_IM (rnd)))) {
+            inex_re = mpfr_set (mpc_realref (rop), mpc_realref (s),
+                                MPC_RND_RE (rnd));
+            if (real) {
+               mpfr_set_zero (mpc_imagref (rop), 1);
+               inex_im = 0;
+            }
+            else
+               inex_im = mpfr_set (mpc_imagref (rop), mpc_imagref (s),
+                                   MPC_RND_IM (rnd));
+            inex = MPC_INEX (inex_re, inex_im);
+            break;
+         }
+         mag = hypgeom_magnitude (s, mag, prec, real);
+         d = (mpcr_inf_p (err) ? 0
+              : (mpfr_exp_t) mpcr_get_exp (err) - mag
+                + MPC_MAX_PREC (rop) + 10);
+         prec += MPC_MAX (prec / 2, d);
+         mpc_set_prec (s, prec);
+      }
+      mpc_clear (s);
+   }
+   mpz_clear (Z [0]);
+   mpz_clear (Z [1]);
+   hypgeom_clear (&h);
+
+   /* Flags raised by intermediate computations are not meaningful. */
+   mpfr_clear_overflow ();
+   mpfr_clear_underflow ();
+   /* restore underflow and overflow flags from MPFR */
+   if (saved_underflow)
+      mpfr_set_underflow ();
+   if (saved_overflow)
+      mpfr_set_overflow ();
+
+   /* restore the exponent range, and check the range of results */
+   mpfr_set_emin (saved_emin);
+   mpfr_set_emax (saved_emax);
+   inex_re = mpfr_check_range (mpc_realref (rop), MPC_INEX_RE (inex),
+                               MPC_RND_RE (rnd));
+   inex_im = mpfr_check_range (mpc_imagref (rop), MPC_INEX_IM (inex),
+                               MPC_RND_IM (rnd));
+
+   return MPC_INEX (inex_re, inex_im);
+}
+
+
+int
+mpc_hypgeom_pfq (mpc_ptr rop, const mpc_ptr *a, unsigned long int p,
+   const mpc_ptr *b, unsigned long int q, mpc_srcptr z, mpc_rnd_t rnd)
+{
+   MPC_STATS_FUNC (hypgeom_pfq, MPC_MAX_PREC (rop))
+   mpc_ptr *c;
+   char *used;
+   unsigned long int i, j, k, l;
+   int inex;
+
+   /* Parameters a_i = b_j cancel, except for non-positive integers,
+      which determine where the series terminates or has a pole. */
+   c = (mpc_ptr *) malloc ((p + q + 1) * sizeof (mpc_ptr));
+   used = (char *) calloc (p + q + 1, 1);
+   MPC_ASSERT (c != NULL && used != NULL);
+   for (i = 0; i < p; i++)
+      if (mpc_fin_p (a [i])
+          && !(mpfr_zero_p (mpc_imagref (a [i]))
+               && mpfr_integer_p (mpc_realref (a [i]))
+               && mpfr_sgn (mpc_realref (a [i])) <= 0))
+         for (j = 0; j < q; j++)
+            if (!used [p + j] && mpc_fin_p (b [j])
+                && mpc_cmp (a [i], b [j]) == 0) {
+               used [i] = used [p + j] = 1;
+               break;
+            }
+   k = 0;
+   for (i = 0; i < p; i++)
+      if (!used [i])
+         c [k++] = a [i];
+   l = 0;
+   for (j = 0; j < q; j++)
+      if (!used [p + j])
+         c [k + l++] = b [j];
+   inex = hypgeom_pfq (rop, c, k, c + k, l, z, rnd);
+   free (c);
+   free (used);
+
+   return inex;
+}
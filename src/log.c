@@ -1,6 +1,6 @@
 /* mpc_log -- Take the logarithm of a complex number.
 
-Copyright (C) 2008, 2009, 2010, 2011, 2012, 2024 INRIA
+Copyright (C) 2008, 2009, 2010, 2011, 2012, 2024, 2025 INRIA
 
 This file is part of GNU MPC.
 
@@ -23,6 +23,7 @@ along with this program. If not, see http://www.gnu.org/licenses/ .
 
 int
 mpc_log (mpc_ptr rop, mpc_srcptr op, mpc_rnd_t rnd){
+   MPC_STATS_FUNC (log, MPC_MAX_PREC (rop))
    int ok, underflow = 0;
    mpfr_srcptr x, y;
    mpfr_t v, w;
@@ -176,6 +177,7 @@ mpc_log (mpc_ptr rop, mpc_srcptr op, mpc_rnd_t rnd){
       do {
          MPC_LOOP_NEXT(loop, op, rop);
          prec += (loop <= 2) ? mpc_ceil_log2 (prec) + 4 : prec / 2;
+         MPC_ZIV_START (log, loop, prec, MPC_PREC_RE (rop));
          mpfr_set_prec (v, prec);
          mpfr_set_prec (w, prec);
 
@@ -213,6 +215,7 @@ mpc_log (mpc_ptr rop, mpc_srcptr op, mpc_rnd_t rnd){
       } while (!underflow &&
                !mpfr_can_round (w, prec - err, MPFR_RNDN, MPFR_RNDZ,
                mpfr_get_prec (mpc_realref (rop)) + (MPC_RND_RE (rnd) == MPFR_RNDN)));
+      MPC_ZIV_END (log, loop, prec, MPC_PREC_RE (rop));
       mpfr_clear (v);
    }
 
@@ -1,6 +1,6 @@
 /* mpc_log10 -- Take the base-10 logarithm of a complex number.
 
-Copyright (C) 2012, 2020, 2024 INRIA
+Copyright (C) 2012, 2020, 2024, 2025 INRIA
 
 This file is part of GNU MPC.
 
@@ -32,6 +32,7 @@ mpfr_const_log10 (mpfr_ptr log10)
 int
 mpc_log10 (mpc_ptr rop, mpc_srcptr op, mpc_rnd_t rnd)
 {
+   MPC_STATS_FUNC (log10, MPC_MAX_PREC (rop))
    int ok = 0, loop = 0, check_exact = 0, special_re, special_im,
        inex, inex_re, inex_im;
    mpfr_prec_t prec;
@@ -51,6 +52,7 @@ mpc_log10 (mpc_ptr rop, mpc_srcptr op, mpc_rnd_t rnd)
    while (ok == 0) {
       MPC_LOOP_NEXT(loop, op, rop);
       prec += (loop <= 2) ? mpc_ceil_log2 (prec) + 4 : prec / 2;
+      MPC_ZIV_START (log10, loop, prec, MPC_MAX_PREC (rop));
       mpfr_set_prec (log10, prec);
       mpc_set_prec (log, prec);
 
@@ -139,6 +141,7 @@ mpc_log10 (mpc_ptr rop, mpc_srcptr op, mpc_rnd_t rnd)
       }
    }
 
+   MPC_ZIV_END (log10, loop, prec, MPC_MAX_PREC (rop));
    inex_re = mpfr_set (mpc_realref(rop), mpc_realref (log), MPC_RND_RE (rnd));
    if (special_re)
       inex_re = MPC_INEX_RE (inex);
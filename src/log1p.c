@@ -0,0 +1,180 @@
+/* mpc_log1p -- natural logarithm of one plus a complex number.
+
+Copyright (C) 2025 INRIA
+
+This file is part of GNU MPC.
+
+GNU MPC is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the
+Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+GNU MPC is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for
+more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program. If not, see http://www.gnu.org/licenses/ .
+*/
+
+#include "mpc-impl.h"
+
+/* For z = x + i*y, we have log(1+z) = log|1+z| + i*atan2(y, 1+x).
+   The real part is computed as
+      log|1+z| = 1/2 * log1p (x*(2+x) + y^2)
+   when x > -1/2, which does not suffer from a cancellation for z close
+   to 0, and as log (hypot (1+x, y)) otherwise, where |1+z| may be close
+   to 0 and the absolute error of the second formula is sufficient. */
+
+int
+mpc_log1p (mpc_ptr rop, mpc_srcptr op, mpc_rnd_t rnd)
+{
+   MPC_STATS_FUNC (log1p, MPC_MAX_PREC (rop))
+   int ok_re = 0, ok_im = 0, loop = 0, inex_re, inex_im, inex_w, inex_h;
+   mpfr_prec_t prec;
+   mpfr_t w, s, u, re, im;
+   mpfr_exp_t err, eu, cancel = 0;
+   mpfr_exp_t saved_emin, saved_emax;
+   int small;
+
+   if (!mpc_fin_p (op))
+      /* Adding 1 to a number with an infinite or NaN part does not change
+         log(z): when the real part is finite, the imaginary part is
+         infinite or NaN, and the result does not depend on the real part. */
+      return mpc_log (rop, op, rnd);
+
+   if (mpfr_zero_p (mpc_imagref (op))
+       && mpfr_cmp_si (mpc_realref (op), -1) >= 0) {
+      /* real input x >= -1: log1p(x+i*0) = log1p(x) + i*0 */
+      inex_re = mpfr_log1p (mpc_realref (rop), mpc_realref (op),
+                            MPC_RND_RE (rnd));
+      inex_im = mpfr_set (mpc_imagref (rop), mpc_imagref (op),
+                          MPC_RND_IM (rnd));
+      return MPC_INEX (inex_re, inex_im);
+   }
+
+   saved_emin = mpfr_get_emin ();
+   saved_emax = mpfr_get_emax ();
+   mpfr_set_emin (mpfr_get_emin_min ());
+   mpfr_set_emax (mpfr_get_emax_max ());
+
+   /* For x > -1/2, |1+z| > 1/2. Otherwise, 1+x is exact in precision
+      at least prec(x)+2 as soon as |x| < 4, and |1+x| >= |x|/2 else. */
+   small = mpfr_cmp_si_2exp (mpc_realref (op), -1, -1) > 0;
+
+   mpfr_init2 (w, 2);
+   mpfr_init2 (s, 2);
+   mpfr_init2 (u, 2);
+   mpfr_init2 (re, 2);
+   mpfr_init2 (im, 2);
+
+   prec = MPC_MAX_PREC (rop);
+   if (!small)
+      prec = MPC_MAX (prec, mpfr_get_prec (mpc_realref (op)) + 2);
+
+   while (ok_re == 0 || ok_im == 0) {
+      MPC_LOOP_NEXT (loop, op, rop);
+      prec += (loop <= 2) ? mpc_ceil_log2 (prec) + 4 + cancel : prec / 2;
+      MPC_ZIV_START (log1p, loop, prec, MPC_MAX_PREC (rop));
+      mpfr_set_prec (w, prec);
+      mpfr_set_prec (s, prec);
+      mpfr_set_prec (u, prec);
+      mpfr_set_prec (re, prec);
+      mpfr_set_prec (im, prec);
+
+      /* w = 1+x with a relative error of at most 2^-prec */
+      inex_w = mpfr_add_ui (w, mpc_realref (op), 1, MPFR_RNDN);
+
+      /* imaginary part: perturbing 1+x by a relative error d changes
+         atan2(y,1+x) by a relative error of at most |d|(1+2|d|), so that
+         with the final rounding the error is bounded by 2 ulps */
+      mpfr_atan2 (im, mpc_imagref (op), w, MPFR_RNDN);
+      ok_im = mpfr_can_round (im, prec - 1, MPFR_RNDN, MPFR_RNDZ,
+                              MPC_PREC_IM (rop)
+                              + (MPC_RND_IM (rnd) == MPFR_RNDN));
+
+      if (small) {
+         /* s = 2+x with relative error 2^-prec, u = x*s + y^2; the error
+            on u is bounded by 2^(max(ex+es,eu)+1-prec) =: 2^err */
+         mpfr_add_ui (s, mpc_realref (op), 2, MPFR_RNDN);
+         mpfr_fmma (u, mpc_realref (op), s, mpc_imagref (op),
+                    mpc_imagref (op), MPFR_RNDN);
+         if (mpfr_zero_p (u)) {
+            /* total cancellation, that is, |1+z| is very close to 1 */
+            cancel = prec;
+            ok_re = 0;
+            continue;
+         }
+         eu = mpfr_get_exp (u);
+         err = eu;
+         if (!mpfr_zero_p (mpc_realref (op)))
+            err = MPC_MAX (err, mpfr_get_exp (mpc_realref (op))
+                                + mpfr_get_exp (s));
+         err += 1 - prec;
+         /* Since 1+u = |1+z|^2 > 1/4, with the computed value u' we have
+            min (1+u, 1+u') >= 2^(eu-2) if u' >= 1 and |u-u'| <= u'/2,
+            and >= 1/8 if |u-u'| <= 1/8; the error on log1p(u') is then
+            bounded by 2^(err-d) with d the logarithm of that bound. */
+         if (mpfr_sgn (u) > 0 && eu >= 1 && err <= eu - 2)
+            err -= eu - 2;
+         else if (err <= -3)
+            err += 3;
+         else {
+            cancel = 0;
+            ok_re = 0;
+            continue;
+         }
+         mpfr_log1p (re, u, MPFR_RNDN);
+         if (mpfr_zero_p (re)) {
+            cancel = prec;
+            ok_re = 0;
+            continue;
+         }
+         /* total error <= 2^err + 2^(EXP(re)-1-prec)
+                        <= 2^(max(err, EXP(re)-prec)+1) */
+         err = MPC_MAX (err, mpfr_get_exp (re) - prec) + 1;
+         cancel = MPC_MAX (err + prec - mpfr_get_exp (re), 0);
+         ok_re = mpfr_can_round (re, prec - cancel, MPFR_RNDN, MPFR_RNDZ,
+                                 MPC_PREC_RE (rop)
+                                 + (MPC_RND_RE (rnd) == MPFR_RNDN));
+         mpfr_div_2ui (re, re, 1, MPFR_RNDN);
+      }
+      else {
+         /* log|w + i*y| with the relative error of w, that of the hypot
+            and the final rounding: error <= 2^(max(2,EXP(re))+1-prec) */
+         inex_h = mpfr_hypot (re, w, mpc_imagref (op), MPFR_RNDN);
+         mpfr_log (re, re, MPFR_RNDN);
+         if (mpfr_zero_p (re)) {
+            /* |1+z| = 1 exactly if both operations were exact */
+            ok_re = (inex_w == 0 && inex_h == 0);
+            cancel = prec;
+         }
+         else {
+            cancel = MPC_MAX (2 - mpfr_get_exp (re), 0);
+            ok_re = mpfr_can_round (re, prec - 1 - cancel,
+                                    MPFR_RNDN, MPFR_RNDZ,
+                                    MPC_PREC_RE (rop)
+                                    + (MPC_RND_RE (rnd) == MPFR_RNDN));
+         }
+      }
+   }
+
+   MPC_ZIV_END (log1p, loop, prec, MPC_MAX_PREC (rop));
+   inex_re = mpfr_set (mpc_realref (rop), re, MPC_RND_RE (rnd));
+   inex_im = mpfr_set (mpc_imagref (rop), im, MPC_RND_IM (rnd));
+
+   mpfr_clear (w);
+   mpfr_clear (s);
+   mpfr_clear (u);
+   mpfr_clear (re);
+   mpfr_clear (im);
+
+   /* restore the exponent range, and check the range of results */
+   mpfr_set_emin (saved_emin);
+   mpfr_set_emax (saved_emax);
+   inex_re = mpfr_check_range (mpc_realref (rop), inex_re, MPC_RND_RE (rnd));
+   inex_im = mpfr_check_range (mpc_imagref (rop), inex_im, MPC_RND_IM (rnd));
+
+   return MPC_INEX (inex_re, inex_im);
+}
@@ -33,6 +33,7 @@ is_power_of_two (mpfr_srcptr x)
 int
 mpc_log2 (mpc_ptr rop, mpc_srcptr op, mpc_rnd_t rnd)
 {
+   MPC_STATS_FUNC (log2, MPC_MAX_PREC (rop))
    int ok = 0, loop = 0, special_re, special_im,
        inex, inex_re, inex_im;
    mpfr_prec_t prec;
@@ -52,6 +53,7 @@ mpc_log2 (mpc_ptr rop, mpc_srcptr op, mpc_rnd_t rnd)
    while (ok == 0) {
       MPC_LOOP_NEXT(loop, op, rop);
       prec += (loop <= 2) ? mpc_ceil_log2 (prec) + 4 : prec / 2;
+      MPC_ZIV_START (log2, loop, prec, MPC_MAX_PREC (rop));
       mpfr_set_prec (log2, prec);
       mpc_set_prec (log, prec);
 
@@ -144,6 +146,7 @@ mpc_log2 (mpc_ptr rop, mpc_srcptr op, mpc_rnd_t rnd)
       }
    }
 
+   MPC_ZIV_END (log2, loop, prec, MPC_MAX_PREC (rop));
    inex_re = mpfr_set (mpc_realref(rop), mpc_realref (log), MPC_RND_RE (rnd));
    if (special_re)
       inex_re = MPC_INEX_RE (inex);
@@ -1,6 +1,6 @@
 /* logging.c -- "Dummy" functions logging calls to real mpc functions.
 
-Copyright (C) 2011, 2022 INRIA
+Copyright (C) 2011, 2022, 2025 INRIA
 
 This file is part of GNU MPC.
 
@@ -18,95 +18,508 @@ You should have received a copy of the GNU Lesser General Public License
 along with this program. If not, see http://www.gnu.org/licenses/ .
 */
 
+/* The functions mpc_log_xxx of this file are called instead of mpc_xxx
+   by programs including mpc-log.h instead of mpc.h. Since this file
+   includes mpc.h, the real functions are called directly.
+   Calls are logged either as text to stderr, or, if the environment
+   variable MPC_LOG_FILE is set, as binary records to the file it names,
+   in the format described in mpc-trace.h. In the latter case, records
+   are collected in a buffer per thread, which is copied into the
+   memory mapped file when it is full, or when the thread or the program
+   terminates; space in the file is reserved by an atomic increment of
+   the used field of its header, so that threads do not need to wait for
+   each other.
+   Further environment variables are:
+   MPC_LOG_SIZE: the size of the trace file in MiB, 64 by default;
+   MPC_LOG_SAMPLE: an integer n such that only every n-th call is logged
+   in each thread, 1 by default;
+   MPC_LOG_FUNCTIONS: a list of function names, separated by commas or
+   spaces and with or without the prefix mpc_, to which logging is
+   restricted; by default, all functions are logged. */
+
 #include <stdio.h>
+#include <string.h>
+#include "mpc-impl.h"
+#include "mpc-trace.h"
+
+#if defined (HAVE_SYS_MMAN_H) && defined (HAVE_MMAP) \
+    && defined (HAVE_CLOCK_GETTIME) && defined (HAVE_ATOMIC_BUILTINS)
+#define MPC_LOG_TRACE
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+#endif
+
+#define MPC_LOG_BUFFER_SIZE (1 << 16)
+
+#define MPC_LOG_OFF    0
+#define MPC_LOG_TEXT   1
+#define MPC_LOG_BINARY 2
+
+static struct {
+   int mode;
+   unsigned long int sample;
+   char enabled [MPC_TRACE_NFUNC];
+   mpc_trace_header_t *trace;
+   uint32_t threads;
+} log_conf;
+
+typedef struct {
+   unsigned long int count; /* calls since the last logged one */
+   uint32_t id;
+   size_t fill;             /* bytes used in buf */
+   uint64_t *big;           /* record not fitting into buf, or NULL */
+   uint64_t start;          /* time of the start of the current call */
+   uint64_t buf [MPC_LOG_BUFFER_SIZE / sizeof (uint64_t)];
+} log_thread_t;
+
+static MPC_THREAD_LOCAL log_thread_t *log_thread = NULL;
+
+#ifdef HAVE_PTHREAD
+static pthread_once_t log_once = PTHREAD_ONCE_INIT;
+static pthread_key_t log_key;
+#else
+static int log_initialised = 0;
+#endif
+
+#define MPC_TRACE_NAME(f, t) #f,
+static const char *log_names [] = {
+   MPC_TRACE_FUNCTIONS (MPC_TRACE_NAME)
+   NULL
+};
+
+
+#ifdef MPC_LOG_TRACE
+static uint64_t
+log_ns (void)
+{
+   struct timespec ts;
+
+   clock_gettime (CLOCK_MONOTONIC, &ts);
+   return (uint64_t) ts.tv_sec * 1000000000u + (uint64_t) ts.tv_nsec;
+}
+
+
+static void
+log_write (const void *p, size_t n, uint64_t records)
+   /* Append the n bytes at p, containing the given number of records,
+      to the trace file, or count them as dropped if they do not fit. */
+{
+   mpc_trace_header_t *h = log_conf.trace;
+   uint64_t off;
+
+   if (n == 0)
+      return;
+   off = __atomic_fetch_add (&h->used, (uint64_t) n, __ATOMIC_RELAXED);
+   if (off + n > h->size - sizeof (mpc_trace_header_t))
+      __atomic_fetch_add (&h->dropped, records, __ATOMIC_RELAXED);
+   else
+      memcpy ((char *) (h + 1) + off, p, n);
+}
+
+
+static void
+log_flush (log_thread_t *t)
+{
+   const unsigned char *p = (const unsigned char *) t->buf;
+   size_t i;
+   uint64_t records = 0;
+
+   for (i = 0; i < t->fill; i += ((const mpc_trace_record_t *) (p + i))->size)
+      records++;
+   log_write (t->buf, t->fill, records);
+   t->fill = 0;
+}
+
+
+static int
+log_open (const char *name)
+   /* Create the trace file and map it into memory; return 0 on success
+      and -1 on failure. */
+{
+   mpc_trace_header_t *h;
+   const char *s;
+   size_t size;
+   void *p;
+   int fd;
+
+   s = getenv ("MPC_LOG_SIZE");
+   size = (s != NULL && atol (s) > 0 ? (size_t) atol (s) : 64) << 20;
+   fd = open (name, O_RDWR | O_CREAT | O_TRUNC, 0644);
+   if (fd == -1)
+      return -1;
+   if (ftruncate (fd, (off_t) size) != 0) {
+      close (fd);
+      return -1;
+   }
+   p = mmap (NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+   close (fd);
+   if (p == MAP_FAILED)
+      return -1;
+
+   h = (mpc_trace_header_t *) p;
+   memcpy (h->magic, MPC_TRACE_MAGIC, 8);
+   h->version = MPC_TRACE_VERSION;
+   h->limb_bytes = sizeof (mp_limb_t);
+   h->size = size;
+   h->used = 0;
+   h->dropped = 0;
+   h->sample = log_conf.sample;
+   log_conf.trace = h;
+
+   return 0;
+}
+#endif
+
+
+static void
+log_thread_end (void *t)
+   /* Write the pending records of a terminating thread. */
+{
+#ifdef MPC_LOG_TRACE
+   if (log_conf.mode == MPC_LOG_BINARY)
+      log_flush ((log_thread_t *) t);
+#endif
+   free (t);
+}
+
+
+static void
+log_exit (void)
+{
+   if (log_thread != NULL) {
+#ifdef HAVE_PTHREAD
+      pthread_setspecific (log_key, NULL);
+#endif
+      log_thread_end (log_thread);
+      log_thread = NULL;
+   }
+}
+
+
+static void
+log_init (void)
+   /* Read the configuration from the environment. */
+{
+   const char *s, *e;
+   size_t n;
+   int i;
+
+   s = getenv ("MPC_LOG_SAMPLE");
+   log_conf.sample = (s != NULL && atol (s) > 0 ? (unsigned long) atol (s) : 1);
 
-#define __MPC_LIBRARY_BUILD
-   /* to indicate we are inside the library build; needed here since mpc-log.h
-      includes mpc.h and not mpc-impl.h */
-#include "mpc-log.h"
+   s = getenv ("MPC_LOG_FUNCTIONS");
+   for (i = 0; i < MPC_TRACE_NFUNC; i++)
+      log_conf.enabled [i] = (s == NULL);
+   if (s != NULL)
+      while (*s != '\0') {
+         if (*s == ',' || *s == ' ') {
+            s++;
+            continue;
+         }
+         if (strncmp (s, "mpc_", 4) == 0)
+            s += 4;
+         for (e = s; *e != '\0' && *e != ',' && *e != ' '; e++);
+         n = (size_t) (e - s);
+         for (i = 0; i < MPC_TRACE_NFUNC; i++)
+            if (strlen (log_names [i]) == n && strncmp (s, log_names [i], n) == 0)
+               break;
+         if (i < MPC_TRACE_NFUNC)
+            log_conf.enabled [i] = 1;
+         else
+            fprintf (stderr, "MPC_LOG_FUNCTIONS: unknown function %.*s\n",
+                     (int) n, s);
+         s = e;
+      }
 
-#include "config.h"
-#ifdef HAVE_DLFCN_H
-#include <dlfcn.h>
+   log_conf.mode = MPC_LOG_TEXT;
+   s = getenv ("MPC_LOG_FILE");
+   if (s != NULL) {
+#ifdef MPC_LOG_TRACE
+      if (log_open (s) == 0)
+         log_conf.mode = MPC_LOG_BINARY;
+      else {
+         fprintf (stderr, "MPC_LOG_FILE: cannot create %s, logging disabled\n", s);
+         log_conf.mode = MPC_LOG_OFF;
+      }
+#else
+      fprintf (stderr, "MPC_LOG_FILE: binary traces are not supported "
+                       "on this system, logging to stderr\n");
 #endif
+   }
+
+#ifdef HAVE_PTHREAD
+   pthread_key_create (&log_key, log_thread_end);
+#endif
+   atexit (log_exit);
+}
+
+
+static log_thread_t *
+log_get_thread (void)
+{
+#ifdef HAVE_PTHREAD
+   pthread_once (&log_once, log_init);
+#else
+   if (!log_initialised) {
+      log_init ();
+      log_initialised = 1;
+   }
+#endif
+   if (log_thread == NULL) {
+      log_thread = (log_thread_t *) malloc (sizeof (log_thread_t));
+      if (log_thread == NULL)
+         return NULL;
+      log_thread->count = 0;
+      log_thread->fill = 0;
+      log_thread->big = NULL;
+#ifdef MPC_LOG_TRACE
+      log_thread->id = __atomic_fetch_add (&log_conf.threads, 1, __ATOMIC_RELAXED);
+#else
+      log_thread->id = log_conf.threads++;
+#endif
+#ifdef HAVE_PTHREAD
+      pthread_setspecific (log_key, log_thread);
+#endif
+   }
+   return log_thread;
+}
+
+
+#ifdef MPC_LOG_TRACE
+static size_t
+log_fr_size (mpfr_srcptr x)
+{
+   return sizeof (mpc_trace_fr_t)
+          + (mpfr_regular_p (x) ?
+             MPC_TRACE_ALIGN (mpfr_custom_get_size (mpfr_get_prec (x))) : 0);
+}
+
+
+static unsigned char *
+log_put_fr (unsigned char *p, mpfr_srcptr x)
+{
+   mpc_trace_fr_t f;
+   size_t n = 0;
+
+   f.kind = mpfr_custom_get_kind (x);
+   f.prec = mpfr_get_prec (x);
+   f.exp = 0;
+   if (mpfr_regular_p (x)) {
+      f.exp = mpfr_custom_get_exp (x);
+      n = mpfr_custom_get_size (mpfr_get_prec (x));
+   }
+   f.limbs = (uint32_t) (n / sizeof (mp_limb_t));
+   memcpy (p, &f, sizeof (mpc_trace_fr_t));
+   p += sizeof (mpc_trace_fr_t);
+   memcpy (p, mpfr_custom_get_significand (x), n);
+   memset (p + n, 0, MPC_TRACE_ALIGN (n) - n);
+
+   return p + MPC_TRACE_ALIGN (n);
+}
+
+
+static void *
+log_record (log_thread_t *t, int func, mpc_srcptr *out, int nout,
+   mpc_srcptr *in, int nin, mpc_rnd_t rnd, mpc_rnd_t rnd2)
+   /* Write a record for the call without its return value and duration,
+      and return a pointer to it, or NULL if it is too large. */
+{
+   mpc_trace_record_t *r;
+   unsigned char *p;
+   size_t size;
+   int64_t prec [2];
+   int i;
+
+   size = sizeof (mpc_trace_record_t) + 2 * nout * sizeof (int64_t);
+   for (i = 0; i < nin; i++)
+      size += log_fr_size (mpc_realref (in [i]))
+              + log_fr_size (mpc_imagref (in [i]));
+   if (size > UINT32_MAX)
+      return NULL;
+
+   if (size <= sizeof (t->buf)) {
+      if (t->fill + size > sizeof (t->buf))
+         log_flush (t);
+      p = (unsigned char *) t->buf + t->fill;
+   }
+   else {
+      t->big = (uint64_t *) malloc (size);
+      if (t->big == NULL)
+         return NULL;
+      p = (unsigned char *) t->big;
+   }
+
+   r = (mpc_trace_record_t *) p;
+   r->size = (uint32_t) size;
+   r->func = (uint16_t) func;
+   r->rnd = (uint8_t) rnd;
+   r->rnd2 = (uint8_t) rnd2;
+   r->inex = 0;
+   r->thread = t->id;
+   r->ns = 0;
+   p += sizeof (mpc_trace_record_t);
+   for (i = 0; i < nout; i++) {
+      prec [0] = mpfr_get_prec (mpc_realref (out [i]));
+      prec [1] = mpfr_get_prec (mpc_imagref (out [i]));
+      memcpy (p, prec, sizeof (prec));
+      p += sizeof (prec);
+   }
+   for (i = 0; i < nin; i++) {
+      p = log_put_fr (p, mpc_realref (in [i]));
+      p = log_put_fr (p, mpc_imagref (in [i]));
+   }
+
+   return r;
+}
+#endif
+
+
+static void
+log_text (const char *name, const char *type, mpc_srcptr *out, int nout,
+   mpc_srcptr *in, int nin)
+{
+   int i;
+
+   fprintf (stderr, "mpc_%s %s", name, type);
+   for (i = 0; i < nout; i++)
+      fprintf (stderr, " %li %li", (long) mpfr_get_prec (mpc_realref (out [i])),
+                                (long) mpfr_get_prec (mpc_imagref (out [i])));
+   for (i = 0; i < nin; i++) {
+      fprintf (stderr, " %li %li", (long) mpfr_get_prec (mpc_realref (in [i])),
+                                (long) mpfr_get_prec (mpc_imagref (in [i])));
+      fprintf (stderr, " ");
+      mpc_out_str (stderr, 16, 0, in [i], MPC_RNDNN);
+   }
+   fprintf (stderr, "\n");
+}
+
+
+static void *
+log_begin (int func, const char *type, mpc_srcptr *out, int nout,
+   mpc_srcptr *in, int nin, mpc_rnd_t rnd, mpc_rnd_t rnd2)
+   /* Log a call before it is executed; in binary mode, return a pointer
+      to its record, to be completed by log_end, and otherwise NULL. */
+{
+   log_thread_t *t = log_get_thread ();
+   void *r = NULL;
+
+   if (t == NULL || log_conf.mode == MPC_LOG_OFF || !log_conf.enabled [func])
+      return NULL;
+   if (++t->count < log_conf.sample)
+      return NULL;
+   t->count = 0;
+
+   if (log_conf.mode == MPC_LOG_TEXT)
+      log_text (log_names [func], type, out, nout, in, nin);
+#ifdef MPC_LOG_TRACE
+   else {
+      r = log_record (t, func, out, nout, in, nin, rnd, rnd2);
+      t->start = log_ns ();
+   }
+#else
+   (void) rnd;
+   (void) rnd2;
+#endif
+
+   return r;
+}
+
+
+static void
+log_end (void *r, int inex)
+   /* Complete the record r, if not NULL, after the call. */
+{
+#ifdef MPC_LOG_TRACE
+   log_thread_t *t;
+   mpc_trace_record_t *rec;
+
+   if (r == NULL)
+      return;
+   t = log_thread;
+   rec = (mpc_trace_record_t *) r;
+   rec->ns = log_ns () - t->start;
+   rec->inex = inex;
+   if (t->big != NULL) {
+      log_write (t->big, rec->size, 1);
+      free (t->big);
+      t->big = NULL;
+   }
+   else
+      t->fill += rec->size;
+#else
+   (void) r;
+   (void) inex;
+#endif
+}
 
-typedef int (*c_c_func_ptr) (mpc_ptr, mpc_srcptr, mpc_rnd_t);
-typedef int (*c_cc_func_ptr) (mpc_ptr, mpc_srcptr, mpc_srcptr, mpc_rnd_t);
-typedef int (*c_ccc_func_ptr) (mpc_ptr, mpc_srcptr, mpc_srcptr, mpc_srcptr, mpc_rnd_t);
-typedef int (*cc_c_func_ptr) (mpc_ptr, mpc_ptr, mpc_srcptr, mpc_rnd_t, mpc_rnd_t);
-
-#define MPC_LOGGING_OUT_PREC(z) \
-   do { \
-      fprintf (stderr, " %li %li", (long) mpfr_get_prec (mpc_realref (z)),  \
-                                (long) mpfr_get_prec (mpc_imagref (z))); \
-   } while (0);
-
-#define MPC_LOGGING_OUT_C(z) \
-   do { \
-      MPC_LOGGING_OUT_PREC (z); \
-      fprintf (stderr, " "); \
-      mpc_out_str (stderr, 16, 0, z, MPC_RNDNN); \
-   } while (0);
-
-#define MPC_LOGGING_FUNC_TYPE(funcname, type) \
-   do { \
-      fprintf (stderr, "mpc_"#funcname" "#type); \
-   } while (0);
 
 #define MPC_LOGGING_C_C(funcname) \
+__MPC_DECLSPEC int mpc_log_##funcname (mpc_ptr, mpc_srcptr, mpc_rnd_t); \
 __MPC_DECLSPEC int mpc_log_##funcname (mpc_ptr rop, mpc_srcptr op, mpc_rnd_t rnd) \
 { \
-   static c_c_func_ptr func = NULL; \
-   if (func == NULL) \
-      func = (c_c_func_ptr) (intptr_t) dlsym (NULL, "mpc_"#funcname); \
-   MPC_LOGGING_FUNC_TYPE (funcname, c_c); \
-   MPC_LOGGING_OUT_PREC (rop); \
-   MPC_LOGGING_OUT_C (op); \
-   fprintf (stderr, "\n"); \
-   return func (rop, op, rnd); \
+   mpc_srcptr out [1], in [1]; \
+   void *r; \
+   int inex; \
+   out [0] = rop; \
+   in [0] = op; \
+   r = log_begin (MPC_TRACE_##funcname, "c_c", out, 1, in, 1, rnd, 0); \
+   inex = mpc_##funcname (rop, op, rnd); \
+   log_end (r, inex); \
+   return inex; \
 }
 
 #define MPC_LOGGING_C_CC(funcname) \
+__MPC_DECLSPEC int mpc_log_##funcname (mpc_ptr, mpc_srcptr, mpc_srcptr, mpc_rnd_t); \
 __MPC_DECLSPEC int mpc_log_##funcname (mpc_ptr rop, mpc_srcptr op1, mpc_srcptr op2, mpc_rnd_t rnd) \
 { \
-   static c_cc_func_ptr func = NULL; \
-   if (func == NULL) \
-      func = (c_cc_func_ptr) (intptr_t) dlsym (NULL, "mpc_"#funcname); \
-   MPC_LOGGING_FUNC_TYPE (funcname, c_cc); \
-   MPC_LOGGING_OUT_PREC (rop); \
-   MPC_LOGGING_OUT_C (op1); \
-   MPC_LOGGING_OUT_C (op2); \
-   fprintf (stderr, "\n"); \
-   return func (rop, op1, op2, rnd); \
+   mpc_srcptr out [1], in [2]; \
+   void *r; \
+   int inex; \
+   out [0] = rop; \
+   in [0] = op1; \
+   in [1] = op2; \
+   r = log_begin (MPC_TRACE_##funcname, "c_cc", out, 1, in, 2, rnd, 0); \
+   inex = mpc_##funcname (rop, op1, op2, rnd); \
+   log_end (r, inex); \
+   return inex; \
 }
 
 #define MPC_LOGGING_C_CCC(funcname) \
+__MPC_DECLSPEC int mpc_log_##funcname (mpc_ptr, mpc_srcptr, mpc_srcptr, mpc_srcptr, mpc_rnd_t); \
 __MPC_DECLSPEC int mpc_log_##funcname (mpc_ptr rop, mpc_srcptr op1, mpc_srcptr op2, mpc_srcptr op3, mpc_rnd_t rnd) \
 { \
-   static c_ccc_func_ptr func = NULL; \
-   if (func == NULL) \
-      func = (c_ccc_func_ptr) (intptr_t) dlsym (NULL, "mpc_"#funcname); \
-   MPC_LOGGING_FUNC_TYPE (funcname, c_ccc); \
-   MPC_LOGGING_OUT_PREC (rop); \
-   MPC_LOGGING_OUT_C (op1); \
-   MPC_LOGGING_OUT_C (op2); \
-   MPC_LOGGING_OUT_C (op3); \
-   fprintf (stderr, "\n"); \
-   return func (rop, op1, op2, op3, rnd); \
+   mpc_srcptr out [1], in [3]; \
+   void *r; \
+   int inex; \
+   out [0] = rop; \
+   in [0] = op1; \
+   in [1] = op2; \
+   in [2] = op3; \
+   r = log_begin (MPC_TRACE_##funcname, "c_ccc", out, 1, in, 3, rnd, 0); \
+   inex = mpc_##funcname (rop, op1, op2, op3, rnd); \
+   log_end (r, inex); \
+   return inex; \
 }
 
 #define MPC_LOGGING_CC_C(funcname) \
+__MPC_DECLSPEC int mpc_log_##funcname (mpc_ptr, mpc_ptr, mpc_srcptr, mpc_rnd_t, mpc_rnd_t); \
 __MPC_DECLSPEC int mpc_log_##funcname (mpc_ptr rop1, mpc_ptr rop2, mpc_srcptr op, mpc_rnd_t rnd1, mpc_rnd_t rnd2) \
 { \
-   static cc_c_func_ptr func = NULL; \
-   if (func == NULL) \
-      func = (cc_c_func_ptr) (intptr_t) dlsym (NULL, "mpc_"#funcname); \
-   MPC_LOGGING_FUNC_TYPE (funcname, cc_c); \
-   MPC_LOGGING_OUT_PREC (rop1); \
-   MPC_LOGGING_OUT_PREC (rop2); \
-   MPC_LOGGING_OUT_C (op); \
-   fprintf (stderr, "\n"); \
-   return func (rop1, rop2, op, rnd1, rnd2); \
+   mpc_srcptr out [2], in [1]; \
+   void *r; \
+   int inex; \
+   out [0] = rop1; \
+   out [1] = rop2; \
+   in [0] = op; \
+   r = log_begin (MPC_TRACE_##funcname, "cc_c", out, 2, in, 1, rnd1, rnd2); \
+   inex = mpc_##funcname (rop1, rop2, op, rnd1, rnd2); \
+   log_end (r, inex); \
+   return inex; \
 }
 
 MPC_LOGGING_C_C (sqr)
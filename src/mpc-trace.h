@@ -0,0 +1,126 @@
+/* mpc-trace.h -- Format of the binary call traces written by logging.c.
+
+Copyright (C) 2025 INRIA
+
+This file is part of GNU MPC.
+
+GNU MPC is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the
+Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+GNU MPC is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for
+more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program. If not, see http://www.gnu.org/licenses/ .
+*/
+
+#ifndef __MPC_TRACE_H
+#define __MPC_TRACE_H
+
+#include <stdint.h>
+
+/* A binary trace, as written by the logging functions when the
+   environment variable MPC_LOG_FILE is set, consists of a header of type
+   mpc_trace_header_t, followed by header.used bytes of records (or by
+   header.size - sizeof (mpc_trace_header_t) bytes if this is smaller, in
+   which case some records have been dropped). All numbers are stored in
+   the byte order of the machine that has written the trace.
+
+   A record consists of
+   - a fixed part of type mpc_trace_record_t;
+   - for each result of the function, the precisions of its real and its
+     imaginary part as two int64_t;
+   - for each argument of the function, its real and its imaginary part,
+     each given by an mpc_trace_fr_t followed by the limbs of the
+     significand for a regular number, padded to a multiple of 8 bytes.
+   The arguments are recorded before the call, so they are correct also
+   when the result variables coincide with some of them.
+   The sizes of all records are multiples of 8, and a record of size 0
+   marks the end of the trace; this may happen before header.used bytes
+   when the writing process has been interrupted. */
+
+#define MPC_TRACE_MAGIC   "MPCTRACE"
+#define MPC_TRACE_VERSION 1
+#define MPC_TRACE_ALIGN(n) (((n) + 7) & ~ (size_t) 7)
+
+typedef struct {
+   char magic [8];
+   uint32_t version;
+   uint32_t limb_bytes; /* sizeof (mp_limb_t) */
+   uint64_t size;       /* size of the trace file in bytes */
+   uint64_t used;       /* bytes reserved for records after the header */
+   uint64_t dropped;    /* number of records that did not fit */
+   uint64_t sample;     /* one call out of sample has been recorded */
+   uint64_t reserved [2];
+} mpc_trace_header_t;
+
+typedef struct {
+   uint32_t size;   /* size of the record in bytes */
+   uint16_t func;   /* position of the function in MPC_TRACE_FUNCTIONS */
+   uint8_t rnd;     /* rounding mode */
+   uint8_t rnd2;    /* second rounding mode for the cc_c type, else 0 */
+   int32_t inex;    /* return value of the function */
+   uint32_t thread; /* number of the calling thread, starting at 0 */
+   uint64_t ns;     /* duration of the call in nanoseconds */
+} mpc_trace_record_t;
+
+typedef struct {
+   int32_t kind;    /* as returned by mpfr_custom_get_kind */
+   uint32_t limbs;  /* number of limbs of the significand that follow */
+   int64_t prec;
+   int64_t exp;     /* exponent of a regular number, else 0 */
+} mpc_trace_fr_t;
+
+/* The traced functions with their types, see the description of
+   --enable-logging in the documentation; the position of a function in
+   the list is its identifier in the records, so new functions must be
+   appended at the end. */
+#define MPC_TRACE_FUNCTIONS(F) \
+   F (sqr, c_c)                \
+   F (conj, c_c)               \
+   F (neg, c_c)                \
+   F (sqrt, c_c)               \
+   F (proj, c_c)               \
+   F (exp, c_c)                \
+   F (log, c_c)                \
+   F (sin, c_c)                \
+   F (cos, c_c)                \
+   F (tan, c_c)                \
+   F (sinh, c_c)               \
+   F (cosh, c_c)               \
+   F (tanh, c_c)               \
+   F (asin, c_c)               \
+   F (acos, c_c)               \
+   F (atan, c_c)               \
+   F (asinh, c_c)              \
+   F (acosh, c_c)              \
+   F (atanh, c_c)              \
+   F (add, c_cc)               \
+   F (sub, c_cc)               \
+   F (mul, c_cc)               \
+   F (div, c_cc)               \
+   F (pow, c_cc)               \
+   F (fma, c_ccc)              \
+   F (sin_cos, cc_c)
+
+/* numbers of results and arguments for each type */
+#define MPC_TRACE_NOUT_c_c   1
+#define MPC_TRACE_NIN_c_c    1
+#define MPC_TRACE_NOUT_c_cc  1
+#define MPC_TRACE_NIN_c_cc   2
+#define MPC_TRACE_NOUT_c_ccc 1
+#define MPC_TRACE_NIN_c_ccc  3
+#define MPC_TRACE_NOUT_cc_c  2
+#define MPC_TRACE_NIN_cc_c   1
+
+#define MPC_TRACE_ENUM(f, t) MPC_TRACE_##f,
+enum {
+   MPC_TRACE_FUNCTIONS (MPC_TRACE_ENUM)
+   MPC_TRACE_NFUNC
+};
+
+#endif /* __MPC_TRACE_H */
@@ -0,0 +1,406 @@
+/* mpcr-inline.h -- Inline functions for radii of complex balls.
+
+Copyright (C) 2022, 2023, 2024, 2025 INRIA
+
+This file is part of GNU MPC.
+
+GNU MPC is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the
+Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+GNU MPC is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for
+more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program. If not, see http://www.gnu.org/licenses/ .
+*/
+
+#ifndef __MPCR_INLINE_H
+#define __MPCR_INLINE_H
+
+/* This file is included by mpc-impl.h and is not installed. It contains
+   the arithmetic on radii, see radius.c, as static inline functions, so
+   that the ball functions do not pay for a function call per operation
+   on a radius. Unless MPCR_NO_INLINE is defined, the exported names of
+   the functions are redirected to the inline versions in the same way as
+   in mpc-log.h; radius.c defines MPCR_NO_INLINE and implements the
+   exported functions on top of the inline ones, so that the ABI does not
+   change. */
+
+#if defined (_MSC_VER) && defined (_M_X64)
+#include <intrin.h>
+#pragma intrinsic (_BitScanReverse64)
+#endif
+
+#define MPCR_MANT(r) ((r)->mant)
+#define MPCR_EXP(r) ((r)->exp)
+#define MPCR_MANT_MIN (((int64_t) 1) << 30)
+#define MPCR_MANT_MAX (MPCR_MANT_MIN << 1)
+
+/* The radius can take three types of values, represented as follows:
+   infinite: the mantissa is -1 and the exponent is undefined;
+   0: the mantissa and the exponent are 0;
+   positive: the mantissa is a positive integer, and the radius is
+   mantissa*2^exponent. A normalised positive radius "has 31 bits",
+   in the sense that the bits 0 to 29 are arbitrary, bit 30 is 1,
+   and bits 31 to 63 are 0; otherwise said, the mantissa lies between
+   2^30 and 2^31-1.
+   Unless stated otherwise, all functions take normalised inputs and
+   produce normalised output; they compute only upper bounds on the radii,
+   without guaranteeing that these are tight. */
+
+
+static inline int
+mpcr_inline_leading_bit (uint64_t n)
+   /* Assuming that n is a positive integer, return the position
+      (from 0 to 63) of the leading bit, that is, the k such that
+      n >= 2^k, but n < 2^(k+1). */
+{
+#if defined (__GNUC__)
+   return 63 - __builtin_clzll (n);
+#elif defined (_MSC_VER) && defined (_M_X64)
+   unsigned long k;
+
+   _BitScanReverse64 (&k, n);
+   return (int) k;
+#else
+   int k, s;
+
+   k = 0;
+   for (s = 32; s > 0; s >>= 1)
+      if (n >> s) {
+         n >>= s;
+         k += s;
+      }
+   return k;
+#endif
+}
+
+
+static inline void
+mpcr_inline_add_one_ulp (mpcr_ptr r)
+   /* Add 1 to the mantissa of the normalised or almost normalised r,
+      that is, with a mantissa of at most 2^31-1, and renormalise. */
+{
+   int64_t c;
+
+   MPCR_MANT (r)++;
+   c = MPCR_MANT (r) >> 31;
+   MPCR_MANT (r) >>= c;
+   MPCR_EXP (r) += c;
+}
+
+
+static inline void
+mpcr_inline_normalise_rnd (mpcr_ptr r, mpfr_rnd_t rnd)
+   /* The function computes a normalised value for the potentially
+      unnormalised r; depending on whether rnd is MPFR_RNDU or MPFR_RNDD,
+      the result is rounded up or down. For efficiency reasons, rounding
+      up does not take exact cases into account and adds one ulp anyway. */
+{
+   int d;
+
+   if (MPCR_MANT (r) == 0)
+      MPCR_EXP (r) = 0;
+   else if (MPCR_MANT (r) != -1) {
+      d = mpcr_inline_leading_bit ((uint64_t) MPCR_MANT (r)) - 30;
+      MPCR_EXP (r) += d;
+      if (d <= 0)
+         MPCR_MANT (r) <<= -d;
+      else {
+         MPCR_MANT (r) >>= d;
+         if (rnd == MPFR_RNDU)
+            mpcr_inline_add_one_ulp (r);
+      }
+   }
+}
+
+
+static inline int
+mpcr_inline_inf_p (mpcr_srcptr r)
+{
+   return MPCR_MANT (r) == -1;
+}
+
+
+static inline int
+mpcr_inline_zero_p (mpcr_srcptr r)
+{
+   return MPCR_MANT (r) == 0;
+}
+
+
+static inline int
+mpcr_inline_lt_half_p (mpcr_srcptr r)
+   /* Return true if r < 1/2, false otherwise. */
+{
+   return MPCR_MANT (r) == 0 || MPCR_EXP (r) < -31;
+}
+
+
+static inline int
+mpcr_inline_cmp (mpcr_srcptr r, mpcr_srcptr s)
+{
+   if (mpcr_inline_inf_p (r) || mpcr_inline_inf_p (s))
+      return mpcr_inline_inf_p (r) - mpcr_inline_inf_p (s);
+   else if (mpcr_inline_zero_p (r) || mpcr_inline_zero_p (s))
+      return mpcr_inline_zero_p (s) - mpcr_inline_zero_p (r);
+   else if (MPCR_EXP (r) != MPCR_EXP (s))
+      return (MPCR_EXP (r) > MPCR_EXP (s)) - (MPCR_EXP (r) < MPCR_EXP (s));
+   else
+      return (MPCR_MANT (r) > MPCR_MANT (s)) - (MPCR_MANT (r) < MPCR_MANT (s));
+}
+
+
+static inline void
+mpcr_inline_set_inf (mpcr_ptr r)
+{
+   MPCR_MANT (r) = -1;
+}
+
+
+static inline void
+mpcr_inline_set_zero (mpcr_ptr r)
+{
+   MPCR_MANT (r) = 0;
+   MPCR_EXP (r) = 0;
+}
+
+
+static inline void
+mpcr_inline_set_one (mpcr_ptr r)
+{
+   MPCR_MANT (r) = MPCR_MANT_MIN;
+   MPCR_EXP (r) = -30;
+}
+
+
+static inline void
+mpcr_inline_set (mpcr_ptr r, mpcr_srcptr s)
+{
+   r [0] = s [0];
+}
+
+
+static inline void
+mpcr_inline_set_ui64_2si64 (mpcr_ptr r, uint64_t mant, int64_t exp)
+   /* Set r to mant*2^exp, rounded up. */
+{
+   if (mant == 0)
+      mpcr_inline_set_zero (r);
+   else {
+      if (mant >= ((uint64_t) 1) << 63) {
+         mant = mant / 2 + mant % 2;
+         exp++;
+      }
+      MPCR_MANT (r) = (int64_t) mant;
+      MPCR_EXP (r) = exp;
+      mpcr_inline_normalise_rnd (r, MPFR_RNDU);
+   }
+}
+
+
+static inline void
+mpcr_inline_max (mpcr_ptr r, mpcr_srcptr s, mpcr_srcptr t)
+   /* Set r to the maximum of s and t. */
+{
+   if (mpcr_inline_cmp (s, t) < 0)
+      mpcr_inline_set (r, t);
+   else
+      mpcr_inline_set (r, s);
+}
+
+
+static inline int64_t
+mpcr_inline_get_exp (mpcr_srcptr r)
+   /* Return the exponent e such that r = m * 2^e with m such that
+      0.5 <= m < 1. */
+{
+   return MPCR_EXP (r) + 31;
+}
+
+
+static inline void
+mpcr_inline_mul (mpcr_ptr r, mpcr_srcptr s, mpcr_srcptr t)
+   /* Set r to the product of s and t, rounded up.
+      The product of two normalised mantissae lies between 2^60 and 2^62,
+      so that its leading bit is known up to one position, and the
+      normalisation needs neither a bit count nor a branch. */
+{
+   int64_t m, c;
+
+   if (mpcr_inline_inf_p (s) || mpcr_inline_inf_p (t))
+      mpcr_inline_set_inf (r);
+   else if (mpcr_inline_zero_p (s) || mpcr_inline_zero_p (t))
+      mpcr_inline_set_zero (r);
+   else {
+      m = MPCR_MANT (s) * MPCR_MANT (t);
+      c = 30 + (m >> 61);
+      MPCR_MANT (r) = m >> c;
+      MPCR_EXP (r) = MPCR_EXP (s) + MPCR_EXP (t) + c;
+      mpcr_inline_add_one_ulp (r);
+   }
+}
+
+
+static inline void
+mpcr_inline_sqr (mpcr_ptr r, mpcr_srcptr s)
+{
+   mpcr_inline_mul (r, s, s);
+}
+
+
+static inline void
+mpcr_inline_mul_2ui (mpcr_ptr r, mpcr_srcptr s, unsigned long int e)
+{
+   mpcr_inline_set (r, s);
+   if (!mpcr_inline_inf_p (s) && !mpcr_inline_zero_p (s))
+      MPCR_EXP (r) += (int64_t) e;
+}
+
+
+static inline void
+mpcr_inline_div_2ui (mpcr_ptr r, mpcr_srcptr s, unsigned long int e)
+{
+   mpcr_inline_set (r, s);
+   if (!mpcr_inline_inf_p (s) && !mpcr_inline_zero_p (s))
+      MPCR_EXP (r) -= (int64_t) e;
+}
+
+
+static inline void
+mpcr_inline_add (mpcr_ptr r, mpcr_srcptr s, mpcr_srcptr t)
+   /* Set r to the sum of s and t, rounded up.
+      After aligning the smaller operand, the sum of the mantissae and the
+      additional ulp lies between 2^30 and 2^32-1, so as for the product,
+      the normalisation is done without a bit count. */
+{
+   int64_t d, m, e, c;
+
+   if (mpcr_inline_inf_p (s) || mpcr_inline_inf_p (t))
+      mpcr_inline_set_inf (r);
+   else if (mpcr_inline_zero_p (s))
+      mpcr_inline_set (r, t);
+   else if (mpcr_inline_zero_p (t))
+      mpcr_inline_set (r, s);
+   else {
+      /* Now all numbers are finite and non-zero. */
+      d = MPCR_EXP (s) - MPCR_EXP (t);
+      if (d >= 0) {
+         e = MPCR_EXP (s);
+         /* Shifting by more than the bitlength of the type may cause
+            compiler warnings and run time errors. */
+         m = MPCR_MANT (s) + (d >= 64 ? 0 : MPCR_MANT (t) >> d);
+      }
+      else {
+         e = MPCR_EXP (t);
+         m = MPCR_MANT (t) + (d <= -64 ? 0 : MPCR_MANT (s) >> (-d));
+      }
+      m++;
+      c = m >> 31;
+      MPCR_MANT (r) = (m >> c) + c;
+      MPCR_EXP (r) = e + c;
+      c = MPCR_MANT (r) >> 31;
+      MPCR_MANT (r) >>= c;
+      MPCR_EXP (r) += c;
+   }
+}
+
+
+static inline void
+mpcr_inline_sub_rnd (mpcr_ptr r, mpcr_srcptr s, mpcr_srcptr t,
+   mpfr_rnd_t rnd)
+   /* Set r to s - t, rounded according to whether rnd is MPFR_RNDU or
+      MPFR_RNDD; if the result were negative, it is set to infinity. */
+{
+   int64_t d;
+   int cmp;
+
+   cmp = mpcr_inline_cmp (s, t);
+   if (mpcr_inline_inf_p (s) || mpcr_inline_inf_p (t) || cmp < 0)
+      mpcr_inline_set_inf (r);
+   else if (cmp == 0)
+      mpcr_inline_set_zero (r);
+   else if (mpcr_inline_zero_p (t))
+      mpcr_inline_set (r, s);
+   else {
+      /* Now all numbers are positive and normalised, and s > t. */
+      d = MPCR_EXP (s) - MPCR_EXP (t);
+      MPCR_MANT (r) = MPCR_MANT (s) - (d >= 64 ? 0 : MPCR_MANT (t) >> d);
+      MPCR_EXP (r) = MPCR_EXP (s);
+      if (rnd == MPFR_RNDD)
+         MPCR_MANT (r)--;
+      mpcr_inline_normalise_rnd (r, rnd);
+   }
+}
+
+
+static inline void
+mpcr_inline_sub (mpcr_ptr r, mpcr_srcptr s, mpcr_srcptr t)
+{
+   mpcr_inline_sub_rnd (r, s, t, MPFR_RNDU);
+}
+
+
+static inline void
+mpcr_inline_div (mpcr_ptr r, mpcr_srcptr s, mpcr_srcptr t)
+{
+   if (mpcr_inline_inf_p (s) || mpcr_inline_inf_p (t)
+       || mpcr_inline_zero_p (t))
+      mpcr_inline_set_inf (r);
+   else if (mpcr_inline_zero_p (s))
+      mpcr_inline_set_zero (r);
+   else {
+      MPCR_MANT (r) = (MPCR_MANT (s) << 32) / MPCR_MANT (t) + 1;
+      MPCR_EXP (r) = MPCR_EXP (s) - 32 - MPCR_EXP (t);
+      mpcr_inline_normalise_rnd (r, MPFR_RNDU);
+   }
+}
+
+
+static inline void
+mpcr_inline_add_rounding_error (mpcr_ptr r, mpfr_prec_t p, mpfr_rnd_t rnd)
+   /* Replace r, radius of a complex ball, by the new radius obtained after
+      rounding both parts of the centre of the ball in direction rnd at
+      precision p.
+      Otherwise said:
+      r += ldexp (1 + r, -p) for rounding to nearest, adding 0.5ulp;
+      r += ldexp (1 + r, 1-p) for directed rounding, adding 1ulp.
+   */
+{
+   mpcr_t s;
+
+   mpcr_inline_set_one (s);
+   mpcr_inline_add (s, s, r);
+   mpcr_inline_div_2ui (s, s, (rnd == MPFR_RNDN ? p : p - 1));
+   mpcr_inline_add (r, r, s);
+}
+
+
+#ifndef MPCR_NO_INLINE
+#define mpcr_inf_p mpcr_inline_inf_p
+#define mpcr_zero_p mpcr_inline_zero_p
+#define mpcr_lt_half_p mpcr_inline_lt_half_p
+#define mpcr_cmp mpcr_inline_cmp
+#define mpcr_set_inf mpcr_inline_set_inf
+#define mpcr_set_zero mpcr_inline_set_zero
+#define mpcr_set_one mpcr_inline_set_one
+#define mpcr_set mpcr_inline_set
+#define mpcr_set_ui64_2si64 mpcr_inline_set_ui64_2si64
+#define mpcr_max mpcr_inline_max
+#define mpcr_get_exp mpcr_inline_get_exp
+#define mpcr_mul mpcr_inline_mul
+#define mpcr_mul_2ui mpcr_inline_mul_2ui
+#define mpcr_sqr mpcr_inline_sqr
+#define mpcr_add mpcr_inline_add
+#define mpcr_sub mpcr_inline_sub
+#define mpcr_sub_rnd mpcr_inline_sub_rnd
+#define mpcr_div mpcr_inline_div
+#define mpcr_div_2ui mpcr_inline_div_2ui
+#define mpcr_add_rounding_error mpcr_inline_add_rounding_error
+#endif
+
+#endif /* __MPCR_INLINE_H */
@@ -1,6 +1,6 @@
 /* mpc_mul -- Multiply two complex numbers
 
-Copyright (C) 2002, 2004, 2005, 2008, 2009, 2010, 2011, 2012, 2016, 2020, 2022 INRIA
+Copyright (C) 2002, 2004, 2005, 2008, 2009, 2010, 2011, 2012, 2016, 2020, 2022, 2025 INRIA
 
 This file is part of GNU MPC.
 
@@ -40,6 +40,7 @@ mul_infinite (mpc_ptr z, mpc_srcptr x, mpc_srcptr y)
 
    int u, v;
 
+   MPC_STATS_EVENT (mul_infinite);
    /* compute the sign of
       u = xrs * yrs * xr * yr - xis * yis * xi * yi
       v = xrs * yis * xr * yi + xis * yrs * xi * yr
@@ -115,6 +116,7 @@ mul_real (mpc_ptr z, mpc_srcptr x, mpc_srcptr y, mpc_rnd_t rnd)
    int xrs, xis, yrs, yis;
    int inex;
 
+   MPC_STATS_EVENT (mul_real);
    /* save signs of operands */
    xrs = MPFR_SIGNBIT (mpc_realref (x));
    xis = MPFR_SIGNBIT (mpc_imagref (x));
@@ -144,6 +146,7 @@ mul_imag (mpc_ptr z, mpc_srcptr x, mpc_srcptr y, mpc_rnd_t rnd)
    int overlap = z == x || z == y;
    mpc_t rop;
 
+   MPC_STATS_EVENT (mul_imag);
    if (overlap)
       mpc_init3 (rop, MPC_PREC_RE (z), MPC_PREC_IM (z));
    else
@@ -179,6 +182,7 @@ mpc_mul_naive (mpc_ptr z, mpc_srcptr x, mpc_srcptr y, mpc_rnd_t rnd)
    int overlap, inex_re, inex_im;
    mpc_t rop;
 
+   MPC_STATS_EVENT (mul_naive);
    MPC_ASSERT (   mpfr_regular_p (mpc_realref (x)) && mpfr_regular_p (mpc_imagref (x))
                && mpfr_regular_p (mpc_realref (y)) && mpfr_regular_p (mpc_imagref (y)));
    overlap = (z == x) || (z == y);
@@ -223,6 +227,7 @@ mpc_mul_karatsuba (mpc_ptr rop, mpc_srcptr op1, mpc_srcptr op2, mpc_rnd_t rnd)
   int loop;
   const int MAX_MUL_LOOP = 1;
 
+  MPC_STATS_EVENT (mul_karatsuba);
   overlap = (rop == op1) || (rop == op2);
   if (overlap)
      mpc_init3 (result, MPC_PREC_RE (rop), MPC_PREC_IM (rop));
@@ -458,6 +463,7 @@ clear:
 int
 mpc_mul (mpc_ptr a, mpc_srcptr b, mpc_srcptr c, mpc_rnd_t rnd)
 {
+   MPC_STATS_FUNC (mul, MPC_MAX_PREC (a))
    /* Conforming to ISO C99 standard (G.5.1 multiplicative operators),
       infinities are treated specially if both parts are NaN when computed
       naively. See also
@@ -470,6 +476,7 @@ mpc_mul (mpc_ptr a, mpc_srcptr b, mpc_srcptr c, mpc_rnd_t rnd)
    /* NaN contamination of both parts in result */
    if (mpfr_nan_p (mpc_realref (b)) || mpfr_nan_p (mpc_imagref (b))
        || mpfr_nan_p (mpc_realref (c)) || mpfr_nan_p (mpc_imagref (c))) {
+      MPC_STATS_EVENT (mul_nan);
       mpfr_set_nan (mpc_realref (a));
       mpfr_set_nan (mpc_imagref (a));
       return MPC_INEX (0, 0);
@@ -1,6 +1,6 @@
 /* mpc_mul_2si -- Multiply a complex number by 2^e.
 
-Copyright (C) 2012 INRIA
+Copyright (C) 2012, 2025 INRIA
 
 This file is part of GNU MPC.
 
@@ -23,6 +23,7 @@ along with this program. If not, see http://www.gnu.org/licenses/ .
 int
 mpc_mul_2si (mpc_ptr a, mpc_srcptr b, long int c, mpc_rnd_t rnd)
 {
+  MPC_STATS_FUNC (mul_2si, MPC_MAX_PREC (a))
   int inex_re, inex_im;
 
   inex_re = mpfr_mul_2si (mpc_realref(a), mpc_realref(b), c, MPC_RND_RE(rnd));
@@ -1,6 +1,6 @@
 /* mpc_mul_fr -- Multiply a complex number by a floating-point number.
 
-Copyright (C) 2002, 2008, 2009, 2010, 2011, 2012 INRIA
+Copyright (C) 2002, 2008, 2009, 2010, 2011, 2012, 2025 INRIA
 
 This file is part of GNU MPC.
 
@@ -23,6 +23,7 @@ along with this program. If not, see http://www.gnu.org/licenses/ .
 int
 mpc_mul_fr (mpc_ptr a, mpc_srcptr b, mpfr_srcptr c, mpc_rnd_t rnd)
 {
+  MPC_STATS_FUNC (mul_fr, MPC_MAX_PREC (a))
   int inex_re, inex_im;
   mpfr_t real;
 
@@ -1,6 +1,6 @@
 /* mpc_mul_i -- Multiply a complex number by plus or minus i.
 
-Copyright (C) 2005, 2009, 2010, 2011, 2012 INRIA
+Copyright (C) 2005, 2009, 2010, 2011, 2012, 2025 INRIA
 
 This file is part of GNU MPC.
 
@@ -24,6 +24,7 @@ int
 mpc_mul_i (mpc_ptr a, mpc_srcptr b, int sign, mpc_rnd_t rnd)
 /* if sign is >= 0, multiply by i, otherwise by -i */
 {
+  MPC_STATS_FUNC (mul_i, MPC_MAX_PREC (a))
   int   inex_re, inex_im;
   mpfr_t tmp;
 
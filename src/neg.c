@@ -1,6 +1,6 @@
 /* mpc_neg -- Negate a complex number.
 
-Copyright (C) 2002, 2009, 2011 INRIA
+Copyright (C) 2002, 2009, 2011, 2025 INRIA
 
 This file is part of GNU MPC.
 
@@ -23,6 +23,7 @@ along with this program. If not, see http://www.gnu.org/licenses/ .
 int
 mpc_neg (mpc_ptr a, mpc_srcptr b, mpc_rnd_t rnd)
 {
+  MPC_STATS_FUNC (neg, MPC_MAX_PREC (a))
   int inex_re, inex_im;
 
   inex_re = mpfr_neg (mpc_realref(a), mpc_realref(b), MPC_RND_RE(rnd));
@@ -1,6 +1,6 @@
 /* mpc_norm -- Square of the norm of a complex number.
 
-Copyright (C) 2002, 2005, 2008, 2009, 2010, 2011, 2012 INRIA
+Copyright (C) 2002, 2005, 2008, 2009, 2010, 2011, 2012, 2025 INRIA
 
 This file is part of GNU MPC.
 
@@ -26,6 +26,7 @@ along with this program. If not, see http://www.gnu.org/licenses/ .
 int
 mpc_norm (mpfr_ptr a, mpc_srcptr b, mpfr_rnd_t rnd)
 {
+   MPC_STATS_FUNC (norm, mpfr_get_prec (a))
    int inexact;
    int saved_underflow, saved_overflow;
 
@@ -574,6 +574,7 @@ is_odd (mpfr_srcptr y, mpfr_exp_t k)
 int
 mpc_pow (mpc_ptr z, mpc_srcptr x, mpc_srcptr y, mpc_rnd_t rnd)
 {
+  MPC_STATS_FUNC (pow, MPC_MAX_PREC (z))
   int ret = -2, loop, x_real, x_imag, y_real, z_real = 0, z_imag = 0,
      ramified = 0;
   mpc_t t, u;
@@ -1,6 +1,6 @@
 /* mpc_pow_fr -- Raise a complex number to a floating-point power.
 
-Copyright (C) 2009, 2011, 2012 INRIA
+Copyright (C) 2009, 2011, 2012, 2025 INRIA
 
 This file is part of GNU MPC.
 
@@ -23,6 +23,7 @@ along with this program. If not, see http://www.gnu.org/licenses/ .
 int
 mpc_pow_fr (mpc_ptr z, mpc_srcptr x, mpfr_srcptr y, mpc_rnd_t rnd)
 {
+  MPC_STATS_FUNC (pow_fr, MPC_MAX_PREC (z))
   mpc_t yy;
   int inex;
 
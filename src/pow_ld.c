@@ -1,6 +1,6 @@
 /* mpc_pow_ld -- Raise a complex number to a long double power.
 
-Copyright (C) 2009 INRIA
+Copyright (C) 2009, 2025 INRIA
 
 This file is part of GNU MPC.
 
@@ -25,6 +25,7 @@ along with this program. If not, see http://www.gnu.org/licenses/ .
 int
 mpc_pow_ld (mpc_ptr z, mpc_srcptr x, long double y, mpc_rnd_t rnd)
 {
+  MPC_STATS_FUNC (pow_ld, MPC_MAX_PREC (z))
   mpc_t yy;
   int inex;
 
@@ -1,6 +1,6 @@
 /* mpc_pow_si -- Raise a complex number to an integer power.
 
-Copyright (C) 2009, 2010 INRIA
+Copyright (C) 2009, 2010, 2025 INRIA
 
 This file is part of GNU MPC.
 
@@ -23,6 +23,7 @@ along with this program. If not, see http://www.gnu.org/licenses/ .
 int
 mpc_pow_si (mpc_ptr z, mpc_srcptr x, long y, mpc_rnd_t rnd)
 {
+   MPC_STATS_FUNC (pow_si, MPC_MAX_PREC (z))
    if (y >= 0)
      return mpc_pow_usi (z, x, (unsigned long) y, 1, rnd);
    else
@@ -1,6 +1,6 @@
 /* mpc_pow_ui -- Raise a complex number to an integer power.
 
-Copyright (C) 2009, 2010, 2011, 2012 INRIA
+Copyright (C) 2009, 2010, 2011, 2012, 2025 INRIA
 
 This file is part of GNU MPC.
 
@@ -165,5 +165,6 @@ mpc_pow_usi (mpc_ptr z, mpc_srcptr x, unsigned long y, int sign,
 int
 mpc_pow_ui (mpc_ptr z, mpc_srcptr x, unsigned long y, mpc_rnd_t rnd)
 {
+  MPC_STATS_FUNC (pow_ui, MPC_MAX_PREC (z))
   return mpc_pow_usi (z, x, y, 1, rnd);
 }
@@ -1,6 +1,6 @@
 /* mpc_pow_z -- Raise a complex number to an integer power.
 
-Copyright (C) 2009, 2010 INRIA
+Copyright (C) 2009, 2010, 2025 INRIA
 
 This file is part of GNU MPC.
 
@@ -23,6 +23,7 @@ along with this program. If not, see http://www.gnu.org/licenses/ .
 int
 mpc_pow_z (mpc_ptr z, mpc_srcptr x, mpz_srcptr y, mpc_rnd_t rnd)
 {
+   MPC_STATS_FUNC (pow_z, MPC_MAX_PREC (z))
    mpc_t yy;
    int inex;
    mpfr_prec_t n = (mpfr_prec_t) mpz_sizeinbase (y, 2);
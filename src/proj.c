@@ -1,6 +1,6 @@
 /* mpc_proj -- projection of a complex number onto the Riemann sphere.
 
-Copyright (C) 2008, 2009, 2011 INRIA
+Copyright (C) 2008, 2009, 2011, 2025 INRIA
 
 This file is part of GNU MPC.
 
@@ -23,6 +23,7 @@ along with this program. If not, see http://www.gnu.org/licenses/ .
 int
 mpc_proj (mpc_ptr a, mpc_srcptr b, mpc_rnd_t rnd)
 {
+   MPC_STATS_FUNC (proj, MPC_MAX_PREC (a))
    if (mpc_inf_p (b)) {
       /* infinities project to +Inf +i* copysign(0.0, cimag(z)) */
       mpfr_set_inf (mpc_realref (a), +1);
@@ -1,6 +1,6 @@
 /* mpc_rootofunity -- primitive root of unity.
 
-Copyright (C) 2012, 2016 INRIA
+Copyright (C) 2012, 2016, 2025 INRIA
 
 This file is part of GNU MPC.
 
@@ -33,6 +33,7 @@ gcd (unsigned long a, unsigned long b)
 int
 mpc_rootofunity (mpc_ptr rop, unsigned long n, unsigned long k, mpc_rnd_t rnd)
 {
+   MPC_STATS_FUNC (rootofunity, MPC_MAX_PREC (rop))
    unsigned long g;
    mpq_t kn;
    mpfr_t t, s, c;
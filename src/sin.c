@@ -1,6 +1,6 @@
 /* mpc_sin -- sine of a complex number.
 
-Copyright (C) 2010, 2011 INRIA
+Copyright (C) 2010, 2011, 2025 INRIA
 
 This file is part of GNU MPC.
 
@@ -23,5 +23,6 @@ along with this program. If not, see http://www.gnu.org/licenses/ .
 int
 mpc_sin (mpc_ptr rop, mpc_srcptr op, mpc_rnd_t rnd)
 {
+   MPC_STATS_FUNC (sin, MPC_MAX_PREC (rop))
    return MPC_INEX1 (mpc_sin_cos (rop, NULL, op, rnd, 0));
 }
@@ -1,6 +1,6 @@
 /* mpc_sin_cos -- combined sine and cosine of a complex number.
 
-Copyright (C) 2010, 2011, 2012, 2020, 2024 INRIA
+Copyright (C) 2010, 2011, 2012, 2020, 2024, 2025 INRIA
 
 This file is part of GNU MPC.
 
@@ -310,6 +310,36 @@ mpc_fix_zero (mpfr_t x, mpfr_rnd_t rnd)
     }
 }
 
+/* Set x to the rounding of c + sign * epsilon, where c is a small
+   non-zero integer, sign is +1 or -1 and epsilon is a positive number
+   smaller than any representable one.
+   Return the inexact flag. */
+int
+mpc_set_si_tiny (mpfr_ptr x, long int c, int sign, mpfr_rnd_t rnd)
+{
+  mpfr_set_si (x, c, MPFR_RNDN);
+  if (sign > 0)
+    {
+      if (rnd == MPFR_RNDU || (rnd == MPFR_RNDA && c > 0)
+          || (rnd == MPFR_RNDZ && c < 0))
+        {
+          mpfr_nextabove (x);
+          return 1;
+        }
+      return -1;
+    }
+  else
+    {
+      if (rnd == MPFR_RNDD || (rnd == MPFR_RNDA && c < 0)
+          || (rnd == MPFR_RNDZ && c > 0))
+        {
+          mpfr_nextbelow (x);
+          return -1;
+        }
+      return 1;
+    }
+}
+
 int
 mpc_sin_cos (mpc_ptr rop_sin, mpc_ptr rop_cos, mpc_srcptr op,
    mpc_rnd_t rnd_sin, mpc_rnd_t rnd_cos)
@@ -317,6 +347,8 @@ mpc_sin_cos (mpc_ptr rop_sin, mpc_ptr rop_cos, mpc_srcptr op,
       rop_cos may be NULL, in which case it is not computed, and the
       corresponding ternary inexact value is set to 0 (exact).       */
 {
+   MPC_STATS_FUNC (sin_cos, rop_sin != NULL ? MPC_MAX_PREC (rop_sin)
+                                             : MPC_MAX_PREC (rop_cos))
    if (!mpc_fin_p (op))
       return mpc_sin_cos_nonfinite (rop_sin, rop_cos, op, rnd_sin, rnd_cos);
    else if (mpfr_zero_p (mpc_imagref (op)))
@@ -383,6 +415,8 @@ mpc_sin_cos (mpc_ptr rop_sin, mpc_ptr rop_cos, mpc_srcptr op,
       do {
          MPC_LOOP_NEXT(loop, op, rop_sin); // FIXME: take into account rop_cos too
          prec += (loop <= 2) ? mpc_ceil_log2 (prec) + 5 : prec / 2;
+         MPC_ZIV_START (sin_cos, loop, prec,
+            MPC_MAX_PREC (rop_sin != NULL ? rop_sin : rop_cos));
 
          mpfr_set_prec (s, prec);
          mpfr_set_prec (c, prec);
@@ -433,6 +467,8 @@ mpc_sin_cos (mpc_ptr rop_sin, mpc_ptr rop_cos, mpc_srcptr op,
             }
          }
       } while (ok == 0);
+      MPC_ZIV_END (sin_cos, loop, prec,
+         MPC_MAX_PREC (rop_sin != NULL ? rop_sin : rop_cos));
 
       if (rop_sin != NULL) {
          inex_re = mpfr_set (mpc_realref (rop_sin), sch, MPC_RND_RE (rnd_sin));
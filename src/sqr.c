@@ -1,6 +1,6 @@
 /* mpc_sqr -- Square a complex number.
 
-Copyright (C) 2002, 2005, 2008, 2009, 2010, 2011, 2012 INRIA
+Copyright (C) 2002, 2005, 2008, 2009, 2010, 2011, 2012, 2025 INRIA
 
 This file is part of GNU MPC.
 
@@ -162,6 +162,7 @@ mpfr_fsss (mpfr_ptr z, mpfr_srcptr a, mpfr_srcptr c, mpfr_rnd_t rnd)
 int
 mpc_sqr (mpc_ptr rop, mpc_srcptr op, mpc_rnd_t rnd)
 {
+   MPC_STATS_FUNC (sqr, MPC_MAX_PREC (rop))
    int ok;
    mpfr_t u, v;
    mpfr_t x;
@@ -174,6 +175,7 @@ mpc_sqr (mpc_ptr rop, mpc_srcptr op, mpc_rnd_t rnd)
 
    /* special values: NaN and infinities */
    if (!mpc_fin_p (op)) {
+      MPC_STATS_EVENT (sqr_special);
       if (mpfr_nan_p (mpc_realref (op)) || mpfr_nan_p (mpc_imagref (op))) {
          mpfr_set_nan (mpc_realref (rop));
          mpfr_set_nan (mpc_imagref (rop));
@@ -209,6 +211,7 @@ mpc_sqr (mpc_ptr rop, mpc_srcptr op, mpc_rnd_t rnd)
    /* Check for real resp. purely imaginary number */
    if (mpfr_zero_p (mpc_imagref(op))) {
       int same_sign = mpfr_signbit (mpc_realref (op)) == mpfr_signbit (mpc_imagref (op));
+      MPC_STATS_EVENT (sqr_real);
       inex_re = mpfr_sqr (mpc_realref(rop), mpc_realref(op), MPC_RND_RE(rnd));
       inex_im = mpfr_set_ui (mpc_imagref(rop), 0ul, MPFR_RNDN);
       if (!same_sign)
@@ -217,6 +220,7 @@ mpc_sqr (mpc_ptr rop, mpc_srcptr op, mpc_rnd_t rnd)
    }
    if (mpfr_zero_p (mpc_realref(op))) {
       int same_sign = mpfr_signbit (mpc_realref (op)) == mpfr_signbit (mpc_imagref (op));
+      MPC_STATS_EVENT (sqr_imag);
       inex_re = -mpfr_sqr (mpc_realref(rop), mpc_imagref(op), INV_RND (MPC_RND_RE(rnd)));
       mpfr_neg (mpc_realref(rop), mpc_realref(rop), MPFR_RNDN);
       inex_im = mpfr_set_ui (mpc_imagref(rop), 0ul, MPFR_RNDN);
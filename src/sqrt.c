@@ -1,6 +1,6 @@
 /* mpc_sqrt -- Take the square root of a complex number.
 
-Copyright (C) 2002, 2008, 2009, 2010, 2011, 2012, 2020, 2024 INRIA
+Copyright (C) 2002, 2008, 2009, 2010, 2011, 2012, 2020, 2024, 2025 INRIA
 
 This file is part of GNU MPC.
 
@@ -23,6 +23,7 @@ along with this program. If not, see http://www.gnu.org/licenses/ .
 int
 mpc_sqrt (mpc_ptr a, mpc_srcptr b, mpc_rnd_t rnd)
 {
+  MPC_STATS_FUNC (sqrt, MPC_MAX_PREC (a))
   int ok_w, ok_t = 0;
   mpfr_t    w, t;
   mpfr_rnd_t  rnd_w, rnd_t;
@@ -211,6 +212,7 @@ mpc_sqrt (mpc_ptr a, mpc_srcptr b, mpc_rnd_t rnd)
     {
       MPC_LOOP_NEXT(loop, b, a);
       prec += (loop <= 2) ? mpc_ceil_log2 (prec) + 4 : prec / 2;
+      MPC_ZIV_START (sqrt, loop, prec, MPC_MAX_PREC (a));
       mpfr_set_prec (w, prec);
       mpfr_set_prec (t, prec);
       /* let b = x + iy */
@@ -269,6 +271,7 @@ mpc_sqrt (mpc_ptr a, mpc_srcptr b, mpc_rnd_t rnd)
       }
     }
     while ((inex_w && !ok_w) || (inex_t && !ok_t));
+  MPC_ZIV_END (sqrt, loop, prec, MPC_MAX_PREC (a));
 
    if (re_cmp > 0) {
          inex_re = mpfr_set (mpc_realref (a), w, MPC_RND_RE(rnd));
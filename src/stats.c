@@ -0,0 +1,230 @@
+/* stats.c -- Statistics on the calls of the library functions.
+
+Copyright (C) 2025 INRIA
+
+This file is part of GNU MPC.
+
+GNU MPC is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the
+Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+GNU MPC is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for
+more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program. If not, see http://www.gnu.org/licenses/ .
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include "mpc-impl.h"
+
+#ifdef MPC_STATS
+#include <time.h>
+
+/* The counters are shared between all threads and updated with atomic
+   operations; times are kept in nanoseconds. */
+typedef struct {
+   uint64_t calls;
+   uint64_t time;
+   uint64_t max_time;
+   uint64_t prec [MPC_STATS_PREC_BUCKETS];
+   uint64_t ziv [MPC_STATS_ZIV_LOOPS];
+   uint64_t ziv_bits;
+   uint64_t ziv_max_bits;
+} stats_func_t;
+
+static stats_func_t stats_func [MPC_STATS_NFUNC];
+static uint64_t stats_event [MPC_STATS_NEVENT];
+
+#define MPC_STATS_NAME(f) #f,
+static const char *stats_func_name [] = {
+   MPC_STATS_FUNCTIONS (MPC_STATS_NAME)
+   NULL
+};
+static const char *stats_event_name [] = {
+   MPC_STATS_EVENTS (MPC_STATS_NAME)
+   NULL
+};
+
+
+static uint64_t
+stats_ns (void)
+{
+   struct timespec ts;
+
+   clock_gettime (CLOCK_MONOTONIC, &ts);
+   return (uint64_t) ts.tv_sec * 1000000000u + (uint64_t) ts.tv_nsec;
+}
+
+
+static void
+stats_max (uint64_t *m, uint64_t d)
+{
+   uint64_t old = __atomic_load_n (m, __ATOMIC_RELAXED);
+
+   while (d > old
+          && !__atomic_compare_exchange_n (m, &old, d, 1,
+                 __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+}
+
+
+mpc_stats_timer_t
+mpc_stats_enter (int func, mpfr_prec_t prec)
+{
+   mpc_stats_timer_t t;
+   int k;
+
+   for (k = 0; k < MPC_STATS_PREC_BUCKETS - 1 && ((mpfr_prec_t) 1 << k) < prec;
+        k++);
+   __atomic_fetch_add (&stats_func [func].calls, 1, __ATOMIC_RELAXED);
+   __atomic_fetch_add (&stats_func [func].prec [k], 1, __ATOMIC_RELAXED);
+   t.func = func;
+   t.start = stats_ns ();
+
+   return t;
+}
+
+
+void
+mpc_stats_leave (mpc_stats_timer_t *t)
+{
+   uint64_t d;
+   stats_func_t *s = stats_func + t->func;
+
+   d = stats_ns () - t->start;
+   __atomic_fetch_add (&s->time, d, __ATOMIC_RELAXED);
+   stats_max (&s->max_time, d);
+}
+
+
+void
+mpc_stats_event (int e)
+{
+   __atomic_fetch_add (&stats_event [e], 1, __ATOMIC_RELAXED);
+}
+
+
+void
+mpc_stats_ziv (int func, int loop, mpfr_prec_t extra)
+   /* Count a Ziv loop of function func that has succeeded after loop
+      iterations, with a final working precision of extra bits more
+      than the result precision. */
+{
+   stats_func_t *s = stats_func + func;
+   uint64_t d = (extra > 0 ? (uint64_t) extra : 0);
+
+   loop = MPC_MIN (MPC_MAX (loop, 1), MPC_STATS_ZIV_LOOPS);
+   __atomic_fetch_add (&s->ziv [loop - 1], 1, __ATOMIC_RELAXED);
+   __atomic_fetch_add (&s->ziv_bits, d, __ATOMIC_RELAXED);
+   stats_max (&s->ziv_max_bits, d);
+}
+#endif
+
+
+int
+mpc_stats_get (mpc_stats_t *s, const char *name)
+   /* Set s to the statistics of the function or special case of the
+      given name, with or without the prefix "mpc_", and return 0;
+      if there is no such name or if the library has been built without
+      --enable-stats, return -1. */
+{
+#ifdef MPC_STATS
+   int i, k;
+
+   if (strncmp (name, "mpc_", 4) == 0)
+      name += 4;
+   for (i = 0; i < MPC_STATS_NFUNC; i++)
+      if (strcmp (name, stats_func_name [i]) == 0) {
+         s->calls = (unsigned long int) stats_func [i].calls;
+         s->time = stats_func [i].time * 1e-9;
+         s->max_time = stats_func [i].max_time * 1e-9;
+         for (k = 0; k < MPC_STATS_PREC_BUCKETS; k++)
+            s->prec [k] = (unsigned long int) stats_func [i].prec [k];
+         for (k = 0; k < MPC_STATS_ZIV_LOOPS; k++)
+            s->ziv [k] = (unsigned long int) stats_func [i].ziv [k];
+         s->ziv_bits = (unsigned long int) stats_func [i].ziv_bits;
+         s->ziv_max_bits = (unsigned long int) stats_func [i].ziv_max_bits;
+         return 0;
+      }
+   for (i = 0; i < MPC_STATS_NEVENT; i++)
+      if (strcmp (name, stats_event_name [i]) == 0) {
+         s->calls = (unsigned long int) stats_event [i];
+         s->time = 0;
+         s->max_time = 0;
+         for (k = 0; k < MPC_STATS_PREC_BUCKETS; k++)
+            s->prec [k] = 0;
+         for (k = 0; k < MPC_STATS_ZIV_LOOPS; k++)
+            s->ziv [k] = 0;
+         s->ziv_bits = 0;
+         s->ziv_max_bits = 0;
+         return 0;
+      }
+#else
+   (void) s;
+   (void) name;
+#endif
+   return -1;
+}
+
+
+void
+mpc_stats_reset (void)
+{
+#ifdef MPC_STATS
+   memset (stats_func, 0, sizeof (stats_func));
+   memset (stats_event, 0, sizeof (stats_event));
+#endif
+}
+
+
+void
+mpc_stats_dump (FILE *f)
+   /* Print the statistics of all functions that have been called and of
+      all special cases that have occurred. */
+{
+#ifdef MPC_STATS
+   stats_func_t *s;
+   uint64_t n;
+   int i, k;
+
+   fprintf (f, "%-16s %12s %12s %12s %12s  %s\n", "function", "calls",
+            "time/s", "mean/ns", "max/ns", "precisions");
+   for (i = 0; i < MPC_STATS_NFUNC; i++) {
+      s = stats_func + i;
+      if (s->calls == 0)
+         continue;
+      fprintf (f, "mpc_%-12s %12lu %12.6f %12.0f %12lu ", stats_func_name [i],
+               (unsigned long int) s->calls, s->time * 1e-9,
+               (double) s->time / (double) s->calls,
+               (unsigned long int) s->max_time);
+      for (k = 0; k < MPC_STATS_PREC_BUCKETS; k++)
+         if (s->prec [k] != 0)
+            fprintf (f, " %s%lu:%lu", k < MPC_STATS_PREC_BUCKETS - 1 ? "<=" : ">",
+                     1ul << (k < MPC_STATS_PREC_BUCKETS - 1 ? k : k - 1),
+                     (unsigned long int) s->prec [k]);
+      fprintf (f, "\n");
+      for (n = 0, k = 0; k < MPC_STATS_ZIV_LOOPS; k++)
+         n += s->ziv [k];
+      if (n != 0) {
+         fprintf (f, "%-16s iterations", "  Ziv loops");
+         for (k = 0; k < MPC_STATS_ZIV_LOOPS; k++)
+            if (s->ziv [k] != 0)
+               fprintf (f, " %s%i:%lu", k < MPC_STATS_ZIV_LOOPS - 1 ? "" : ">=",
+                        k + 1, (unsigned long int) s->ziv [k]);
+         fprintf (f, ", extra bits mean %.1f max %lu\n",
+                  (double) s->ziv_bits / (double) n,
+                  (unsigned long int) s->ziv_max_bits);
+      }
+   }
+   for (i = 0; i < MPC_STATS_NEVENT; i++)
+      if (stats_event [i] != 0)
+         fprintf (f, "%-16s %12lu\n", stats_event_name [i],
+                  (unsigned long int) stats_event [i]);
+#else
+   fprintf (f, "GNU MPC has been built without --enable-stats\n");
+#endif
+}
@@ -1,7 +1,7 @@
 /* mpc_sub_fr -- Substract a floating-point number to the real part of a
    complex number.
 
-Copyright (C) 2008, 2009, 2011 INRIA
+Copyright (C) 2008, 2009, 2011, 2025 INRIA
 
 This file is part of GNU MPC.
 
@@ -25,6 +25,7 @@ along with this program. If not, see http://www.gnu.org/licenses/ .
 int
 mpc_sub_fr (mpc_ptr a, mpc_srcptr b, mpfr_srcptr c, mpc_rnd_t rnd)
 {
+  MPC_STATS_FUNC (sub_fr, MPC_MAX_PREC (a))
   int inex_re, inex_im;
 
   inex_re = mpfr_sub (mpc_realref(a), mpc_realref(b), c, MPC_RND_RE(rnd));
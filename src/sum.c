@@ -1,6 +1,6 @@
 /* mpc_sum -- Add an array of complex numbers.
 
-Copyright (C) 2018 INRIA
+Copyright (C) 2018, 2025 INRIA
 
 This file is part of GNU MPC.
 
@@ -24,6 +24,7 @@ along with this program. If not, see http://www.gnu.org/licenses/ .
 int
 mpc_sum (mpc_ptr sum, const mpc_ptr *z, unsigned long n, mpc_rnd_t rnd)
 {
+  MPC_STATS_FUNC (sum, MPC_MAX_PREC (sum))
   int inex_re, inex_im;
   mpfr_ptr *t;
   unsigned long i;
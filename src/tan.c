@@ -1,6 +1,6 @@
 /* mpc_tan -- tangent of a complex number.
 
-Copyright (C) 2008, 2009, 2010, 2011, 2012, 2013, 2015, 2020, 2022, 2024 INRIA
+Copyright (C) 2008, 2009, 2010, 2011, 2012, 2013, 2015, 2020, 2022, 2024, 2025 INRIA
 
 This file is part of GNU MPC.
 
@@ -118,6 +118,7 @@ tan_re_cmp_zero (mpc_srcptr op, mpfr_exp_t emin, mpfr_ptr xout, mpfr_prec_t px,
 int
 mpc_tan (mpc_ptr rop, mpc_srcptr op, mpc_rnd_t rnd)
 {
+  MPC_STATS_FUNC (tan, MPC_MAX_PREC (rop))
   mpc_t x, y;
   mpfr_prec_t prec, py;
   mpfr_exp_t err;
@@ -284,6 +285,7 @@ mpc_tan (mpc_ptr rop, mpc_srcptr op, mpc_rnd_t rnd)
 
       /* FIXME: prevent addition overflow */
       prec += mpc_ceil_log2 (prec) + err;
+      MPC_ZIV_START (tan, loop, prec, MPC_MAX_PREC (rop));
       mpc_set_prec (x, prec);
       mpc_set_prec (y, prec);
 
@@ -406,6 +408,7 @@ mpc_tan (mpc_ptr rop, mpc_srcptr op, mpc_rnd_t rnd)
         prec += prec / 2;
     }
   while (ok == 0);
+  MPC_ZIV_END (tan, loop, prec, MPC_MAX_PREC (rop));
 
   inex = mpc_set (rop, x, rnd);
 
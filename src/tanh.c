@@ -1,6 +1,6 @@
 /* mpc_tanh -- hyperbolic tangent of a complex number.
 
-Copyright (C) 2008, 2009, 2011, 2012 INRIA
+Copyright (C) 2008, 2009, 2011, 2012, 2025 INRIA
 
 This file is part of GNU MPC.
 
@@ -23,6 +23,7 @@ along with this program. If not, see http://www.gnu.org/licenses/ .
 int
 mpc_tanh (mpc_ptr rop, mpc_srcptr op, mpc_rnd_t rnd)
 {
+  MPC_STATS_FUNC (tanh, MPC_MAX_PREC (rop))
   /* tanh(op) = -i*tan(i*op) = conj(-i*tan(conj(-i*op))) */
   mpc_t z;
   mpc_t tan_z;
@@ -1,6 +1,6 @@
 /* mpc_ui_div -- Divide an unsigned long int by a complex number.
 
-Copyright (C) 2002, 2009 INRIA
+Copyright (C) 2002, 2009, 2025 INRIA
 
 This file is part of GNU MPC.
 
@@ -24,6 +24,7 @@ along with this program. If not, see http://www.gnu.org/licenses/ .
 int
 mpc_ui_div (mpc_ptr a, unsigned long int b, mpc_srcptr c, mpc_rnd_t rnd)
 {
+  MPC_STATS_FUNC (ui_div, MPC_MAX_PREC (a))
   int inex;
   mpc_t bb;
 
@@ -1,7 +1,7 @@
 /* mpc_ui_ui_sub -- Subtract a complex number from another one given
    implicitly by its real and imaginary parts of type unsigned long int.
 
-Copyright (C) 2011 INRIA
+Copyright (C) 2011, 2025 INRIA
 
 This file is part of GNU MPC.
 
@@ -25,6 +25,7 @@ int
 mpc_ui_ui_sub (mpc_ptr rop, unsigned long int re, unsigned long int im,
                mpc_srcptr op, mpc_rnd_t rnd)
 {
+   MPC_STATS_FUNC (ui_ui_sub, MPC_MAX_PREC (rop))
    int inex_re, inex_im;
 
    inex_re = mpfr_ui_sub (mpc_realref (rop), re, mpc_realref (op), MPC_RND_RE (rnd));
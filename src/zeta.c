@@ -0,0 +1,1077 @@
+/* mpc_hurwitz_zeta, mpc_zeta, mpc_zeta_vertical -- Hurwitz and Riemann
+   zeta functions of a complex number.
+
+Copyright (C) 2025 INRIA
+
+This file is part of GNU MPC.
+
+GNU MPC is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the
+Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+GNU MPC is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for
+more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program. If not, see http://www.gnu.org/licenses/ .
+*/
+
+#include <stdio.h> /* for MPC_ASSERT */
+#include "mpc-impl.h"
+
+/* Write s = sigma + i tau and alpha = Re (a). For integers N >= 0 and
+   M >= 1, the Euler-Maclaurin formula reads
+      zeta (s, a) = sum_{k=0}^{N-1} (a+k)^(-s) + (a+N)^(1-s) / (s-1)
+                    + (a+N)^(-s) / 2
+                    + sum_{j=1}^M B_{2j} / (2j)! (s)_{2j-1} (a+N)^(1-s-2j)
+                    + R,
+   where (s)_k = s (s+1) ... (s+k-1) is the rising factorial, and by
+   Theorem 1 of Johansson, "Rigorous high-precision computation of the
+   Hurwitz zeta function and its derivatives", Numer. Algorithms 69 (2015),
+   http://arxiv.org/abs/1309.2877,
+      |R| <= 4 |(s)_{2M}| / (2 pi)^(2M) * exp (|tau| theta)
+             * (alpha+N)^(1-sigma-2M) / (sigma+2M-1)
+   with theta = |arg (a+N)| <= |Im (a)| / (alpha+N), as long as
+   alpha + N > 0 and sigma + 2M > 1. We impose alpha + N >= 1, so that
+   the bound decreases with N. Given the target accuracy, N and M are
+   chosen to minimise the cost of the N powers plus that of the M
+   Bernoulli terms; the latter are B_{2j} / (2j)! V_j with
+   V_1 = s (a+N)^(-s) / (a+N) and
+   V_{j+1} = V_j (s+2j-1) (s+2j) / (a+N)^2.
+   For a = 1, the powers k^(-s) are obtained from a table of the
+   logarithms and the k^(-sigma) for the primes k, the powers of
+   composite k as products of two smaller powers. The table only depends
+   on sigma, so that it is shared by all points of a vertical line.
+   All the terms are added by mpc_sum, so that the error of the sum is
+   the sum of the errors of the terms plus a final rounding. The error of
+   each term is bounded by a multiple of u = 2^(-prec) of its absolute
+   value, which is accumulated at low precision with rounding upwards.
+   Since the cost grows linearly with |s|, large imaginary parts are
+   expensive; no functional equation is used. */
+
+#define LOG2_E    1.4426950408889634
+#define LOG2_2PI  2.6514961294723187
+#define BOUND_PREC 32 /* precision of the error bounds */
+/* Rough costs in multiplications: of a power k^(-s) for a = 1 and
+   composite k, of an additional log, exp and sin_cos for prime k, of a
+   power (a+k)^(-s) for general a, and of a Bernoulli term. */
+#define COST_ONE     1
+#define COST_PRIME  25
+#define COST_POW    35
+#define COST_BER     8
+
+/* The coefficients B_{2j} / (2j)! for 1 <= j <= zeta_size, rounded to
+   nearest at precision zeta_prec, which is the largest precision
+   requested so far. */
+static MPC_THREAD_LOCAL mpfr_t *zeta_cache = NULL;
+static MPC_THREAD_LOCAL unsigned long int zeta_size = 0;
+static MPC_THREAD_LOCAL mpfr_prec_t zeta_prec = 0;
+
+static void
+zeta_set (mpfr_ptr c, unsigned long int j)
+{
+   mpq_t q;
+
+   mpq_init (q);
+   mpz_fac_ui (mpq_denref (q), 2 * j);
+   mpz_set_ui (mpq_numref (q), 1);
+   mpq_mul (q, q, mpc_bernoulli_b2k (j));
+   mpfr_set_q (c, q, MPFR_RNDN);
+   mpq_clear (q);
+}
+
+
+static mpfr_srcptr
+zeta_coefficient (unsigned long int j, mpfr_prec_t prec)
+   /* Return B_{2j} / (2j)! rounded to nearest at a precision of at
+      least prec. */
+{
+   unsigned long int i, n;
+
+   if (prec > zeta_prec) {
+      for (i = 0; i < zeta_size; i++) {
+         mpfr_set_prec (zeta_cache [i], prec);
+         zeta_set (zeta_cache [i], i + 1);
+      }
+      zeta_prec = prec;
+   }
+   if (j > zeta_size) {
+      n = MPC_MAX (j, zeta_size + zeta_size / 2);
+      zeta_cache = (mpfr_t *) realloc (zeta_cache, n * sizeof (mpfr_t));
+      MPC_ASSERT (zeta_cache != NULL);
+      for (i = zeta_size; i < n; i++) {
+         mpfr_init2 (zeta_cache [i], zeta_prec);
+         zeta_set (zeta_cache [i], i + 1);
+      }
+      zeta_size = n;
+   }
+
+   return zeta_cache [j - 1];
+}
+
+
+void
+mpc_zeta_free_cache (void)
+{
+   unsigned long int i;
+
+   for (i = 0; i < zeta_size; i++)
+      mpfr_clear (zeta_cache [i]);
+   free (zeta_cache);
+   zeta_cache = NULL;
+   zeta_size = 0;
+   zeta_prec = 0;
+}
+
+
+/* The table of powers for a = 1 and a fixed sigma. */
+typedef struct {
+   unsigned long int n;     /* the table covers the integers 1 <= k < n */
+   unsigned long int *spf;  /* the smallest prime factor of k */
+   unsigned char *omega;    /* the number of prime factors of k */
+   mpfr_t *lg;              /* log (k), for k prime */
+   mpfr_t *pw;              /* k^(-sigma), for k prime */
+} zeta_table_t;
+
+static void
+table_init (zeta_table_t *tab, unsigned long int n, mpfr_srcptr sigma,
+   mpfr_prec_t prec)
+{
+   unsigned long int k, l;
+
+   tab->n = n;
+   tab->spf = (unsigned long int *) calloc (n, sizeof (unsigned long int));
+   tab->omega = (unsigned char *) malloc (n);
+   tab->lg = (mpfr_t *) malloc (n * sizeof (mpfr_t));
+   tab->pw = (mpfr_t *) malloc (n * sizeof (mpfr_t));
+   MPC_ASSERT (tab->spf != NULL && tab->omega != NULL
+               && tab->lg != NULL && tab->pw != NULL);
+   if (n > 1)
+      tab->omega [1] = 0;
+   for (k = 2; k < n; k++) {
+      if (tab->spf [k] == 0) {
+         for (l = k; l < n; l += k)
+            if (tab->spf [l] == 0)
+               tab->spf [l] = k;
+         mpfr_init2 (tab->lg [k], prec);
+         mpfr_init2 (tab->pw [k], prec);
+         /* mpfr_log_ui is slower at small precision */
+         mpfr_set_ui (tab->pw [k], k, MPFR_RNDN);
+         mpfr_log (tab->lg [k], tab->pw [k], MPFR_RNDN);
+         mpfr_mul (tab->pw [k], tab->lg [k], sigma, MPFR_RNDN);
+         mpfr_neg (tab->pw [k], tab->pw [k], MPFR_RNDN);
+         mpfr_exp (tab->pw [k], tab->pw [k], MPFR_RNDN);
+      }
+      tab->omega [k] = tab->omega [k / tab->spf [k]] + 1;
+   }
+}
+
+
+static void
+table_clear (zeta_table_t *tab)
+{
+   unsigned long int k;
+
+   for (k = 2; k < tab->n; k++)
+      if (tab->spf [k] == k) {
+         mpfr_clear (tab->lg [k]);
+         mpfr_clear (tab->pw [k]);
+      }
+   free (tab->spf);
+   free (tab->omega);
+   free (tab->lg);
+   free (tab->pw);
+}
+
+
+static double
+log2_approx (double x)
+   /* Return an approximation of log2 (x) for x > 0, with an absolute
+      error less than 10^-5, without using the mathematical library. */
+{
+   double e = 0, y, y2;
+
+   while (x >= 4294967296.0) {
+      x /= 4294967296.0;
+      e += 32;
+   }
+   while (x < 1) {
+      x *= 4294967296.0;
+      e -= 32;
+   }
+   while (x >= 2) {
+      x /= 2;
+      e++;
+   }
+   /* log (x) = 2 atanh (y) with 0 <= y < 1/3 */
+   y = (x - 1) / (x + 1);
+   y2 = y * y;
+   return e + 2 * LOG2_E * y
+              * (1 + y2 * (1.0 / 3 + y2 * (1.0 / 5 + y2 * (1.0 / 7
+                 + y2 / 9))));
+}
+
+
+static double
+exp2_approx (double x)
+   /* Return an approximation of 2^x for x < 1024, with a relative error
+      less than 10^-5. */
+{
+   double r = 1, f, t, e;
+   int i;
+
+   while (x >= 1) {
+      r *= 2;
+      x--;
+   }
+   while (x < 0) {
+      r /= 2;
+      x++;
+   }
+   /* 2^x = exp (x log (2)) with 0 <= x < 1 */
+   f = x / LOG2_E;
+   t = 1;
+   e = 1;
+   for (i = 1; i <= 10; i++) {
+      t = t * f / i;
+      e += t;
+   }
+   return r * e;
+}
+
+
+static void
+zeta_remainder (mpfr_ptr r, mpc_srcptr s, mpc_srcptr a,
+   unsigned long int N, unsigned long int M)
+   /* Set r to an upper bound on the remainder |R| of the Euler-Maclaurin
+      formula, or to +Inf if alpha + N < 1 or sigma + 2M - 1 <= 0. */
+{
+   mpfr_t b, e, t, x, y;
+   unsigned long int j;
+
+   mpfr_init2 (b, BOUND_PREC);
+   mpfr_init2 (e, BOUND_PREC);
+   mpfr_init2 (t, BOUND_PREC);
+   mpfr_init2 (x, BOUND_PREC);
+   mpfr_init2 (y, BOUND_PREC);
+
+   mpfr_add_ui (b, mpc_realref (a), N, MPFR_RNDD);
+   mpfr_add_ui (e, mpc_realref (s), 2 * M - 1, MPFR_RNDD);
+   if (mpfr_cmp_ui (b, 1) < 0 || mpfr_sgn (e) <= 0)
+      mpfr_set_inf (r, 1);
+   else {
+      /* 4 |(s)_{2M}|, from the product of the |s+j|^2 */
+      mpfr_set_ui (r, 1, MPFR_RNDU);
+      mpfr_sqr (y, mpc_imagref (s), MPFR_RNDU);
+      for (j = 0; j < 2 * M; j++) {
+         mpfr_add_ui (x, mpc_realref (s), j, MPFR_RNDA);
+         mpfr_sqr (t, x, MPFR_RNDU);
+         mpfr_add (t, t, y, MPFR_RNDU);
+         mpfr_mul (r, r, t, MPFR_RNDU);
+      }
+      mpfr_sqrt (r, r, MPFR_RNDU);
+      mpfr_mul_2ui (r, r, 2, MPFR_RNDU);
+      mpfr_abs (y, mpc_imagref (s), MPFR_RNDU);
+      /* (2 pi)^(2M) */
+      mpfr_const_pi (t, MPFR_RNDD);
+      mpfr_mul_2ui (t, t, 1, MPFR_RNDD);
+      mpfr_pow_ui (t, t, 2 * M, MPFR_RNDD);
+      mpfr_div (r, r, t, MPFR_RNDU);
+      /* exp (|tau| theta) */
+      if (!mpfr_zero_p (mpc_imagref (a)) && !mpfr_zero_p (y)) {
+         mpfr_abs (t, mpc_imagref (a), MPFR_RNDU);
+         mpfr_mul (t, t, y, MPFR_RNDU);
+         mpfr_div (t, t, b, MPFR_RNDU);
+         mpfr_exp (t, t, MPFR_RNDU);
+         mpfr_mul (r, r, t, MPFR_RNDU);
+      }
+      /* (alpha+N)^(1-sigma-2M) / (sigma+2M-1) */
+      mpfr_pow (t, b, e, MPFR_RNDD);
+      mpfr_div (r, r, t, MPFR_RNDU);
+      mpfr_div (r, r, e, MPFR_RNDU);
+   }
+
+   mpfr_clear (b);
+   mpfr_clear (e);
+   mpfr_clear (t);
+   mpfr_clear (x);
+   mpfr_clear (y);
+}
+
+
+static int
+zeta_parameters (unsigned long int *N, unsigned long int *M,
+   mpc_srcptr s, mpc_srcptr a, mpfr_exp_t target, int one)
+   /* Set N and M such that the remainder of the Euler-Maclaurin formula
+      is bounded by 2^target, at a cost close to the minimal one; the
+      powers are cheaper when one is non-zero, that is, for a = 1.
+      The search uses rough estimates in double precision, and N is then
+      increased until the rigorous bound of zeta_remainder holds.
+      Since N grows like |Im s|, and the terms of the sum and the table
+      of powers are held in memory, return 0 if N would exceed
+      ZETA_MAX_TERMS, and 1 otherwise. */
+{
+   double sigma, tau, alpha, beta, lp, lr, e, n, c, best, x;
+   unsigned long int m, mmax, worse;
+   mpfr_t r;
+
+   sigma = mpfr_get_d (mpc_realref (s), MPFR_RNDN);
+   tau = mpfr_get_d (mpc_imagref (s), MPFR_RNDN);
+   tau = (tau < 0 ? -tau : tau);
+   alpha = mpfr_get_d (mpc_realref (a), MPFR_RNDN);
+   beta = mpfr_get_d (mpc_imagref (a), MPFR_RNDN);
+   beta = (beta < 0 ? -beta : beta);
+
+   /* Beyond mmax, which is much larger than anything reasonable, we
+      give up: only huge values of |s| lead there. */
+   mmax = (sigma < 0 ? (unsigned long int) (-sigma / 2) : 0)
+          + (((unsigned long int) 1) << 24);
+   lp = 2; /* log2 (4 |(s)_{2m}|) */
+   best = -1;
+   worse = 0;
+   for (m = 1; worse < 4 + m / 8 && m < mmax; m++) {
+      x = sigma + (double) (2 * m - 2);
+      lp += log2_approx (x * x + tau * tau + 1e-300) / 2;
+      x += 1;
+      lp += log2_approx (x * x + tau * tau + 1e-300) / 2;
+      e = sigma + (double) (2 * m - 1);
+      if (e < 0.5)
+         continue;
+      /* The bound holds when (alpha+N)^e exceeds 2^lr. */
+      lr = lp - 2 * m * LOG2_2PI - log2_approx (e) - (double) target;
+      if (lr / e > 60) {
+         /* N would not fit, m is too small */
+         if (best >= 0)
+            worse++;
+         continue;
+      }
+      n = exp2_approx (MPC_MAX (lr / e, -64)) - alpha;
+      if (beta > 0 && tau > 0) {
+         /* take exp (|tau| theta) into account */
+         x = alpha + MPC_MAX (n, 1 - alpha);
+         n = exp2_approx (MPC_MAX ((lr + LOG2_E * tau * beta / x) / e, -64))
+             - alpha;
+      }
+      n = MPC_MAX (MPC_MAX (n, 1 - alpha), 1);
+      if (one)
+         /* about n / log (n) primes */
+         c = n * (COST_ONE + COST_PRIME / (log2_approx (n + 1) / LOG2_E));
+      else
+         c = n * COST_POW;
+      c += m * COST_BER;
+      if (best < 0 || c < best) {
+         best = c;
+         *N = (unsigned long int) n + 1;
+         *M = m;
+         worse = 0;
+      }
+      else
+         worse++;
+   }
+   if (best < 0 || *N > ZETA_MAX_TERMS)
+      return 0;
+
+   mpfr_init2 (r, BOUND_PREC);
+   while (*N <= ZETA_MAX_TERMS) {
+      zeta_remainder (r, s, a, *N, *M);
+      if (mpfr_cmp_ui_2exp (r, 1, target) <= 0)
+         break;
+      *N += *N / 16 + 1;
+   }
+   mpfr_clear (r);
+
+   return *N <= ZETA_MAX_TERMS;
+}
+
+
+static void
+abs_bound (mpfr_ptr r, mpc_srcptr z)
+   /* Set r to |Re (z)| + |Im (z)| >= |z| rounded upwards, which is
+      much cheaper than mpc_abs. */
+{
+   mpfr_t t;
+
+   mpfr_init2 (t, BOUND_PREC);
+   mpfr_abs (r, mpc_realref (z), MPFR_RNDU);
+   mpfr_abs (t, mpc_imagref (z), MPFR_RNDU);
+   mpfr_add (r, r, t, MPFR_RNDU);
+   mpfr_clear (t);
+}
+
+
+static void
+add_error (mpfr_ptr e, mpc_srcptr z, mpfr_srcptr c)
+   /* Add c |z| to e, rounding upwards. */
+{
+   mpfr_t t;
+
+   mpfr_init2 (t, BOUND_PREC);
+   abs_bound (t, z);
+   mpfr_mul (t, t, c, MPFR_RNDU);
+   mpfr_add (e, e, t, MPFR_RNDU);
+   mpfr_clear (t);
+}
+
+
+static void
+zeta_sum (mpc_ptr S, mpc_ptr D, mpfr_ptr E, mpc_srcptr s, mpc_srcptr a,
+   zeta_table_t *tab, unsigned long int N, unsigned long int M)
+   /* Evaluate the Euler-Maclaurin formula with parameters N and M at the
+      precision prec of S. Let Z be the exact sum of the computed terms;
+      set S to Z rounded to nearest and E to an upper bound on
+      |Z - zeta (s, a)|, or to +Inf if prec is too small for the error
+      analysis to hold. If tab is not NULL, then a = 1, the table has been
+      built for sigma at precision prec and covers N+1, and D is set to
+      Z - 1 rounded to nearest, S to 1 + D with its real part rounded to
+      nearest.
+      Let u = 2^(-prec). Every operation rounds to nearest, so that the
+      relative error of its result is at most sqrt (2) u. For a prime k,
+      the error of log (k) is at most u log (k), so that the error of the
+      argument tau log (k) of the power is at most 2 |tau| log (k) u, and
+      similarly for sigma log (k); then the relative error of the computed
+      k^(-s) is at most (3.2 |s| log (k) + 5) u, and for composite k it
+      is bounded by Omega (k) (3.2 |s| log (k) + 7) u, where Omega (k) is
+      the number of prime factors of k with multiplicities. For general
+      a, the relative error of (a+k)^(-s) = exp (-s log (a+k)) is at most
+      (|s| (1.9 + 3.3 |log (a+k)|) + 1.5) u. If E1 is the maximum of these
+      errors for the power (a+N)^(-s), then the relative errors of the
+      integral term and of V_1 are at most E1 + 7u and E1 + 5u; each step
+      V_j -> V_{j+1} adds at most 14u, and the multiplication by the
+      rounded Bernoulli coefficient 2u. The computed errors are only
+      valid as long as the relative errors are small, which is checked at
+      the end; the factor 2 in the final bound covers the difference
+      between the computed terms and the exact ones. */
+{
+   mpfr_prec_t prec = MPC_PREC_RE (S);
+   unsigned long int n = N + M + 2, k, j, l;
+   mpc_t *t, x, v, w;
+   mpc_ptr *p;
+   mpfr_t abs_s, err, eps, eps1, emax, r;
+
+   t = (mpc_t *) malloc (n * sizeof (mpc_t));
+   p = (mpc_ptr *) malloc (n * sizeof (mpc_ptr));
+   MPC_ASSERT (t != NULL && p != NULL);
+   for (k = 0; k < n; k++) {
+      mpc_init2 (t [k], prec);
+      p [k] = t [k];
+   }
+   mpc_init2 (x, prec);
+   mpc_init2 (v, prec);
+   mpc_init2 (w, prec);
+   mpfr_init2 (abs_s, BOUND_PREC);
+   mpfr_init2 (err, BOUND_PREC);
+   mpfr_init2 (eps, BOUND_PREC);
+   mpfr_init2 (eps1, BOUND_PREC);
+   mpfr_init2 (emax, BOUND_PREC);
+   mpfr_init2 (r, BOUND_PREC);
+
+   abs_bound (abs_s, s);
+   mpfr_set_ui (err, 0, MPFR_RNDN);
+   if (tab != NULL) {
+      /* The powers of the terms with the same number of prime factors
+         have the same error bound, 4 |s| ceil (log2 (N+2)) + 8 being an
+         upper bound on 3.2 |s| log (k) + 7. */
+      mpfr_mul_ui (eps1, abs_s, 4 * mpc_ceil_log2 (N + 2), MPFR_RNDU);
+      mpfr_add_ui (eps1, eps1, 8, MPFR_RNDU);
+      mpc_set_ui (t [0], 1, MPC_RNDNN);
+      for (k = 1; k <= N; k++) {
+         l = tab->spf [k + 1];
+         if (l == k + 1) {
+            mpfr_mul (mpc_realref (w), mpc_imagref (s), tab->lg [l],
+                      MPFR_RNDN);
+            mpfr_sin_cos (mpc_imagref (x), mpc_realref (x), mpc_realref (w),
+                          MPFR_RNDN);
+            mpfr_mul (mpc_realref (t [k]), mpc_realref (x), tab->pw [l],
+                      MPFR_RNDN);
+            mpfr_mul (mpc_imagref (t [k]), mpc_imagref (x), tab->pw [l],
+                      MPFR_RNDN);
+            mpfr_neg (mpc_imagref (t [k]), mpc_imagref (t [k]), MPFR_RNDN);
+         }
+         else
+            mpc_mul (t [k], t [l - 1], t [(k + 1) / l - 1], MPC_RNDNN);
+         if (k < N) {
+            mpfr_mul_ui (eps, eps1, tab->omega [k + 1], MPFR_RNDU);
+            add_error (err, t [k], eps);
+         }
+      }
+      mpfr_mul_ui (emax, eps1, mpc_ceil_log2 (N + 2), MPFR_RNDU);
+      mpfr_mul_ui (eps1, eps1, tab->omega [N + 1], MPFR_RNDU);
+      mpc_set_ui (x, N + 1, MPC_RNDNN);
+   }
+   else {
+      mpfr_set_ui (emax, 0, MPFR_RNDN);
+      for (k = 0; k <= N; k++) {
+         mpc_add_ui (x, a, k, MPC_RNDNN);
+         mpc_log (w, x, MPC_RNDNN);
+         abs_bound (eps, w);
+         mpc_mul (w, w, s, MPC_RNDNN);
+         mpc_neg (w, w, MPC_RNDNN);
+         mpc_exp (t [k], w, MPC_RNDNN);
+         /* 4 |s| (|log (a+k)| + 1) + 2 */
+         mpfr_add_ui (eps, eps, 1, MPFR_RNDU);
+         mpfr_mul (eps, eps, abs_s, MPFR_RNDU);
+         mpfr_mul_2ui (eps, eps, 2, MPFR_RNDU);
+         mpfr_add_ui (eps, eps, 2, MPFR_RNDU);
+         if (k < N)
+            add_error (err, t [k], eps);
+         mpfr_max (emax, emax, eps, MPFR_RNDU);
+      }
+      mpfr_set (eps1, eps, MPFR_RNDU);
+      mpc_add_ui (x, a, N, MPC_RNDNN);
+   }
+
+   /* the integral term (a+N)^(1-s) / (s-1) */
+   mpc_mul (w, t [N], x, MPC_RNDNN);
+   mpc_sub_ui (v, s, 1, MPC_RNDNN);
+   mpc_div (t [N + 1], w, v, MPC_RNDNN);
+   mpfr_add_ui (eps, eps1, 7, MPFR_RNDU);
+   add_error (err, t [N + 1], eps);
+   /* the Bernoulli terms, with x = 1 / (a+N)^2 */
+   mpc_mul (v, t [N], s, MPC_RNDNN);
+   mpc_div (v, v, x, MPC_RNDNN);
+   mpc_sqr (x, x, MPC_RNDNN);
+   mpc_ui_div (x, 1, x, MPC_RNDNN);
+   mpfr_add_ui (eps, eps1, 7, MPFR_RNDU);
+   for (j = 1; j <= M; j++) {
+      mpc_mul_fr (t [N + 1 + j], v, zeta_coefficient (j, prec), MPC_RNDNN);
+      add_error (err, t [N + 1 + j], eps);
+      if (j < M) {
+         mpc_add_ui (w, s, 2 * j - 1, MPC_RNDNN);
+         mpc_mul (v, v, w, MPC_RNDNN);
+         mpc_add_ui (w, s, 2 * j, MPC_RNDNN);
+         mpc_mul (v, v, w, MPC_RNDNN);
+         mpc_mul (v, v, x, MPC_RNDNN);
+         mpfr_add_ui (eps, eps, 14, MPFR_RNDU);
+      }
+   }
+   mpfr_max (emax, emax, eps, MPFR_RNDU);
+   /* the term (a+N)^(-s) / 2 */
+   mpc_div_2ui (t [N], t [N], 1, MPC_RNDNN);
+   add_error (err, t [N], eps1);
+
+   if (tab != NULL) {
+      mpc_sum (D, p + 1, n - 1, MPC_RNDNN);
+      mpfr_add_ui (mpc_realref (S), mpc_realref (D), 1, MPFR_RNDN);
+      mpfr_set (mpc_imagref (S), mpc_imagref (D), MPFR_RNDN);
+   }
+   else
+      mpc_sum (S, p, n, MPC_RNDNN);
+
+   /* The relative errors must be at most 2^-10. */
+   if (mpfr_cmp_ui_2exp (emax, 1, prec - 10) > 0)
+      mpfr_set_inf (E, 1);
+   else {
+      mpfr_mul_2si (E, err, 1 - prec, MPFR_RNDU);
+      zeta_remainder (r, s, a, N, M);
+      mpfr_add (E, E, r, MPFR_RNDU);
+   }
+
+   for (k = 0; k < n; k++)
+      mpc_clear (t [k]);
+   free (t);
+   free (p);
+   mpc_clear (x);
+   mpc_clear (v);
+   mpc_clear (w);
+   mpfr_clear (abs_s);
+   mpfr_clear (err);
+   mpfr_clear (eps);
+   mpfr_clear (eps1);
+   mpfr_clear (emax);
+   mpfr_clear (r);
+}
+
+
+static int
+can_round_part (mpfr_srcptr x, mpfr_srcptr err, mpfr_prec_t prec,
+   mpfr_rnd_t rnd)
+   /* Return 1 if a number at distance at most err from x can be correctly
+      rounded to precision prec in the direction rnd from x. */
+{
+   mpfr_exp_t e;
+
+   if (mpfr_zero_p (x) || !mpfr_number_p (err))
+      return 0;
+   else if (mpfr_zero_p (err))
+      return 1;
+   e = mpfr_get_exp (x) - mpfr_get_exp (err);
+   return e > 1 && mpfr_can_round (x, e, MPFR_RNDN, MPFR_RNDZ,
+                                   prec + (rnd == MPFR_RNDN));
+}
+
+
+static void
+add_half_ulp (mpfr_ptr e, mpfr_srcptr x)
+   /* Add half an ulp of x to e, rounding upwards. */
+{
+   if (mpfr_regular_p (x)) {
+      mpfr_t h;
+
+      mpfr_init2 (h, 2);
+      mpfr_set_ui_2exp (h, 1, mpfr_get_exp (x) - mpfr_get_prec (x) - 1,
+                        MPFR_RNDN);
+      mpfr_add (e, e, h, MPFR_RNDU);
+      mpfr_clear (h);
+   }
+}
+
+
+static int
+zeta_round (mpc_ptr rop, int *inex, mpc_srcptr S, mpc_srcptr D,
+   mpfr_srcptr E, int one, int real, mpc_rnd_t rnd)
+   /* Given S, D and E as computed by zeta_sum, where one is non-zero if
+      a = 1, try to round zeta (s, a) to rop, where the imaginary part of
+      the result is +0 if real is non-zero. If successful, set *inex to the
+      inexact value and return 1, otherwise return 0.
+      For a = 1, the real part may be 1 plus a number too small to be
+      seen at the target precision, in which case it is rounded from the
+      sign of the real part of D. */
+{
+   mpfr_t err, tiny;
+   int ok, small, inex_re, inex_im;
+
+   mpfr_init2 (err, BOUND_PREC);
+   mpfr_init2 (tiny, BOUND_PREC);
+
+   ok = 1;
+   small = 0;
+   if (!real) {
+      mpfr_set (err, E, MPFR_RNDU);
+      if (one)
+         add_half_ulp (err, mpc_imagref (D));
+      add_half_ulp (err, mpc_imagref (S));
+      ok = can_round_part (mpc_imagref (S), err, MPC_PREC_IM (rop),
+                           MPC_RND_IM (rnd));
+   }
+   if (ok) {
+      mpfr_set (err, E, MPFR_RNDU);
+      if (one) {
+         add_half_ulp (err, mpc_realref (D));
+         mpfr_abs (tiny, mpc_realref (D), MPFR_RNDU);
+         mpfr_add (tiny, tiny, err, MPFR_RNDU);
+         small = (mpfr_cmp_ui_2exp (tiny, 1, - MPC_PREC_RE (rop) - 2) < 0);
+      }
+      if (small)
+         /* 1 + D with |D| < 2^(-prec-2), only its sign matters */
+         ok = (mpfr_cmpabs (mpc_realref (D), err) > 0);
+      else {
+         add_half_ulp (err, mpc_realref (S));
+         ok = can_round_part (mpc_realref (S), err, MPC_PREC_RE (rop),
+                              MPC_RND_RE (rnd));
+      }
+   }
+
+   if (ok) {
+      if (small)
+         inex_re = mpc_set_si_tiny (mpc_realref (rop), 1,
+                                    mpfr_sgn (mpc_realref (D)),
+                                    MPC_RND_RE (rnd));
+      else
+         inex_re = mpfr_set (mpc_realref (rop), mpc_realref (S),
+                             MPC_RND_RE (rnd));
+      if (real) {
+         mpfr_set_zero (mpc_imagref (rop), 1);
+         inex_im = 0;
+      }
+      else
+         inex_im = mpfr_set (mpc_imagref (rop), mpc_imagref (S),
+                             MPC_RND_IM (rnd));
+      *inex = MPC_INEX (inex_re, inex_im);
+   }
+
+   mpfr_clear (err);
+   mpfr_clear (tiny);
+
+   return ok;
+}
+
+
+static mpfr_exp_t
+zeta_magnitude (mpc_srcptr S, mpc_srcptr D, mpfr_exp_t mag,
+   mpfr_prec_t prec, int one, int real)
+   /* Return the exponent of the smallest part of the result that has to
+      be rounded, as seen from S and D, or mag - prec if it vanishes. */
+{
+   mpfr_srcptr x;
+   mpfr_exp_t e, m;
+
+   m = mpfr_get_emax ();
+   x = (one ? mpc_realref (D) : mpc_realref (S));
+   e = (mpfr_zero_p (x) ? mag - prec : mpfr_get_exp (x));
+   m = MPC_MIN (m, e);
+   if (!real) {
+      x = mpc_imagref (S);
+      e = (mpfr_zero_p (x) ? mag - prec : mpfr_get_exp (x));
+      m = MPC_MIN (m, e);
+   }
+
+   return m;
+}
+
+
+static int
+zeta_aux (mpc_ptr rop, mpc_srcptr s, mpc_srcptr a, mpc_rnd_t rnd)
+   /* Hurwitz zeta function for finite s which is not an integer <= 1 and
+      finite a which is not an integer <= 0. */
+{
+   mpc_t S, D;
+   mpfr_t E;
+   zeta_table_t tab;
+   mpfr_prec_t prec;
+   mpfr_exp_t mag, e;
+   unsigned long int N, M;
+   int one, real, inex, inex_re, inex_im;
+   int saved_underflow, saved_overflow;
+   mpfr_exp_t saved_emin, saved_emax;
+
+   one = (mpfr_cmp_ui (mpc_realref (a), 1) == 0
+          && mpfr_zero_p (mpc_imagref (a)));
+   real = (mpfr_zero_p (mpc_imagref (s)) && mpfr_zero_p (mpc_imagref (a))
+           && mpfr_sgn (mpc_realref (a)) > 0);
+
+   saved_emin = mpfr_get_emin ();
+   saved_emax = mpfr_get_emax ();
+   mpfr_set_emin (mpfr_get_emin_min ());
+   mpfr_set_emax (mpfr_get_emax_max ());
+   saved_underflow = mpfr_underflow_p ();
+   saved_overflow = mpfr_overflow_p ();
+
+   /* Initial working precision: the relative errors of the powers are of
+      the order of |s| log (N)^2 u. The exponent mag of the result is
+      first assumed to be 0, and then taken from the previous
+      approximation. */
+   prec = MPC_MAX_PREC (rop);
+   prec += mpc_ceil_log2 (prec) + 20;
+   e = (mpfr_zero_p (mpc_realref (s)) ? 0 : mpfr_get_exp (mpc_realref (s)));
+   if (!mpfr_zero_p (mpc_imagref (s)))
+      e = MPC_MAX (e, mpfr_get_exp (mpc_imagref (s)));
+   prec += MPC_MAX (e, 0);
+   mag = 0;
+
+   mpc_init2 (S, prec);
+   mpc_init2 (D, prec);
+   mpfr_init2 (E, BOUND_PREC);
+   while (1) {
+      if (!zeta_parameters (&N, &M, s, a, mag - prec, one)) {
+         /* out of reach; Riemann-Siegel type formulae would be needed */
+         mpc_set_nan (rop);
+         mpfr_set_erangeflag ();
+         inex = MPC_INEX (0, 0);
+         break;
+      }
+      if (one)
+         table_init (&tab, N + 2, mpc_realref (s), prec);
+      zeta_sum (S, D, E, s, a, one ? &tab : NULL, N, M);
+      if (one)
+         table_clear (&tab);
+      if (zeta_round (rop, &inex, S, D, E, one, real, rnd))
+         break;
+      mag = zeta_magnitude (S, D, mag, prec, one, real);
+      prec += prec / 2;
+      mpc_set_prec (S, prec);
+      mpc_set_prec (D, prec);
+   }
+   mpc_clear (S);
+   mpc_clear (D);
+   mpfr_clear (E);
+
+   /* Flags raised by intermediate computations are not meaningful. */
+   mpfr_clear_overflow ();
+   mpfr_clear_underflow ();
+   /* restore underflow and overflow flags from MPFR */
+   if (saved_underflow)
+      mpfr_set_underflow ();
+   if (saved_overflow)
+      mpfr_set_overflow ();
+
+   /* restore the exponent range, and check the range of results */
+   mpfr_set_emin (saved_emin);
+   mpfr_set_emax (saved_emax);
+   inex_re = mpfr_check_range (mpc_realref (rop), MPC_INEX_RE (inex),
+                               MPC_RND_RE (rnd));
+   inex_im = mpfr_check_range (mpc_imagref (rop), MPC_INEX_IM (inex),
+                               MPC_RND_IM (rnd));
+
+   return MPC_INEX (inex_re, inex_im);
+}
+
+
+static int
+zeta_bernoulli (mpc_ptr rop, mpc_srcptr s, mpc_srcptr a, mpc_rnd_t rnd)
+   /* Hurwitz zeta function for s = -n with n a non-negative integer:
+      zeta (-n, a) = - B_{n+1} (a) / (n+1) with the Bernoulli polynomial
+      B_m (a) = sum_{k=0}^m binomial (m, k) B_k a^(m-k), which is computed
+      exactly from a = (x + i y) 2^e with integers x and y. */
+{
+   mpz_t x, y, u, v, w, c;
+   mpq_t re, im, b, q;
+   mpfr_exp_t ex, ey, e;
+   unsigned long int m, j, k;
+   int inex_re, inex_im;
+
+   MPC_ASSERT (mpfr_fits_slong_p (mpc_realref (s), MPFR_RNDN));
+   m = (unsigned long int) (- mpfr_get_si (mpc_realref (s), MPFR_RNDN)) + 1;
+
+   mpz_init (x);
+   mpz_init (y);
+   mpz_init_set_ui (u, 1);
+   mpz_init_set_ui (v, 0);
+   mpz_init (w);
+   mpz_init (c);
+   mpq_init (re);
+   mpq_init (im);
+   mpq_init (b);
+   mpq_init (q);
+
+   ex = (mpfr_zero_p (mpc_realref (a)) ? mpfr_get_emax ()
+         : mpfr_get_z_2exp (x, mpc_realref (a)));
+   ey = (mpfr_zero_p (mpc_imagref (a)) ? mpfr_get_emax ()
+         : mpfr_get_z_2exp (y, mpc_imagref (a)));
+   e = MPC_MIN (ex, ey);
+   if (mpfr_zero_p (mpc_realref (a)))
+      mpz_set_ui (x, 0);
+   else
+      mpz_mul_2exp (x, x, (mp_bitcnt_t) (ex - e));
+   if (mpfr_zero_p (mpc_imagref (a)))
+      mpz_set_ui (y, 0);
+   else
+      mpz_mul_2exp (y, y, (mp_bitcnt_t) (ey - e));
+
+   /* u + i v = (x + i y)^j */
+   for (j = 0; j <= m; j++) {
+      k = m - j;
+      if (k == 0)
+         mpq_set_ui (b, 1, 1);
+      else if (k == 1)
+         mpq_set_si (b, -1, 2);
+      else if (k % 2 == 0)
+         mpq_set (b, mpc_bernoulli_b2k (k / 2));
+      else
+         mpq_set_ui (b, 0, 1);
+      if (mpq_sgn (b) != 0) {
+         mpz_bin_uiui (c, m, k);
+         mpz_mul (mpq_numref (b), mpq_numref (b), c);
+         mpq_canonicalize (b);
+         mpq_set_z (q, u);
+         if (e >= 0)
+            mpq_mul_2exp (q, q, (mp_bitcnt_t) e * j);
+         else
+            mpq_div_2exp (q, q, (mp_bitcnt_t) (-e) * j);
+         mpq_mul (q, q, b);
+         mpq_add (re, re, q);
+         mpq_set_z (q, v);
+         if (e >= 0)
+            mpq_mul_2exp (q, q, (mp_bitcnt_t) e * j);
+         else
+            mpq_div_2exp (q, q, (mp_bitcnt_t) (-e) * j);
+         mpq_mul (q, q, b);
+         mpq_add (im, im, q);
+      }
+      if (j < m) {
+         mpz_mul (w, u, y);
+         mpz_mul (u, u, x);
+         mpz_submul (u, v, y);
+         mpz_mul (v, v, x);
+         mpz_add (v, v, w);
+      }
+   }
+   mpz_set_ui (c, m);
+   mpq_set_z (q, c);
+   mpq_neg (q, q);
+   mpq_div (re, re, q);
+   mpq_div (im, im, q);
+   inex_re = mpfr_set_q (mpc_realref (rop), re, MPC_RND_RE (rnd));
+   inex_im = mpfr_set_q (mpc_imagref (rop), im, MPC_RND_IM (rnd));
+
+   mpz_clear (x);
+   mpz_clear (y);
+   mpz_clear (u);
+   mpz_clear (v);
+   mpz_clear (w);
+   mpz_clear (c);
+   mpq_clear (re);
+   mpq_clear (im);
+   mpq_clear (b);
+   mpq_clear (q);
+
+   return MPC_INEX (inex_re, inex_im);
+}
+
+
+int
+mpc_hurwitz_zeta (mpc_ptr rop, mpc_srcptr s, mpc_srcptr a, mpc_rnd_t rnd)
+{
+   MPC_STATS_FUNC (hurwitz_zeta, MPC_MAX_PREC (rop))
+   if (!mpc_fin_p (s) || !mpc_fin_p (a)) {
+      mpc_set_nan (rop);
+      return MPC_INEX (0, 0);
+   }
+   else if (mpfr_zero_p (mpc_imagref (s))
+            && mpfr_integer_p (mpc_realref (s))) {
+      if (mpfr_sgn (mpc_realref (s)) <= 0)
+         return zeta_bernoulli (rop, s, a, rnd);
+      else if (mpfr_cmp_ui (mpc_realref (s), 1) == 0) {
+         /* the pole */
+         mpfr_set_inf (mpc_realref (rop), 1);
+         mpfr_set_zero (mpc_imagref (rop), 1);
+         return MPC_INEX (0, 0);
+      }
+   }
+   if (mpfr_zero_p (mpc_imagref (a)) && mpfr_integer_p (mpc_realref (a))
+       && mpfr_sgn (mpc_realref (a)) <= 0) {
+      mpc_set_nan (rop);
+      return MPC_INEX (0, 0);
+   }
+
+   return zeta_aux (rop, s, a, rnd);
+}
+
+
+int
+mpc_zeta (mpc_ptr rop, mpc_srcptr s, mpc_rnd_t rnd)
+{
+   MPC_STATS_FUNC (zeta, MPC_MAX_PREC (rop))
+   mpc_t one;
+   int inex;
+
+   if (mpfr_zero_p (mpc_imagref (s))) {
+      inex = mpfr_zeta (mpc_realref (rop), mpc_realref (s), MPC_RND_RE (rnd));
+      mpfr_set_zero (mpc_imagref (rop), 1);
+      return MPC_INEX (inex, 0);
+   }
+   else if (!mpc_fin_p (s)) {
+      /* zeta (s) tends to 1 when Re (s) tends to +Inf */
+      if (mpfr_inf_p (mpc_realref (s)) && mpfr_sgn (mpc_realref (s)) > 0
+          && mpfr_number_p (mpc_imagref (s))) {
+         mpfr_set_ui (mpc_realref (rop), 1, MPFR_RNDN);
+         mpfr_set_zero (mpc_imagref (rop), 1);
+      }
+      else
+         mpc_set_nan (rop);
+      return MPC_INEX (0, 0);
+   }
+
+   mpc_init2 (one, 2);
+   mpc_set_ui (one, 1, MPC_RNDNN);
+   inex = zeta_aux (rop, s, one, rnd);
+   mpc_clear (one);
+
+   return inex;
+}
+
+
+void
+mpc_zeta_vertical (mpc_ptr *rop, int *inex, mpfr_srcptr sigma,
+   const mpfr_ptr *t, unsigned long int n, mpc_rnd_t rnd)
+   /* Set rop [j] to zeta (sigma + i t [j]) for 0 <= j < n, and inex [j] to
+      the corresponding inexact value unless inex is NULL. All values are
+      first computed with a common working precision and a common table of
+      powers; those which cannot be rounded are then recomputed one by one
+      with mpc_zeta. */
+{
+   mpc_t s, one, S, D;
+   mpfr_t E;
+   zeta_table_t tab;
+   mpfr_prec_t prec;
+   mpfr_exp_t e;
+   unsigned long int j, nmax, *N, *M;
+   int *done, *in;
+   int saved_underflow, saved_overflow;
+   mpfr_exp_t saved_emin, saved_emax;
+
+   if (n == 0)
+      return;
+
+   N = (unsigned long int *) malloc (n * sizeof (unsigned long int));
+   M = (unsigned long int *) malloc (n * sizeof (unsigned long int));
+   done = (int *) calloc (n, sizeof (int));
+   in = (int *) malloc (n * sizeof (int));
+   MPC_ASSERT (N != NULL && M != NULL && done != NULL && in != NULL);
+
+   /* Only non-zero finite t [j] use the common path. */
+   prec = 0;
+   e = (mpfr_regular_p (sigma) ? mpfr_get_exp (sigma) : 0);
+   for (j = 0; j < n; j++)
+      if (mpfr_regular_p (t [j])) {
+         prec = MPC_MAX (prec, MPC_MAX_PREC (rop [j]));
+         e = MPC_MAX (e, mpfr_get_exp (t [j]));
+      }
+   mpc_init3 (s, mpfr_get_prec (sigma), MPFR_PREC_MIN);
+   mpfr_set (mpc_realref (s), sigma, MPFR_RNDN);
+
+   if (prec > 0 && mpfr_number_p (sigma)) {
+      saved_emin = mpfr_get_emin ();
+      saved_emax = mpfr_get_emax ();
+      mpfr_set_emin (mpfr_get_emin_min ());
+      mpfr_set_emax (mpfr_get_emax_max ());
+      saved_underflow = mpfr_underflow_p ();
+      saved_overflow = mpfr_overflow_p ();
+
+      /* the same working precision as in zeta_aux */
+      prec += mpc_ceil_log2 (prec) + 20 + MPC_MAX (e, 0);
+      mpc_init2 (one, 2);
+      mpc_set_ui (one, 1, MPC_RNDNN);
+      nmax = 0;
+      for (j = 0; j < n; j++)
+         if (mpfr_regular_p (t [j])) {
+            mpfr_set_prec (mpc_imagref (s), mpfr_get_prec (t [j]));
+            mpfr_set (mpc_imagref (s), t [j], MPFR_RNDN);
+            if (zeta_parameters (N + j, M + j, s, one, -prec, 1))
+               nmax = MPC_MAX (nmax, N [j]);
+            else
+               N [j] = 0; /* left to mpc_zeta */
+         }
+
+      mpc_init2 (S, prec);
+      mpc_init2 (D, prec);
+      mpfr_init2 (E, BOUND_PREC);
+      table_init (&tab, nmax + 2, sigma, prec);
+      for (j = 0; j < n; j++)
+         if (mpfr_regular_p (t [j]) && N [j] != 0) {
+            mpfr_set_prec (mpc_imagref (s), mpfr_get_prec (t [j]));
+            mpfr_set (mpc_imagref (s), t [j], MPFR_RNDN);
+            zeta_sum (S, D, E, s, one, &tab, N [j], M [j]);
+            done [j] = zeta_round (rop [j], in + j, S, D, E, 1, 0, rnd);
+         }
+      table_clear (&tab);
+      mpc_clear (S);
+      mpc_clear (D);
+      mpfr_clear (E);
+      mpc_clear (one);
+
+      mpfr_clear_overflow ();
+      mpfr_clear_underflow ();
+      if (saved_underflow)
+         mpfr_set_underflow ();
+      if (saved_overflow)
+         mpfr_set_overflow ();
+      mpfr_set_emin (saved_emin);
+      mpfr_set_emax (saved_emax);
+      for (j = 0; j < n; j++)
+         if (done [j])
+            in [j] = MPC_INEX (
+               mpfr_check_range (mpc_realref (rop [j]), MPC_INEX_RE (in [j]),
+                                 MPC_RND_RE (rnd)),
+               mpfr_check_range (mpc_imagref (rop [j]), MPC_INEX_IM (in [j]),
+                                 MPC_RND_IM (rnd)));
+   }
+
+   for (j = 0; j < n; j++) {
+      if (!done [j]) {
+         mpfr_set_prec (mpc_imagref (s), mpfr_get_prec (t [j]));
+         mpfr_set (mpc_imagref (s), t [j], MPFR_RNDN);
+         in [j] = mpc_zeta (rop [j], s, rnd);
+      }
+      if (inex != NULL)
+         inex [j] = in [j];
+   }
+
+   mpc_clear (s);
+   free (N);
+   free (M);
+   free (done);
+   free (in);
+}
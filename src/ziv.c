@@ -0,0 +1,308 @@
+/* mpcb_ziv -- Ziv loop around an evaluation in ball arithmetic;
+   mpc_ziv_start, mpc_ziv_end -- adaptive precision of Ziv loops.
+
+Copyright (C) 2025 INRIA
+
+This file is part of GNU MPC.
+
+GNU MPC is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the
+Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+GNU MPC is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for
+more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program. If not, see http://www.gnu.org/licenses/ .
+*/
+
+#include <string.h>
+#include "mpc-impl.h"
+
+static int
+can_round_real (mpcb_srcptr op, mpfr_prec_t prec, mpfr_rnd_t rnd)
+   /* Return true if the centre of op has an imaginary part 0 and its
+      real part can be rounded to precision prec in direction rnd with a
+      known rounding direction value, assuming that all the elements of
+      the ball relevant to the caller are real. Since the absolute error
+      of the real part is bounded by |x| * r, this works as in
+      mpcb_can_round. */
+{
+   mpfr_srcptr re = mpc_realref (op->c);
+
+   if (!mpfr_zero_p (mpc_imagref (op->c)) || mpcr_inf_p (op->r))
+      return 0;
+   else if (mpcr_zero_p (op->r))
+      return 1;
+   else if (mpfr_zero_p (re))
+      return 0;
+   else
+      return mpfr_can_round (re, - mpcr_get_exp (op->r), MPFR_RNDN,
+         MPFR_RNDZ, prec + (rnd == MPFR_RNDN));
+}
+
+
+int
+mpcb_ziv (mpc_ptr rop, mpcb_eval_t f, const void *data, mpc_srcptr op,
+   int real, mpc_rnd_t rnd)
+   /* Set rop to the correctly rounded value of a function and return the
+      corresponding rounding direction value, where f (b, prec, data)
+      sets the ball b to an enclosure of the function value computed at
+      working precision prec and returns 0, or returns a non-zero value
+      if the function is not defined at its argument, in which case rop
+      is set to NaN.
+      op, if not NULL, is the main argument of the function; the initial
+      working precision is increased by the largest exponent of its
+      parts, which accounts for the absolute errors of exponential-type
+      functions.
+      If real is non-zero, the function value is known to be real, and
+      the imaginary part of rop is set to +0; otherwise no part of the
+      function value may be exactly representable, unless the ball
+      computed by f has radius 0, or the loop does not terminate.
+      After a failure, the precision is increased to the target precision
+      plus the number of bits lost in the previous evaluation, as read
+      off the radius, plus a margin; but at least by half, so that hard
+      to round cases need only a logarithmic number of steps. An infinite
+      radius carries no such information, and the precision is doubled.
+      The evaluations take place in the extended exponent range, and the
+      result is then brought back into the current one, so that a value
+      is found whenever it is representable there, and overflows and
+      underflows are handled as for the elementary functions. If the
+      radius is infinite and f has raised the MPFR overflow or underflow
+      flag even in the extended range, the function value is taken to
+      overflow or underflow, and rop is set accordingly, with the signs
+      of the parts of the centre. If the radius is still infinite
+      after MPCB_ZIV_INF_MAX doublings in a row, or if the precision
+      exceeds MPFR_PREC_MAX / 4, the loop gives up and sets rop to NaN
+      and the erange flag. */
+{
+   const mpfr_prec_t prec_re = mpfr_get_prec (mpc_realref (rop));
+   const mpfr_prec_t prec_im = mpfr_get_prec (mpc_imagref (rop));
+   const mpfr_prec_t target = MPC_MAX (prec_re, prec_im);
+   mpfr_prec_t prec, lost;
+   mpfr_exp_t e;
+   mpcb_t b;
+   int ok, nan, inex, inex_re, inex_im, inf, overflow, underflow;
+   int saved_underflow, saved_overflow;
+   mpfr_exp_t saved_emin, saved_emax;
+
+   prec = target + mpc_ceil_log2 (target) + MPCB_ZIV_GUARD;
+   if (op != NULL) {
+      e = 0;
+      if (mpfr_regular_p (mpc_realref (op)))
+         e = MPC_MAX (e, mpfr_get_exp (mpc_realref (op)));
+      if (mpfr_regular_p (mpc_imagref (op)))
+         e = MPC_MAX (e, mpfr_get_exp (mpc_imagref (op)));
+      prec += e;
+   }
+
+   saved_emin = mpfr_get_emin ();
+   saved_emax = mpfr_get_emax ();
+   mpfr_set_emin (mpfr_get_emin_min ());
+   mpfr_set_emax (mpfr_get_emax_max ());
+   saved_underflow = mpfr_underflow_p ();
+   saved_overflow = mpfr_overflow_p ();
+   mpcb_init (b);
+   ok = 0;
+   nan = 0;
+   inf = 0;
+   overflow = 0;
+   underflow = 0;
+   while (1) {
+      mpfr_clear_overflow ();
+      mpfr_clear_underflow ();
+      nan = f (b, prec, data);
+      if (nan)
+         break;
+      if (real)
+         ok = can_round_real (b, prec_re, MPC_RND_RE (rnd));
+      else
+         ok = mpcb_can_round (b, prec_re, prec_im, rnd);
+      if (ok)
+         break;
+      if (mpcr_inf_p (b->r)) {
+         overflow = mpfr_overflow_p ();
+         underflow = mpfr_underflow_p ();
+         if (overflow || underflow || ++inf > MPCB_ZIV_INF_MAX)
+            break;
+      }
+      else
+         inf = 0;
+      if (prec > MPFR_PREC_MAX / 4)
+         break;
+      if (inf)
+         prec += prec;
+      else {
+         lost = prec + (mpfr_prec_t) mpcr_get_exp (b->r);
+         lost = MPC_MIN (MPC_MAX (lost, 0), MPFR_PREC_MAX / 4);
+         prec = MPC_MAX (target + lost + MPCB_ZIV_GUARD + mpc_ceil_log2 (prec),
+                         prec + prec / 2);
+         prec = MPC_MIN (prec, MPFR_PREC_MAX);
+      }
+   }
+
+   if (overflow || underflow) {
+      if (overflow) {
+         mpfr_set_inf (mpc_realref (rop),
+                       mpfr_signbit (mpc_realref (b->c)) ? -1 : 1);
+         inex_re = mpc_fix_inf (mpc_realref (rop), MPC_RND_RE (rnd));
+      }
+      else {
+         mpfr_set_zero (mpc_realref (rop),
+                        mpfr_signbit (mpc_realref (b->c)) ? -1 : 1);
+         inex_re = mpc_fix_zero (mpc_realref (rop), MPC_RND_RE (rnd));
+      }
+      if (real) {
+         mpfr_set_ui (mpc_imagref (rop), 0, MPFR_RNDN);
+         inex_im = 0;
+      }
+      else if (overflow) {
+         mpfr_set_inf (mpc_imagref (rop),
+                       mpfr_signbit (mpc_imagref (b->c)) ? -1 : 1);
+         inex_im = mpc_fix_inf (mpc_imagref (rop), MPC_RND_IM (rnd));
+      }
+      else {
+         mpfr_set_zero (mpc_imagref (rop),
+                        mpfr_signbit (mpc_imagref (b->c)) ? -1 : 1);
+         inex_im = mpc_fix_zero (mpc_imagref (rop), MPC_RND_IM (rnd));
+      }
+   }
+   else if (nan || !ok) {
+      mpc_set_nan (rop);
+      inex_re = 0;
+      inex_im = 0;
+   }
+   else if (real) {
+      inex_re = mpfr_set (mpc_realref (rop), mpc_realref (b->c),
+                          MPC_RND_RE (rnd));
+      inex_im = mpfr_set_ui (mpc_imagref (rop), 0, MPFR_RNDN);
+   }
+   else {
+      inex = mpcb_round (rop, b, rnd);
+      inex_re = MPC_INEX_RE (inex);
+      inex_im = MPC_INEX_IM (inex);
+   }
+   mpcb_clear (b);
+
+   /* restore underflow and overflow flags from MPFR */
+   mpfr_clear_overflow ();
+   mpfr_clear_underflow ();
+   if (saved_underflow || underflow)
+      mpfr_set_underflow ();
+   if (saved_overflow || overflow)
+      mpfr_set_overflow ();
+   if (!nan && !ok && !overflow && !underflow)
+      mpfr_set_erangeflag ();
+
+   /* restore the exponent range, and check the range of results */
+   mpfr_set_emin (saved_emin);
+   mpfr_set_emax (saved_emax);
+   inex_re = mpfr_check_range (mpc_realref (rop), inex_re, MPC_RND_RE (rnd));
+   inex_im = mpfr_check_range (mpc_imagref (rop), inex_im, MPC_RND_IM (rnd));
+
+   return MPC_INEX (inex_re, inex_im);
+}
+
+
+/* In adaptive mode, the number of extra bits over the target precision
+   that has sufficed for the last calls is remembered for each Ziv loop
+   and each range ]2^(k-1), 2^k] of target precisions, and the first
+   iteration starts with at least this precision. When the first
+   iteration has succeeded ZIV_DECAY times in a row, the number is
+   decreased by a quarter, so that it follows the needs of the workload
+   downwards as well; hard to round cases needing more than ZIV_LEARN
+   iterations are not learnt. The mode and the tables are local to each
+   thread if the compiler supports it, so that they need no locking; the
+   additional threads of mpc_batch_run take the mode of the calling
+   thread. */
+#define ZIV_BUCKETS 32
+#define ZIV_DECAY 64
+#define ZIV_LEARN 3
+
+typedef struct {
+   mpfr_prec_t guard;
+   unsigned int hits;
+} ziv_entry_t;
+
+static MPC_THREAD_LOCAL int ziv_adaptive = 0;
+static MPC_THREAD_LOCAL ziv_entry_t ziv_table [MPC_ZIV_NSITE][ZIV_BUCKETS];
+
+#ifdef MPC_STATS
+#define MPC_ZIV_STATS(f) MPC_STATS_##f,
+static const int ziv_stats [] = { MPC_ZIV_SITES (MPC_ZIV_STATS) 0 };
+#endif
+
+
+void
+mpc_set_ziv_adaptive (int flag)
+   /* Switch the adaptive initial precision of the Ziv loops on if flag
+      is non-zero, off otherwise, in the current thread. */
+{
+   ziv_adaptive = (flag != 0);
+}
+
+
+int
+mpc_get_ziv_adaptive (void)
+{
+   return ziv_adaptive;
+}
+
+
+void
+mpc_ziv_free_cache (void)
+{
+   memset (ziv_table, 0, sizeof (ziv_table));
+}
+
+
+static ziv_entry_t *
+ziv_entry (int site, mpfr_prec_t target)
+{
+   mpfr_prec_t k = mpc_ceil_log2 (target);
+
+   return ziv_table [site] + MPC_MIN (k, ZIV_BUCKETS - 1);
+}
+
+
+mpfr_prec_t
+mpc_ziv_start (int site, mpfr_prec_t p, mpfr_prec_t target)
+   /* Return the working precision for the first iteration of the Ziv
+      loop at site, which would otherwise be p, for a result of precision
+      target. */
+{
+   if (!ziv_adaptive)
+      return p;
+   return MPC_MAX (p, target + ziv_entry (site, target)->guard);
+}
+
+
+void
+mpc_ziv_end (int site, int loop, mpfr_prec_t p, mpfr_prec_t target)
+   /* Record that the Ziv loop at site has succeeded after loop
+      iterations with a working precision p, for a result of precision
+      target. */
+{
+   ziv_entry_t *e;
+
+#ifdef MPC_STATS
+   mpc_stats_ziv (ziv_stats [site], loop, p - target);
+#endif
+   if (!ziv_adaptive)
+      return;
+
+   e = ziv_entry (site, target);
+   if (loop == 1) {
+      if (e->guard > 0 && ++e->hits >= ZIV_DECAY) {
+         e->guard -= e->guard / 4 + 1;
+         e->hits = 0;
+      }
+   }
+   else if (loop <= ZIV_LEARN) {
+      e->guard = MPC_MAX (p - target, 0);
+      e->hits = 0;
+   }
+}
@@ -1,6 +1,6 @@
 /* tballs -- test file for complex ball arithmetic.
 
-Copyright (C) 2018, 2020, 2021, 2022, 2023, 2024 INRIA
+Copyright (C) 2018, 2020, 2021, 2022, 2023, 2024, 2025 INRIA
 
 This file is part of GNU MPC.
 
@@ -23,16 +23,37 @@ along with this program. If not, see http://www.gnu.org/licenses/ .
    /* For the alternative AGM implementation, we need all the power of
       this include file. */
 
+extern const char *mpc_rnd_mode[];
+
+static int
+agm_ball (mpcb_ptr res, mpfr_prec_t prec, const void *data)
+   /* Evaluation function for mpcb_ziv, where data points to an array
+      containing the two arguments of the AGM. */
+{
+   mpc_srcptr *op = (mpc_srcptr *) data;
+   mpcb_t a, b;
+
+   /* So copying the arguments is exact. */
+   prec = MPC_MAX (prec, MPC_MAX (MPC_MAX_PREC (op [0]),
+                                  MPC_MAX_PREC (op [1])));
+   mpcb_init (a);
+   mpcb_init (b);
+   mpcb_set_c (a, op [0], prec, 0, 0);
+   mpcb_set_c (b, op [1], prec, 0, 0);
+   mpcb_agm (res, a, b);
+   mpcb_clear (a);
+   mpcb_clear (b);
+
+   return 0;
+}
+
+
 static int
 mpc_mpcb_agm (mpc_ptr rop, mpc_srcptr opa, mpc_srcptr opb, mpc_rnd_t rnd)
    /* Alternative implementation of mpc_agm that uses complex balls. */
 {
-   mpfr_prec_t prec;
-   mpc_t b0, diff;
-   mpcb_t a, b, an, bn, anp1, bnp1, res;
-   mpfr_exp_t exp_an, exp_diff;
-   mpcr_t rab;
-   int cmp, equal, re_zero, im_zero, ok, inex;
+   mpc_srcptr op [2];
+   mpc_t b0;
 
    if (!mpc_fin_p (opa) || !mpc_fin_p (opb)
        || mpc_zero_p (opa) || mpc_zero_p (opb)
@@ -60,112 +81,9 @@ mpc_mpcb_agm (mpc_ptr rop, mpc_srcptr opa, mpc_srcptr opb, mpc_rnd_t rnd)
    }
    mpc_clear (b0);
 
-   cmp = mpc_cmp_abs (opa, opb);
-
-   mpcb_init (a);
-   mpcb_init (b);
-   mpcb_init (an);
-   mpcb_init (bn);
-   mpcb_init (anp1);
-   mpcb_init (bnp1);
-   mpcb_init (res);
-   prec = MPC_MAX (MPC_MAX (MPC_MAX_PREC (opa), MPC_MAX_PREC (opb)),
-      MPC_MAX_PREC (rop) + 20);
-      /* So copying opa and opb will be exact, and there is a small safety
-         margin for the result. */
-   do {
-      mpcb_set_prec (a, prec);
-      mpcb_set_prec (b, prec);
-      mpcb_set_prec (an, prec);
-      mpcb_set_prec (bn, prec);
-      mpcb_set_prec (anp1, prec);
-      mpcb_set_prec (bnp1, prec);
-      mpcb_set_prec (res, prec);
-      /* TODO: Think about the mpcb_set variants; mpcb_set_c, for instance,
-         modifies the precision. It is probably better to add a precision
-         parameter to mpcb_init and potentially round with mpcb_set_xxx. */
-      mpc_set (a->c, opa, MPC_RNDNN); /* exact */
-      mpcr_set_zero (a->r);
-      mpc_set (b->c, opb, MPC_RNDNN);
-      mpcr_set_zero (b->r);
-      mpc_set_ui_ui (an->c, 1, 0, MPC_RNDNN);
-      mpcr_set_zero (an->r);
-      if (cmp >= 0)
-         mpcb_div (bn, b, a);
-      else
-         mpcb_div (bn, a, b);
-
-      /* Iterate until there is a fixed point or (often one iteration
-         earlier) the arithmetic and the geometric mean coincide. */
-      do {
-         mpcb_add (anp1, an, bn);
-         mpcb_div_2ui (anp1, anp1, 1);
-         mpcb_mul (bnp1, an, bn);
-         mpcb_sqrt (bnp1, bnp1);
-            /* Be aware of the branch cut! The current function does
-               what is needed here. */
-         equal = mpc_cmp (anp1->c, bnp1->c) == 0
-                 || (   mpc_cmp (an->c, anp1->c) == 0
-                     && mpc_cmp (bn->c, bnp1->c) == 0);
-         mpcb_set (an, anp1);
-         mpcb_set (bn, bnp1);
-      } while (!equal);
-
-      /* Check whether we can conclude, see the error analysis in
-         algorithms.tex. */
-      if (mpcr_inf_p (anp1->r))
-         ok = 0;
-      else {
-         mpcb_set (res, anp1);
-         mpc_init2 (diff, prec);
-         mpc_sub (diff, an->c, bn->c, MPC_RNDAA);
-         re_zero = mpfr_zero_p (mpc_realref (diff));
-         im_zero = mpfr_zero_p (mpc_imagref (diff));
-         if (re_zero && im_zero)
-            mpcr_set_zero (rab);
-         else {
-            exp_an = MPC_MIN (mpfr_get_exp (mpc_realref (an->c)),
-                              mpfr_get_exp (mpc_imagref (an->c))) - 1;
-            if (re_zero)
-               exp_diff = mpfr_get_exp (mpc_imagref (diff)) + 1;
-            else if (im_zero)
-               exp_diff = mpfr_get_exp (mpc_realref (diff)) + 1;
-            else
-               exp_diff = MPC_MAX (mpfr_get_exp (mpc_realref (diff)),
-                                   mpfr_get_exp (mpc_imagref (diff)) + 1);
-            mpcr_set_one (rab);
-            (rab->exp) += (exp_diff - exp_an);
-               /* TODO: Should be done by an mpcr function. */
-         }
-         mpcr_add (rab, rab, an->r);
-         (rab->exp)++;
-         mpcr_add (res->r, rab, bn->r);
-            /* r = 2 * (rab + an->r) + bn->r */
-         if (cmp >= 0)
-            mpcb_mul (res, res, a);
-         else
-            mpcb_mul (res, res, b);
-         ok = mpcb_can_round (res, MPC_PREC_RE (rop), MPC_PREC_IM (rop),
-            rnd);
-
-         mpc_clear (diff);
-      }
-
-      if (!ok)
-         prec += prec + mpcr_get_exp (res->r);
-   } while (!ok);
-
-   inex = mpcb_round (rop, res, rnd);
-
-   mpcb_clear (a);
-   mpcb_clear (b);
-   mpcb_clear (an);
-   mpcb_clear (bn);
-   mpcb_clear (anp1);
-   mpcb_clear (bnp1);
-   mpcb_clear (res);
-
-   return inex;
+   op [0] = opa;
+   op [1] = opb;
+   return mpcb_ziv (rop, agm_ball, op, NULL, 0, rnd);
 }
 
 
@@ -215,6 +133,177 @@ test_agm (void)
 }
 
 
+static void
+mpcb_sin (mpcb_ptr z, mpcb_srcptr z1)
+{
+   mpcb_t c;
+
+   mpcb_init (c);
+   mpcb_sin_cos (z, c, z1);
+   mpcb_clear (c);
+}
+
+
+static void
+mpcb_cos (mpcb_ptr z, mpcb_srcptr z1)
+{
+   mpcb_t s;
+
+   mpcb_init (s);
+   mpcb_sin_cos (s, z, z1);
+   mpcb_clear (s);
+}
+
+
+static int
+test_function (const char *name, void (*fb) (mpcb_ptr, mpcb_srcptr),
+   int (*fc) (mpc_ptr, mpc_srcptr, mpc_rnd_t))
+   /* Compare the result of a Ziv loop around the ball function fb with
+      the correctly rounded function fc on random arguments. */
+{
+   const mpc_rnd_t rnd [4] = { MPC_RNDNN, MPC_RNDZU, MPC_RNDUD, MPC_RNDDZ };
+   mpfr_prec_t prec, p;
+   mpc_t z, res1, res2;
+   mpcb_t zb, resb;
+   int i, inex1, inex2, ok;
+
+   mpc_init2 (z, 2);
+   mpc_init2 (res1, 2);
+   mpc_init2 (res2, 2);
+   mpcb_init (zb);
+   mpcb_init (resb);
+
+   ok = 1;
+   for (i = 0; ok && i < 200; i++) {
+      prec = 2 + i;
+      mpc_set_prec (z, prec);
+      mpc_set_prec (res1, prec);
+      mpc_set_prec (res2, prec);
+      do
+         test_default_random (z, -4, 4, 128, 0);
+      while (mpfr_zero_p (mpc_realref (z)) || mpfr_zero_p (mpc_imagref (z)));
+      inex1 = fc (res1, z, rnd [i % 4]);
+      for (p = prec + 10;
+           p <= 100 * prec;
+           p += p / 2) {
+         mpcb_set_c (zb, z, p, 0, 0);
+         fb (resb, zb);
+         if (mpcb_can_round (resb, prec, prec, rnd [i % 4]))
+            break;
+      }
+      inex2 = mpcb_round (res2, resb, rnd [i % 4]);
+      if (p > 100 * prec || inex1 != inex2 || mpc_cmp (res1, res2) != 0) {
+         printf ("Error in %s for rounding mode %s and\nz = ", name,
+            mpc_rnd_mode [rnd [i % 4]]);
+         mpc_out_str (stdout, 16, 0, z, MPC_RNDNN);
+         printf ("\n");
+         MPC_OUT (res1);
+         mpcb_out_str (stdout, resb);
+         printf ("\n");
+         ok = 0;
+      }
+   }
+
+   mpc_clear (z);
+   mpc_clear (res1);
+   mpc_clear (res2);
+   mpcb_clear (zb);
+   mpcb_clear (resb);
+
+   return !ok;
+}
+
+
+static int
+test_fma (void)
+   /* Compare a Ziv loop around mpcb_fma, mpcb_addmul and mpcb_submul with
+      mpc_fma on random exact arguments. */
+{
+   const mpc_rnd_t rnd [4] = { MPC_RNDNN, MPC_RNDZU, MPC_RNDUD, MPC_RNDDZ };
+   mpfr_prec_t prec, p;
+   mpc_t a, b, c, res1, res2;
+   mpcb_t ab, bb, cb, resb;
+   int i, j, inex1, inex2, ok;
+
+   mpc_init2 (a, 2);
+   mpc_init2 (b, 2);
+   mpc_init2 (c, 2);
+   mpc_init2 (res1, 2);
+   mpc_init2 (res2, 2);
+   mpcb_init (ab);
+   mpcb_init (bb);
+   mpcb_init (cb);
+   mpcb_init (resb);
+
+   ok = 1;
+   for (i = 0; ok && i < 300; i++) {
+      prec = 2 + i;
+      mpc_set_prec (a, prec);
+      mpc_set_prec (b, prec);
+      mpc_set_prec (c, prec);
+      mpc_set_prec (res1, prec);
+      mpc_set_prec (res2, prec);
+      do {
+         test_default_random (a, -4, 4, 128, 0);
+         test_default_random (b, -4, 4, 128, 0);
+         test_default_random (c, -8, 8, 128, 0);
+      } while (mpc_zero_p (a) || mpc_zero_p (b) || mpc_zero_p (c));
+      /* j = 0 tests mpcb_fma, j = 1 mpcb_addmul and j = 2 mpcb_submul,
+         which is compared with mpc_fma on -a. */
+      j = i % 3;
+      if (j == 2)
+         mpc_neg (a, a, MPC_RNDNN);
+      inex1 = mpc_fma (res1, a, b, c, rnd [i % 4]);
+      if (j == 2)
+         mpc_neg (a, a, MPC_RNDNN);
+      for (p = prec + 10; p <= 100 * prec; p += p / 2) {
+         mpcb_set_c (ab, a, p, 0, 0);
+         mpcb_set_c (bb, b, p, 0, 0);
+         mpcb_set_c (cb, c, p, 0, 0);
+         if (j == 0)
+            mpcb_fma (resb, ab, bb, cb);
+         else {
+            mpcb_set (resb, cb);
+            if (j == 1)
+               mpcb_addmul (resb, ab, bb);
+            else
+               mpcb_submul (resb, ab, bb);
+         }
+         if (mpcb_can_round (resb, prec, prec, rnd [i % 4]))
+            break;
+      }
+      inex2 = mpcb_round (res2, resb, rnd [i % 4]);
+      if (p > 100 * prec || inex1 != inex2 || mpc_cmp (res1, res2) != 0) {
+         printf ("Error in %s for rounding mode %s and\na = ",
+            (j == 0 ? "mpcb_fma" : (j == 1 ? "mpcb_addmul" : "mpcb_submul")),
+            mpc_rnd_mode [rnd [i % 4]]);
+         mpc_out_str (stdout, 16, 0, a, MPC_RNDNN);
+         printf ("\nb = ");
+         mpc_out_str (stdout, 16, 0, b, MPC_RNDNN);
+         printf ("\nc = ");
+         mpc_out_str (stdout, 16, 0, c, MPC_RNDNN);
+         printf ("\n");
+         MPC_OUT (res1);
+         mpcb_out_str (stdout, resb);
+         printf ("\n");
+         ok = 0;
+      }
+   }
+
+   mpc_clear (a);
+   mpc_clear (b);
+   mpc_clear (c);
+   mpc_clear (res1);
+   mpc_clear (res2);
+   mpcb_clear (ab);
+   mpcb_clear (bb);
+   mpcb_clear (cb);
+   mpcb_clear (resb);
+
+   return !ok;
+}
+
+
 int
 main (void)
 {
@@ -222,6 +311,12 @@ main (void)
 
   test_start ();
   ret = test_agm ();
+  ret |= test_function ("mpcb_exp", mpcb_exp, mpc_exp);
+  ret |= test_function ("mpcb_log", mpcb_log, mpc_log);
+  ret |= test_function ("mpcb_sin_cos (sine)", mpcb_sin, mpc_sin);
+  ret |= test_function ("mpcb_sin_cos (cosine)", mpcb_cos, mpc_cos);
+  ret |= test_function ("mpcb_atan", mpcb_atan, mpc_atan);
+  ret |= test_fma ();
   test_end ();
 
   return ret;
@@ -0,0 +1,313 @@
+/* tellip -- test file for complete elliptic integrals and periods.
+
+Copyright (C) 2025 INRIA
+
+This file is part of GNU MPC.
+
+GNU MPC is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the
+Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+GNU MPC is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for
+more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program. If not, see http://www.gnu.org/licenses/ .
+*/
+
+#include "mpc-tests.h"
+
+static int
+close_p (mpc_srcptr x, mpc_srcptr y, mpfr_exp_t e)
+   /* Return non-zero if |x - y| <= 2^e |y|. */
+{
+   mpc_t d;
+   mpfr_t a, b;
+   int res;
+
+   mpc_init2 (d, mpc_get_prec (x) + 10);
+   mpfr_init2 (a, 53);
+   mpfr_init2 (b, 53);
+   mpc_sub (d, x, y, MPC_RNDNN);
+   mpc_abs (a, d, MPFR_RNDU);
+   mpc_abs (b, y, MPFR_RNDD);
+   mpfr_mul_2si (b, b, e, MPFR_RNDD);
+   res = (mpfr_cmp (a, b) <= 0);
+   mpc_clear (d);
+   mpfr_clear (a);
+   mpfr_clear (b);
+
+   return res;
+}
+
+
+static int
+test_ellipke (void)
+{
+   const mpfr_prec_t p = 200;
+   mpc_t m, m1, k, k1, e, e1, ref;
+   mpfr_t pi;
+   int i, inex, inex_ref, ok = 1;
+   known_signs_t ks = {1, 1};
+
+   mpc_init2 (m, 64);
+   mpc_init2 (m1, 128);
+   mpc_init2 (k, p);
+   mpc_init2 (k1, p);
+   mpc_init2 (e, p);
+   mpc_init2 (e1, p);
+   mpc_init2 (ref, p);
+   mpfr_init2 (pi, p);
+
+   /* K (0) = E (0) = pi/2, K (1) = +inf, E (1) = 1 */
+   mpc_set_ui (m, 0, MPC_RNDNN);
+   inex = mpc_ellipk (k, m, MPC_RNDDU);
+   inex_ref = mpfr_const_pi (pi, MPFR_RNDD);
+   mpfr_div_2ui (pi, pi, 1, MPFR_RNDN);
+   mpc_ellipe (e, m, MPC_RNDDU);
+   if (   inex != MPC_INEX (inex_ref, 0) || mpc_cmp (k, e) != 0
+       || !mpfr_equal_p (mpc_realref (k), pi)
+       || !mpfr_zero_p (mpc_imagref (k))) {
+      printf ("Error in mpc_ellipk or mpc_ellipe for m = 0\n");
+      MPC_OUT (k);
+      MPC_OUT (e);
+      ok = 0;
+   }
+   mpc_set_ui (m, 1, MPC_RNDNN);
+   mpc_ellipk (k, m, MPC_RNDNN);
+   inex = mpc_ellipe (e, m, MPC_RNDNN);
+   if (   !mpfr_inf_p (mpc_realref (k)) || mpfr_sgn (mpc_realref (k)) < 0
+       || inex != 0 || mpc_cmp_si_si (e, 1, 0) != 0) {
+      printf ("Error in mpc_ellipk or mpc_ellipe for m = 1\n");
+      MPC_OUT (k);
+      MPC_OUT (e);
+      ok = 0;
+   }
+
+   /* Legendre's relation E K' + E' K - K K' = pi/2, where the primed
+      values are taken in 1 - m; and K (conj (m)) = conj (K (m)). */
+   mpfr_const_pi (pi, MPFR_RNDN);
+   mpfr_div_2ui (pi, pi, 1, MPFR_RNDN);
+   for (i = 0; i < 20 && ok; i++) {
+      mpfr_urandomb (mpc_realref (m), rands);
+      mpfr_urandomb (mpc_imagref (m), rands);
+      mpfr_mul_2si (mpc_realref (m), mpc_realref (m), i % 5 - 1, MPFR_RNDN);
+      mpfr_sub_d (mpc_realref (m), mpc_realref (m), 0.75, MPFR_RNDN);
+      if (i % 4 == 0)
+         mpfr_set_ui (mpc_imagref (m), 0, MPFR_RNDN);
+      else if (i % 4 == 1)
+         mpfr_neg (mpc_imagref (m), mpc_imagref (m), MPFR_RNDN);
+      mpc_ui_sub (m1, 1, m, MPC_RNDNN); /* exact */
+      mpc_ellipk (k, m, MPC_RNDNN);
+      mpc_ellipk (k1, m1, MPC_RNDNN);
+      mpc_ellipe (e, m, MPC_RNDNN);
+      mpc_ellipe (e1, m1, MPC_RNDNN);
+      mpc_mul (e, e, k1, MPC_RNDNN);
+      mpc_mul (e1, e1, k, MPC_RNDNN);
+      mpc_add (ref, e, e1, MPC_RNDNN);
+      mpc_mul (e, k, k1, MPC_RNDNN);
+      mpc_sub (ref, ref, e, MPC_RNDNN);
+      mpc_set_fr (e, pi, MPC_RNDNN);
+      if (!close_p (ref, e, 10 - p)) {
+         printf ("Error in Legendre's relation for m = ");
+         MPC_OUT (m);
+         MPC_OUT (ref);
+         ok = 0;
+      }
+      if (   i % 4 == 0 && mpfr_cmp_ui (mpc_realref (m), 1) < 0
+          && !mpfr_zero_p (mpc_imagref (k))) {
+         printf ("Error in mpc_ellipk for real m = ");
+         MPC_OUT (m);
+         MPC_OUT (k);
+         ok = 0;
+      }
+      mpc_conj (m1, m, MPC_RNDNN);
+      mpc_ellipk (e, m1, MPC_RNDNN);
+      mpc_conj (e, e, MPC_RNDNN);
+      ks.im = (i % 4 != 0);
+      if (!same_mpc_value (k, e, ks)) {
+         printf ("Error in mpc_ellipk for m = ");
+         MPC_OUT (m1);
+         MPC_OUT (e);
+         MPC_OUT (k);
+         ok = 0;
+      }
+   }
+
+   /* The two sides of the branch cut are distinguished by the sign of
+      the zero imaginary part. */
+   ks.im = 1;
+   mpc_set_ui_ui (m, 2, 0, MPC_RNDNN);
+   mpc_ellipk (k, m, MPC_RNDNN);
+   mpc_conj (m, m, MPC_RNDNN);
+   mpc_ellipk (k1, m, MPC_RNDNN);
+   mpc_conj (k1, k1, MPC_RNDNN);
+   if (!same_mpc_value (k, k1, ks) || mpfr_sgn (mpc_imagref (k)) <= 0) {
+      printf ("Error in mpc_ellipk on the branch cut\n");
+      MPC_OUT (k);
+      MPC_OUT (k1);
+      ok = 0;
+   }
+
+   mpc_set_nan (m);
+   mpc_ellipe (e, m, MPC_RNDNN);
+   if (!mpfr_nan_p (mpc_realref (e)) || !mpfr_nan_p (mpc_imagref (e))) {
+      printf ("Error in mpc_ellipe for m = NaN\n");
+      MPC_OUT (e);
+      ok = 0;
+   }
+
+   mpc_clear (m);
+   mpc_clear (m1);
+   mpc_clear (k);
+   mpc_clear (k1);
+   mpc_clear (e);
+   mpc_clear (e1);
+   mpc_clear (ref);
+   mpfr_clear (pi);
+
+   return !ok;
+}
+
+
+static int
+test_periods (void)
+{
+   const mpfr_prec_t p = 150;
+   const unsigned long int n = 30;
+   mpc_t e [3][30], w1 [30], w2 [30], v1, v2, m;
+   mpc_ptr pe [3][30], pw1 [30], pw2 [30];
+   int inex [30], inex_ref;
+   known_signs_t ks = {1, 1};
+   unsigned long int i;
+   int j, ok = 1;
+
+   mpc_init2 (v1, p);
+   mpc_init2 (v2, p);
+   mpc_init2 (m, 64);
+
+   /* The lemniscatic curve y^2 = 4x^3 - 4x with roots 1, 0 and -1 has
+      the square lattice spanned by varpi = 2.622... and i * varpi, where
+      varpi = sqrt (2) K (1/2). */
+   for (i = 0; i < 3; i++) {
+      mpc_init2 (e [i][0], 64);
+      mpc_set_si (e [i][0], 1 - (long int) i, MPC_RNDNN);
+   }
+   mpc_init2 (w1 [0], p);
+   mpc_init2 (w2 [0], p);
+   mpc_ellip_periods (w1 [0], w2 [0], e [0][0], e [1][0], e [2][0],
+                      MPC_RNDNN);
+   mpc_set_d (m, 0.5, MPC_RNDNN);
+   mpc_ellipk (v1, m, MPC_RNDNN);
+   mpc_sqrt (v2, v1, MPC_RNDNN);
+   mpfr_set_ui (mpc_realref (v2), 2, MPFR_RNDN);
+   mpfr_sqrt (mpc_realref (v2), mpc_realref (v2), MPFR_RNDN);
+   mpfr_set_ui (mpc_imagref (v2), 0, MPFR_RNDN);
+   mpc_mul (v1, v1, v2, MPC_RNDNN);
+   mpc_mul_i (v2, w2 [0], -1, MPC_RNDNN);
+   if (   !mpfr_zero_p (mpc_imagref (w1 [0]))
+       || !mpfr_zero_p (mpc_realref (w2 [0]))
+       || mpc_cmp (w1 [0], v2) != 0 || !close_p (w1 [0], v1, 3 - p)) {
+      printf ("Error in mpc_ellip_periods for the lemniscatic curve\n");
+      MPC_OUT (w1 [0]);
+      MPC_OUT (w2 [0]);
+      MPC_OUT (v1);
+      ok = 0;
+   }
+
+   /* Random roots, among which some real ones and some pairs of complex
+      conjugates; the batched function agrees with the individual calls,
+      and multiplying the roots by 4 halves the periods. */
+   for (i = 1; i < n; i++) {
+      for (j = 0; j < 3; j++) {
+         mpc_init2 (e [j][i], 64);
+         mpc_urandom (e [j][i], rands);
+         mpc_mul_2si (e [j][i], e [j][i], (long int) (i % 3), MPC_RNDNN);
+         if (i % 3 == 0)
+            mpfr_set_ui (mpc_imagref (e [j][i]), 0, MPFR_RNDN);
+      }
+      if (i % 3 == 1)
+         mpc_conj (e [(i / 3) % 3][i], e [(i / 3 + 1) % 3][i], MPC_RNDNN);
+      mpc_init2 (w1 [i], 20 + 11 * i);
+      mpc_init2 (w2 [i], 30 + 7 * i);
+   }
+   for (i = 0; i < n; i++) {
+      for (j = 0; j < 3; j++)
+         pe [j][i] = e [j][i];
+      pw1 [i] = w1 [i];
+      pw2 [i] = w2 [i];
+   }
+   mpc_ellip_periods_vec (pw1, pw2, inex, (const mpc_ptr *) pe [0],
+                          (const mpc_ptr *) pe [1], (const mpc_ptr *) pe [2],
+                          n, MPC_RNDZU);
+   for (i = 0; i < n && ok; i++) {
+      mpc_set_prec (v1, mpc_get_prec (w1 [i]));
+      mpc_set_prec (v2, mpc_get_prec (w2 [i]));
+      inex_ref = mpc_ellip_periods (v1, v2, e [0][i], e [1][i], e [2][i],
+                                    MPC_RNDZU);
+      if (   inex [i] != inex_ref || !same_mpc_value (w1 [i], v1, ks)
+          || !same_mpc_value (w2 [i], v2, ks)) {
+         printf ("Error in mpc_ellip_periods_vec for the roots\n");
+         MPC_OUT (e [0][i]);
+         MPC_OUT (e [1][i]);
+         MPC_OUT (e [2][i]);
+         MPC_OUT (w1 [i]);
+         MPC_OUT (v1);
+         MPC_OUT (w2 [i]);
+         MPC_OUT (v2);
+         ok = 0;
+      }
+      for (j = 0; j < 3; j++)
+         mpc_mul_2ui (e [j][i], e [j][i], 2, MPC_RNDNN);
+      inex_ref = mpc_ellip_periods (v1, v2, e [0][i], e [1][i], e [2][i],
+                                    MPC_RNDZU);
+      mpc_mul_2ui (v1, v1, 1, MPC_RNDNN);
+      mpc_mul_2ui (v2, v2, 1, MPC_RNDNN);
+      if (   ok && (inex [i] != inex_ref || !same_mpc_value (w1 [i], v1, ks)
+          || !same_mpc_value (w2 [i], v2, ks))) {
+         printf ("Error in mpc_ellip_periods for the scaled roots\n");
+         MPC_OUT (e [0][i]);
+         MPC_OUT (e [1][i]);
+         MPC_OUT (e [2][i]);
+         ok = 0;
+      }
+   }
+
+   /* NaN for a double root */
+   mpc_ellip_periods (v1, v2, e [0][1], e [1][1], e [0][1], MPC_RNDNN);
+   if (!mpfr_nan_p (mpc_realref (v1)) || !mpfr_nan_p (mpc_imagref (v2))) {
+      printf ("Error in mpc_ellip_periods for a double root\n");
+      MPC_OUT (v1);
+      MPC_OUT (v2);
+      ok = 0;
+   }
+
+   for (i = 0; i < n; i++) {
+      for (j = 0; j < 3; j++)
+         mpc_clear (e [j][i]);
+      mpc_clear (w1 [i]);
+      mpc_clear (w2 [i]);
+   }
+   mpc_clear (v1);
+   mpc_clear (v2);
+   mpc_clear (m);
+
+   return !ok;
+}
+
+
+int
+main (void)
+{
+  int ret;
+
+  test_start ();
+  ret = test_ellipke ();
+  ret |= test_periods ();
+  test_end ();
+
+  return ret;
+}
@@ -1,6 +1,7 @@
-/* teta -- test file for the Dedekind eta function.
+/* teta -- test file for the Dedekind eta function and related modular
+   functions.
 
-Copyright (C) 2022, 2023 INRIA
+Copyright (C) 2022, 2023, 2025 INRIA
 
 This file is part of GNU MPC.
 
@@ -132,6 +133,16 @@ test_eta (void)
       printf ("%li\n", re);
    }
 
+   /* Check whether mpc_eta_fund returns NaN instead of looping far
+      outside of the fundamental domain. */
+   mpc_set_ui_ui (z, 1, 1, MPC_RNDNN);
+   mpc_eta_fund (eta, z, MPC_RNDNN);
+   if (!mpfr_nan_p (mpc_realref (eta)) || !mpfr_nan_p (mpc_imagref (eta))) {
+      printf ("Error for mpc_eta_fund (1+I), expected NaN, got\n");
+      MPC_OUT (eta);
+      ok = 0;
+   }
+
    mpc_clear (eta);
    mpc_clear (z);
    mpcb_clear (j);
@@ -141,6 +152,477 @@ test_eta (void)
 }
 
 
+static int
+test_eta_fund_vec (void)
+{
+   const unsigned long int n = 40;
+   mpc_t z [40], got [40], ref;
+   mpc_ptr pz [40], pgot [40];
+   int inex [40], inex_ref;
+   mpc_rnd_t rnd = MPC_RNDZU;
+   known_signs_t ks = {1, 1};
+   unsigned long int i;
+   int ok = 1;
+
+   /* Random points in the fundamental domain, with |Re z| <= 1/2 and
+      1 <= Im z < 3, and varying target precisions. */
+   mpc_init2 (ref, 2);
+   for (i = 0; i < n; i++) {
+      mpc_init2 (z [i], 64);
+      mpc_init2 (got [i], 10 + 37 * i);
+      pz [i] = z [i];
+      pgot [i] = got [i];
+      mpfr_urandomb (mpc_realref (z [i]), rands);
+      mpfr_sub_d (mpc_realref (z [i]), mpc_realref (z [i]), 0.5,
+                  MPFR_RNDN);
+      mpfr_urandomb (mpc_imagref (z [i]), rands);
+      mpfr_mul_2ui (mpc_imagref (z [i]), mpc_imagref (z [i]), 1,
+                    MPFR_RNDN);
+      mpfr_add_ui (mpc_imagref (z [i]), mpc_imagref (z [i]), 1,
+                   MPFR_RNDN);
+   }
+
+   mpc_eta_fund_vec (pgot, inex, (const mpc_ptr *) pz, n, rnd);
+
+   for (i = 0; i < n && ok; i++) {
+      mpc_set_prec (ref, mpc_get_prec (got [i]));
+      inex_ref = mpc_eta_fund (ref, z [i], rnd);
+      if (inex [i] != inex_ref || !same_mpc_value (got [i], ref, ks)) {
+         printf ("Error in mpc_eta_fund_vec for z = ");
+         MPC_OUT (z [i]);
+         printf ("got inex %i, expected %i\n", inex [i], inex_ref);
+         MPC_OUT (got [i]);
+         MPC_OUT (ref);
+         ok = 0;
+      }
+   }
+
+   /* inex may be NULL */
+   mpc_eta_fund_vec (pgot, NULL, (const mpc_ptr *) pz, 1, rnd);
+
+   mpc_clear (ref);
+   for (i = 0; i < n; i++) {
+      mpc_clear (z [i]);
+      mpc_clear (got [i]);
+   }
+
+   return !ok;
+}
+
+
+static int
+test_eta_reduction (void)
+{
+   mpc_t z, w, got, ref;
+   mpfr_prec_t prec;
+   int i, inex, inex_ref, ok = 1;
+   known_signs_t ks = {1, 1};
+
+   mpc_init2 (z, 64);
+   mpc_init2 (w, 72); /* so that z + 24 is exact */
+   mpc_init2 (got, 2);
+   mpc_init2 (ref, 2);
+
+   /* eta (i/4^k) = 2^k * eta (4^k i) and both values are real. */
+   for (i = 1; i <= 3 && ok; i++) {
+      prec = 50 * i;
+      mpc_set_prec (got, prec);
+      mpc_set_prec (ref, prec);
+      mpc_set_ui_ui (z, 0, 1, MPC_RNDNN);
+      mpc_div_2ui (z, z, 2 * i, MPC_RNDNN);
+      mpc_mul_2ui (w, z, 4 * i, MPC_RNDNN);
+      inex = mpc_eta (got, z, MPC_RNDZZ);
+      inex_ref = mpc_eta_fund (ref, w, MPC_RNDZZ);
+      mpc_mul_2ui (ref, ref, i, MPC_RNDNN);
+      if (inex != inex_ref || !same_mpc_value (got, ref, ks)) {
+         printf ("Error in mpc_eta for z = ");
+         MPC_OUT (z);
+         MPC_OUT (got);
+         MPC_OUT (ref);
+         ok = 0;
+      }
+   }
+
+   /* eta (-conj (z)) = conj (eta (z)) and eta (z + 24) = eta (z),
+      for random z close to the real axis; in the fundamental domain,
+      mpc_eta and mpc_eta_fund agree. */
+   for (i = 0; i < 30 && ok; i++) {
+      prec = 20 + 13 * i;
+      mpc_set_prec (got, prec);
+      mpc_set_prec (ref, prec);
+      mpfr_urandomb (mpc_realref (z), rands);
+      mpfr_sub_d (mpc_realref (z), mpc_realref (z), 0.5, MPFR_RNDN);
+      mpfr_urandomb (mpc_imagref (z), rands);
+      if (i % 3 == 0) {
+         mpfr_add_ui (mpc_imagref (z), mpc_imagref (z), 1, MPFR_RNDN);
+         inex = mpc_eta (got, z, MPC_RNDNN);
+         inex_ref = mpc_eta_fund (ref, z, MPC_RNDNN);
+      }
+      else {
+         mpfr_mul_2ui (mpc_realref (z), mpc_realref (z), 5, MPFR_RNDN);
+         mpfr_div_2ui (mpc_imagref (z), mpc_imagref (z), i % 7 + 1,
+                       MPFR_RNDN);
+         inex = mpc_eta (got, z, MPC_RNDNN);
+         mpc_conj (w, z, MPC_RNDNN);
+         mpc_neg (w, w, MPC_RNDNN);
+         inex_ref = mpc_eta (ref, w, MPC_RNDNN);
+         mpc_conj (ref, ref, MPC_RNDNN);
+         inex_ref = MPC_INEX (MPC_INEX_RE (inex_ref), -MPC_INEX_IM (inex_ref));
+         if (inex == inex_ref && same_mpc_value (got, ref, ks)) {
+            mpc_add_ui (w, z, 24, MPC_RNDNN);
+            inex_ref = mpc_eta (ref, w, MPC_RNDNN);
+         }
+      }
+      if (inex != inex_ref || !same_mpc_value (got, ref, ks)) {
+         printf ("Error in mpc_eta for z = ");
+         MPC_OUT (z);
+         MPC_OUT (got);
+         MPC_OUT (ref);
+         ok = 0;
+      }
+   }
+
+   /* eta (m + i*y) = exp (pi*i*m/12) * eta (i*y) is real or purely
+      imaginary for m divisible by 6; y = 1/2 leads to a reduction with
+      c > 0, and y = 1 to a translation. */
+   for (i = 0; i < 8 && ok; i++) {
+      prec = 40 + 17 * i;
+      mpc_set_prec (got, prec);
+      mpc_set_prec (ref, prec);
+      mpc_set_ui_ui (w, 0, 1, MPC_RNDNN);
+      mpc_div_2ui (w, w, i % 2, MPC_RNDNN);
+      inex_ref = mpc_eta (ref, w, MPC_RNDZZ);
+      mpc_add_ui (z, w, 6 * (i / 2 + 1), MPC_RNDNN);
+      inex = mpc_eta (got, z, MPC_RNDZZ);
+      if ((i / 2) % 2 == 0) {
+         /* m = 6 or m = 18 */
+         mpc_mul_i (ref, ref, (i / 2 == 0 ? 1 : -1), MPC_RNDNN);
+         mpfr_set_ui (mpc_realref (ref), 0, MPFR_RNDN);
+         inex_ref = MPC_INEX (0, (i / 2 == 0 ? 1 : -1)
+                                 * MPC_INEX_RE (inex_ref));
+      }
+      else if (i / 2 == 1) {
+         /* m = 12 */
+         mpfr_neg (mpc_realref (ref), mpc_realref (ref), MPFR_RNDN);
+         inex_ref = MPC_INEX (-MPC_INEX_RE (inex_ref), 0);
+      }
+      if (inex != inex_ref || !same_mpc_value (got, ref, ks)) {
+         printf ("Error in mpc_eta for z = ");
+         MPC_OUT (z);
+         printf ("got inex %i, expected %i\n", inex, inex_ref);
+         MPC_OUT (got);
+         MPC_OUT (ref);
+         ok = 0;
+      }
+   }
+
+   /* NaN outside the upper half plane */
+   mpc_set_si_si (z, 1, -1, MPC_RNDNN);
+   mpc_eta (got, z, MPC_RNDNN);
+   if (!mpfr_nan_p (mpc_realref (got)) || !mpfr_nan_p (mpc_imagref (got))) {
+      printf ("Error in mpc_eta for z = 1-i\n");
+      MPC_OUT (got);
+      ok = 0;
+   }
+
+   mpc_clear (z);
+   mpc_clear (w);
+   mpc_clear (got);
+   mpc_clear (ref);
+
+   return !ok;
+}
+
+
+static int
+test_eta_real_axis (void)
+   /* Close to the real axis, the reduced argument has a huge imaginary
+      part, so that q underflows in the default exponent range while
+      the value of eta is still representable. */
+{
+   mpc_t z, got, ref;
+   mpfr_exp_t emin;
+   int inex, ok = 1;
+
+   mpc_init2 (z, 53);
+   mpc_init2 (got, 53);
+   mpc_init2 (ref, 53);
+
+   mpc_set_d_d (z, -0.5, 1e-10, MPC_RNDNN);
+   mpfr_set_str (mpc_realref (ref), "0x1d83287dced93bp-944241733", 0,
+      MPFR_RNDN);
+   mpfr_set_str (mpc_imagref (ref), "-0x1f153e58bed1d0p-944241736", 0,
+      MPFR_RNDN);
+   mpfr_clear_flags ();
+   mpc_eta (got, z, MPC_RNDNN);
+   if (mpc_cmp (got, ref) != 0 || mpfr_underflow_p ()) {
+      printf ("Error in mpc_eta close to the real axis for z = ");
+      MPC_OUT (z);
+      MPC_OUT (got);
+      MPC_OUT (ref);
+      ok = 0;
+   }
+
+   /* In a smaller exponent range, the value underflows. */
+   emin = mpfr_get_emin ();
+   mpfr_set_emin (-1000000);
+   mpfr_clear_flags ();
+   inex = mpc_eta (got, z, MPC_RNDNN);
+   if (!mpfr_zero_p (mpc_realref (got)) || mpfr_signbit (mpc_realref (got))
+       || !mpfr_zero_p (mpc_imagref (got))
+       || !mpfr_signbit (mpc_imagref (got))
+       || inex != MPC_INEX (-1, 1) || !mpfr_underflow_p ()) {
+      printf ("Error in mpc_eta for an underflowing value, z = ");
+      MPC_OUT (z);
+      MPC_OUT (got);
+      ok = 0;
+   }
+   mpfr_set_emin (emin);
+
+   mpc_clear (z);
+   mpc_clear (got);
+   mpc_clear (ref);
+
+   return !ok;
+}
+
+
+static int
+test_theta_j (void)
+{
+   static const long int orbit [][4] = {
+      /* z = (x + i*y) / 2^e, j (z) */
+      {0, 1, 0, 1728}, {1, 1, 1, 1728}, {-1, 1, 1, 1728},
+      {0, 2, 0, 287496}, {0, 1, 1, 287496}, {1, 1, 2, 287496},
+      {3, 2, 0, 287496}};
+   mpc_t z, w, q, got, ref, t;
+   mpfr_prec_t prec;
+   int i, k, inex, inex_ref, ok = 1;
+   known_signs_t ks = {1, 1};
+
+   mpc_init2 (z, 64);
+   mpc_init2 (w, 72); /* so that z + 1 is exact */
+   mpc_init2 (q, 64);
+   mpc_init2 (got, 20); /* so that the exact values are representable */
+   mpc_init2 (ref, 2);
+   mpc_init2 (t, 120);
+
+   /* exact values on the orbits of i and 2*i */
+   for (i = 0; i < (int) (sizeof (orbit) / sizeof (orbit [0])) && ok; i++) {
+      mpc_set_si_si (z, orbit [i][0], orbit [i][1], MPC_RNDNN);
+      mpc_div_2ui (z, z, (unsigned long int) orbit [i][2], MPC_RNDNN);
+      inex = mpc_j (got, z, MPC_RNDNN);
+      if (inex != 0 || mpc_cmp_si_si (got, orbit [i][3], 0) != 0) {
+         printf ("Error in mpc_j for z = ");
+         MPC_OUT (z);
+         MPC_OUT (got);
+         ok = 0;
+      }
+   }
+
+   /* j (z + 1) = j (z) for random z; the values are real in (1 + i) / 8
+      and (3 + i) / 8, which are equivalent to points on the boundary of
+      the fundamental domain. */
+   for (i = 0; i < 20 && ok; i++) {
+      prec = 20 + 11 * i;
+      mpc_set_prec (got, prec);
+      mpc_set_prec (ref, prec);
+      if (i < 2) {
+         mpc_set_ui_ui (z, 2 * i + 1, 1, MPC_RNDNN);
+         mpc_div_2ui (z, z, 3, MPC_RNDNN);
+      }
+      else {
+         mpfr_urandomb (mpc_realref (z), rands);
+         mpfr_urandomb (mpc_imagref (z), rands);
+         mpfr_div_2ui (mpc_imagref (z), mpc_imagref (z), i % 5,
+                       MPFR_RNDN);
+      }
+      inex = mpc_j (got, z, MPC_RNDZZ);
+      mpc_add_ui (w, z, 1, MPC_RNDNN);
+      inex_ref = mpc_j (ref, w, MPC_RNDZZ);
+      if (inex != inex_ref || !same_mpc_value (got, ref, ks)
+          || (i < 2 && !mpfr_zero_p (mpc_imagref (got)))) {
+         printf ("Error in mpc_j for z = ");
+         MPC_OUT (z);
+         MPC_OUT (got);
+         MPC_OUT (ref);
+         ok = 0;
+      }
+   }
+
+   /* theta_3^4 = theta_2^4 + theta_4^4 in z = 0, and theta_1 (0, q) = 0;
+      for real q > 0 and purely imaginary z, theta_3 (z, q) is real and
+      theta_1 (z, q) purely imaginary. */
+   mpc_set_prec (got, 120);
+   mpc_set_prec (ref, 120);
+   for (i = 0; i < 10 && ok; i++) {
+      mpfr_urandomb (mpc_realref (q), rands);
+      mpfr_urandomb (mpc_imagref (q), rands);
+      mpfr_sub_d (mpc_realref (q), mpc_realref (q), 0.5, MPFR_RNDN);
+      if (i % 2 == 0)
+         mpfr_set_ui (mpc_imagref (q), 0, MPFR_RNDN);
+      else
+         mpfr_sub_d (mpc_imagref (q), mpc_imagref (q), 0.5, MPFR_RNDN);
+      mpc_set_ui (z, 0, MPC_RNDNN);
+      mpc_theta (ref, 3, z, q, MPC_RNDNN);
+      mpc_pow_ui (ref, ref, 4, MPC_RNDNN);
+      for (k = 2; k <= 4; k += 2) {
+         mpc_theta (t, k, z, q, MPC_RNDNN);
+         mpc_pow_ui (t, t, 4, MPC_RNDNN);
+         mpc_sub (ref, ref, t, MPC_RNDNN);
+      }
+      mpc_abs (mpc_realref (t), ref, MPFR_RNDN);
+      inex = mpc_theta (got, 1, z, q, MPC_RNDNN);
+      if (mpfr_cmp_ui_2exp (mpc_realref (t), 1, -100) > 0
+          || inex != 0 || mpc_cmp_si_si (got, 0, 0) != 0) {
+         printf ("Error in mpc_theta for q = ");
+         MPC_OUT (q);
+         MPC_OUT (ref);
+         MPC_OUT (got);
+         ok = 0;
+      }
+      if (ok && i % 2 == 0 && mpfr_sgn (mpc_realref (q)) > 0) {
+         mpfr_set_ui (mpc_realref (z), 0, MPFR_RNDN);
+         mpfr_urandomb (mpc_imagref (z), rands);
+         mpc_theta (got, 3, z, q, MPC_RNDNN);
+         mpc_theta (ref, 1, z, q, MPC_RNDNN);
+         if (!mpfr_zero_p (mpc_imagref (got))
+             || !mpfr_zero_p (mpc_realref (ref))) {
+            printf ("Error in mpc_theta for z = ");
+            MPC_OUT (z);
+            MPC_OUT (q);
+            MPC_OUT (got);
+            MPC_OUT (ref);
+            ok = 0;
+         }
+      }
+   }
+
+   /* j (tau) = 32 (theta_2^8 + theta_3^8 + theta_4^8)^3
+                / (theta_2 theta_3 theta_4)^8 in 0 with q = exp (pi*i*tau),
+      for tau = 1/8 + 9/8*i */
+   if (ok) {
+      mpc_set_ui_ui (z, 1, 9, MPC_RNDNN);
+      mpc_div_2ui (z, z, 3, MPC_RNDNN);
+      mpc_j (got, z, MPC_RNDNN);
+      mpc_set_prec (w, 130);
+      mpfr_const_pi (mpc_realref (w), MPFR_RNDN);
+      mpc_mul_fr (w, z, mpc_realref (w), MPC_RNDNN);
+      mpc_mul_i (w, w, 1, MPC_RNDNN);
+      mpc_set_prec (q, 130);
+      mpc_exp (q, w, MPC_RNDNN);
+      mpc_set_ui (z, 0, MPC_RNDNN);
+      mpc_set_ui (ref, 0, MPC_RNDNN);
+      mpc_set_ui (w, 1, MPC_RNDNN);
+      for (k = 2; k <= 4; k++) {
+         mpc_theta (t, k, z, q, MPC_RNDNN);
+         mpc_pow_ui (t, t, 8, MPC_RNDNN);
+         mpc_add (ref, ref, t, MPC_RNDNN);
+         mpc_mul (w, w, t, MPC_RNDNN);
+      }
+      mpc_pow_ui (ref, ref, 3, MPC_RNDNN);
+      mpc_mul_2ui (ref, ref, 5, MPC_RNDNN);
+      mpc_div (ref, ref, w, MPC_RNDNN);
+      mpc_sub (t, ref, got, MPC_RNDNN);
+      mpc_div (t, t, got, MPC_RNDNN);
+      mpc_abs (mpc_realref (t), t, MPFR_RNDN);
+      if (mpfr_cmp_ui_2exp (mpc_realref (t), 1, -100) > 0) {
+         printf ("Error in mpc_j or mpc_theta for z = 1/8 + 9/8*i\n");
+         MPC_OUT (got);
+         MPC_OUT (ref);
+         ok = 0;
+      }
+   }
+
+   /* NaN for |q| >= 1 */
+   mpc_set_ui (z, 0, MPC_RNDNN);
+   mpc_set_si_si (q, 0, -1, MPC_RNDNN);
+   mpc_theta (got, 3, z, q, MPC_RNDNN);
+   if (!mpfr_nan_p (mpc_realref (got)) || !mpfr_nan_p (mpc_imagref (got))) {
+      printf ("Error in mpc_theta for q = -i\n");
+      MPC_OUT (got);
+      ok = 0;
+   }
+
+   mpc_clear (z);
+   mpc_clear (w);
+   mpc_clear (q);
+   mpc_clear (got);
+   mpc_clear (ref);
+   mpc_clear (t);
+
+   return !ok;
+}
+
+
+static int
+test_theta_j_range (void)
+   /* Intermediate quantities leave the default exponent range, while
+      the values of theta are representable; close to the real axis,
+      j overflows. */
+{
+   mpc_t z, q, got, ref;
+   int k, inex, ok = 1;
+
+   mpc_init2 (z, 53);
+   mpc_init2 (q, 53);
+   mpc_init2 (got, 53);
+   mpc_init2 (ref, 53);
+
+   /* theta_2 and theta_3 (3.9e8*i, 2^(-3e8)), where w^2 = exp (-2*z)
+      overflows */
+   mpc_set_d_d (z, 0, 3.9e8, MPC_RNDNN);
+   mpc_set_ui (q, 1, MPC_RNDNN);
+   mpc_div_2ui (q, q, 300000000ul, MPC_RNDNN);
+   for (k = 2; k <= 3; k++) {
+      mpfr_set_str (mpc_realref (ref), k == 2 ? "0x1ca47d0de18597p1012953145"
+                    : "0x1b9a838232c3ccp1050604211", 0, MPFR_RNDN);
+      mpfr_set_ui (mpc_imagref (ref), 0, MPFR_RNDN);
+      mpfr_clear_flags ();
+      mpc_theta (got, k, z, q, MPC_RNDNN);
+      if (mpc_cmp (got, ref) != 0 || mpfr_overflow_p ()) {
+         printf ("Error in mpc_theta for k = %i, z = ", k);
+         MPC_OUT (z);
+         MPC_OUT (q);
+         MPC_OUT (got);
+         MPC_OUT (ref);
+         ok = 0;
+      }
+   }
+
+   /* j (-1/2 + 1e-10*i) is real, negative and about -2^(2.27e10). */
+   mpc_set_d_d (z, -0.5, 1e-10, MPC_RNDNN);
+   mpfr_clear_flags ();
+   inex = mpc_j (got, z, MPC_RNDNN);
+   if (!mpfr_inf_p (mpc_realref (got)) || mpfr_sgn (mpc_realref (got)) > 0
+       || !mpfr_zero_p (mpc_imagref (got))
+       || mpfr_signbit (mpc_imagref (got))
+       || inex != MPC_INEX (-1, 0) || !mpfr_overflow_p ()) {
+      printf ("Error in mpc_j for an overflowing value, z = ");
+      MPC_OUT (z);
+      MPC_OUT (got);
+      ok = 0;
+   }
+   mpfr_clear_flags ();
+   inex = mpc_j (got, z, MPC_RNDZZ);
+   mpfr_set_inf (mpc_realref (ref), -1);
+   mpfr_nextabove (mpc_realref (ref));
+   if (mpfr_cmp (mpc_realref (got), mpc_realref (ref)) != 0
+       || inex != MPC_INEX (1, 0) || !mpfr_overflow_p ()) {
+      printf ("Error in mpc_j for an overflowing value rounded to zero\n");
+      MPC_OUT (got);
+      ok = 0;
+   }
+
+   mpc_clear (z);
+   mpc_clear (q);
+   mpc_clear (got);
+   mpc_clear (ref);
+
+   return !ok;
+}
+
+
 int
 main (void)
 {
@@ -148,6 +630,11 @@ main (void)
 
   test_start ();
   ret = test_eta ();
+  ret |= test_eta_fund_vec ();
+  ret |= test_eta_reduction ();
+  ret |= test_eta_real_axis ();
+  ret |= test_theta_j ();
+  ret |= test_theta_j_range ();
   test_end ();
 
   return ret;
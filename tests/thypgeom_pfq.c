@@ -0,0 +1,362 @@
+/* thypgeom_pfq -- test file for mpc_hypgeom_pfq.
+
+Copyright (C) 2025 INRIA
+
+This file is part of GNU MPC.
+
+GNU MPC is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the
+Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+GNU MPC is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for
+more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program. If not, see http://www.gnu.org/licenses/ .
+*/
+
+#include "mpc-tests.h"
+
+extern const char *mpc_rnd_mode[];
+
+static mpc_rnd_t rnd[4] = { MPC_RNDNN, MPC_RNDZU, MPC_RNDUD, MPC_RNDDZ };
+
+static void
+check_result (const char *name, mpc_srcptr z, mpc_rnd_t r,
+              mpc_ptr got, int inex, mpc_ptr ref, int inex_ref)
+{
+  known_signs_t ks = {1, 1};
+
+  if (inex != inex_ref || !same_mpc_value (got, ref, ks))
+    {
+      printf ("mpc_hypgeom_pfq failed for %s with z = ", name);
+      mpc_out_str (stdout, 10, 0, z, MPC_RNDNN);
+      printf (" and rounding mode %s\n", mpc_rnd_mode[r]);
+      printf ("     got inexact value: %d\nexpected inexact value: %d\n",
+              inex, inex_ref);
+      MPC_OUT (got);
+      MPC_OUT (ref);
+      exit (1);
+    }
+}
+
+/* Compare with correctly rounded functions: 0F0 (;; z) = exp (z),
+   0F1 (; 1/2; z^2/4) = cosh (z) and 1F0 (-n;; z) = (1-z)^n. */
+static void
+check_closed_forms (void)
+{
+  mpc_t z, w, a, b, got, ref;
+  mpc_ptr pa[1], pb[1];
+  mpfr_prec_t prec;
+  unsigned long n;
+  int i, j, inex, inex_ref;
+
+  mpc_init2 (z, 12);
+  mpc_init2 (w, 256);
+  mpc_init2 (a, 32);
+  mpc_init2 (b, 32);
+  mpc_init2 (got, 2);
+  mpc_init2 (ref, 2);
+  pa[0] = a;
+  pb[0] = b;
+  mpc_set_ui_ui (b, 1, 0, MPC_RNDNN);
+  mpc_div_2ui (b, b, 1, MPC_RNDNN);
+
+  for (i = 0; i < 60; i++)
+    {
+      test_default_random (z, -4, 2, 128, 0);
+      prec = 2 + i * 5;
+      mpc_set_prec (got, prec);
+      mpc_set_prec (ref, prec);
+      for (j = 0; j < 4; j++)
+        {
+          inex = mpc_hypgeom_pfq (got, NULL, 0, NULL, 0, z, rnd[j]);
+          inex_ref = mpc_exp (ref, z, rnd[j]);
+          check_result ("0F0", z, rnd[j], got, inex, ref, inex_ref);
+
+          mpc_sqr (w, z, MPC_RNDNN);
+          mpc_div_2ui (w, w, 2, MPC_RNDNN);
+          inex = mpc_hypgeom_pfq (got, NULL, 0, pb, 1, w, rnd[j]);
+          inex_ref = mpc_cosh (ref, z, rnd[j]);
+          check_result ("0F1 (; 1/2; z^2/4)", z, rnd[j], got, inex, ref,
+                        inex_ref);
+
+          n = 1 + i % 12;
+          mpc_set_si_si (a, - (long) n, 0, MPC_RNDNN);
+          mpc_ui_sub (w, 1, z, MPC_RNDNN);
+          inex = mpc_hypgeom_pfq (got, pa, 1, NULL, 0, z, rnd[j]);
+          inex_ref = mpc_pow_ui (ref, w, n, rnd[j]);
+          check_result ("1F0 (-n;; z)", z, rnd[j], got, inex, ref, inex_ref);
+        }
+    }
+
+  mpc_clear (z);
+  mpc_clear (w);
+  mpc_clear (a);
+  mpc_clear (b);
+  mpc_clear (got);
+  mpc_clear (ref);
+}
+
+static void
+check_special (void)
+{
+  mpc_t z, a[2], b[2], got, ref;
+  mpc_ptr pa[2], pb[2];
+  int i, inex;
+
+  mpc_init2 (z, 53);
+  mpc_init2 (got, 53);
+  mpc_init2 (ref, 53);
+  for (i = 0; i < 2; i++)
+    {
+      mpc_init2 (a[i], 53);
+      mpc_init2 (b[i], 53);
+      pa[i] = a[i];
+      pb[i] = b[i];
+    }
+
+  /* 1F0 (-1;; 1+i) = -i is exact, with a real part +0 */
+  mpc_set_si_si (a[0], -1, 0, MPC_RNDNN);
+  mpc_set_ui_ui (z, 1, 1, MPC_RNDNN);
+  inex = mpc_hypgeom_pfq (got, pa, 1, NULL, 0, z, MPC_RNDNN);
+  if (inex != 0 || !mpfr_zero_p (mpc_realref (got))
+      || mpfr_signbit (mpc_realref (got))
+      || mpfr_cmp_si (mpc_imagref (got), -1) != 0)
+    {
+      printf ("Error in mpc_hypgeom_pfq for 1F0 (-1;; 1+i)\n");
+      MPC_OUT (got);
+      exit (1);
+    }
+
+  /* exactly representable values of non-terminating series:
+     1F0 (1;; 1/2) = 2, 1F0 (2;; 1/2) = 4, 1F0 (1/2;; 3/4) = 2 and
+     2F1 (1, 1; 1; 1/2) = 1F0 (1;; 1/2) = 2 */
+  mpc_set_ui_ui (z, 1, 0, MPC_RNDNN);
+  mpc_div_2ui (z, z, 1, MPC_RNDNN);
+  for (i = 1; i <= 2; i++)
+    {
+      mpc_set_ui_ui (a[0], i, 0, MPC_RNDNN);
+      inex = mpc_hypgeom_pfq (got, pa, 1, NULL, 0, z, MPC_RNDNN);
+      if (inex != 0 || mpc_cmp_si_si (got, 2 * i, 0) != 0
+          || mpfr_signbit (mpc_imagref (got)))
+        {
+          printf ("Error in mpc_hypgeom_pfq for 1F0 (%i;; 1/2)\n", i);
+          MPC_OUT (got);
+          exit (1);
+        }
+    }
+  mpc_set_ui_ui (a[0], 1, 0, MPC_RNDNN);
+  mpc_set_ui_ui (a[1], 1, 0, MPC_RNDNN);
+  mpc_set_ui_ui (b[0], 1, 0, MPC_RNDNN);
+  inex = mpc_hypgeom_pfq (got, pa, 2, pb, 1, z, MPC_RNDNN);
+  if (inex != 0 || mpc_cmp_si_si (got, 2, 0) != 0
+      || mpfr_signbit (mpc_imagref (got)))
+    {
+      printf ("Error in mpc_hypgeom_pfq for 2F1 (1, 1; 1; 1/2)\n");
+      MPC_OUT (got);
+      exit (1);
+    }
+  mpc_div_2ui (a[0], a[1], 1, MPC_RNDNN);
+  mpc_set_ui_ui (z, 3, 0, MPC_RNDNN);
+  mpc_div_2ui (z, z, 2, MPC_RNDNN);
+  inex = mpc_hypgeom_pfq (got, pa, 1, NULL, 0, z, MPC_RNDZZ);
+  if (inex != 0 || mpc_cmp_si_si (got, 2, 0) != 0)
+    {
+      printf ("Error in mpc_hypgeom_pfq for 1F0 (1/2;; 3/4)\n");
+      MPC_OUT (got);
+      exit (1);
+    }
+
+  /* 2F1 (-2, 1; -3; 3) = 6 terminates before the pole of b */
+  mpc_set_si_si (a[0], -2, 0, MPC_RNDNN);
+  mpc_set_ui_ui (a[1], 1, 0, MPC_RNDNN);
+  mpc_set_si_si (b[0], -3, 0, MPC_RNDNN);
+  mpc_set_ui_ui (z, 3, 0, MPC_RNDNN);
+  inex = mpc_hypgeom_pfq (got, pa, 2, pb, 1, z, MPC_RNDNN);
+  if (inex != 0 || mpc_cmp_si_si (got, 6, 0) != 0
+      || mpfr_signbit (mpc_imagref (got)))
+    {
+      printf ("Error in mpc_hypgeom_pfq for 2F1 (-2, 1; -3; 3)\n");
+      MPC_OUT (got);
+      exit (1);
+    }
+
+  /* but 2F1 (-4, 1; -3; z) has a pole */
+  mpc_set_si_si (a[0], -4, 0, MPC_RNDNN);
+  inex = mpc_hypgeom_pfq (got, pa, 2, pb, 1, z, MPC_RNDNN);
+  if (inex != 0 || !mpfr_nan_p (mpc_realref (got))
+      || !mpfr_nan_p (mpc_imagref (got)))
+    {
+      printf ("Error in mpc_hypgeom_pfq for 2F1 (-4, 1; -3; 3)\n");
+      MPC_OUT (got);
+      exit (1);
+    }
+
+  /* 2F1 (1/2, 1; 3/2; z) diverges for |z| >= 1, and 2F0 for z != 0 */
+  mpc_set_ui_ui (a[0], 1, 0, MPC_RNDNN);
+  mpc_div_2ui (a[0], a[0], 1, MPC_RNDNN);
+  mpc_set_ui_ui (b[0], 3, 0, MPC_RNDNN);
+  mpc_div_2ui (b[0], b[0], 1, MPC_RNDNN);
+  mpc_set_si_si (z, 0, -1, MPC_RNDNN);
+  inex = mpc_hypgeom_pfq (got, pa, 2, pb, 1, z, MPC_RNDNN);
+  if (inex != 0 || !mpfr_nan_p (mpc_realref (got)))
+    {
+      printf ("Error in mpc_hypgeom_pfq for 2F1 (1/2, 1; 3/2; -i)\n");
+      MPC_OUT (got);
+      exit (1);
+    }
+  mpc_set_ui_ui (z, 1, 0, MPC_RNDNN);
+  mpc_div_2ui (z, z, 10, MPC_RNDNN);
+  inex = mpc_hypgeom_pfq (got, pa, 2, NULL, 0, z, MPC_RNDNN);
+  if (inex != 0 || !mpfr_nan_p (mpc_realref (got)))
+    {
+      printf ("Error in mpc_hypgeom_pfq for 2F0 (1/2, 1;; 2^-10)\n");
+      MPC_OUT (got);
+      exit (1);
+    }
+
+  /* 2F1 (1/2, 1; 3/2; z^2) = atanh (z) / z, here for z = 1/2 */
+  mpc_set_ui_ui (z, 1, 0, MPC_RNDNN);
+  mpc_div_2ui (z, z, 2, MPC_RNDNN);
+  mpc_set_prec (got, 200);
+  mpc_set_prec (ref, 200);
+  mpc_hypgeom_pfq (got, pa, 2, pb, 1, z, MPC_RNDNN);
+  mpc_set_ui_ui (z, 1, 0, MPC_RNDNN);
+  mpc_div_2ui (z, z, 1, MPC_RNDNN);
+  mpc_atanh (ref, z, MPC_RNDNN);
+  mpc_mul_2ui (ref, ref, 1, MPC_RNDNN);
+  if (mpc_cmp (got, ref) != 0)
+    {
+      printf ("Error in mpc_hypgeom_pfq for 2F1 (1/2, 1; 3/2; 1/4)\n");
+      MPC_OUT (got);
+      MPC_OUT (ref);
+      exit (1);
+    }
+
+  /* z = 0 and a_i = 0 give 1 */
+  mpc_set_ui_ui (z, 0, 0, MPC_RNDNN);
+  inex = mpc_hypgeom_pfq (got, pa, 2, pb, 1, z, MPC_RNDNN);
+  if (inex != 0 || mpc_cmp_si_si (got, 1, 0) != 0)
+    {
+      printf ("Error in mpc_hypgeom_pfq for z = 0\n");
+      MPC_OUT (got);
+      exit (1);
+    }
+  mpc_set_ui_ui (a[1], 0, 0, MPC_RNDNN);
+  mpc_set_ui_ui (z, 17, 3, MPC_RNDNN);
+  inex = mpc_hypgeom_pfq (got, pa, 2, NULL, 0, z, MPC_RNDNN);
+  if (inex != 0 || mpc_cmp_si_si (got, 1, 0) != 0)
+    {
+      printf ("Error in mpc_hypgeom_pfq for a = 0\n");
+      MPC_OUT (got);
+      exit (1);
+    }
+
+  mpc_clear (z);
+  mpc_clear (got);
+  mpc_clear (ref);
+  for (i = 0; i < 2; i++)
+    {
+      mpc_clear (a[i]);
+      mpc_clear (b[i]);
+    }
+}
+
+/* For real z, the result is real also for non-real parameters that
+   cancel or come in conjugate pairs: 1F1 (i; i; z) = exp (z), and
+   2F1 (a, -a; 1/2; sin^2 (x)) = cos (2 a x), so that
+   2F1 (i, -i; 1/2; 1/2) = cosh (pi/2). */
+static void
+check_real_results (void)
+{
+  mpc_t z, a[2], b[1], got, ref;
+  mpc_ptr pa[2], pb[1];
+  mpfr_t c;
+  mpfr_prec_t prec;
+  int i, j, inex, inex_ref;
+
+  mpc_init2 (z, 53);
+  mpc_init2 (a[0], 53);
+  mpc_init2 (a[1], 53);
+  mpc_init2 (b[0], 53);
+  mpc_init2 (got, 2);
+  mpc_init2 (ref, 2);
+  mpfr_init2 (c, 2);
+  pa[0] = a[0];
+  pa[1] = a[1];
+  pb[0] = b[0];
+
+  mpc_set_ui_ui (z, 1, 0, MPC_RNDNN);
+  mpc_div_2ui (z, z, 1, MPC_RNDNN);
+  for (i = 0; i < 10; i++)
+    {
+      prec = 2 + i * 23;
+      mpc_set_prec (got, prec);
+      mpc_set_prec (ref, prec);
+      for (j = 0; j < 4; j++)
+        {
+          mpc_set_ui_ui (a[0], 0, 1, MPC_RNDNN);
+          mpc_set_ui_ui (b[0], 0, 1, MPC_RNDNN);
+          inex = mpc_hypgeom_pfq (got, pa, 1, pb, 1, z, rnd[j]);
+          inex_ref = mpc_exp (ref, z, rnd[j]);
+          check_result ("1F1 (i; i; z)", z, rnd[j], got, inex, ref,
+                        inex_ref);
+
+          mpc_set_si_si (a[1], 0, -1, MPC_RNDNN);
+          mpc_set_ui_ui (b[0], 1, 0, MPC_RNDNN);
+          mpc_div_2ui (b[0], b[0], 1, MPC_RNDNN);
+          inex = mpc_hypgeom_pfq (got, pa, 2, pb, 1, z, rnd[j]);
+          /* cosh (pi/2) is not a hard case to round at these
+             precisions */
+          mpfr_set_prec (c, prec + 64);
+          mpfr_const_pi (c, MPFR_RNDN);
+          mpfr_div_2ui (c, c, 1, MPFR_RNDN);
+          mpfr_cosh (c, c, MPFR_RNDN);
+          inex_ref = MPC_INEX (mpfr_set (mpc_realref (ref), c,
+                                         MPC_RND_RE (rnd[j])), 0);
+          mpfr_set_zero (mpc_imagref (ref), 1);
+          check_result ("2F1 (i, -i; 1/2; z)", z, rnd[j], got, inex, ref,
+                        inex_ref);
+        }
+    }
+
+  /* 2F1 (i, -i; 1; 1/2) = 1.6764285478314645140... */
+  mpc_set_prec (got, 53);
+  mpc_set_ui_ui (b[0], 1, 0, MPC_RNDNN);
+  inex = mpc_hypgeom_pfq (got, pa, 2, pb, 1, z, MPC_RNDNN);
+  mpfr_set_prec (c, 53);
+  mpfr_set_str (c, "0x1ad2a6bdb04545p-52", 0, MPFR_RNDN);
+  if (inex != MPC_INEX (-1, 0) || mpfr_cmp (mpc_realref (got), c) != 0
+      || !mpfr_zero_p (mpc_imagref (got)) || mpfr_signbit (mpc_imagref (got)))
+    {
+      printf ("Error in mpc_hypgeom_pfq for 2F1 (i, -i; 1; 1/2)\n");
+      MPC_OUT (got);
+      exit (1);
+    }
+
+  mpc_clear (z);
+  mpc_clear (a[0]);
+  mpc_clear (a[1]);
+  mpc_clear (b[0]);
+  mpc_clear (got);
+  mpc_clear (ref);
+  mpfr_clear (c);
+}
+
+int
+main (void)
+{
+  test_start ();
+
+  check_special ();
+  check_closed_forms ();
+  check_real_results ();
+
+  test_end ();
+
+  return 0;
+}
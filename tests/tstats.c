@@ -0,0 +1,108 @@
+/* tstats -- Test file for mpc_stats_get, mpc_stats_reset and mpc_stats_dump
+
+Copyright (C) 2025 INRIA
+
+This file is part of GNU MPC.
+
+GNU MPC is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the
+Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+GNU MPC is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for
+more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program. If not, see http://www.gnu.org/licenses/ .
+*/
+
+#include "mpc-tests.h"
+
+#ifdef MPC_STATS
+static void
+check_stats (const char *name, unsigned long int calls, int bucket)
+{
+  mpc_stats_t s;
+
+  if (mpc_stats_get (&s, name) != 0)
+    {
+      printf ("Error: mpc_stats_get does not know %s\n", name);
+      exit (1);
+    }
+  if (s.calls != calls
+      || (bucket >= 0 && s.prec [bucket] != calls)
+      || s.max_time > s.time || s.time < 0)
+    {
+      printf ("Error in the statistics of %s\n"
+              "expected %lu calls, got %lu (%lu in bucket %d)\n",
+              name, calls, s.calls, bucket >= 0 ? s.prec [bucket] : 0ul,
+              bucket);
+      exit (1);
+    }
+}
+#endif
+
+int
+main (void)
+{
+  mpc_stats_t s;
+  mpc_t x, y;
+  int i;
+#ifdef MPC_STATS
+  unsigned long int n;
+#endif
+
+  test_start ();
+
+  mpc_init2 (x, 100);
+  mpc_init2 (y, 5000);
+  mpc_stats_reset ();
+  mpc_set_ui_ui (x, 1, 2, MPC_RNDNN);
+  for (i = 0; i < 10; i++)
+    mpc_exp (y, x, MPC_RNDNN);
+  mpc_set_ui_ui (y, 3, 0, MPC_RNDNN);
+  mpc_mul (x, x, y, MPC_RNDNN);
+  mpc_set_nan (y);
+  mpc_div (x, x, y, MPC_RNDNN);
+
+#ifdef MPC_STATS
+  /* precision 5000 is in ]2^12, 2^13], precision 100 in ]2^6, 2^7] */
+  check_stats ("mpc_exp", 10, 13);
+  check_stats ("exp", 10, 13);
+  check_stats ("mul", 1, 7);
+  check_stats ("mul_real", 1, -1);
+  check_stats ("div_nan", 1, -1);
+  check_stats ("div_zero", 0, -1);
+  mpc_stats_get (&s, "exp");
+  for (n = 0, i = 0; i < MPC_STATS_ZIV_LOOPS; i++)
+    n += s.ziv [i];
+  if (n != 10 || s.ziv_max_bits == 0 || s.ziv_bits < s.ziv_max_bits)
+    {
+      printf ("Error in the Ziv loop statistics of exp\n"
+              "expected 10 loops, got %lu\n", n);
+      exit (1);
+    }
+  if (mpc_stats_get (&s, "mpc_no_such_function") != -1)
+    {
+      printf ("Error: mpc_stats_get accepts an unknown function\n");
+      exit (1);
+    }
+  mpc_stats_reset ();
+  check_stats ("exp", 0, 13);
+#else
+  if (mpc_stats_get (&s, "mpc_exp") != -1)
+    {
+      printf ("Error: mpc_stats_get succeeds without --enable-stats\n");
+      exit (1);
+    }
+#endif
+
+  mpc_clear (x);
+  mpc_clear (y);
+
+  test_end ();
+
+  return 0;
+}
@@ -0,0 +1,143 @@
+/* tzeta -- test file for mpc_zeta and mpc_zeta_vertical.
+
+Copyright (C) 2025 INRIA
+
+This file is part of GNU MPC.
+
+GNU MPC is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the
+Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+GNU MPC is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for
+more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program. If not, see http://www.gnu.org/licenses/ .
+*/
+
+#include "mpc-tests.h"
+
+extern const char *mpc_rnd_mode[];
+
+/* Check mpc_zeta_vertical against mpc_zeta, with different precisions
+   for the results, including values of t for which the function falls
+   back on mpc_zeta, and one for which the sum has too many terms. */
+static void
+check_vertical (void)
+{
+#define N 9
+  mpc_t z[N], ref, s;
+  mpfr_t t[N], sigma;
+  mpc_ptr rop[N];
+  mpfr_ptr tp[N];
+  int inex[N], inex_ref;
+  known_signs_t ks = {1, 1};
+  const char *tv[N] = { "14.134725", "-21.5", "0", "1e-10", "100", "nan",
+                        "0.5", "1000", "1e10" };
+  const char *sv[3] = { "0.5", "-2.75", "3" };
+  mpc_rnd_t rnd[3] = { MPC_RNDNN, MPC_RNDUD, MPC_RNDZU };
+  int i, j;
+
+  mpfr_init2 (sigma, 53);
+  mpc_init2 (ref, 2);
+  mpc_init2 (s, 53);
+  for (i = 0; i < N; i++)
+    {
+      mpc_init3 (z[i], 10 + 31 * i, 100 - 11 * i);
+      mpfr_init2 (t[i], 53);
+      mpfr_set_str (t[i], tv[i], 10, MPFR_RNDN);
+      rop[i] = z[i];
+      tp[i] = t[i];
+    }
+  for (j = 0; j < 3; j++)
+    {
+      mpfr_set_str (sigma, sv[j], 10, MPFR_RNDN);
+      mpc_zeta_vertical (rop, inex, sigma, tp, N, rnd[j]);
+      for (i = 0; i < N; i++)
+        {
+          mpfr_set (mpc_realref (s), sigma, MPFR_RNDN);
+          mpfr_set (mpc_imagref (s), t[i], MPFR_RNDN);
+          mpfr_set_prec (mpc_realref (ref), MPC_PREC_RE (z[i]));
+          mpfr_set_prec (mpc_imagref (ref), MPC_PREC_IM (z[i]));
+          inex_ref = mpc_zeta (ref, s, rnd[j]);
+          if (inex[i] != inex_ref || !same_mpc_value (z[i], ref, ks))
+            {
+              printf ("mpc_zeta_vertical failed for s = ");
+              mpc_out_str (stdout, 10, 0, s, MPC_RNDNN);
+              printf (" with rounding mode %s\n", mpc_rnd_mode[rnd[j]]);
+              printf ("     got inexact value: %d\nexpected inexact value: %d\n",
+                      inex[i], inex_ref);
+              MPC_OUT (z[i]);
+              MPC_OUT (ref);
+              exit (1);
+            }
+        }
+      /* inex may be NULL */
+      mpc_zeta_vertical (rop, NULL, sigma, tp, N, rnd[j]);
+    }
+  for (i = 0; i < N; i++)
+    {
+      mpc_clear (z[i]);
+      mpfr_clear (t[i]);
+    }
+  mpc_clear (ref);
+  mpc_clear (s);
+  mpfr_clear (sigma);
+#undef N
+}
+
+/* For huge imaginary parts, the Euler-Maclaurin sum would need too
+   many terms, and the result is NaN with the erange flag set. */
+static void
+check_large_imag (void)
+{
+  mpc_t s, z;
+  int inex;
+
+  mpc_init2 (s, 53);
+  mpc_init2 (z, 53);
+  mpc_set_d_d (s, 1, 1e10, MPC_RNDNN);
+  mpfr_clear_erangeflag ();
+  inex = mpc_zeta (z, s, MPC_RNDNN);
+  if (inex != 0 || !mpfr_nan_p (mpc_realref (z))
+      || !mpfr_nan_p (mpc_imagref (z)) || !mpfr_erangeflag_p ())
+    {
+      printf ("mpc_zeta failed for s = 1 + 1e10*i\n");
+      MPC_OUT (z);
+      exit (1);
+    }
+  mpfr_clear_erangeflag ();
+  mpc_clear (s);
+  mpc_clear (z);
+}
+
+#define MPC_FUNCTION_CALL                                               \
+  P[0].mpc_inex = mpc_zeta (P[1].mpc, P[2].mpc, P[3].mpc_rnd)
+#define MPC_FUNCTION_CALL_REUSE_OP1                                     \
+  P[0].mpc_inex = mpc_zeta (P[1].mpc, P[1].mpc, P[3].mpc_rnd)
+
+#include "data_check.tpl"
+#include "tgeneric.tpl"
+
+int
+main (void)
+{
+  test_start ();
+
+  check_vertical ();
+  check_large_imag ();
+
+  data_check_template ("zeta.dsc", "zeta.dat");
+
+  tgeneric_template ("zeta.dsc", 2, 256, 19, 4);
+
+  /* release the constants cached by the previous calls */
+  mpc_free_cache ();
+
+  test_end ();
+
+  return 0;
+}
@@ -0,0 +1,103 @@
+/* tziv -- Test file for the adaptive precision of Ziv loops.
+
+Copyright (C) 2025 INRIA
+
+This file is part of GNU MPC.
+
+GNU MPC is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the
+Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+GNU MPC is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for
+more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program. If not, see http://www.gnu.org/licenses/ .
+*/
+
+#include "mpc-tests.h"
+
+typedef int (*func_t) (mpc_ptr, mpc_srcptr, mpc_rnd_t);
+
+static struct {
+  const char *name;
+  func_t f;
+} funcs [] = {
+  { "acos", mpc_acos }, { "asin", mpc_asin }, { "atan", mpc_atan },
+  { "exp", mpc_exp }, { "expm1", mpc_expm1 }, { "log", mpc_log },
+  { "log10", mpc_log10 }, { "log1p", mpc_log1p }, { "log2", mpc_log2 },
+  { "sin", mpc_sin }, { "sqrt", mpc_sqrt }, { "tan", mpc_tan }
+};
+
+/* The results and rounding direction values must not depend on the
+   adaptive mode; the learnt precisions of one function are carried over
+   from one argument to the next. */
+static void
+check_adaptive (mpfr_prec_t prec, int n)
+{
+  known_signs_t ks = { 1, 1 };
+  mpc_t z, ref, got;
+  mpc_rnd_t rnd;
+  int i, k, inex_ref, inex_got;
+
+  mpc_init2 (z, prec);
+  mpc_init2 (ref, prec);
+  mpc_init2 (got, prec);
+  for (k = 0; k < (int) (sizeof (funcs) / sizeof (funcs [0])); k++)
+    for (i = 0; i < n; i++)
+      {
+        test_default_random (z, -20, 20, 128, 25);
+        rnd = MPC_RND (gmp_urandomm_ui (rands, 5), gmp_urandomm_ui (rands, 5));
+        mpc_set_ziv_adaptive (0);
+        inex_ref = funcs [k].f (ref, z, rnd);
+        mpc_set_ziv_adaptive (1);
+        inex_got = funcs [k].f (got, z, rnd);
+        if (!same_mpc_value (got, ref, ks) || inex_got != inex_ref)
+          {
+            printf ("Error in mpc_%s with adaptive precision for\n",
+                    funcs [k].name);
+            MPC_OUT (z);
+            printf ("expected inex %i ", inex_ref);
+            MPC_OUT (ref);
+            printf ("got inex %i      ", inex_got);
+            MPC_OUT (got);
+            exit (1);
+          }
+      }
+  mpc_clear (z);
+  mpc_clear (ref);
+  mpc_clear (got);
+}
+
+int
+main (void)
+{
+  test_start ();
+
+  mpc_set_ziv_adaptive (1);
+  if (mpc_get_ziv_adaptive () != 1)
+    {
+      printf ("Error: mpc_set_ziv_adaptive (1) is not effective\n");
+      exit (1);
+    }
+
+  check_adaptive (2, 50);
+  check_adaptive (53, 200);
+  check_adaptive (113, 200);
+  check_adaptive (1000, 20);
+
+  mpc_set_ziv_adaptive (0);
+  if (mpc_get_ziv_adaptive () != 0)
+    {
+      printf ("Error: mpc_set_ziv_adaptive (0) is not effective\n");
+      exit (1);
+    }
+  mpc_free_cache ();
+
+  test_end ();
+
+  return 0;
+}
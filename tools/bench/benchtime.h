@@ -1,6 +1,6 @@
 /* benchtime.h -- compute the timings for the benchmark.
 
-Copyright (C) 2014 INRIA - CNRS
+Copyright (C) 2014, 2025 INRIA - CNRS
 
 This file is part of GNU MPC.
 
@@ -18,49 +18,304 @@ You should have received a copy of the GNU Lesser General Public License
 along with this program. If not, see http://www.gnu.org/licenses/ .
 */
 
+#include <stdlib.h>
+#include <time.h>
+#include <gmp.h>
+#ifdef HAVE_SYS_TIME_H
+#include <sys/time.h>
+#endif
 
-/* compute the time to run accurately niter calls of the function for any number of inputs */
-#define DECLARE_ACCURATE_TIME_NOP(func, funccall)      \
-unsigned long int ACCURATE_TIME_NOP##func( unsigned long int niter, int n, mpc_t* z, mpc_t* x, mpc_t* y, int nop);\
-unsigned long int ACCURATE_TIME_NOP##func( unsigned long int niter, int n, mpc_t* z, mpc_t* x, \
-__attribute__ ((__unused__)) mpc_t* y, \
-__attribute__ ((__unused__)) int nop)\
-{                                             \
-  unsigned long int i;  int kn;           \
-  unsigned long int t0 = get_cputime ();      \
-  for (i = niter, kn=0; i > 0; i--)           \
-    {                                         \
-	  funccall;	                              \
-	  kn++; if (kn==n) kn = 0; 			      \
-    }                                         \
-  return get_cputime () - t0;                 \
-}
-
-/* address of the function to time accurately niter calls of func */
-#define ADDR_ACCURATE_TIME_NOP(func) ACCURATE_TIME_NOP##func
-
-/* address of the function to time one call of func */
-#define ADDR_TIME_NOP(func) TIME_NOP##func
-
-
-/* compute the time to run only one call of the function with two inputs  */
-#define DECLARE_TIME_NOP(func, funcall, nop)				  \
- DECLARE_ACCURATE_TIME_NOP(func, funcall)					  \
- double TIME_NOP##func(int n, mpc_t* z, mpc_t* x, mpc_t* y);  \
- double TIME_NOP##func(int n, mpc_t* z, mpc_t* x, mpc_t* y)   \
- {					                                          \
-  double t; unsigned long int nbcall, mytime;                 \
-    for (nbcall = 1, mytime=0; mytime<25000; ) 	  \
-      {									                      \
-          nbcall <<= 1; \
-	   mytime = ACCURATE_TIME_NOP##func(nbcall, n, z, x, y, nop);  \
-      }									                      \
-      t = (double) mytime/ nbcall ;					          \
-   return t;							                      \
- }
-
-/* compute the time to run accurately niter calls of the function */
-/* functions with 2 operands */
-#define DECLARE_TIME_2OP(func)   DECLARE_TIME_NOP(func, func(z[kn],x[kn],y[kn], MPC_RNDNN), 2 )
-/* functions with 1 operand */
-#define DECLARE_TIME_1OP(func)   DECLARE_TIME_NOP(func, func(z[kn],x[kn], MPC_RNDNN), 1 )
+#if defined (HAVE_CLOCK_GETTIME) && defined (CLOCK_MONOTONIC)
+#define BENCH_CLOCK "CLOCK_MONOTONIC"
+#elif defined (HAVE_GETTIMEOFDAY)
+#define BENCH_CLOCK "gettimeofday"
+#else
+#define BENCH_CLOCK "clock"
+#endif
+
+/* return the time in nanoseconds since the first call, from a monotonic
+   clock if available */
+static double
+bench_ns (void)
+{
+#if defined (HAVE_CLOCK_GETTIME) && defined (CLOCK_MONOTONIC)
+  static time_t sec0 = 0;
+  struct timespec ts;
+
+  clock_gettime (CLOCK_MONOTONIC, &ts);
+  if (sec0 == 0)
+    sec0 = ts.tv_sec;
+  return 1e9 * (double) (ts.tv_sec - sec0) + (double) ts.tv_nsec;
+#elif defined (HAVE_GETTIMEOFDAY)
+  static time_t sec0 = 0;
+  struct timeval tv;
+
+  gettimeofday (&tv, NULL);
+  if (sec0 == 0)
+    sec0 = tv.tv_sec;
+  return 1e9 * (double) (tv.tv_sec - sec0) + 1e3 * (double) tv.tv_usec;
+#else
+  return 1e9 * (double) clock () / (double) CLOCKS_PER_SEC;
+#endif
+}
+
+/* return the cost of one time measurement, which is subtracted from the
+   measured durations of the calls */
+static double
+bench_overhead (void)
+{
+  double t0, t1, m = 1e9;
+  int i;
+
+  for (i = 0; i < 1000; i++)
+    {
+      t0 = bench_ns ();
+      t1 = bench_ns ();
+      if (t1 - t0 < m)
+        m = t1 - t0;
+    }
+  return m;
+}
+
+/* summary of the durations of n calls, in nanoseconds */
+typedef struct
+{
+  unsigned long int n;
+  double median, p99, mean, min, max;
+} bench_stats_t;
+
+static int
+bench_cmp_double (const void *a, const void *b)
+{
+  double x = *(const double *) a, y = *(const double *) b;
+
+  return (x > y) - (x < y);
+}
+
+/* summarise the n > 0 durations in t, from which the overhead of the
+   measurement is subtracted; t is sorted in place */
+static void
+bench_summarise (bench_stats_t *s, double *t, unsigned long int n,
+                 double overhead)
+{
+  unsigned long int i;
+  double sum = 0;
+
+  for (i = 0; i < n; i++)
+    {
+      t [i] -= overhead;
+      if (t [i] < 0)
+        t [i] = 0;
+      sum += t [i];
+    }
+  qsort (t, n, sizeof (double), bench_cmp_double);
+  s->n = n;
+  s->median = (n % 2 == 1 ? t [n / 2] : (t [n / 2 - 1] + t [n / 2]) / 2);
+  s->p99 = t [(99 * n + 99) / 100 - 1];
+  s->mean = sum / (double) n;
+  s->min = t [0];
+  s->max = t [n - 1];
+}
+
+/* Hardware performance counters, read with the Linux perf_event_open
+   system call for the current thread in user space; counters which
+   cannot be opened, for instance in virtual machines without access to
+   the performance monitoring unit, are reported as negative values. */
+#define BENCH_NCOUNTERS 5
+
+static const char *bench_counter_name [BENCH_NCOUNTERS] =
+  { "cycles", "instructions", "branch_misses", "l1d_misses", "llc_misses" };
+
+#if defined (HAVE_LINUX_PERF_EVENT_H) && defined (HAVE_SYS_SYSCALL_H) \
+    && defined (HAVE_SYS_IOCTL_H) && defined (HAVE_UNISTD_H)
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#ifdef SYS_perf_event_open
+#define BENCH_HAVE_COUNTERS 1
+#endif
+#endif
+
+#ifdef BENCH_HAVE_COUNTERS
+static int bench_counter_fd [BENCH_NCOUNTERS] = { -1, -1, -1, -1, -1 };
+
+/* open the counters, and return the number of available ones */
+static int
+bench_counters_open (void)
+{
+  static const struct
+  {
+    uint32_t type;
+    uint64_t config;
+  } event [BENCH_NCOUNTERS] = {
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+    { PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D
+                          | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+                          | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16) },
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES }
+  };
+  struct perf_event_attr attr;
+  int i, n = 0;
+
+  for (i = 0; i < BENCH_NCOUNTERS; i++)
+    {
+      memset (&attr, 0, sizeof (attr));
+      attr.size = sizeof (attr);
+      attr.type = event [i].type;
+      attr.config = event [i].config;
+      attr.disabled = 1;
+      attr.exclude_kernel = 1;
+      attr.exclude_hv = 1;
+      /* the counters may be multiplexed on the hardware */
+      attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED
+                         | PERF_FORMAT_TOTAL_TIME_RUNNING;
+      bench_counter_fd [i] = (int) syscall (SYS_perf_event_open, &attr, 0,
+                                            -1, -1, 0);
+      n += (bench_counter_fd [i] >= 0);
+    }
+  return n;
+}
+
+static void
+bench_counters_start (void)
+{
+  int i;
+
+  for (i = 0; i < BENCH_NCOUNTERS; i++)
+    if (bench_counter_fd [i] >= 0)
+      {
+        ioctl (bench_counter_fd [i], PERF_EVENT_IOC_RESET, 0);
+        ioctl (bench_counter_fd [i], PERF_EVENT_IOC_ENABLE, 0);
+      }
+}
+
+/* stop the counters and store their values since bench_counters_start in
+   c, scaled if the counters were not running all the time */
+static void
+bench_counters_stop (double *c)
+{
+  uint64_t v [3];
+  int i;
+
+  for (i = 0; i < BENCH_NCOUNTERS; i++)
+    if (bench_counter_fd [i] >= 0)
+      ioctl (bench_counter_fd [i], PERF_EVENT_IOC_DISABLE, 0);
+  for (i = 0; i < BENCH_NCOUNTERS; i++)
+    if (bench_counter_fd [i] < 0
+        || read (bench_counter_fd [i], v, sizeof (v)) != sizeof (v)
+        || v [2] == 0)
+      c [i] = -1;
+    else
+      c [i] = (double) v [0] * ((double) v [1] / (double) v [2]);
+}
+
+static void
+bench_counters_close (void)
+{
+  int i;
+
+  for (i = 0; i < BENCH_NCOUNTERS; i++)
+    if (bench_counter_fd [i] >= 0)
+      {
+        close (bench_counter_fd [i]);
+        bench_counter_fd [i] = -1;
+      }
+}
+#else
+static int
+bench_counters_open (void)
+{
+  return 0;
+}
+
+static void
+bench_counters_start (void)
+{
+}
+
+static void
+bench_counters_stop (double *c)
+{
+  int i;
+
+  for (i = 0; i < BENCH_NCOUNTERS; i++)
+    c [i] = -1;
+}
+
+static void
+bench_counters_close (void)
+{
+}
+#endif
+
+/* Counts of the calls to the GMP memory functions, which are also used
+   by MPFR and MPC for the significands of their variables: number and
+   bytes of allocations, reallocations, where the bytes are the new sizes,
+   and frees. */
+#define BENCH_NMEMORY 6
+
+static const char *bench_memory_name [BENCH_NMEMORY] =
+  { "allocs", "alloc_bytes", "reallocs", "realloc_bytes", "frees",
+    "free_bytes" };
+
+static double bench_memory_count [BENCH_NMEMORY];
+static void *(*bench_memory_alloc_func) (size_t);
+static void *(*bench_memory_realloc_func) (void *, size_t, size_t);
+static void (*bench_memory_free_func) (void *, size_t);
+
+static void *
+bench_memory_alloc (size_t n)
+{
+  bench_memory_count [0]++;
+  bench_memory_count [1] += (double) n;
+  return bench_memory_alloc_func (n);
+}
+
+static void *
+bench_memory_realloc (void *p, size_t old, size_t n)
+{
+  bench_memory_count [2]++;
+  bench_memory_count [3] += (double) n;
+  return bench_memory_realloc_func (p, old, n);
+}
+
+static void
+bench_memory_free (void *p, size_t n)
+{
+  bench_memory_count [4]++;
+  bench_memory_count [5] += (double) n;
+  bench_memory_free_func (p, n);
+}
+
+/* install the counting memory functions on top of the current ones */
+static void
+bench_memory_start (void)
+{
+  int i;
+
+  for (i = 0; i < BENCH_NMEMORY; i++)
+    bench_memory_count [i] = 0;
+  mp_get_memory_functions (&bench_memory_alloc_func,
+                           &bench_memory_realloc_func,
+                           &bench_memory_free_func);
+  mp_set_memory_functions (bench_memory_alloc, bench_memory_realloc,
+                           bench_memory_free);
+}
+
+/* restore the previous memory functions and store the counts in c */
+static void
+bench_memory_stop (double *c)
+{
+  int i;
+
+  mp_set_memory_functions (bench_memory_alloc_func,
+                           bench_memory_realloc_func,
+                           bench_memory_free_func);
+  for (i = 0; i < BENCH_NMEMORY; i++)
+    c [i] = bench_memory_count [i];
+}
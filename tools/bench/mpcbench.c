@@ -1,6 +1,6 @@
 /* mpcbench.c -- perform the benchmark on the complex numbers.
 
-Copyright (C) 2014 CNRS - INRIA
+Copyright (C) 2014, 2025 CNRS - INRIA
 
 This file is part of GNU MPC.
 
@@ -21,133 +21,961 @@ along with this program. If not, see http://www.gnu.org/licenses/ .
 #include "config.h"
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 #include <math.h>
-#ifdef HAVE_SYS_TIME_H
-#include <sys/time.h>
-#endif
-#ifdef HAVE_SYS_RESOURCE_H
-#include <sys/resource.h>
-#endif
 #include "mpc.h"
 #include "benchtime.h"
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+#endif
+#if defined (HAVE_SYSCONF) && defined (HAVE_UNISTD_H)
+#include <unistd.h>
+#endif
 
-static unsigned long get_cputime (void);
+#ifndef MPC_BENCH_DATADIR
+#define MPC_BENCH_DATADIR "."
+#endif
 
 /* enumeration of the group of functions */
 enum egroupfunc
 {
-  egroup_arith = 0,             /* e.g., arith ... */
-  egroup_special,               /* e.g., cos, ... */
+  egroup_arith = 0,             /* e.g., add, sqrt ... */
+  egroup_elem,                  /* e.g., exp, acos ... */
+  egroup_special,               /* e.g., zeta, eta ... */
   egroup_last                   /* to get the number of enum */
 };
 
 /* name of the group of functions */
-const char *groupname [] = { 
-"Arith  ", 
-"Special"
+const char *groupname [] = {
+"arith",
+"elem",
+"special"
 };
 
+/* number of complex operands passed to sum, dot and hypgeom_pfq */
+#define BENCH_VLEN 8
+/* range of the binary exponents of the "wide" distribution */
+#define BENCH_WIDE_EXP 16
+
+/* operands for one precision: the i-th call of a function uses the
+   results z[i] and z2[i], the complex operands x[i], y[i] and w[i], the
+   real operand f[i], the integers u[i] > 0 and s[i] != 0 with at most 16
+   bits, v[i] < u[i], d[i] = f[i] as a double and m[i] = s[i] as an mpz_t;
+   xp, yp and wp point to x, y and w, cyclically extended by BENCH_VLEN
+   entries, for the functions with vectors of operands;
+   label[i] describes the operands read from a data file or from the
+   list of hard inputs, and label is NULL for random operands */
+typedef struct
+{
+  int n;
+  mpc_t *z, *z2, *x, *y, *w, *t;
+  mpfr_t *f;
+  unsigned long int *u, *v;
+  long int *s;
+  double *d;
+  mpz_t *m;
+  mpc_ptr *xp, *yp, *wp;
+  char **label;
+} bench_data_t;
+
+/* wrappers with a common interface around the functions */
+typedef void (*bench_func_t) (bench_data_t *, int);
+
+#define BENCH_C_C(fn)                                                   \
+static void b_##fn (bench_data_t *b, int i)                             \
+{ mpc_##fn (b->z [i], b->x [i], MPC_RNDNN); }
+#define BENCH_C_CC(fn)                                                  \
+static void b_##fn (bench_data_t *b, int i)                             \
+{ mpc_##fn (b->z [i], b->x [i], b->y [i], MPC_RNDNN); }
+#define BENCH_C_CFR(fn)                                                 \
+static void b_##fn (bench_data_t *b, int i)                             \
+{ mpc_##fn (b->z [i], b->x [i], b->f [i], MPC_RNDNN); }
+#define BENCH_C_FRC(fn)                                                 \
+static void b_##fn (bench_data_t *b, int i)                             \
+{ mpc_##fn (b->z [i], b->f [i], b->x [i], MPC_RNDNN); }
+#define BENCH_C_CUI(fn)                                                 \
+static void b_##fn (bench_data_t *b, int i)                             \
+{ mpc_##fn (b->z [i], b->x [i], b->u [i], MPC_RNDNN); }
+#define BENCH_C_CSI(fn)                                                 \
+static void b_##fn (bench_data_t *b, int i)                             \
+{ mpc_##fn (b->z [i], b->x [i], b->s [i], MPC_RNDNN); }
+#define BENCH_FR_C(fn)                                                  \
+static void b_##fn (bench_data_t *b, int i)                             \
+{ mpc_##fn (mpc_realref (b->z [i]), b->x [i], MPFR_RNDN); }
+
+BENCH_C_CC (add)
+BENCH_C_CFR (add_fr)
+BENCH_C_CSI (add_si)
+BENCH_C_CUI (add_ui)
+BENCH_C_CC (sub)
+BENCH_C_CFR (sub_fr)
+BENCH_C_FRC (fr_sub)
+BENCH_C_CUI (sub_ui)
+BENCH_C_CC (mul)
+BENCH_C_CFR (mul_fr)
+BENCH_C_CUI (mul_ui)
+BENCH_C_CSI (mul_si)
+BENCH_C_CUI (mul_2ui)
+BENCH_C_CSI (mul_2si)
+BENCH_C_C (sqr)
+BENCH_C_CC (div)
+BENCH_C_CFR (div_fr)
+BENCH_C_FRC (fr_div)
+BENCH_C_CUI (div_ui)
+BENCH_C_CUI (div_2ui)
+BENCH_C_CSI (div_2si)
+BENCH_C_C (conj)
+BENCH_C_C (neg)
+BENCH_C_C (proj)
+BENCH_FR_C (abs)
+BENCH_FR_C (norm)
+BENCH_FR_C (arg)
+BENCH_C_C (sqrt)
+BENCH_C_CC (pow)
+BENCH_C_CFR (pow_fr)
+BENCH_C_CSI (pow_si)
+BENCH_C_CUI (pow_ui)
+BENCH_C_C (exp)
+BENCH_C_C (exp10)
+BENCH_C_C (exp2)
+BENCH_C_C (expm1)
+BENCH_C_C (log)
+BENCH_C_C (log10)
+BENCH_C_C (log2)
+BENCH_C_C (log1p)
+BENCH_C_C (sin)
+BENCH_C_C (cos)
+BENCH_C_C (tan)
+BENCH_C_C (sinh)
+BENCH_C_C (cosh)
+BENCH_C_C (tanh)
+BENCH_C_C (asin)
+BENCH_C_C (acos)
+BENCH_C_C (atan)
+BENCH_C_C (asinh)
+BENCH_C_C (acosh)
+BENCH_C_C (atanh)
+BENCH_C_CC (agm)
+BENCH_C_C (ellipk)
+BENCH_C_C (ellipe)
+BENCH_C_C (lgamma)
+BENCH_C_C (tgamma)
+BENCH_C_C (erf)
+BENCH_C_C (erfc)
+BENCH_C_C (zeta)
+BENCH_C_CC (hurwitz_zeta)
+BENCH_C_C (eta_fund)
+BENCH_C_C (eta)
+BENCH_C_C (j)
+
+static void
+b_ui_ui_sub (bench_data_t *b, int i)
+{
+  mpc_ui_ui_sub (b->z [i], b->u [i], b->v [i], b->x [i], MPC_RNDNN);
+}
+
+static void
+b_mul_i (bench_data_t *b, int i)
+{
+  mpc_mul_i (b->z [i], b->x [i], (int) (b->s [i] > 0 ? 1 : -1), MPC_RNDNN);
+}
+
+static void
+b_ui_div (bench_data_t *b, int i)
+{
+  mpc_ui_div (b->z [i], b->u [i], b->x [i], MPC_RNDNN);
+}
+
+static void
+b_fma (bench_data_t *b, int i)
+{
+  mpc_fma (b->z [i], b->x [i], b->y [i], b->w [i], MPC_RNDNN);
+}
+
+static void
+b_sum (bench_data_t *b, int i)
+{
+  mpc_sum (b->z [i], b->xp + i, BENCH_VLEN, MPC_RNDNN);
+}
+
+static void
+b_dot (bench_data_t *b, int i)
+{
+  mpc_dot (b->z [i], b->xp + i, b->yp + i, BENCH_VLEN, MPC_RNDNN);
+}
+
+static void
+b_pow_d (bench_data_t *b, int i)
+{
+  mpc_pow_d (b->z [i], b->x [i], b->d [i], MPC_RNDNN);
+}
+
+static void
+b_pow_ld (bench_data_t *b, int i)
+{
+  mpc_pow_ld (b->z [i], b->x [i], (long double) b->d [i], MPC_RNDNN);
+}
+
+static void
+b_pow_z (bench_data_t *b, int i)
+{
+  mpc_pow_z (b->z [i], b->x [i], b->m [i], MPC_RNDNN);
+}
+
+static void
+b_sin_cos (bench_data_t *b, int i)
+{
+  mpc_sin_cos (b->z [i], b->z2 [i], b->x [i], MPC_RNDNN, MPC_RNDNN);
+}
+
+static void
+b_rootofunity (bench_data_t *b, int i)
+{
+  mpc_rootofunity (b->z [i], b->u [i], b->v [i], MPC_RNDNN);
+}
 
+static void
+b_ellip_periods (bench_data_t *b, int i)
+{
+  mpc_ellip_periods (b->z [i], b->z2 [i], b->x [i], b->y [i], b->w [i],
+                     MPC_RNDNN);
+}
+
+static void
+b_hypgeom_pfq (bench_data_t *b, int i)
+{
+  mpc_hypgeom_pfq (b->z [i], b->yp + i, 2, b->wp + i, 1, b->x [i],
+                   MPC_RNDNN);
+}
+
+static void
+b_theta (bench_data_t *b, int i)
+{
+  mpc_theta (b->z [i], 1 + i % 4, b->x [i], b->y [i], MPC_RNDNN);
+}
+
+/* restrictions on the operands of some functions: the operand x or y is
+   moved into the upper half plane, the fundamental domain of Sl_2(Z) or
+   the open unit disk */
+enum edomain
+{
+  edomain_any = 0,
+  edomain_x_upper,
+  edomain_x_fund,
+  edomain_x_disc,
+  edomain_y_disc
+};
 
 struct benchfunc
 {
-  const char *name;             /* name of the function */
-  double (*func_init) (int n, mpc_t * z, mpc_t * x, mpc_t * y); /* compute the time for one call (not accurate) */
-  unsigned long int (*func_accurate) (unsigned long int niter, int n, mpc_t * z, mpc_t * x, mpc_t * y, int nop); /* compute the time for "niter" calls (accurate) */
+  const char *name;             /* name of the function without mpc_ */
+  bench_func_t func;
   enum egroupfunc group;        /* group of the function */
-  int  noperands;               /* number of operands */
+  enum edomain domain;
 };
 
-
-/* declare the function to compute the cost for one call of the mpc function */
-DECLARE_TIME_2OP (mpc_add)
-DECLARE_TIME_2OP (mpc_sub)
-DECLARE_TIME_2OP (mpc_mul)
-DECLARE_TIME_2OP (mpc_div)
-DECLARE_TIME_1OP (mpc_sqrt)
-DECLARE_TIME_1OP (mpc_exp)
-DECLARE_TIME_1OP (mpc_log)
-DECLARE_TIME_2OP (mpc_pow)
-DECLARE_TIME_1OP (mpc_sin)
-DECLARE_TIME_1OP (mpc_cos)
-DECLARE_TIME_1OP (mpc_asin) 
-DECLARE_TIME_1OP (mpc_acos)
-
-/* number of operations to score*/
-#define NB_BENCH_OP 12
-/* number of random numbers */
-#define NB_RAND_CPLX 10000
+#define BENCH_F(f, g) { #f, b_##f, egroup_##g, edomain_any }
+#define BENCH_FD(f, g, d) { #f, b_##f, egroup_##g, edomain_##d }
 
 /* list of functions to compute the score */
-const struct benchfunc
-      arrayfunc[NB_BENCH_OP] = {
-      {"add", ADDR_TIME_NOP (mpc_add), ADDR_ACCURATE_TIME_NOP (mpc_add), egroup_arith, 2},
-      {"sub", ADDR_TIME_NOP (mpc_sub), ADDR_ACCURATE_TIME_NOP (mpc_sub), egroup_arith, 2},
-      {"mul", ADDR_TIME_NOP (mpc_mul), ADDR_ACCURATE_TIME_NOP (mpc_mul), egroup_arith, 2},
-      {"div", ADDR_TIME_NOP (mpc_div), ADDR_ACCURATE_TIME_NOP (mpc_div), egroup_arith, 2},
-      {"sqrt", ADDR_TIME_NOP (mpc_sqrt), ADDR_ACCURATE_TIME_NOP (mpc_sqrt), egroup_arith, 1},
-      {"exp", ADDR_TIME_NOP (mpc_exp), ADDR_ACCURATE_TIME_NOP (mpc_exp), egroup_special, 1},
-      {"log", ADDR_TIME_NOP (mpc_log), ADDR_ACCURATE_TIME_NOP (mpc_log), egroup_special, 1},
-      {"pow", ADDR_TIME_NOP (mpc_pow), ADDR_ACCURATE_TIME_NOP (mpc_pow), egroup_special, 2},
-      {"sin", ADDR_TIME_NOP (mpc_sin), ADDR_ACCURATE_TIME_NOP (mpc_sin), egroup_special, 1},
-      {"cos", ADDR_TIME_NOP (mpc_cos), ADDR_ACCURATE_TIME_NOP (mpc_cos), egroup_special, 1},
-      {"asin", ADDR_TIME_NOP (mpc_asin), ADDR_ACCURATE_TIME_NOP (mpc_asin), egroup_special, 1},
-      {"acos", ADDR_TIME_NOP (mpc_acos), ADDR_ACCURATE_TIME_NOP (mpc_acos), egroup_special, 1}
-    };
-
-/* the following arrays must have the same number of elements */
-
-/* list of precisions to test for the first operand */
-const int arrayprecision_op1[] =
-  { 32, 64, 128, 256, 512, 1024, 2048, 4096, 8192, 16384, 
-  50, 100, 200, 350, 700, 1500, 3000, 6000, 10000, 1500, 3000, 5000,
+const struct benchfunc arrayfunc [] = {
+  BENCH_F (add, arith), BENCH_F (add_fr, arith), BENCH_F (add_si, arith),
+  BENCH_F (add_ui, arith), BENCH_F (sub, arith), BENCH_F (sub_fr, arith),
+  BENCH_F (fr_sub, arith), BENCH_F (sub_ui, arith),
+  BENCH_F (ui_ui_sub, arith), BENCH_F (mul, arith), BENCH_F (mul_fr, arith),
+  BENCH_F (mul_ui, arith), BENCH_F (mul_si, arith), BENCH_F (mul_i, arith),
+  BENCH_F (mul_2ui, arith), BENCH_F (mul_2si, arith), BENCH_F (sqr, arith),
+  BENCH_F (div, arith), BENCH_F (div_fr, arith), BENCH_F (fr_div, arith),
+  BENCH_F (div_ui, arith), BENCH_F (ui_div, arith),
+  BENCH_F (div_2ui, arith), BENCH_F (div_2si, arith), BENCH_F (conj, arith),
+  BENCH_F (neg, arith), BENCH_F (proj, arith), BENCH_F (abs, arith),
+  BENCH_F (norm, arith), BENCH_F (arg, arith), BENCH_F (fma, arith),
+  BENCH_F (sum, arith), BENCH_F (dot, arith), BENCH_F (sqrt, arith),
+  BENCH_F (pow, elem), BENCH_F (pow_fr, elem), BENCH_F (pow_d, elem),
+  BENCH_F (pow_ld, elem), BENCH_F (pow_si, elem), BENCH_F (pow_ui, elem),
+  BENCH_F (pow_z, elem), BENCH_F (exp, elem), BENCH_F (exp10, elem),
+  BENCH_F (exp2, elem), BENCH_F (expm1, elem), BENCH_F (log, elem),
+  BENCH_F (log10, elem), BENCH_F (log2, elem), BENCH_F (log1p, elem),
+  BENCH_F (sin, elem), BENCH_F (cos, elem), BENCH_F (sin_cos, elem),
+  BENCH_F (tan, elem), BENCH_F (sinh, elem), BENCH_F (cosh, elem),
+  BENCH_F (tanh, elem), BENCH_F (asin, elem), BENCH_F (acos, elem),
+  BENCH_F (atan, elem), BENCH_F (asinh, elem), BENCH_F (acosh, elem),
+  BENCH_F (atanh, elem), BENCH_F (rootofunity, elem),
+  BENCH_F (agm, special), BENCH_F (ellipk, special),
+  BENCH_F (ellipe, special), BENCH_F (ellip_periods, special),
+  BENCH_F (lgamma, special), BENCH_F (tgamma, special),
+  BENCH_F (erf, special), BENCH_F (erfc, special), BENCH_F (zeta, special),
+  BENCH_F (hurwitz_zeta, special),
+  BENCH_FD (hypgeom_pfq, special, x_disc),
+  BENCH_FD (eta_fund, special, x_fund), BENCH_FD (eta, special, x_upper),
+  BENCH_FD (theta, special, y_disc), BENCH_FD (j, special, x_upper)
 };
 
-/* list of precisions to test for the second operand */
-const int arrayprecision_op2[] =
-  { 32, 64, 128, 256, 512, 1024, 2048, 4096, 8192, 16384,
-  50, 100, 200, 350, 700, 1500, 3000, 6000, 10000, 3000, 6000, 10000
-  
+#define NB_BENCH_OP ((int) (sizeof (arrayfunc) / sizeof (arrayfunc [0])))
+
+/* distributions of the operands */
+enum edist
+{
+  edist_unit = 0,               /* real and imaginary part in [0, 1) */
+  edist_signed,                 /* real and imaginary part in (-1, 1) */
+  edist_wide,                   /* random signs and binary exponents */
+  edist_real,                   /* signed with imaginary part 0 */
+  edist_imag,                   /* signed with real part 0 */
+  edist_hard,                   /* list hardinputs below */
+  edist_dat,                    /* data files of the test suite */
+  edist_last
 };
 
-/* get the time in microseconds */
-static unsigned long
-get_cputime (void)
+const char *distname [] =
+  { "unit", "signed", "wide", "real", "imag", "hard", "dat" };
+
+/* Inputs on which some functions are much slower than on random operands.
+   Each value is used as the first complex operand of the functions or
+   groups listed in func, or of all functions if func is NULL; the other
+   operands are random.  */
+static const struct
 {
-#ifdef HAVE_GETRUSAGE
-  struct rusage ru;
+  const char *func;
+  const char *re, *im;
+} hardinputs [] = {
+  /* close to the real or imaginary axis */
+  { NULL, "1", "1e-1000" },
+  { NULL, "-1", "1e-1000" },
+  { NULL, "1e-1000", "1" },
+  { NULL, "3", "-1e-20" },
+  { NULL, "-1e-20", "3" },
+  /* huge and tiny exponents */
+  { "arith elem", "1e10000", "1" },
+  { "arith elem", "1", "-1e10000" },
+  { "arith elem", "1e-1000", "1e-1000" },
+  { "arith elem", "1e1000", "1e-1000" },
+  /* large arguments needing a precise reduction */
+  { "exp exp2 exp10 expm1 sin cos sin_cos tan sinh cosh tanh",
+    "1e20", "1" },
+  { "exp exp2 exp10 expm1 sin cos sin_cos tan sinh cosh tanh",
+    "1", "1e20" },
+  /* near singularities, branch points and zeros */
+  { "log log2 log10 log1p", "0.99999999999999999999999999999", "1e-40" },
+  { "log1p expm1", "1e-40", "-1e-40" },
+  { "tan", "1.5707963267948966192313216916397514420985846996875529",
+    "1e-50" },
+  { "tanh", "1e-50",
+    "1.5707963267948966192313216916397514420985846996875529" },
+  { "lgamma tgamma", "-3.00000000000000000000000000001", "1e-40" },
+  { "lgamma tgamma", "-1e-40", "1e-40" },
+  { "zeta hurwitz_zeta", "1", "1e-40" },
+  { "zeta", "0.5", "100" },
+  { "erf erfc", "30", "1e-10" },
+  { "erf erfc", "1e-10", "30" }
+};
 
-  getrusage (RUSAGE_SELF, &ru);
-  return ru.ru_utime.tv_sec * 1000000 + ru.ru_utime.tv_usec
-         +ru.ru_stime.tv_sec * 1000000 + ru.ru_stime.tv_usec;
-#else
-  printf("\nthe function getrusage not available\n");
-  exit(1);
-  return 0;
-#endif
+#define NB_HARD ((int) (sizeof (hardinputs) / sizeof (hardinputs [0])))
+
+enum eformat { eformat_text, eformat_csv, eformat_json };
+
+/* default precisions: 32, 64, ..., 16384 */
+#define BENCH_PREC_MIN 32
+#define BENCH_PREC_MAX 16384
+#define BENCH_MAX_PREC_COUNT 64
+
+/* options of the program */
+static int bench_selected [NB_BENCH_OP];
+static mpfr_prec_t bench_prec [BENCH_MAX_PREC_COUNT];
+static int bench_nprec = 0;
+static enum edist bench_dist = edist_unit;
+static enum eformat bench_format = eformat_text;
+static int bench_noperands = 1000;
+static double bench_budget = 0.05; /* seconds per function and precision */
+static const char *bench_datadir = MPC_BENCH_DATADIR;
+static int bench_counters = 0;
+static int bench_memory = 0;
+static int bench_threads = 0;
+/* smallest scaling efficiency with several threads before a function is
+   flagged */
+#define BENCH_MIN_EFFICIENCY 0.5
+static unsigned long int bench_max_samples = 1000000;
+static double bench_clock_overhead;
+static int bench_first_result = 1;
+
+
+static void *
+bench_alloc (size_t n)
+{
+  void *p = malloc (n);
+
+  if (p == NULL)
+    {
+      fprintf (stderr, "mpcbench: cannot allocate %lu bytes\n",
+               (unsigned long int) n);
+      exit (1);
+    }
+  return p;
+}
+
+
+/* set z to a random complex number with distribution dist */
+static void
+bench_random (mpc_ptr z, enum edist dist, gmp_randstate_t randstate)
+{
+  unsigned long int r;
+
+  mpc_urandom (z, randstate);
+  if (dist == edist_unit)
+    return;
+  r = gmp_urandomb_ui (randstate, 2);
+  if (r & 1)
+    mpfr_neg (mpc_realref (z), mpc_realref (z), MPFR_RNDN);
+  if (r & 2)
+    mpfr_neg (mpc_imagref (z), mpc_imagref (z), MPFR_RNDN);
+  if (dist == edist_wide)
+    {
+      mpfr_mul_2si (mpc_realref (z), mpc_realref (z),
+                    (long int) gmp_urandomm_ui (randstate,
+                                                2 * BENCH_WIDE_EXP + 1)
+                    - BENCH_WIDE_EXP, MPFR_RNDN);
+      mpfr_mul_2si (mpc_imagref (z), mpc_imagref (z),
+                    (long int) gmp_urandomm_ui (randstate,
+                                                2 * BENCH_WIDE_EXP + 1)
+                    - BENCH_WIDE_EXP, MPFR_RNDN);
+    }
+  else if (dist == edist_real)
+    mpfr_set_zero (mpc_imagref (z), +1);
+  else if (dist == edist_imag)
+    mpfr_set_zero (mpc_realref (z), +1);
 }
 
-/* initialize an array of n random complex numbers */
+
 static mpc_t *
-bench_random_array (int n, mpfr_prec_t precision, gmp_randstate_t randstate)
+bench_mpc_array (int n, mpfr_prec_t prec)
+{
+  mpc_t *p = (mpc_t *) bench_alloc (n * sizeof (mpc_t));
+  int i;
+
+  for (i = 0; i < n; i++)
+    {
+      mpc_init2 (p [i], prec);
+      mpc_set_ui (p [i], 0, MPC_RNDNN);
+    }
+  return p;
+}
+
+
+static void
+bench_clear_mpc_array (mpc_t *p, int n)
+{
+  int i;
+
+  for (i = 0; i < n; i++)
+    mpc_clear (p [i]);
+  free (p);
+}
+
+
+static mpc_ptr *
+bench_pointers (mpc_t *p, int n)
+{
+  mpc_ptr *q = (mpc_ptr *) bench_alloc ((n + BENCH_VLEN) * sizeof (mpc_ptr));
+  int i;
+
+  for (i = 0; i < n + BENCH_VLEN; i++)
+    q [i] = p [i % n];
+  return q;
+}
+
+
+/* allocate the operands of n calls at precision prec, with complex
+   operands of distribution dist, which must be one of the random ones */
+static void
+bench_data_init (bench_data_t *b, int n, mpfr_prec_t prec, enum edist dist,
+                 gmp_randstate_t randstate)
+{
+  int i;
+
+  b->n = n;
+  b->z = bench_mpc_array (n, prec);
+  b->z2 = bench_mpc_array (n, prec);
+  b->x = bench_mpc_array (n, prec);
+  b->y = bench_mpc_array (n, prec);
+  b->w = bench_mpc_array (n, prec);
+  b->t = bench_mpc_array (n, prec);
+  b->f = (mpfr_t *) bench_alloc (n * sizeof (mpfr_t));
+  b->u = (unsigned long int *) bench_alloc (n * sizeof (unsigned long int));
+  b->v = (unsigned long int *) bench_alloc (n * sizeof (unsigned long int));
+  b->s = (long int *) bench_alloc (n * sizeof (long int));
+  b->d = (double *) bench_alloc (n * sizeof (double));
+  b->m = (mpz_t *) bench_alloc (n * sizeof (mpz_t));
+  for (i = 0; i < n; i++)
+    {
+      bench_random (b->x [i], dist, randstate);
+      bench_random (b->y [i], dist, randstate);
+      bench_random (b->w [i], dist, randstate);
+      bench_random (b->t [i], dist, randstate);
+      mpfr_init2 (b->f [i], prec);
+      mpfr_set (b->f [i], mpc_realref (b->t [i]), MPFR_RNDN);
+      b->d [i] = mpfr_get_d (b->f [i], MPFR_RNDN);
+      b->u [i] = 1 + gmp_urandomb_ui (randstate, 16);
+      b->v [i] = gmp_urandomm_ui (randstate, b->u [i]);
+      b->s [i] = (gmp_urandomb_ui (randstate, 1) ? 1 : -1) * (long int) b->u [i];
+      mpz_init_set_si (b->m [i], b->s [i]);
+    }
+  b->xp = bench_pointers (b->x, n);
+  b->yp = bench_pointers (b->y, n);
+  b->wp = bench_pointers (b->w, n);
+  b->label = NULL;
+}
+
+
+static void
+bench_data_clear (bench_data_t *b)
+{
+  int i;
+
+  for (i = 0; i < b->n; i++)
+    {
+      mpfr_clear (b->f [i]);
+      mpz_clear (b->m [i]);
+    }
+  bench_clear_mpc_array (b->z, b->n);
+  bench_clear_mpc_array (b->z2, b->n);
+  bench_clear_mpc_array (b->x, b->n);
+  bench_clear_mpc_array (b->y, b->n);
+  bench_clear_mpc_array (b->w, b->n);
+  bench_clear_mpc_array (b->t, b->n);
+  free (b->f);
+  free (b->u);
+  free (b->v);
+  free (b->s);
+  free (b->d);
+  free (b->m);
+  free (b->xp);
+  free (b->yp);
+  free (b->wp);
+  if (b->label != NULL)
+    {
+      for (i = 0; i < b->n; i++)
+        free (b->label [i]);
+      free (b->label);
+    }
+}
+
+
+static char *
+bench_strdup (const char *s)
+{
+  return strcpy ((char *) bench_alloc (strlen (s) + 1), s);
+}
+
+
+/* return non-zero if the function arrayfunc[op] appears in list, given as
+   function and group names separated by spaces */
+static int
+bench_in_list (int op, const char *list)
+{
+  const char *name [2];
+  size_t len;
+  int k;
+
+  name [0] = arrayfunc [op].name;
+  name [1] = groupname [arrayfunc [op].group];
+  while (*list != '\0')
+    {
+      len = strcspn (list, " ");
+      for (k = 0; k < 2; k++)
+        if (strlen (name [k]) == len && strncmp (list, name [k], len) == 0)
+          return 1;
+      list += len;
+      list += strspn (list, " ");
+    }
+  return 0;
+}
+
+
+/* set up the operands of arrayfunc[op] at precision prec from the hard
+   inputs for this function, and return their number */
+static int
+bench_data_hard (bench_data_t *b, int op, mpfr_prec_t prec,
+                 gmp_randstate_t randstate)
 {
-  int j;
+  char buf [256];
+  int i, k, n;
 
-  mpc_t *ptr;
+  for (k = 0, n = 0; k < NB_HARD; k++)
+    n += (hardinputs [k].func == NULL || bench_in_list (op, hardinputs [k].func));
+  if (n == 0)
+    return 0;
+  bench_data_init (b, n, prec, edist_unit, randstate);
+  b->label = (char **) bench_alloc (n * sizeof (char *));
+  for (k = 0, i = 0; k < NB_HARD; k++)
+    if (hardinputs [k].func == NULL || bench_in_list (op, hardinputs [k].func))
+      {
+        mpfr_set_str (mpc_realref (b->x [i]), hardinputs [k].re, 10,
+                      MPFR_RNDN);
+        mpfr_set_str (mpc_imagref (b->x [i]), hardinputs [k].im, 10,
+                      MPFR_RNDN);
+        sprintf (buf, "(%.100s %.100s)", hardinputs [k].re, hardinputs [k].im);
+        b->label [i++] = bench_strdup (buf);
+      }
+  return n;
+}
 
-  ptr = (mpc_t *) malloc (n * sizeof (mpc_t));
-  if (ptr == NULL)
+
+/* read the next token of the data file fp into buf, skipping spaces and
+   comments and counting lines in *line; return 0 at the end of the file */
+static int
+bench_token (FILE *fp, char *buf, size_t size, unsigned long int *line)
+{
+  size_t len = 0;
+  int c;
+
+  for (c = getc (fp); ; c = getc (fp))
+    {
+      if (c == '#')
+        while (c != '\n' && c != EOF)
+          c = getc (fp);
+      if (c == '\n')
+        (*line)++;
+      else if (c != ' ' && c != '\t' && c != '\r')
+        break;
+    }
+  for (; c != EOF && c != ' ' && c != '\t' && c != '\r' && c != '\n'
+         && c != '#'; c = getc (fp))
     {
-      printf ("Can't allocate memory for %d complex numbers\n", n);
+      if (len + 1 == size)
+        {
+          fprintf (stderr, "mpcbench: token too long in line %lu\n", *line);
+          exit (1);
+        }
+      buf [len++] = (char) c;
+    }
+  if (c != EOF)
+    ungetc (c, fp);
+  buf [len] = '\0';
+  return len > 0;
+}
+
+
+/* Read the description file of arrayfunc[op] in the test suite, and
+   return in layout one letter per field of a line of the data file:
+   'i' for a ternary value, 'z' for a complex result, 'r' for a real
+   result, 'c' for a complex operand, 'f' for a real operand, 'u', 's',
+   'm' and 'd' for an unsigned long, long, mpz_t or double operand and 'n'
+   for a rounding mode.  Return 0 if there is no description file or if
+   it contains an unsupported type. */
+static int
+bench_read_dsc (int op, char *layout, size_t size)
+{
+  static const struct
+  {
+    const char *type, *fields;
+  } types [] = {
+    { "mpc_inex", "ii" }, { "mpfr_inex", "i" }, { "int", "i" },
+    { "mpc_ptr", "z" }, { "mpfr_ptr", "r" },
+    { "mpc_srcptr", "c" }, { "mpfr_srcptr", "f" },
+    { "unsigned long int", "u" }, { "long int", "s" },
+    { "mpz_srcptr", "m" }, { "double", "d" },
+    { "mpc_rnd_t", "nn" }, { "mpfr_rnd_t", "n" }
+  };
+  char buf [256], *line, *end;
+  int section = 0, k;
+  FILE *fp;
+
+  sprintf (buf, "%.200s/%.40s.dsc", bench_datadir, arrayfunc [op].name);
+  fp = fopen (buf, "r");
+  if (fp == NULL)
+    return 0;
+  layout [0] = '\0';
+  while (fgets (buf, sizeof (buf), fp) != NULL)
+    {
+      line = buf + strspn (buf, " \t");
+      for (end = line + strlen (line);
+           end > line && (end [-1] == '\n' || end [-1] == ' '
+                          || end [-1] == '\r' || end [-1] == '\t'); end--);
+      *end = '\0';
+      if (*line == '#' || *line == '\0')
+        continue;
+      if (strcmp (line, "NAME:") == 0)
+        section = 1;
+      else if (strcmp (line, "RETURN:") == 0 || strcmp (line, "OUTPUT:") == 0
+               || strcmp (line, "INPUT:") == 0)
+        section = 2;
+      else if (section == 2)
+        {
+          for (k = 0; k < (int) (sizeof (types) / sizeof (types [0]))
+                 && strcmp (line, types [k].type) != 0; k++);
+          if (k == (int) (sizeof (types) / sizeof (types [0]))
+              || strlen (layout) + strlen (types [k].fields) >= size)
+            break;
+          strcat (layout, types [k].fields);
+        }
+    }
+  k = feof (fp);
+  fclose (fp);
+  return k && layout [0] != '\0';
+}
+
+
+static void
+bench_read_mpfr (mpfr_ptr x, FILE *fp, char *buf, size_t size,
+                 unsigned long int *line, const char *file)
+{
+  long int prec;
+
+  if (!bench_token (fp, buf, size, line)
+      || (prec = strtol (buf, NULL, 10)) < MPFR_PREC_MIN
+      || prec > MPFR_PREC_MAX
+      || (mpfr_set_prec (x, prec), !bench_token (fp, buf, size, line))
+      || mpfr_set_str (x, buf, 0, MPFR_RNDN) != 0)
+    {
+      fprintf (stderr, "mpcbench: cannot read a number in %s line %lu\n",
+               file, *line);
       exit (1);
-      return NULL;
     }
-  for (j = 0; j < n; j++)
+}
+
+
+/* set up the operands of arrayfunc[op] from the data file of the test
+   suite, and return their number */
+static int
+bench_data_dat (bench_data_t *b, int op, gmp_randstate_t randstate)
+{
+  char layout [64], file [256], buf [4096];
+  const char *l;
+  unsigned long int line, first;
+  int i, n, tokens, count, nz, nc, nu;
+  mpc_t *c;
+  FILE *fp;
+
+  if (!bench_read_dsc (op, layout, sizeof (layout)))
+    return 0;
+  sprintf (file, "%.200s/%.40s.dat", bench_datadir, arrayfunc [op].name);
+  fp = fopen (file, "r");
+  if (fp == NULL)
+    return 0;
+
+  /* count the fields */
+  for (l = layout, tokens = 0; *l != '\0'; l++)
+    tokens += (*l == 'z' || *l == 'c' ? 4 : *l == 'r' || *l == 'f' ? 2 : 1);
+  line = 1;
+  for (count = 0; bench_token (fp, buf, sizeof (buf), &line); count++);
+  n = count / tokens;
+  if (n == 0 || count % tokens != 0)
+    {
+      if (n != 0)
+        fprintf (stderr, "mpcbench: %s does not match %s.dsc\n", file,
+                 arrayfunc [op].name);
+      fclose (fp);
+      return 0;
+    }
+
+  bench_data_init (b, n, MPFR_PREC_MIN, edist_unit, randstate);
+  b->label = (char **) bench_alloc (n * sizeof (char *));
+  rewind (fp);
+  line = 1;
+  for (i = 0; i < n; i++)
     {
-      mpc_init2 (ptr[j], precision);
-      mpc_urandom (ptr[j], randstate);
+      nz = nc = nu = 0;
+      first = 0;
+      for (l = layout; *l != '\0'; l++)
+        {
+          if (*l == 'z')
+            {
+              c = (nz++ == 0 ? b->z : b->z2);
+              bench_read_mpfr (mpc_realref (c [i]), fp, buf, sizeof (buf),
+                               &line, file);
+              bench_read_mpfr (mpc_imagref (c [i]), fp, buf, sizeof (buf),
+                               &line, file);
+            }
+          else if (*l == 'r')
+            bench_read_mpfr (mpc_realref (b->z [i]), fp, buf, sizeof (buf),
+                             &line, file);
+          else if (*l == 'c')
+            {
+              c = (nc == 0 ? b->x : nc == 1 ? b->y : b->w);
+              nc++;
+              bench_read_mpfr (mpc_realref (c [i]), fp, buf, sizeof (buf),
+                               &line, file);
+              bench_read_mpfr (mpc_imagref (c [i]), fp, buf, sizeof (buf),
+                               &line, file);
+            }
+          else if (*l == 'f')
+            bench_read_mpfr (b->f [i], fp, buf, sizeof (buf), &line, file);
+          else
+            {
+              bench_token (fp, buf, sizeof (buf), &line);
+              if (*l == 'u')
+                (nu++ == 0 ? b->u : b->v) [i] = strtoul (buf, NULL, 0);
+              else if (*l == 's')
+                b->s [i] = strtol (buf, NULL, 0);
+              else if (*l == 'm')
+                mpz_set_str (b->m [i], buf + (buf [0] == '+'), 0);
+              else if (*l == 'd')
+                b->d [i] = strtod (buf, NULL);
+            }
+          if (first == 0)
+            first = line;
+        }
+      sprintf (buf, "%.40s.dat:%lu", arrayfunc [op].name, first);
+      b->label [i] = bench_strdup (buf);
     }
-  return ptr;
+  fclose (fp);
+  return n;
+}
+
+
+/* set t to a copy of z moved into the domain d */
+static void
+bench_move (mpc_ptr t, mpc_srcptr z, enum edomain d)
+{
+  mpfr_t a;
+
+  mpc_set (t, z, MPC_RNDNN);
+  switch (d)
+    {
+    case edomain_x_upper:
+      mpfr_abs (mpc_imagref (t), mpc_imagref (t), MPFR_RNDN);
+      mpfr_add_d (mpc_imagref (t), mpc_imagref (t), 0.5, MPFR_RNDN);
+      break;
+    case edomain_x_fund:
+      /* real part in (-1/2, 1/2), imaginary part at least 1 */
+      mpfr_frac (mpc_realref (t), mpc_realref (t), MPFR_RNDN);
+      mpfr_div_2ui (mpc_realref (t), mpc_realref (t), 1, MPFR_RNDN);
+      mpfr_abs (mpc_imagref (t), mpc_imagref (t), MPFR_RNDN);
+      mpfr_add_ui (mpc_imagref (t), mpc_imagref (t), 1, MPFR_RNDN);
+      break;
+    case edomain_x_disc:
+    case edomain_y_disc:
+      /* t = z / (1 + |z|) */
+      mpfr_init2 (a, mpc_get_prec (t));
+      mpc_abs (a, t, MPFR_RNDU);
+      mpfr_add_ui (a, a, 1, MPFR_RNDU);
+      mpc_div_fr (t, t, a, MPC_RNDZZ);
+      mpfr_clear (a);
+      break;
+    default:
+      break;
+    }
+}
+
+
+/* move the operands in b into the domain of e->func, and return the
+   original ones, or NULL if nothing is to be done */
+static mpc_t *
+bench_domain_enter (const struct benchfunc *e, bench_data_t *b)
+{
+  mpc_t *save;
+  int i;
+
+  if (e->domain == edomain_any)
+    return NULL;
+  save = (e->domain == edomain_y_disc ? b->y : b->x);
+  for (i = 0; i < b->n; i++)
+    bench_move (b->t [i], save [i], e->domain);
+  if (e->domain == edomain_y_disc)
+    b->y = b->t;
+  else
+    b->x = b->t;
+  b->t = save;
+  return save;
+}
+
+
+static void
+bench_domain_leave (const struct benchfunc *e, bench_data_t *b, mpc_t *save)
+{
+  if (save == NULL)
+    return;
+  b->t = (e->domain == edomain_y_disc ? b->y : b->x);
+  if (e->domain == edomain_y_disc)
+    b->y = save;
+  else
+    b->x = save;
+}
+
+
+/* call e->func n times, cycling through the operands in b */
+static void
+bench_repeat (const struct benchfunc *e, bench_data_t *b, unsigned long int n)
+{
+  unsigned long int k;
+  int i;
+
+  for (k = 0, i = 0; k < n; k++)
+    {
+      e->func (b, i);
+      if (++i == b->n)
+        i = 0;
+    }
+}
+
+
+/* time the calls of arrayfunc[op] on the operands in b, and return the
+   statistics of their durations in s; the worst case latency, that is the
+   largest over the operands of the fastest call on this operand, is
+   returned in *worst together with the index of the operand in *iworst.
+   With hard inputs and data files, every operand is called at least once
+   even if this exceeds the time budget.  If the hardware counters or the
+   memory counts are enabled, the calls are repeated without time
+   measurements and the counts per call are returned in counters and
+   memory. */
+static void
+bench_time (bench_stats_t *s, double *worst, int *iworst, double *counters,
+            double *memory, int op, bench_data_t *b, double *samples)
+{
+  const struct benchfunc *e = arrayfunc + op;
+  mpc_t *save = NULL;
+  double t0, t1, start, *fastest;
+  unsigned long int n;
+  int i, round = 0;
+
+  save = bench_domain_enter (e, b);
+  fastest = (double *) bench_alloc (b->n * sizeof (double));
+  for (i = 0; i < b->n; i++)
+    fastest [i] = -1;
+  e->func (b, 0); /* warm up caches */
+  start = bench_ns ();
+  for (n = 0, i = 0; n < bench_max_samples; )
+    {
+      t0 = bench_ns ();
+      e->func (b, i);
+      t1 = bench_ns ();
+      samples [n++] = t1 - t0;
+      if (fastest [i] < 0 || t1 - t0 < fastest [i])
+        fastest [i] = t1 - t0;
+      if (++i == b->n)
+        {
+          i = 0;
+          round++;
+        }
+      if (t1 - start >= 1e9 * bench_budget
+          && (b->label == NULL || round > 0))
+        break;
+    }
+  if (bench_counters)
+    {
+      bench_counters_start ();
+      bench_repeat (e, b, n);
+      bench_counters_stop (counters);
+      for (i = 0; i < BENCH_NCOUNTERS; i++)
+        if (counters [i] >= 0)
+          counters [i] /= (double) n;
+    }
+  if (bench_memory)
+    {
+      bench_memory_start ();
+      bench_repeat (e, b, n);
+      bench_memory_stop (memory);
+      for (i = 0; i < BENCH_NMEMORY; i++)
+        memory [i] /= (double) n;
+    }
+  bench_summarise (s, samples, n, bench_clock_overhead);
+  for (i = 0, *iworst = 0; i < b->n; i++)
+    if (fastest [i] > fastest [*iworst])
+      *iworst = i;
+  *worst = fastest [*iworst] - bench_clock_overhead;
+  if (*worst < 0)
+    *worst = 0;
+  free (fastest);
+  bench_domain_leave (e, b, save);
 }
 
 
@@ -178,162 +1006,753 @@ static void sensible_print (double x)
 }
 
 
-/* compute the score for the operation arrayfunc[op] */
+/* print the result of arrayfunc[op] at precision prec, where prec is 0
+   for operands from data files, and where worst is the worst case latency
+   on the operand described by label */
+static void
+print_result (int op, mpfr_prec_t prec, const bench_stats_t *s,
+              double worst, const char *label, const double *counters,
+              const double *memory)
+{
+  const char *name = arrayfunc [op].name;
+  const char *group = groupname [arrayfunc [op].group];
+  double ops = (s->median > 0 ? 1e9 / s->median : 0);
+  int i;
+
+  switch (bench_format)
+    {
+    case eformat_csv:
+      printf ("%s,%s,%lu,%s,%lu,%.1f,%.1f,%.1f,%.1f,%.1f,%.1f,%.1f,\"%s\"",
+              name, group, (unsigned long int) prec, distname [bench_dist],
+              s->n, s->median, s->p99, s->mean, s->min, s->max, ops, worst,
+              label);
+      if (bench_counters)
+        {
+          for (i = 0; i < BENCH_NCOUNTERS; i++)
+            if (counters [i] >= 0)
+              printf (",%.1f", counters [i]);
+            else
+              printf (",");
+        }
+      if (bench_memory)
+        for (i = 0; i < BENCH_NMEMORY; i++)
+          printf (",%.2f", memory [i]);
+      printf ("\n");
+      break;
+    case eformat_json:
+      printf ("%s\n    {\"function\": \"%s\", \"group\": \"%s\", "
+              "\"precision\": %lu, \"samples\": %lu, \"median_ns\": %.1f, "
+              "\"p99_ns\": %.1f, \"mean_ns\": %.1f, \"min_ns\": %.1f, "
+              "\"max_ns\": %.1f, \"ops_per_s\": %.1f, \"worst_ns\": %.1f, "
+              "\"worst_input\": \"%s\"",
+              bench_first_result ? "" : ",", name, group,
+              (unsigned long int) prec, s->n, s->median, s->p99, s->mean,
+              s->min, s->max, ops, worst, label);
+      if (bench_counters)
+        {
+          for (i = 0; i < BENCH_NCOUNTERS; i++)
+            if (counters [i] >= 0)
+              printf (", \"%s\": %.1f", bench_counter_name [i], counters [i]);
+            else
+              printf (", \"%s\": null", bench_counter_name [i]);
+        }
+      if (bench_memory)
+        for (i = 0; i < BENCH_NMEMORY; i++)
+          printf (", \"%s\": %.2f", bench_memory_name [i], memory [i]);
+      printf ("}");
+      break;
+    default:
+      printf ("op %13s, prec %5lu: %9lu calls, median ", name,
+              (unsigned long int) prec, s->n);
+      sensible_print (s->median);
+      printf (" ns, p99 ");
+      sensible_print (s->p99);
+      printf (" ns, ");
+      sensible_print (ops);
+      printf (" ops/s, worst ");
+      sensible_print (worst);
+      printf (" ns %s\n", label);
+      if (bench_counters)
+        {
+          printf ("%38s", "per call:");
+          for (i = 0; i < BENCH_NCOUNTERS; i++)
+            if (counters [i] >= 0)
+              printf (" %s %.1f", bench_counter_name [i], counters [i]);
+          printf ("\n");
+        }
+      if (bench_memory)
+        printf ("%38s allocs %.2f (%.0f bytes), reallocs %.2f (%.0f bytes), "
+                "frees %.2f (%.0f bytes)\n", "per call:", memory [0],
+                memory [1], memory [2], memory [3], memory [4], memory [5]);
+    }
+  bench_first_result = 0;
+  fflush (stdout);
+}
+
+
+/* compute the score for all groups, as geometric means computed through
+   logarithms to avoid overflows */
 static void
-compute_score (double *zscore, int op, gmp_randstate_t randstate)
+compute_groupscore (double groupscore[], int countop, double zscore[])
 {
-  mpc_t *xptr, *yptr, *zptr;
+  int op;
+  enum egroupfunc group;
+  int countgroupop;
 
-  int i, j;
-  size_t k;
+  for (group = (enum egroupfunc)0; group != egroup_last; group++)
+    {
+      groupscore[group] = 0.0;
+      for (op = 0, countgroupop = 0; op < countop; op++)
+        {
+          if (bench_selected [op] && group == arrayfunc[op].group)
+            {
+              groupscore[group] += log (zscore[op]);
+              countgroupop++;
+            }
+        }
+      groupscore[group] = (countgroupop == 0 ? 0
+                           : exp (groupscore[group] / (double) countgroupop));
+    }
+}
 
-  unsigned long niter, ti;
 
-  double t;
+/* compute the global score */
+static void
+compute_globalscore (double *globalscore, int countop, double zscore[])
+{
+  int op, count = 0;
 
-  double ops_per_time;
+  *globalscore = 0.0;
+  for (op = 0; op < countop; op++)
+    if (bench_selected [op])
+      {
+        *globalscore += log (zscore[op]);
+        count++;
+      }
+  *globalscore = (count == 0 ? 0 : exp (*globalscore / (double) count));
+}
 
-  int countprec = 0;
 
-  *zscore = 1.0;
+/* set up the operands of n calls of arrayfunc[op] at precision prec from
+   the chosen source, and return n */
+static int
+bench_data_setup (bench_data_t *b, int op, mpfr_prec_t prec,
+                  gmp_randstate_t randstate)
+{
+  if (bench_dist == edist_hard)
+    return bench_data_hard (b, op, prec, randstate);
+  else if (bench_dist == edist_dat)
+    return bench_data_dat (b, op, randstate);
+  bench_data_init (b, bench_noperands, prec, bench_dist, randstate);
+  return bench_noperands;
+}
 
-  i = op;
-  for (k = 0; k < (int)sizeof (arrayprecision_op1) / sizeof (arrayprecision_op1[0]);
-       k++, countprec++)
-    {
 
-      mpfr_prec_t precision1 = arrayprecision_op1[k];
-      mpfr_prec_t precision2 = arrayprecision_op2[k];
-      mpfr_prec_t precision3 = arrayprecision_op2[k];
-      /* allocate array of random numbers */
-      xptr = bench_random_array (NB_RAND_CPLX, precision1, randstate);
-      yptr = bench_random_array (NB_RAND_CPLX, precision2, randstate);
-      zptr = bench_random_array (NB_RAND_CPLX, precision3, randstate);
+#ifdef HAVE_PTHREAD
+/* state of one thread of the scaling benchmark */
+typedef struct
+{
+  pthread_t id;
+  const struct benchfunc *e;
+  bench_data_t data;
+  mpc_t *save;
+  unsigned long int calls;
+  double end;
+} bench_thread_t;
+
+static pthread_mutex_t bench_start_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t bench_start_cond = PTHREAD_COND_INITIALIZER;
+static int bench_start_flag;
+static int bench_ready;
+static double bench_start_time;
 
-      /* compute the number of operations per seconds */
-      if (arrayfunc[i].noperands==2)
-          printf ("op %4s, prec %5lux%5lu->%5lu:",
-                  arrayfunc[i].name, precision1, precision2, precision3);
-      else
-          printf ("op %4s, prec %5lu      ->%5lu:",
-                  arrayfunc[i].name, precision1, precision3);
-      fflush (stdout);
+/* call the function on the operands of the thread from the common start
+   time until the time budget is spent, once all threads are ready */
+static void *
+bench_thread_run (void *arg)
+{
+  bench_thread_t *t = (bench_thread_t *) arg;
+  int i = 0;
 
-      t = arrayfunc[i].func_init (NB_RAND_CPLX, zptr, xptr, yptr);
-      niter = 1 + (unsigned long) (1e6 / t);
+  t->e->func (&t->data, 0); /* warm up caches */
+  pthread_mutex_lock (&bench_start_mutex);
+  bench_ready++;
+  pthread_cond_broadcast (&bench_start_cond);
+  while (!bench_start_flag)
+    pthread_cond_wait (&bench_start_cond, &bench_start_mutex);
+  pthread_mutex_unlock (&bench_start_mutex);
 
-      printf ("%9lu iter:", niter);
-      fflush (stdout);
+  t->calls = 0;
+  do
+    {
+      t->e->func (&t->data, i);
+      t->calls++;
+      if (++i == t->data.n)
+        i = 0;
+      t->end = bench_ns ();
+    }
+  while (1e-9 * (t->end - bench_start_time) < bench_budget);
+  mpfr_free_cache ();
+  return NULL;
+}
 
-      /* ti expressed in microseconds */
-      niter = (niter + 9) / 10;
-      ti = arrayfunc[i].func_accurate (niter, NB_RAND_CPLX, zptr, xptr, yptr, arrayfunc[i].noperands);
 
-      ops_per_time = 1e5 * niter / (double) ti;
-         /* use 0.1s */
+static int
+bench_same_fr (mpfr_srcptr a, mpfr_srcptr b)
+{
+  return (mpfr_nan_p (a) && mpfr_nan_p (b))
+    || (mpfr_equal_p (a, b) && mpfr_signbit (a) == mpfr_signbit (b));
+}
 
-      sensible_print (ops_per_time);
-      printf ("\n");
 
-      *zscore *= ops_per_time;
+static int
+bench_same (mpc_srcptr a, mpc_srcptr b)
+{
+  return bench_same_fr (mpc_realref (a), mpc_realref (b))
+    && bench_same_fr (mpc_imagref (a), mpc_imagref (b));
+}
+
+
+/* run arrayfunc[op] at precision prec on nthreads threads, each with its
+   own operands; return the total number of calls per second of elapsed
+   time, and in *wrong the number of results computed in the threads which
+   differ from the ones obtained afterwards in a single thread */
+static double
+bench_threaded (int op, mpfr_prec_t prec, int nthreads,
+                gmp_randstate_t *randstate, unsigned long int *wrong)
+{
+  bench_thread_t *t;
+  mpc_t got, got2;
+  double calls = 0, end = 0;
+  int k, i, n;
+
+  /* every thread works on its own copy of the same operands, so that the
+     throughputs for different numbers of threads are comparable */
+  t = (bench_thread_t *) bench_alloc (nthreads * sizeof (bench_thread_t));
+  for (k = 0; k < nthreads; k++)
+    {
+      gmp_randseed_ui (randstate [k], 17 * op + prec);
+      t [k].e = arrayfunc + op;
+      bench_data_setup (&t [k].data, op, prec, randstate [k]);
+    }
 
-      /* free memory */
-      for (j = 0; j < NB_RAND_CPLX; j++)
+  bench_start_flag = 0;
+  bench_ready = 0;
+  for (k = 0; k < nthreads; k++)
+    {
+      t [k].save = bench_domain_enter (t [k].e, &t [k].data);
+      if (pthread_create (&t [k].id, NULL, bench_thread_run, t + k) != 0)
         {
-          mpc_clear (xptr[j]);
-          mpc_clear (yptr[j]);
-          mpc_clear (zptr[j]);
+          fprintf (stderr, "mpcbench: cannot create thread %d\n", k);
+          exit (1);
         }
-      free (xptr);
-      free (yptr);
-      free (zptr);
     }
+  pthread_mutex_lock (&bench_start_mutex);
+  while (bench_ready < nthreads)
+    pthread_cond_wait (&bench_start_cond, &bench_start_mutex);
+  bench_start_flag = 1;
+  bench_start_time = bench_ns ();
+  pthread_cond_broadcast (&bench_start_cond);
+  pthread_mutex_unlock (&bench_start_mutex);
+  for (k = 0; k < nthreads; k++)
+    pthread_join (t [k].id, NULL);
 
-  *zscore = pow (*zscore, 1.0 / (double) countprec);
+  /* check the last result of every operand */
+  *wrong = 0;
+  for (k = 0; k < nthreads; k++)
+    {
+      calls += (double) t [k].calls;
+      if (t [k].end > end)
+        end = t [k].end;
+      n = (t [k].calls < (unsigned long int) t [k].data.n
+           ? (int) t [k].calls : t [k].data.n);
+      for (i = 0; i < n; i++)
+        {
+          mpc_init3 (got, mpfr_get_prec (mpc_realref (t [k].data.z [i])),
+                     mpfr_get_prec (mpc_imagref (t [k].data.z [i])));
+          mpc_init3 (got2, mpfr_get_prec (mpc_realref (t [k].data.z2 [i])),
+                     mpfr_get_prec (mpc_imagref (t [k].data.z2 [i])));
+          mpc_set (got, t [k].data.z [i], MPC_RNDNN);
+          mpc_set (got2, t [k].data.z2 [i], MPC_RNDNN);
+          t [k].e->func (&t [k].data, i);
+          if (!bench_same (got, t [k].data.z [i])
+              || !bench_same (got2, t [k].data.z2 [i]))
+            (*wrong)++;
+          mpc_clear (got);
+          mpc_clear (got2);
+        }
+      bench_domain_leave (t [k].e, &t [k].data, t [k].save);
+      bench_data_clear (&t [k].data);
+    }
+  free (t);
+  return calls / (1e-9 * (end - bench_start_time));
 }
 
-/* compute the score for all groups */
+
+/* compare the throughput of every function on one and on bench_threads
+   threads */
 static void
-compute_groupscore (double groupscore[], int countop, double zscore[])
+bench_scaling (void)
 {
-  int op;
-  enum egroupfunc group;
-  int countgroupop;
- 
-  for (group = (enum egroupfunc)0; group != egroup_last; group++)
+  gmp_randstate_t *randstate;
+  unsigned long int wrong, wrong1;
+  double ops1, opsn, speedup, efficiency;
+  int i, k, npass, ncpu = bench_threads, first = 1, ncollapse = 0,
+    nwrong = 0;
+  mpfr_prec_t prec;
+
+#if defined (HAVE_SYSCONF) && defined (HAVE_UNISTD_H) \
+    && defined (_SC_NPROCESSORS_ONLN)
+  ncpu = (int) sysconf (_SC_NPROCESSORS_ONLN);
+  if (ncpu <= 0)
+    ncpu = bench_threads;
+#endif
+  randstate = (gmp_randstate_t *)
+    bench_alloc (bench_threads * sizeof (gmp_randstate_t));
+  for (k = 0; k < bench_threads; k++)
+    gmp_randinit_default (randstate [k]);
+
+  if (bench_format == eformat_csv)
+    printf ("function,group,precision,distribution,threads,cpus,"
+            "ops_per_s_1,ops_per_s_n,speedup,efficiency,wrong_results\n");
+  else if (bench_format == eformat_json)
+    printf ("{\n  \"gmp\": \"%s\", \"mpfr\": \"%s\", \"mpc\": \"%s\",\n"
+            "  \"clock\": \"%s\", \"distribution\": \"%s\", "
+            "\"threads\": %d, \"cpus\": %d,\n  \"results\": [",
+            gmp_version, mpfr_get_version (), mpc_get_version (),
+            BENCH_CLOCK, distname [bench_dist], bench_threads, ncpu);
+  else
+    printf ("%d threads on %d processors, efficiency relative to %d times "
+            "the throughput of one thread\n\n", bench_threads, ncpu,
+            bench_threads < ncpu ? bench_threads : ncpu);
+
+  npass = (bench_dist == edist_dat ? 1 : bench_nprec);
+  for (k = 0; k < npass; k++)
     {
-      groupscore[group] = 1.0;
-      for (op = 0, countgroupop = 0; op < countop; op++)
+      prec = (bench_dist == edist_dat ? 0 : bench_prec [k]);
+      for (i = 0; i < NB_BENCH_OP; i++)
         {
-          if (group == arrayfunc[op].group)
+          bench_data_t probe;
+
+          if (!bench_selected [i])
+            continue;
+          /* skip the functions without operands in this source */
+          if (bench_dist >= edist_hard)
             {
-              groupscore[group] *= zscore[op];
-              countgroupop++;
+              if (bench_data_setup (&probe, i, prec, randstate [0]) == 0)
+                continue;
+              bench_data_clear (&probe);
+            }
+          ops1 = bench_threaded (i, prec, 1, randstate, &wrong1);
+          opsn = bench_threaded (i, prec, bench_threads, randstate, &wrong);
+          wrong += wrong1;
+          speedup = opsn / ops1;
+          efficiency = speedup
+            / (double) (bench_threads < ncpu ? bench_threads : ncpu);
+          ncollapse += (efficiency < BENCH_MIN_EFFICIENCY);
+          nwrong += (wrong > 0);
+          switch (bench_format)
+            {
+            case eformat_csv:
+              printf ("%s,%s,%lu,%s,%d,%d,%.1f,%.1f,%.3f,%.3f,%lu\n",
+                      arrayfunc [i].name, groupname [arrayfunc [i].group],
+                      (unsigned long int) prec, distname [bench_dist],
+                      bench_threads, ncpu, ops1, opsn, speedup, efficiency,
+                      wrong);
+              break;
+            case eformat_json:
+              printf ("%s\n    {\"function\": \"%s\", \"group\": \"%s\", "
+                      "\"precision\": %lu, \"ops_per_s_1\": %.1f, "
+                      "\"ops_per_s_n\": %.1f, \"speedup\": %.3f, "
+                      "\"efficiency\": %.3f, \"wrong_results\": %lu}",
+                      first ? "" : ",", arrayfunc [i].name,
+                      groupname [arrayfunc [i].group],
+                      (unsigned long int) prec, ops1, opsn, speedup,
+                      efficiency, wrong);
+              break;
+            default:
+              printf ("op %13s, prec %5lu: 1 thread ", arrayfunc [i].name,
+                      (unsigned long int) prec);
+              sensible_print (ops1);
+              printf (" ops/s, %d threads ", bench_threads);
+              sensible_print (opsn);
+              printf (" ops/s, efficiency %5.2f", efficiency);
+              if (efficiency < BENCH_MIN_EFFICIENCY)
+                printf (", SCALING COLLAPSE");
+              if (wrong > 0)
+                printf (", %lu WRONG RESULTS", wrong);
+              printf ("\n");
             }
+          first = 0;
+          fflush (stdout);
         }
-      groupscore[group] = pow (groupscore[group], 1.0 / (double) countgroupop);
     }
+  if (bench_format == eformat_json)
+    printf ("\n  ]\n}\n");
+  else if (bench_format == eformat_text)
+    printf ("\n%d scaling collapses, %d functions with wrong results\n",
+            ncollapse, nwrong);
+
+  for (k = 0; k < bench_threads; k++)
+    gmp_randclear (randstate [k]);
+  free (randstate);
 }
+#endif
 
 
-/* compute the global score */
 static void
-compute_globalscore (double *globalscore, int countop, double zscore[])
+usage (void)
 {
-  int op;
+  printf ("Usage: mpcbench [options]\n"
+          "  -f list   comma separated functions or groups arith, elem, special\n"
+          "            (default all)\n"
+          "  -p list   comma separated precisions, or a:b for a, 2a, 4a, ... up\n"
+          "            to b, or a:b:c for a, a+c, a+2c, ... (default %d:%d)\n"
+          "  -d dist   operands unit, signed, wide, real or imag (default unit),\n"
+          "            hard for a list of slow inputs, or dat for the data files\n"
+          "            of the test suite, with their own precisions (prec 0)\n"
+          "  -D dir    directory of the data files (default %s)\n"
+          "  -n num    number of operands per precision (default %d)\n"
+          "  -t sec    time per function and precision (default %g)\n"
+          "  -o fmt    output text, csv or json (default text)\n"
+          "  -c 1      read the hardware performance counters (Linux only)\n"
+          "  -a 1      count the allocations through the GMP memory functions\n"
+          "  -T num    compare the throughput on num threads to the one on one\n"
+          "            thread, and check the results computed in the threads\n",
+          BENCH_PREC_MIN, BENCH_PREC_MAX, bench_datadir, bench_noperands,
+          bench_budget);
+  exit (1);
+}
 
-  *globalscore = 1.0;
-  for (op = 0; op < countop; op++)
-    *globalscore *= zscore[op];
-  *globalscore = pow (*globalscore, 1.0 / (double) countop);
+
+static void
+add_precision (long int p)
+{
+  if (p < MPFR_PREC_MIN || p > MPFR_PREC_MAX)
+    {
+      fprintf (stderr, "mpcbench: invalid precision %ld\n", p);
+      exit (1);
+    }
+  if (bench_nprec == BENCH_MAX_PREC_COUNT)
+    {
+      fprintf (stderr, "mpcbench: more than %d precisions\n",
+               BENCH_MAX_PREC_COUNT);
+      exit (1);
+    }
+  bench_prec [bench_nprec++] = p;
 }
 
-int
-main (void)
+
+static void
+parse_precisions (const char *arg)
 {
-  int i;
+  long int a, b, c;
+  const char *s;
+  char *end;
+
+  if (strchr (arg, ':') != NULL)
+    {
+      a = strtol (arg, &end, 10);
+      if (*end != ':')
+        usage ();
+      b = strtol (end + 1, &end, 10);
+      c = 0;
+      if (*end == ':')
+        {
+          c = strtol (end + 1, &end, 10);
+          if (c <= 0)
+            usage ();
+        }
+      if (*end != '\0' || a <= 0 || b < a)
+        usage ();
+      for (; a <= b; a = (c > 0 ? a + c : 2 * a))
+        add_precision (a);
+    }
+  else
+    for (s = arg; *s != '\0'; s = (*end == ',' ? end + 1 : end))
+      {
+        a = strtol (s, &end, 10);
+        if (end == s || (*end != ',' && *end != '\0'))
+          usage ();
+        add_precision (a);
+      }
+}
 
-  double score[NB_BENCH_OP];
 
-  double globalscore, groupscore[egroup_last];
+static void
+parse_functions (const char *arg)
+{
+  char name [64];
+  const char *s, *t;
+  size_t len;
+  int op, g, found;
 
+  for (s = arg; *s != '\0'; s = (*t == ',' ? t + 1 : t))
+    {
+      for (t = s; *t != ',' && *t != '\0'; t++);
+      len = t - s;
+      if (len >= sizeof (name))
+        usage ();
+      memcpy (name, s, len);
+      name [len] = '\0';
+      if (strncmp (name, "mpc_", 4) == 0)
+        memmove (name, name + 4, len - 3);
+      found = 0;
+      for (op = 0; op < NB_BENCH_OP; op++)
+        if (strcmp (name, arrayfunc [op].name) == 0)
+          found = bench_selected [op] = 1;
+      for (g = 0; g < egroup_last; g++)
+        if (strcmp (name, groupname [g]) == 0)
+          for (op = 0; op < NB_BENCH_OP; op++)
+            if ((int) arrayfunc [op].group == g)
+              found = bench_selected [op] = 1;
+      if (!found)
+        {
+          fprintf (stderr, "mpcbench: unknown function %s\n", name);
+          exit (1);
+        }
+    }
+}
+
+
+static void
+parse_options (int argc, char *argv [])
+{
+  int i, k, any = 0;
+  const char *arg;
+
+  for (i = 1; i < argc; i += 2)
+    {
+      if (argv [i][0] != '-' || argv [i][1] == '\0' || argv [i][2] != '\0'
+          || i + 1 == argc)
+        usage ();
+      arg = argv [i + 1];
+      switch (argv [i][1])
+        {
+        case 'f':
+          parse_functions (arg);
+          any = 1;
+          break;
+        case 'p':
+          parse_precisions (arg);
+          break;
+        case 'd':
+          for (k = 0; k < edist_last && strcmp (arg, distname [k]) != 0; k++);
+          if (k == edist_last)
+            usage ();
+          bench_dist = (enum edist) k;
+          break;
+        case 'D':
+          bench_datadir = arg;
+          break;
+        case 'c':
+          bench_counters = (atoi (arg) != 0);
+          break;
+        case 'a':
+          bench_memory = (atoi (arg) != 0);
+          break;
+        case 'T':
+          bench_threads = atoi (arg);
+          if (bench_threads <= 0)
+            usage ();
+#ifndef HAVE_PTHREAD
+          fprintf (stderr, "mpcbench: compiled without thread support\n");
+          exit (1);
+#endif
+          break;
+        case 'n':
+          bench_noperands = atoi (arg);
+          if (bench_noperands <= 0)
+            usage ();
+          break;
+        case 't':
+          bench_budget = atof (arg);
+          if (bench_budget <= 0)
+            usage ();
+          break;
+        case 'o':
+          if (strcmp (arg, "text") == 0)
+            bench_format = eformat_text;
+          else if (strcmp (arg, "csv") == 0)
+            bench_format = eformat_csv;
+          else if (strcmp (arg, "json") == 0)
+            bench_format = eformat_json;
+          else
+            usage ();
+          break;
+        default:
+          usage ();
+        }
+    }
+  if (!any)
+    for (k = 0; k < NB_BENCH_OP; k++)
+      bench_selected [k] = 1;
+  if (bench_nprec == 0)
+    for (k = BENCH_PREC_MIN; k <= BENCH_PREC_MAX; k *= 2)
+      add_precision (k);
+}
+
+
+int
+main (int argc, char *argv [])
+{
+  int i, k, n, npass, iworst, *nscore;
+  double *score, globalscore, groupscore[egroup_last], *samples, worst;
+  double counters [BENCH_NCOUNTERS], memory [BENCH_NMEMORY];
+  mpfr_prec_t prec;
+  bench_stats_t s;
+  bench_data_t data;
   gmp_randstate_t randstate;
 
+  parse_options (argc, argv);
+  if (bench_counters && bench_counters_open () == 0)
+    {
+      fprintf (stderr, "mpcbench: no hardware performance counters "
+               "available\n");
+      bench_counters = 0;
+    }
+  bench_clock_overhead = bench_overhead ();
+#ifdef HAVE_PTHREAD
+  if (bench_threads > 0)
+    {
+      bench_scaling ();
+      return 0;
+    }
+#endif
+  samples = (double *) bench_alloc (bench_max_samples * sizeof (double));
+  score = (double *) bench_alloc (NB_BENCH_OP * sizeof (double));
+  nscore = (int *) bench_alloc (NB_BENCH_OP * sizeof (int));
+  for (i = 0; i < NB_BENCH_OP; i++)
+    {
+      score [i] = 0.0;
+      nscore [i] = 0;
+    }
+
+  if (bench_format == eformat_csv)
+    {
+      printf ("function,group,precision,distribution,samples,median_ns,"
+              "p99_ns,mean_ns,min_ns,max_ns,ops_per_s,worst_ns,worst_input");
+      if (bench_counters)
+        for (i = 0; i < BENCH_NCOUNTERS; i++)
+          printf (",%s", bench_counter_name [i]);
+      if (bench_memory)
+        for (i = 0; i < BENCH_NMEMORY; i++)
+          printf (",%s", bench_memory_name [i]);
+      printf ("\n");
+    }
+  else if (bench_format == eformat_json)
+    printf ("{\n  \"gmp\": \"%s\", \"mpfr\": \"%s\", \"mpc\": \"%s\",\n"
+            "  \"clock\": \"%s\", \"clock_overhead_ns\": %.1f,\n"
+            "  \"distribution\": \"%s\", \"operands\": %d,\n"
+            "  \"results\": [",
+            gmp_version, mpfr_get_version (), mpc_get_version (),
+            BENCH_CLOCK, bench_clock_overhead, distname [bench_dist],
+            bench_noperands);
+
+  /* the operands from the data files come with their precisions */
+  npass = (bench_dist == edist_dat ? 1 : bench_nprec);
   gmp_randinit_default (randstate);
+  for (k = 0; k < npass; k++)
+    {
+      prec = (bench_dist == edist_dat ? 0 : bench_prec [k]);
+      if (bench_dist < edist_hard)
+        bench_data_init (&data, bench_noperands, prec, bench_dist,
+                         randstate);
+      for (i = 0; i < NB_BENCH_OP; i++)
+        if (bench_selected [i])
+          {
+            if (bench_dist == edist_hard)
+              n = bench_data_hard (&data, i, prec, randstate);
+            else if (bench_dist == edist_dat)
+              n = bench_data_dat (&data, i, randstate);
+            else
+              n = 1;
+            if (n == 0)
+              continue;
+            bench_time (&s, &worst, &iworst, counters, memory, i, &data,
+                        samples);
+            print_result (i, prec, &s, worst,
+                          data.label == NULL ? "" : data.label [iworst],
+                          counters, memory);
+            score [i] += log (s.median > 0 ? 1e9 / s.median : 1e9);
+            nscore [i]++;
+            if (bench_dist >= edist_hard)
+              bench_data_clear (&data);
+          }
+      if (bench_dist < edist_hard)
+        bench_data_clear (&data);
+    }
+  gmp_randclear (randstate);
 
-  for (i = 0; i < NB_BENCH_OP; i++)
-      compute_score (&(score[i]), i, randstate);
+  /* functions without operands do not count in the scores */
+  for (i = 0, n = 0; i < NB_BENCH_OP; i++)
+    if (nscore [i] == 0)
+      bench_selected [i] = 0;
+    else
+      {
+        score [i] = exp (score [i] / (double) nscore [i]);
+        n++;
+      }
+  if (n == 0)
+    {
+      fprintf (stderr, "mpcbench: no operands for the selected functions\n");
+      exit (1);
+    }
   compute_globalscore (&globalscore, NB_BENCH_OP, score);
   compute_groupscore (groupscore, NB_BENCH_OP, score);
 
-  printf ("\n=================================================================\n\n");
-  printf ("GMP: %s,  MPFR: %s,  MPC: %s\n", gmp_version,
-          mpfr_get_version (), mpc_get_version ());
+  if (bench_format == eformat_json)
+    {
+      printf ("\n  ],\n  \"scores\": {");
+      for (i = 0; i < NB_BENCH_OP; i++)
+        if (bench_selected [i])
+          printf ("\"%s\": %.1f, ", arrayfunc [i].name, score [i]);
+      for (i = 0; i < egroup_last; i++)
+        if (groupscore [i] > 0)
+          printf ("\"group %s\": %.1f, ", groupname [i], groupscore [i]);
+      printf ("\"global\": %.1f}\n}\n", globalscore);
+    }
+  else if (bench_format == eformat_text)
+    {
+      printf ("\n=================================================================\n\n");
+      printf ("GMP: %s,  MPFR: %s,  MPC: %s\n", gmp_version,
+              mpfr_get_version (), mpc_get_version ());
 #ifdef __GMP_CC
-  printf ("GMP compiler: %s\n", __GMP_CC);
+      printf ("GMP compiler: %s\n", __GMP_CC);
 #endif
 #ifdef __GMP_CFLAGS
-  printf ("GMP flags   : %s\n", __GMP_CFLAGS);
+      printf ("GMP flags   : %s\n", __GMP_CFLAGS);
 #endif
-  printf ("\n");
+      printf ("clock: %s, operands: %s\n\n", BENCH_CLOCK,
+              distname [bench_dist]);
 
-  for (i = 0; i < NB_BENCH_OP; i++)
-    {
-      printf ("   score for %4s  ", arrayfunc[i].name);
-      sensible_print (score[i]);
-      printf ("\n");
-      if (i == NB_BENCH_OP-1 || arrayfunc[i +1].group != arrayfunc[i].group)
+      for (i = 0; i < NB_BENCH_OP; i++)
         {
-          enum egroupfunc g = arrayfunc[i].group;
-          printf ("group score %s", groupname[g]);
-          sensible_print (groupscore[g]);
-          printf ("\n\n");
+          if (bench_selected [i])
+            {
+              printf ("   score for %13s  ", arrayfunc[i].name);
+              sensible_print (score[i]);
+              printf ("\n");
+            }
+          if (i == NB_BENCH_OP-1 || arrayfunc[i +1].group != arrayfunc[i].group)
+            {
+              enum egroupfunc g = arrayfunc[i].group;
+              if (groupscore [g] > 0)
+                {
+                  printf ("group score %-7s          ", groupname[g]);
+                  sensible_print (groupscore[g]);
+                  printf ("\n\n");
+                }
+            }
         }
+      printf ("global score                     ");
+      sensible_print (globalscore);
+      printf ("\n\n");
     }
-  printf ("global score       ");
-  sensible_print (globalscore);
-  printf ("\n\n");
 
-  gmp_randclear (randstate);
+  bench_counters_close ();
+  free (samples);
+  free (score);
+  free (nscore);
   return 0;
 }
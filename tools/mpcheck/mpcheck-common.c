@@ -1,6 +1,6 @@
 /* shared routines for mpcheck-xxx
 
-Copyright (C) 2020 INRIA
+Copyright (C) 2020, 2025 INRIA
 
 This file is part of GNU MPC.
 
@@ -19,12 +19,26 @@ along with this program. If not, see http://www.gnu.org/licenses/ .
 */
 
 #include <limits.h>
+#include <math.h>
+#include <time.h>
 #include <sys/types.h>
 #include <sys/resource.h>
 
 unsigned long Max_err_re = 0, Max_err_im = 0;
 unsigned long Max_err = 0; /* for real-valued functions like abs */
 int recheck = 0;
+int timing = 0;
+
+/* number of random inputs generated at once in timing mode */
+#define TIMING_BLOCK 1000
+
+/* sum of the logarithms of the slowdowns, and number of timed functions */
+double Log_slowdown = 0;
+int Timed = 0;
+
+/* the results of the C library in timing mode are stored here, so that
+   the compiler cannot remove the calls */
+volatile TYPE complex timing_sink;
 
 /* y is the reference value computed by MPC */
 static unsigned long
@@ -190,13 +204,43 @@ mpfr_agree (mpfr_t a, mpfr_t b, int inex)
     return mpfr_equal_p (a, b) || inex == 2 || inex == -2;
 }
 
-#if 0
-static int
+/* return the processor time of the process in nanoseconds */
+static double
 cputime (void)
 {
+#ifdef CLOCK_PROCESS_CPUTIME_ID
+  struct timespec ts;
+
+  clock_gettime (CLOCK_PROCESS_CPUTIME_ID, &ts);
+  return 1e9 * (double) ts.tv_sec + (double) ts.tv_nsec;
+#else
   struct rusage rus;
 
-  getrusage (0, &rus);
-  return rus.ru_utime.tv_sec * 1000 + rus.ru_utime.tv_usec / 1000;
-}
+  getrusage (RUSAGE_SELF, &rus);
+  return 1e9 * (double) rus.ru_utime.tv_sec
+    + 1e3 * (double) rus.ru_utime.tv_usec;
 #endif
+}
+
+/* t_c and t_mpc are the times in nanoseconds of n calls to the function
+   of the C library and to the MPC function at precision p */
+static void
+report_timing (const char *name, mpfr_prec_t p, unsigned long n,
+               double t_c, double t_mpc)
+{
+  if (n == 0 || t_c <= 0)
+    return;
+  printf ("Timing for %s: c%s %.1f ns, mpc_%s %.1f ns at precision %lu,"
+          " slowdown %.1f\n", name, name, t_c / (double) n, name,
+          t_mpc / (double) n, (unsigned long) p, t_mpc / t_c);
+  Log_slowdown += log (t_mpc / t_c);
+  Timed ++;
+}
+
+static void
+report_slowdown (void)
+{
+  if (Timed > 0)
+    printf ("Geometric mean of the slowdowns: %.1f over %d functions\n",
+            exp (Log_slowdown / Timed), Timed);
+}
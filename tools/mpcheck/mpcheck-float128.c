@@ -1,7 +1,7 @@
 /* mpcheck-float128 -- compare mpc functions against "__float128 complex"
                        from the GNU libc implementation
 
-Copyright (C) 2020 INRIA
+Copyright (C) 2020, 2025 INRIA
 
 This file is part of GNU MPC.
 
@@ -189,6 +189,12 @@ main (int argc, char *argv[])
           argc --;
           argv ++;
         }
+      else if (strcmp (argv[1], "-time") == 0)
+        {
+          timing = 1;
+          argc --;
+          argv ++;
+        }
       else
         {
           fprintf (stderr, "Unknown option %s\n", argv[1]);
@@ -248,7 +254,10 @@ main (int argc, char *argv[])
   gmp_randclear (state);
   mpz_clear (expz);
 
-  report_maximal_errors ();
+  if (timing)
+    report_slowdown ();
+  else
+    report_maximal_errors ();
 
   return 0;
 }
@@ -1,6 +1,6 @@
 /* template for complex -> real function, for example abs
 
-Copyright (C) 2020 INRIA
+Copyright (C) 2020, 2025 INRIA
 
 This file is part of GNU MPC.
 
@@ -25,6 +25,7 @@ along with this program. If not, see http://www.gnu.org/licenses/ .
 
 #define FUN CAT2(test_,FOO)
 #define CHECK CAT2(check_,FOO)
+#define TIME CAT2(time_,FOO)
 #define MPC_FOO CAT2(mpc_,FOO)
 #define CFOO CAT2(CAT2(c,FOO),SUFFIX)
 #define BAR TOSTRING(FOO)
@@ -70,6 +71,48 @@ CHECK (mpc_t x, mpfr_t z)
   mpfr_clear (t);
 }
 
+/* time n calls to the C library function and to the MPC function at
+   precision p, on the same random inputs */
+static void
+TIME (mpfr_prec_t p, unsigned long n)
+{
+  unsigned long i, j, m;
+  mpc_t x[TIMING_BLOCK];
+  mpfr_t z;
+  TYPE complex xx[TIMING_BLOCK];
+  TYPE zz[TIMING_BLOCK];
+  double t0, t_c = 0, t_mpc = 0;
+
+  gmp_randseed_ui (state, seed);
+
+  for (j = 0; j < TIMING_BLOCK; j++)
+    mpc_init2 (x[j], p);
+  mpfr_init2 (z, p);
+  for (i = 0; i < n; i += m)
+    {
+      m = (n - i < TIMING_BLOCK) ? n - i : TIMING_BLOCK;
+      for (j = 0; j < m; j++)
+        {
+          mpcheck_random (x[j]);
+          xx[j] = mpc_get_type (x[j], MPC_RNDNN);
+        }
+      t0 = cputime ();
+      for (j = 0; j < m; j++)
+        zz[j] = CFOO (xx[j]);
+      t_c += cputime () - t0;
+      t0 = cputime ();
+      for (j = 0; j < m; j++)
+        MPC_FOO (z, x[j], MPFR_RNDN);
+      t_mpc += cputime () - t0;
+      for (j = 0; j < m; j++)
+        timing_sink = zz[j];
+    }
+  for (j = 0; j < TIMING_BLOCK; j++)
+    mpc_clear (x[j]);
+  mpfr_clear (z);
+  report_timing (BAR, p, n, t_c, t_mpc);
+}
+
 static void
 FUN (mpfr_prec_t p, unsigned long n)
 {
@@ -84,6 +127,12 @@ FUN (mpfr_prec_t p, unsigned long n)
   if (verbose > 0)
     printf ("Testing function %s\n", BAR);
 
+  if (timing)
+    {
+      TIME (p, n);
+      return;
+    }
+
   gmp_randseed_ui (state, seed);
 
   mpc_init2 (x, p);
@@ -0,0 +1,570 @@
+/* mpcreplay.c -- replay a binary trace of mpc calls as a benchmark.
+
+Copyright (C) 2025 INRIA
+
+This file is part of GNU MPC.
+
+GNU MPC is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the
+Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+GNU MPC is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for
+more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program. If not, see http://www.gnu.org/licenses/ .
+*/
+
+/* Usage:
+      mpcreplay [-r repeat] trace
+   reads a trace written by a program compiled with mpc-log.h and run
+   with the environment variable MPC_LOG_FILE set (see --enable-logging
+   in the documentation), reconstructs the arguments and the result
+   variables of all recorded calls with their precisions, and executes
+   the calls repeat times (5 by default), after one untimed round. Every
+   call is timed individually, and for each function and range of output
+   precisions, the throughput and percentiles of the latency are printed
+   to stdout, together with the median latency recorded in the trace, the
+   number of calls whose return value differs from the recorded one and
+   a hash of the results.
+      mpcreplay --compare old new
+   reads two outputs of mpcreplay, typically obtained by linking it with
+   two different builds of the library, and prints for each line the
+   ratio of the new to the old median latency and throughput, flagging
+   lines with different hashes, that is, different results. */
+
+#include "config.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#ifdef HAVE_CLOCK_GETTIME
+#include <time.h>
+#elif defined (HAVE_SYS_TIME_H)
+#include <sys/time.h>
+#endif
+#include "mpc.h"
+#include "mpc-trace.h"
+
+typedef int (*c_c_func_ptr) (mpc_ptr, mpc_srcptr, mpc_rnd_t);
+typedef int (*c_cc_func_ptr) (mpc_ptr, mpc_srcptr, mpc_srcptr, mpc_rnd_t);
+typedef int (*c_ccc_func_ptr) (mpc_ptr, mpc_srcptr, mpc_srcptr, mpc_srcptr, mpc_rnd_t);
+typedef int (*cc_c_func_ptr) (mpc_ptr, mpc_ptr, mpc_srcptr, mpc_rnd_t, mpc_rnd_t);
+typedef void (*func_ptr) (void);
+
+struct replayfunc
+{
+   const char *name;
+   int nout, nin;
+   func_ptr func;
+};
+
+#define REPLAY_FUNC(f, t) \
+   { #f, MPC_TRACE_NOUT_##t, MPC_TRACE_NIN_##t, (func_ptr) mpc_##f },
+static const struct replayfunc arrayfunc [] = {
+   MPC_TRACE_FUNCTIONS (REPLAY_FUNC)
+};
+
+/* a recorded call, with its own result variables */
+struct call
+{
+   int func;
+   mpc_rnd_t rnd, rnd2;
+   int inex;      /* recorded return value */
+   uint64_t ns;   /* recorded duration */
+   mpc_t out [2];
+   mpc_t in [3];
+   int bucket;    /* index of the group of the call */
+};
+
+/* a function and a range of precisions ]2^(k-1), 2^k] of the results */
+struct group
+{
+   int func, k;
+   unsigned long int calls, mismatch;
+   double *t;          /* latencies of all executed calls */
+   unsigned long int nt;
+   double *trace;      /* recorded latencies */
+   unsigned long int ntrace;
+   uint64_t hash;
+};
+
+#define NB_BUCKETS 64
+
+#define MAX(a,b) ((a) > (b) ? (a) : (b))
+
+
+static double
+get_ns (void)
+{
+#ifdef HAVE_CLOCK_GETTIME
+   struct timespec ts;
+
+   clock_gettime (CLOCK_MONOTONIC, &ts);
+   return ts.tv_sec * 1e9 + ts.tv_nsec;
+#elif defined (HAVE_GETTIMEOFDAY)
+   struct timeval tv;
+
+   gettimeofday (&tv, NULL);
+   return tv.tv_sec * 1e9 + tv.tv_usec * 1e3;
+#else
+   printf ("\nno timing function available\n");
+   exit (1);
+   return 0;
+#endif
+}
+
+
+static void *
+xmalloc (size_t n)
+{
+   void *p = malloc (n);
+
+   if (p == NULL) {
+      fprintf (stderr, "Cannot allocate %lu bytes\n", (unsigned long) n);
+      exit (1);
+   }
+   return p;
+}
+
+
+static const unsigned char *
+read_fr (mpfr_ptr x, const unsigned char *p)
+   /* Initialise x from its encoding at p, see mpc-trace.h, and return a
+      pointer to the data after it. */
+{
+   mpc_trace_fr_t f;
+   size_t n;
+   void *m;
+
+   memcpy (&f, p, sizeof (mpc_trace_fr_t));
+   p += sizeof (mpc_trace_fr_t);
+   n = mpfr_custom_get_size ((mpfr_prec_t) f.prec);
+   m = xmalloc (n);
+   mpfr_custom_init (m, (mpfr_prec_t) f.prec);
+   if (f.limbs != 0)
+      memcpy (m, p, f.limbs * sizeof (mp_limb_t));
+   mpfr_custom_init_set (x, f.kind, (mpfr_exp_t) f.exp, (mpfr_prec_t) f.prec, m);
+
+   return p + MPC_TRACE_ALIGN (f.limbs * sizeof (mp_limb_t));
+}
+
+
+static void
+clear_fr (mpfr_ptr x)
+{
+   free (mpfr_custom_get_significand (x));
+}
+
+
+static unsigned char *
+read_file (const char *name, size_t *size)
+{
+   FILE *f;
+   unsigned char *buf;
+   long n;
+
+   f = fopen (name, "rb");
+   if (f == NULL) {
+      fprintf (stderr, "Cannot open %s\n", name);
+      exit (1);
+   }
+   fseek (f, 0, SEEK_END);
+   n = ftell (f);
+   fseek (f, 0, SEEK_SET);
+   buf = (unsigned char *) xmalloc ((size_t) n + sizeof (mpc_trace_record_t));
+   if (fread (buf, 1, (size_t) n, f) != (size_t) n) {
+      fprintf (stderr, "Cannot read %s\n", name);
+      exit (1);
+   }
+   fclose (f);
+   /* a zero record behind the data ends the trace in any case */
+   memset (buf + n, 0, sizeof (mpc_trace_record_t));
+   *size = (size_t) n;
+
+   return buf;
+}
+
+
+static struct call *
+read_trace (const char *name, unsigned long int *ncalls)
+{
+   unsigned char *buf;
+   const unsigned char *p, *end;
+   mpc_trace_header_t h;
+   mpc_trace_record_t r;
+   struct call *calls;
+   unsigned long int n, alloc;
+   int64_t prec [2];
+   size_t size;
+   int i;
+
+   buf = read_file (name, &size);
+   memcpy (&h, buf, sizeof (mpc_trace_header_t));
+   if (   size < sizeof (mpc_trace_header_t)
+       || memcmp (h.magic, MPC_TRACE_MAGIC, 8) != 0
+       || h.version != MPC_TRACE_VERSION) {
+      fprintf (stderr, "%s is not a trace of GNU MPC calls\n", name);
+      exit (1);
+   }
+   if (h.limb_bytes != sizeof (mp_limb_t)) {
+      fprintf (stderr, "%s has been written with limbs of %u bytes\n",
+               name, (unsigned int) h.limb_bytes);
+      exit (1);
+   }
+   if (h.dropped != 0)
+      fprintf (stderr, "Warning: %lu records have been dropped from %s\n",
+               (unsigned long) h.dropped, name);
+   if (h.sample > 1)
+      fprintf (stderr, "Warning: %s contains only one call out of %lu\n",
+               name, (unsigned long) h.sample);
+
+   p = buf + sizeof (mpc_trace_header_t);
+   end = p + (h.used < size - sizeof (mpc_trace_header_t) ?
+              h.used : size - sizeof (mpc_trace_header_t));
+   alloc = 1024;
+   calls = (struct call *) xmalloc (alloc * sizeof (struct call));
+   for (n = 0; p < end; n++) {
+      memcpy (&r, p, sizeof (mpc_trace_record_t));
+      if (r.size == 0)
+         break;
+      if (r.func >= MPC_TRACE_NFUNC) {
+         fprintf (stderr, "Unknown function %u in %s\n",
+                  (unsigned int) r.func, name);
+         exit (1);
+      }
+      if (n == alloc) {
+         alloc *= 2;
+         calls = (struct call *) realloc (calls, alloc * sizeof (struct call));
+         if (calls == NULL) {
+            fprintf (stderr, "Cannot allocate memory for the calls\n");
+            exit (1);
+         }
+      }
+      calls [n].func = r.func;
+      calls [n].rnd = r.rnd;
+      calls [n].rnd2 = r.rnd2;
+      calls [n].inex = r.inex;
+      calls [n].ns = r.ns;
+      p += sizeof (mpc_trace_record_t);
+      for (i = 0; i < arrayfunc [r.func].nout; i++) {
+         memcpy (prec, p, sizeof (prec));
+         p += sizeof (prec);
+         mpc_init3 (calls [n].out [i], (mpfr_prec_t) prec [0],
+                    (mpfr_prec_t) prec [1]);
+      }
+      for (i = 0; i < arrayfunc [r.func].nin; i++) {
+         p = read_fr (mpc_realref (calls [n].in [i]), p);
+         p = read_fr (mpc_imagref (calls [n].in [i]), p);
+      }
+   }
+   free (buf);
+   *ncalls = n;
+
+   return calls;
+}
+
+
+static int
+execute (struct call *c)
+{
+   func_ptr f = arrayfunc [c->func].func;
+
+   switch (arrayfunc [c->func].nin + 4 * arrayfunc [c->func].nout) {
+   case 5:
+      return ((c_c_func_ptr) f) (c->out [0], c->in [0], c->rnd);
+   case 6:
+      return ((c_cc_func_ptr) f) (c->out [0], c->in [0], c->in [1], c->rnd);
+   case 7:
+      return ((c_ccc_func_ptr) f) (c->out [0], c->in [0], c->in [1],
+                                   c->in [2], c->rnd);
+   default:
+      return ((cc_c_func_ptr) f) (c->out [0], c->out [1], c->in [0],
+                                  c->rnd, c->rnd2);
+   }
+}
+
+
+static uint64_t
+hash_fr (uint64_t h, mpfr_srcptr x)
+   /* FNV-1a hash of x, continuing from h */
+{
+   const unsigned char *p;
+   size_t i, n;
+   long int e;
+
+   h = (h ^ (uint64_t) (mpfr_nan_p (x) ? 0 : mpfr_signbit (x) ? 1 : 2))
+       * 1099511628211u;
+   if (mpfr_regular_p (x)) {
+      e = (long int) mpfr_get_exp (x);
+      p = (const unsigned char *) &e;
+      for (i = 0; i < sizeof (long int); i++)
+         h = (h ^ p [i]) * 1099511628211u;
+      p = (const unsigned char *) mpfr_custom_get_significand (x);
+      n = mpfr_custom_get_size (mpfr_get_prec (x));
+      for (i = 0; i < n; i++)
+         h = (h ^ p [i]) * 1099511628211u;
+   }
+   else
+      h = (h ^ (uint64_t) (mpfr_inf_p (x) ? 3 : mpfr_zero_p (x) ? 4 : 5))
+          * 1099511628211u;
+
+   return h;
+}
+
+
+static int
+cmp_double (const void *a, const void *b)
+{
+   double x = *(const double *) a, y = *(const double *) b;
+
+   return (x < y ? -1 : x > y);
+}
+
+
+static double
+percentile (double *t, unsigned long int n, double q)
+   /* t is sorted */
+{
+   unsigned long int i = (unsigned long int) (q * (n - 1) + 0.5);
+
+   return (n == 0 ? 0 : t [i]);
+}
+
+
+static void
+replay (const char *name, int repeat)
+{
+   struct call *calls;
+   struct group *groups;
+   unsigned long int n, i, m;
+   mpfr_prec_t p, pr, pi;
+   double t0, t1, overhead, total;
+   int j, k, r, inex;
+
+   calls = read_trace (name, &n);
+   if (n == 0) {
+      fprintf (stderr, "%s contains no calls\n", name);
+      exit (1);
+   }
+
+   /* assign the calls to groups */
+   groups = (struct group *) xmalloc (MPC_TRACE_NFUNC * NB_BUCKETS
+                                      * sizeof (struct group));
+   for (i = 0; i < MPC_TRACE_NFUNC * NB_BUCKETS; i++) {
+      groups [i].func = (int) (i / NB_BUCKETS);
+      groups [i].k = (int) (i % NB_BUCKETS);
+      groups [i].calls = 0;
+      groups [i].mismatch = 0;
+      groups [i].nt = 0;
+      groups [i].ntrace = 0;
+      groups [i].hash = 14695981039346656037u;
+   }
+   for (i = 0; i < n; i++) {
+      p = 0;
+      for (j = 0; j < arrayfunc [calls [i].func].nout; j++) {
+         mpc_get_prec2 (&pr, &pi, calls [i].out [j]);
+         p = MAX (p, MAX (pr, pi));
+      }
+      for (k = 0; k < NB_BUCKETS - 1 && ((mpfr_prec_t) 1 << k) < p; k++);
+      calls [i].bucket = calls [i].func * NB_BUCKETS + k;
+      groups [calls [i].bucket].calls++;
+   }
+   for (i = 0; i < MPC_TRACE_NFUNC * NB_BUCKETS; i++)
+      if (groups [i].calls != 0) {
+         groups [i].t = (double *) xmalloc (groups [i].calls * repeat
+                                            * sizeof (double));
+         groups [i].trace = (double *) xmalloc (groups [i].calls
+                                                * sizeof (double));
+      }
+
+   /* one untimed round, which also fills the internal caches of the
+      library, checks the return values and hashes the results */
+   for (i = 0; i < n; i++) {
+      struct group *g = groups + calls [i].bucket;
+      inex = execute (calls + i);
+      if (inex != calls [i].inex)
+         g->mismatch++;
+      g->hash = (g->hash ^ (uint64_t) (unsigned int) inex) * 1099511628211u;
+      for (j = 0; j < arrayfunc [calls [i].func].nout; j++) {
+         g->hash = hash_fr (g->hash, mpc_realref (calls [i].out [j]));
+         g->hash = hash_fr (g->hash, mpc_imagref (calls [i].out [j]));
+      }
+      g->trace [g->ntrace++] = (double) calls [i].ns;
+   }
+
+   /* the overhead of reading the clock is subtracted from the timings */
+   for (i = 0, overhead = 1e30; i < 1000; i++) {
+      t0 = get_ns ();
+      t1 = get_ns ();
+      if (t1 - t0 < overhead)
+         overhead = t1 - t0;
+   }
+
+   for (r = 0; r < repeat; r++)
+      for (i = 0; i < n; i++) {
+         struct group *g = groups + calls [i].bucket;
+         t0 = get_ns ();
+         execute (calls + i);
+         t1 = get_ns ();
+         g->t [g->nt++] = (t1 - t0 > overhead ? t1 - t0 - overhead : 0);
+      }
+
+   printf ("# GMP: %s,  MPFR: %s,  MPC: %s\n", gmp_version,
+           mpfr_get_version (), mpc_get_version ());
+   printf ("# %lu calls from %s, %d repetitions, latencies in ns\n",
+           n, name, repeat);
+   printf ("# %-9s %11s %8s %12s %10s %10s %10s %10s %10s %6s %16s\n",
+           "function", "precision", "calls", "calls/s", "p50", "p90", "p99",
+           "max", "trace p50", "inex", "hash");
+   for (i = 0; i < MPC_TRACE_NFUNC * NB_BUCKETS; i++) {
+      struct group *g = groups + i;
+      if (g->calls == 0)
+         continue;
+      for (m = 0, total = 0; m < g->nt; m++)
+         total += g->t [m];
+      qsort (g->t, g->nt, sizeof (double), cmp_double);
+      qsort (g->trace, g->ntrace, sizeof (double), cmp_double);
+      printf ("%-11s %5lu-%-5lu %8lu %12.0f %10.0f %10.0f %10.0f %10.0f %10.0f %6lu %08lx%08lx\n",
+              arrayfunc [g->func].name,
+              g->k == 0 ? 1ul : (1ul << (g->k - 1)) + 1, 1ul << g->k,
+              g->calls, total > 0 ? g->nt * 1e9 / total : 0,
+              percentile (g->t, g->nt, 0.5), percentile (g->t, g->nt, 0.9),
+              percentile (g->t, g->nt, 0.99), g->t [g->nt - 1],
+              percentile (g->trace, g->ntrace, 0.5), g->mismatch,
+              (unsigned long) (g->hash >> 32),
+              (unsigned long) (g->hash & 0xffffffffu));
+      free (g->t);
+      free (g->trace);
+   }
+
+   for (i = 0; i < n; i++) {
+      for (j = 0; j < arrayfunc [calls [i].func].nout; j++)
+         mpc_clear (calls [i].out [j]);
+      for (j = 0; j < arrayfunc [calls [i].func].nin; j++) {
+         clear_fr (mpc_realref (calls [i].in [j]));
+         clear_fr (mpc_imagref (calls [i].in [j]));
+      }
+   }
+   free (calls);
+   free (groups);
+}
+
+
+/* one line of the output of replay */
+struct line
+{
+   char key [64];
+   double rate, p50;
+   char hash [17];
+};
+
+
+static struct line *
+read_output (const char *name, int *n)
+{
+   FILE *f;
+   char buf [512], func [32], prec [32];
+   struct line *l;
+   int alloc = 64;
+   double rate, p50;
+   unsigned long calls;
+
+   f = fopen (name, "r");
+   if (f == NULL) {
+      fprintf (stderr, "Cannot open %s\n", name);
+      exit (1);
+   }
+   l = (struct line *) xmalloc (alloc * sizeof (struct line));
+   *n = 0;
+   while (fgets (buf, sizeof (buf), f) != NULL) {
+      if (buf [0] == '#')
+         continue;
+      if (*n == alloc) {
+         alloc *= 2;
+         l = (struct line *) realloc (l, alloc * sizeof (struct line));
+         if (l == NULL) {
+            fprintf (stderr, "Cannot allocate memory\n");
+            exit (1);
+         }
+      }
+      if (sscanf (buf, "%31s %31s %lu %lf %lf %*f %*f %*f %*f %*u %16s",
+                  func, prec, &calls, &rate, &p50, l [*n].hash) != 6)
+         continue;
+      sprintf (l [*n].key, "%s %s", func, prec);
+      l [*n].rate = rate;
+      l [*n].p50 = p50;
+      (*n)++;
+   }
+   fclose (f);
+
+   return l;
+}
+
+
+static void
+compare (const char *old, const char *new)
+{
+   struct line *lo, *ln;
+   int no, nn, i, j;
+   double lrate = 0, lp50 = 0;
+   int count = 0;
+
+   lo = read_output (old, &no);
+   ln = read_output (new, &nn);
+   printf ("# ratios new/old of %s and %s\n", new, old);
+   printf ("# %-21s %10s %10s\n", "function precision", "calls/s", "p50");
+   for (i = 0; i < nn; i++) {
+      for (j = 0; j < no && strcmp (lo [j].key, ln [i].key) != 0; j++);
+      if (j == no) {
+         printf ("%-23s only in %s\n", ln [i].key, new);
+         continue;
+      }
+      printf ("%-23s %10.3f %10.3f%s\n", ln [i].key,
+              ln [i].rate / lo [j].rate, ln [i].p50 / lo [j].p50,
+              strcmp (ln [i].hash, lo [j].hash) != 0 ?
+              "   different results" : "");
+      lrate += log (ln [i].rate / lo [j].rate);
+      lp50 += log (ln [i].p50 / lo [j].p50);
+      count++;
+   }
+   if (count > 0)
+      printf ("%-23s %10.3f %10.3f\n", "geometric mean",
+              exp (lrate / count), exp (lp50 / count));
+   free (lo);
+   free (ln);
+}
+
+
+static void
+usage (void)
+{
+   fprintf (stderr, "Usage: mpcreplay [-r repeat] trace\n"
+                    "       mpcreplay --compare old new\n");
+   exit (1);
+}
+
+
+int
+main (int argc, char *argv [])
+{
+   int repeat = 5;
+
+   if (argc == 4 && strcmp (argv [1], "--compare") == 0)
+      compare (argv [2], argv [3]);
+   else {
+      if (argc == 4 && strcmp (argv [1], "-r") == 0) {
+         repeat = atoi (argv [2]);
+         argc -= 2;
+         argv += 2;
+      }
+      if (argc != 2 || repeat <= 0)
+         usage ();
+      replay (argv [1], repeat);
+   }
+
+   return 0;
+}